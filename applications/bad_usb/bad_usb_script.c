@@ -3,6 +3,7 @@
 #include <gui/gui.h>
 #include <input/input.h>
 #include <lib/toolbox/args.h>
+#include <lib/toolbox/crc32_calc.h>
 #include <furi_hal_usb_hid.h>
 #include <storage/storage.h>
 #include "bad_usb_script.h"
@@ -10,11 +11,18 @@
 
 #define TAG "BadUSB"
 #define WORKER_TAG TAG "Worker"
-#define FILE_BUFFER_LEN 16
+#define FILE_BUFFER_LEN 256
+#define COMPILE_BUFFER_LEN 64
+#define RAM_CODE_MAX (8 * 1024)
+#define RAM_CODE_MIN_CAPACITY 256
+#define TYPE_BUFFER_LEN 64
+
+#define BYTECODE_EXTENSION ".duckc"
+#define BYTECODE_MAGIC "DKBC"
+#define BYTECODE_VERSION 1
 
 #define SCRIPT_STATE_ERROR (-1)
 #define SCRIPT_STATE_END (-2)
-#define SCRIPT_STATE_NEXT_LINE (-3)
 
 typedef enum {
     WorkerEvtToggle = (1 << 0),
@@ -29,16 +37,78 @@ struct BadUsbScript {
     string_t file_path;
     uint32_t defdelay;
     FuriThread* thread;
-    uint8_t file_buf[FILE_BUFFER_LEN + 1];
-    uint8_t buf_start;
-    uint8_t buf_len;
-    bool file_end;
-    string_t line;
-
-    string_t line_prev;
+    uint8_t file_buf[FILE_BUFFER_LEN];
+    uint16_t type_buf[TYPE_BUFFER_LEN];
+    uint32_t buf_offset;
+    uint16_t buf_len;
+
+    uint8_t* code; /* Bytecode in RAM, used when cache file can't be written */
+    uint32_t code_size;
+    uint32_t code_capacity;
+    /* Script too big for RAM: code keeps lines compiled while running, starting at code_base */
+    bool code_stream;
+    bool code_stream_end;
+    uint32_t code_base;
+    uint32_t code_stream_offset; /* Next script byte to compile */
+    uint16_t code_stream_line_nb;
+
+    uint32_t pc;
+    uint32_t line_pc;
+    uint32_t line_prev_pc;
+    uint32_t repeat_pc;
     uint32_t repeat_cnt;
 };
 
+/* Scripts are compiled to bytecode on first run. Bytecode is cached next to
+ * the script and reused while script size and CRC32 stay the same.
+ *
+ * File layout: DuckyCodeHeader, then code_size bytes of ops. Every script
+ * line starts with DuckyOpLine, code ends with DuckyOpEnd. Operands follow
+ * opcode, little-endian.
+ */
+typedef enum {
+    DuckyOpEnd = 0x00,
+    DuckyOpLine = 0x01,
+    DuckyOpKey = 0x02, /* u16 keycode, press and release */
+    DuckyOpPress = 0x03, /* u16 keycode */
+    DuckyOpRelease = 0x04, /* u16 keycode */
+    DuckyOpString = 0x05, /* u16 count, u16 keycode[count] */
+    DuckyOpDelay = 0x06, /* u32 ms */
+    DuckyOpDefDelay = 0x07, /* u32 ms */
+    DuckyOpRepeat = 0x08, /* u32 count, repeats previous line */
+    DuckyOpNumlockOn = 0x09,
+    DuckyOpError = 0x0A, /* line can't be parsed */
+} DuckyOp;
+
+typedef enum {
+    DuckyCodeFlagUsbId = (1 << 0),
+} DuckyCodeFlag;
+
+#pragma pack(push, 1)
+typedef struct {
+    char magic[4];
+    uint8_t version;
+    uint8_t flags;
+    uint16_t line_nb;
+    uint32_t source_size;
+    uint32_t source_crc;
+    uint32_t code_size;
+    FuriHalUsbHidConfig hid_cfg;
+} DuckyCodeHeader;
+#pragma pack(pop)
+
+typedef struct {
+    File* file; /* NULL to compile into RAM */
+    uint8_t* code;
+    uint32_t code_capacity;
+    uint32_t code_max; /* RAM code limit, code is dropped and overflow is set above it */
+    uint8_t buf[COMPILE_BUFFER_LEN];
+    uint16_t buf_len;
+    uint32_t code_size;
+    bool error;
+    bool overflow;
+} DuckyCompiler;
+
 typedef struct {
     char* name;
     uint16_t keycode;
@@ -155,35 +225,105 @@ static void ducky_numlock_on() {
     }
 }
 
-static bool ducky_numpad_press(const char num) {
-    if((num < '0') || (num > '9')) return false;
+static uint16_t ducky_get_keycode(const char* param, bool accept_chars) {
+    for(uint8_t i = 0; i < (sizeof(ducky_keys) / sizeof(ducky_keys[0])); i++) {
+        uint8_t key_cmd_len = strlen(ducky_keys[i].name);
+        if((strncmp(param, ducky_keys[i].name, key_cmd_len) == 0) &&
+           (ducky_is_line_end(param[key_cmd_len]))) {
+            return ducky_keys[i].keycode;
+        }
+    }
+    if((accept_chars) && (strlen(param) > 0)) {
+        return (HID_ASCII_TO_KEY(param[0]) & 0xFF);
+    }
+    return 0;
+}
 
-    uint16_t key = numpad_keys[num - '0'];
-    furi_hal_hid_kb_press(key);
-    furi_hal_hid_kb_release(key);
+/* Grows RAM code geometrically, so flushes don't copy whole code every time */
+static bool ducky_code_reserve(DuckyCompiler* compiler, uint32_t used, uint32_t size) {
+    if(size <= compiler->code_capacity) return true;
 
+    if(size > compiler->code_max) {
+        free(compiler->code);
+        compiler->code = NULL;
+        compiler->code_capacity = 0;
+        compiler->overflow = true;
+        return false;
+    }
+
+    uint32_t capacity = MAX(compiler->code_capacity * 2, (uint32_t)RAM_CODE_MIN_CAPACITY);
+    capacity = MIN(MAX(capacity, size), compiler->code_max);
+    uint8_t* code = malloc(capacity);
+    if(compiler->code) {
+        memcpy(code, compiler->code, used);
+        free(compiler->code);
+    }
+    compiler->code = code;
+    compiler->code_capacity = capacity;
     return true;
 }
 
-static bool ducky_altchar(const char* charcode) {
-    uint8_t i = 0;
-    bool state = false;
+static void ducky_emit_flush(DuckyCompiler* compiler) {
+    if(compiler->buf_len == 0) return;
+    if(compiler->file) {
+        if(storage_file_write(compiler->file, compiler->buf, compiler->buf_len) !=
+           compiler->buf_len) {
+            compiler->error = true;
+        }
+    } else if(!compiler->overflow) {
+        // Buffered bytes are already counted in code_size
+        uint32_t code_len = compiler->code_size - compiler->buf_len;
+        if(ducky_code_reserve(compiler, code_len, compiler->code_size)) {
+            memcpy(&compiler->code[code_len], compiler->buf, compiler->buf_len);
+        }
+    }
+    compiler->buf_len = 0;
+}
 
-    FURI_LOG_I(WORKER_TAG, "char %s", charcode);
+static void ducky_emit(DuckyCompiler* compiler, const void* data, size_t size) {
+    const uint8_t* bytes = data;
+    for(size_t i = 0; i < size; i++) {
+        if(compiler->buf_len == COMPILE_BUFFER_LEN) ducky_emit_flush(compiler);
+        compiler->buf[compiler->buf_len++] = bytes[i];
+    }
+    compiler->code_size += size;
+}
 
-    furi_hal_hid_kb_press(KEY_MOD_LEFT_ALT);
+static void ducky_emit_op(DuckyCompiler* compiler, DuckyOp op) {
+    uint8_t opcode = op;
+    ducky_emit(compiler, &opcode, sizeof(opcode));
+}
 
-    while(!ducky_is_line_end(charcode[i])) {
-        state = ducky_numpad_press(charcode[i]);
-        if(state == false) break;
-        i++;
+static void ducky_emit_op_u16(DuckyCompiler* compiler, DuckyOp op, uint16_t val) {
+    ducky_emit_op(compiler, op);
+    ducky_emit(compiler, &val, sizeof(val));
+}
+
+static void ducky_emit_op_u32(DuckyCompiler* compiler, DuckyOp op, uint32_t val) {
+    ducky_emit_op(compiler, op);
+    ducky_emit(compiler, &val, sizeof(val));
+}
+
+static bool ducky_compile_altchar(DuckyCompiler* compiler, const char* charcode) {
+    uint8_t digit_cnt = 0;
+    while((charcode[digit_cnt] >= '0') && (charcode[digit_cnt] <= '9')) {
+        digit_cnt++;
     }
 
-    furi_hal_hid_kb_release(KEY_MOD_LEFT_ALT);
-    return state;
+    ducky_emit_op_u16(compiler, DuckyOpPress, KEY_MOD_LEFT_ALT);
+    if(digit_cnt > 0) {
+        ducky_emit_op_u16(compiler, DuckyOpString, digit_cnt);
+        for(uint8_t i = 0; i < digit_cnt; i++) {
+            uint16_t keycode = numpad_keys[charcode[i] - '0'];
+            ducky_emit(compiler, &keycode, sizeof(keycode));
+        }
+    }
+    ducky_emit_op_u16(compiler, DuckyOpRelease, KEY_MOD_LEFT_ALT);
+
+    return (digit_cnt > 0) && ducky_is_line_end(charcode[digit_cnt]);
 }
 
-static bool ducky_altstring(const char* param) {
+static bool ducky_compile_altstring(DuckyCompiler* compiler, const char* param) {
     uint32_t i = 0;
     bool state = false;
 
@@ -196,244 +336,571 @@ static bool ducky_altstring(const char* param) {
         char temp_str[4];
         snprintf(temp_str, 4, "%u", param[i]);
 
-        state = ducky_altchar(temp_str);
+        state = ducky_compile_altchar(compiler, temp_str);
         if(state == false) break;
         i++;
     }
     return state;
 }
 
-static bool ducky_string(const char* param) {
-    uint32_t i = 0;
-    while(param[i] != '\0') {
-        uint16_t keycode = HID_ASCII_TO_KEY(param[i]);
-        if(keycode != HID_KEYBOARD_NONE) {
-            furi_hal_hid_kb_press(keycode);
-            furi_hal_hid_kb_release(keycode);
+static bool ducky_compile_string(DuckyCompiler* compiler, const char* param) {
+    size_t len = strlen(param);
+    size_t i = 0;
+
+    while(i < len) {
+        // Key count goes first, so find how many chars map to keys
+        size_t chunk_end = i;
+        uint16_t key_cnt = 0;
+        while((chunk_end < len) && (key_cnt < UINT16_MAX)) {
+            if(HID_ASCII_TO_KEY(param[chunk_end]) != HID_KEYBOARD_NONE) key_cnt++;
+            chunk_end++;
         }
-        i++;
-    }
-    return true;
-}
 
-static uint16_t ducky_get_keycode(const char* param, bool accept_chars) {
-    for(uint8_t i = 0; i < (sizeof(ducky_keys) / sizeof(ducky_keys[0])); i++) {
-        uint8_t key_cmd_len = strlen(ducky_keys[i].name);
-        if((strncmp(param, ducky_keys[i].name, key_cmd_len) == 0) &&
-           (ducky_is_line_end(param[key_cmd_len]))) {
-            return ducky_keys[i].keycode;
+        if(key_cnt > 0) {
+            ducky_emit_op_u16(compiler, DuckyOpString, key_cnt);
+            for(; i < chunk_end; i++) {
+                uint16_t keycode = HID_ASCII_TO_KEY(param[i]);
+                if(keycode != HID_KEYBOARD_NONE) {
+                    ducky_emit(compiler, &keycode, sizeof(keycode));
+                }
+            }
         }
+        i = chunk_end;
     }
-    if((accept_chars) && (strlen(param) > 0)) {
-        return (HID_ASCII_TO_KEY(param[0]) & 0xFF);
-    }
-    return 0;
+    return true;
 }
 
-static int32_t ducky_parse_line(BadUsbScript* bad_usb, string_t line) {
-    uint32_t line_len = string_size(line);
-    const char* line_tmp = string_get_cstr(line);
+static bool ducky_compile_command(DuckyCompiler* compiler, const char* line_tmp, bool first_line) {
     bool state = false;
-
-    for(uint32_t i = 0; i < line_len; i++) {
-        if((line_tmp[i] != ' ') && (line_tmp[i] != '\t') && (line_tmp[i] != '\n')) {
-            line_tmp = &line_tmp[i];
-            break; // Skip spaces and tabs
-        }
-        if(i == line_len - 1) return SCRIPT_STATE_NEXT_LINE; // Skip empty lines
-    }
-
-    FURI_LOG_D(WORKER_TAG, "line:%s", line_tmp);
+    uint32_t val = 0;
 
     // General commands
     if(strncmp(line_tmp, ducky_cmd_comment, strlen(ducky_cmd_comment)) == 0) {
         // REM - comment line
-        return (0);
+        return true;
     } else if(strncmp(line_tmp, ducky_cmd_id, strlen(ducky_cmd_id)) == 0) {
-        // ID - executed in ducky_script_preload
-        return (0);
+        // ID - stored in bytecode header
+        return true;
     } else if(strncmp(line_tmp, ducky_cmd_delay, strlen(ducky_cmd_delay)) == 0) {
         // DELAY
         line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
-        uint32_t delay_val = 0;
-        state = ducky_get_number(line_tmp, &delay_val);
-        if((state) && (delay_val > 0)) {
-            return (int32_t)delay_val;
+        state = ducky_get_number(line_tmp, &val);
+        if((state) && (val > 0)) {
+            ducky_emit_op_u32(compiler, DuckyOpDelay, val);
+            return true;
         }
-        return SCRIPT_STATE_ERROR;
+        return false;
     } else if(
         (strncmp(line_tmp, ducky_cmd_defdelay_1, strlen(ducky_cmd_defdelay_1)) == 0) ||
         (strncmp(line_tmp, ducky_cmd_defdelay_2, strlen(ducky_cmd_defdelay_2)) == 0)) {
         // DEFAULT_DELAY
         line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
-        state = ducky_get_number(line_tmp, &bad_usb->defdelay);
-        return (state) ? (0) : SCRIPT_STATE_ERROR;
+        state = ducky_get_number(line_tmp, &val);
+        if(state) ducky_emit_op_u32(compiler, DuckyOpDefDelay, val);
+        return state;
     } else if(strncmp(line_tmp, ducky_cmd_string, strlen(ducky_cmd_string)) == 0) {
         // STRING
         line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
-        state = ducky_string(line_tmp);
-        return (state) ? (0) : SCRIPT_STATE_ERROR;
+        return ducky_compile_string(compiler, line_tmp);
     } else if(strncmp(line_tmp, ducky_cmd_altchar, strlen(ducky_cmd_altchar)) == 0) {
         // ALTCHAR
         line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
-        ducky_numlock_on();
-        state = ducky_altchar(line_tmp);
-        return (state) ? (0) : SCRIPT_STATE_ERROR;
+        ducky_emit_op(compiler, DuckyOpNumlockOn);
+        return ducky_compile_altchar(compiler, line_tmp);
     } else if(
         (strncmp(line_tmp, ducky_cmd_altstr_1, strlen(ducky_cmd_altstr_1)) == 0) ||
         (strncmp(line_tmp, ducky_cmd_altstr_2, strlen(ducky_cmd_altstr_2)) == 0)) {
         // ALTSTRING
         line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
-        ducky_numlock_on();
-        state = ducky_altstring(line_tmp);
-        return (state) ? (0) : SCRIPT_STATE_ERROR;
+        ducky_emit_op(compiler, DuckyOpNumlockOn);
+        return ducky_compile_altstring(compiler, line_tmp);
     } else if(strncmp(line_tmp, ducky_cmd_repeat, strlen(ducky_cmd_repeat)) == 0) {
-        // REPEAT
+        // REPEAT - nothing to repeat at first line
         line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
-        state = ducky_get_number(line_tmp, &bad_usb->repeat_cnt);
-        return (state) ? (0) : SCRIPT_STATE_ERROR;
+        state = ducky_get_number(line_tmp, &val);
+        if((state) && (!first_line)) {
+            ducky_emit_op_u32(compiler, DuckyOpRepeat, val);
+            return true;
+        }
+        return false;
     } else {
         // Special keys + modifiers
         uint16_t key = ducky_get_keycode(line_tmp, false);
-        if(key == HID_KEYBOARD_NONE) return SCRIPT_STATE_ERROR;
+        if(key == HID_KEYBOARD_NONE) return false;
         if((key & 0xFF00) != 0) {
             // It's a modifier key
             line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
             key |= ducky_get_keycode(line_tmp, true);
         }
-        furi_hal_hid_kb_press(key);
-        furi_hal_hid_kb_release(key);
-        return (0);
+        ducky_emit_op_u16(compiler, DuckyOpKey, key);
+        return true;
     }
-    return SCRIPT_STATE_ERROR;
+    return false;
 }
 
-static bool ducky_set_usb_id(BadUsbScript* bad_usb, const char* line) {
-    if(sscanf(line, "%lX:%lX", &bad_usb->hid_cfg.vid, &bad_usb->hid_cfg.pid) == 2) {
-        bad_usb->hid_cfg.manuf[0] = '\0';
-        bad_usb->hid_cfg.product[0] = '\0';
+static bool ducky_set_usb_id(FuriHalUsbHidConfig* hid_cfg, const char* line) {
+    if(sscanf(line, "%lX:%lX", &hid_cfg->vid, &hid_cfg->pid) == 2) {
+        hid_cfg->manuf[0] = '\0';
+        hid_cfg->product[0] = '\0';
 
         uint8_t id_len = ducky_get_command_len(line);
         if(!ducky_is_line_end(line[id_len + 1])) {
             sscanf(
                 &line[id_len + 1],
                 "%31[^\r\n:]:%31[^\r\n]",
-                bad_usb->hid_cfg.manuf,
-                bad_usb->hid_cfg.product);
+                hid_cfg->manuf,
+                hid_cfg->product);
         }
         FURI_LOG_D(
             WORKER_TAG,
             "set id: %04X:%04X mfr:%s product:%s",
-            bad_usb->hid_cfg.vid,
-            bad_usb->hid_cfg.pid,
-            bad_usb->hid_cfg.manuf,
-            bad_usb->hid_cfg.product);
+            hid_cfg->vid,
+            hid_cfg->pid,
+            hid_cfg->manuf,
+            hid_cfg->product);
         return true;
     }
     return false;
 }
 
-static bool ducky_script_preload(BadUsbScript* bad_usb, File* script_file) {
-    uint8_t ret = 0;
-    uint32_t line_len = 0;
+static void ducky_compile_line(DuckyCompiler* compiler, DuckyCodeHeader* header, string_t line) {
+    uint32_t line_len = string_size(line);
+    const char* line_tmp = string_get_cstr(line);
+
+    header->line_nb++;
+    ducky_emit_op(compiler, DuckyOpLine);
+
+    if(header->line_nb == 1) { // Looking for ID command at first line
+        if((strncmp(line_tmp, ducky_cmd_id, strlen(ducky_cmd_id)) == 0) &&
+           (ducky_set_usb_id(&header->hid_cfg, &line_tmp[strlen(ducky_cmd_id) + 1]))) {
+            header->flags |= DuckyCodeFlagUsbId;
+        }
+    }
+
+    for(uint32_t i = 0; i < line_len; i++) {
+        if((line_tmp[i] != ' ') && (line_tmp[i] != '\t') && (line_tmp[i] != '\n')) {
+            line_tmp = &line_tmp[i];
+            break; // Skip spaces and tabs
+        }
+        if(i == line_len - 1) return; // Skip empty lines
+    }
+
+    if(!ducky_compile_command(compiler, line_tmp, header->line_nb == 1)) {
+        // Reported when execution reaches this line
+        ducky_emit_op(compiler, DuckyOpError);
+    }
+}
+
+static void ducky_script_get_code_path(string_t file_path, string_t code_path) {
+    string_set(code_path, file_path);
+    size_t ext_start = string_search_rchar(code_path, '.');
+    size_t name_start = string_search_rchar(code_path, '/');
+    if((ext_start != STRING_FAILURE) &&
+       ((name_start == STRING_FAILURE) || (ext_start > name_start))) {
+        string_left(code_path, ext_start);
+    }
+    string_cat_str(code_path, BYTECODE_EXTENSION);
+}
+
+static void ducky_script_hash(BadUsbScript* bad_usb, File* script_file, DuckyCodeHeader* header) {
+    uint16_t ret = 0;
+
+    header->source_size = 0;
+    header->source_crc = 0;
+    storage_file_seek(script_file, 0, true);
+
+    do {
+        ret = storage_file_read(script_file, bad_usb->file_buf, FILE_BUFFER_LEN);
+        header->source_crc = crc32_calc_buffer(header->source_crc, bad_usb->file_buf, ret);
+        header->source_size += ret;
+    } while(ret > 0);
+}
+
+static bool ducky_code_open(File* code_file, string_t code_path, DuckyCodeHeader* header) {
+    DuckyCodeHeader code_header;
+    bool result = false;
+
+    do {
+        if(!storage_file_open(
+               code_file, string_get_cstr(code_path), FSAM_READ, FSOM_OPEN_EXISTING))
+            break;
+        if(storage_file_read(code_file, &code_header, sizeof(code_header)) !=
+           sizeof(code_header))
+            break;
+        if((memcmp(code_header.magic, BYTECODE_MAGIC, sizeof(code_header.magic)) != 0) ||
+           (code_header.version != BYTECODE_VERSION))
+            break;
+        if((code_header.source_size != header->source_size) ||
+           (code_header.source_crc != header->source_crc))
+            break;
+        if(storage_file_size(code_file) != sizeof(code_header) + code_header.code_size) break;
+        *header = code_header;
+        result = true;
+    } while(false);
+
+    if(!result) storage_file_close(code_file);
+    return result;
+}
+
+static void ducky_script_compile_code(
+    BadUsbScript* bad_usb,
+    File* script_file,
+    DuckyCompiler* compiler,
+    DuckyCodeHeader* header) {
+    string_t line;
+    string_init(line);
 
-    string_reset(bad_usb->line);
+    header->line_nb = 0;
+    header->flags = 0;
+    storage_file_seek(script_file, 0, true);
 
+    uint16_t ret = 0;
     do {
         ret = storage_file_read(script_file, bad_usb->file_buf, FILE_BUFFER_LEN);
         for(uint16_t i = 0; i < ret; i++) {
-            if(bad_usb->file_buf[i] == '\n' && line_len > 0) {
-                bad_usb->st.line_nb++;
-                line_len = 0;
-            } else {
-                if(bad_usb->st.line_nb == 0) { // Save first line
-                    string_push_back(bad_usb->line, bad_usb->file_buf[i]);
+            if(bad_usb->file_buf[i] == '\n') {
+                if(string_size(line) > 0) {
+                    ducky_compile_line(compiler, header, line);
+                    string_reset(line);
                 }
-                line_len++;
+            } else {
+                string_push_back(line, bad_usb->file_buf[i]);
             }
         }
-        if(storage_file_eof(script_file)) {
-            if(line_len > 0) {
-                bad_usb->st.line_nb++;
-                break;
+    } while((ret > 0) && (!compiler->error));
+    if(string_size(line) > 0) {
+        ducky_compile_line(compiler, header, line);
+    }
+    ducky_emit_op(compiler, DuckyOpEnd);
+    ducky_emit_flush(compiler);
+
+    string_clear(line);
+}
+
+static bool ducky_script_compile(
+    BadUsbScript* bad_usb,
+    File* script_file,
+    File* code_file,
+    string_t code_path,
+    DuckyCodeHeader* header) {
+    DuckyCompiler* compiler = malloc(sizeof(DuckyCompiler));
+    compiler->file = code_file;
+    compiler->buf_len = 0;
+    compiler->code_size = 0;
+    compiler->error = false;
+    bool result = false;
+
+    do {
+        if(!storage_file_open(
+               code_file, string_get_cstr(code_path), FSAM_WRITE, FSOM_CREATE_ALWAYS))
+            break;
+        // Placeholder, header is written when code is complete
+        DuckyCodeHeader empty_header = {0};
+        if(storage_file_write(code_file, &empty_header, sizeof(empty_header)) !=
+           sizeof(empty_header))
+            break;
+
+        ducky_script_compile_code(bad_usb, script_file, compiler, header);
+        if(compiler->error) break;
+
+        memcpy(header->magic, BYTECODE_MAGIC, sizeof(header->magic));
+        header->version = BYTECODE_VERSION;
+        header->code_size = compiler->code_size;
+        if(!storage_file_seek(code_file, 0, true)) break;
+        if(storage_file_write(code_file, header, sizeof(DuckyCodeHeader)) !=
+           sizeof(DuckyCodeHeader))
+            break;
+
+        FURI_LOG_I(
+            WORKER_TAG, "Compiled %u lines, %lu bytes", header->line_nb, header->code_size);
+        result = true;
+    } while(false);
+
+    storage_file_close(code_file);
+    free(compiler);
+    return result;
+}
+
+/* Fallback for storage errors, script still runs without cache. Script that doesn't fit
+ * into RAM_CODE_MAX is compiled line by line while running, see ducky_code_stream_line.
+ */
+static void ducky_script_compile_ram(
+    BadUsbScript* bad_usb,
+    File* script_file,
+    DuckyCodeHeader* header) {
+    DuckyCompiler* compiler = malloc(sizeof(DuckyCompiler));
+    compiler->code_max = RAM_CODE_MAX;
+
+    // Runs till the end even after overflow, line count and USB ID are still needed
+    ducky_script_compile_code(bad_usb, script_file, compiler, header);
+    header->code_size = compiler->code_size;
+    if(compiler->overflow) {
+        bad_usb->code_stream = true;
+        FURI_LOG_I(
+            WORKER_TAG,
+            "%lu bytes of code don't fit into RAM, compiling while running",
+            header->code_size);
+    } else {
+        bad_usb->code = compiler->code;
+        bad_usb->code_size = compiler->code_size;
+        bad_usb->code_capacity = compiler->code_capacity;
+        FURI_LOG_I(
+            WORKER_TAG,
+            "Compiled %u lines, %lu bytes in RAM",
+            header->line_nb,
+            header->code_size);
+    }
+
+    free(compiler);
+}
+
+static void ducky_code_stream_rewind(BadUsbScript* bad_usb) {
+    bad_usb->code_size = 0;
+    bad_usb->code_base = 0;
+    bad_usb->code_stream_offset = 0;
+    bad_usb->code_stream_line_nb = 0;
+    bad_usb->code_stream_end = false;
+}
+
+/* Compiles next script line into RAM. Lines before previous one are dropped,
+ * previous line is kept for REPEAT.
+ */
+static bool ducky_code_stream_line(BadUsbScript* bad_usb, File* script_file) {
+    if(bad_usb->code_stream_end) return false;
+
+    uint32_t drop = bad_usb->line_prev_pc - bad_usb->code_base;
+    if(drop > 0) {
+        memmove(bad_usb->code, &bad_usb->code[drop], bad_usb->code_size - drop);
+        bad_usb->code_base += drop;
+        bad_usb->code_size -= drop;
+    }
+
+    DuckyCompiler* compiler = malloc(sizeof(DuckyCompiler));
+    compiler->code = bad_usb->code;
+    compiler->code_capacity = bad_usb->code_capacity;
+    compiler->code_size = bad_usb->code_size;
+    compiler->code_max = UINT32_MAX;
+    DuckyCodeHeader header = {.line_nb = bad_usb->code_stream_line_nb};
+
+    string_t line;
+    string_init(line);
+    bool line_end = false;
+    bool file_end = false;
+    while(!line_end && !file_end) {
+        if(!storage_file_seek(script_file, bad_usb->code_stream_offset, true)) break;
+        uint16_t ret = storage_file_read(script_file, bad_usb->file_buf, FILE_BUFFER_LEN);
+        file_end = (ret == 0);
+        uint16_t i = 0;
+        while((i < ret) && !line_end) {
+            if(bad_usb->file_buf[i] != '\n') {
+                string_push_back(line, bad_usb->file_buf[i]);
+            } else if(string_size(line) > 0) {
+                line_end = true;
             }
+            i++;
         }
-    } while(ret > 0);
-
-    const char* line_tmp = string_get_cstr(bad_usb->line);
-    bool id_set = false; // Looking for ID command at first line
-    if(strncmp(line_tmp, ducky_cmd_id, strlen(ducky_cmd_id)) == 0) {
-        id_set = ducky_set_usb_id(bad_usb, &line_tmp[strlen(ducky_cmd_id) + 1]);
+        bad_usb->code_stream_offset += i;
     }
 
-    if(id_set) {
-        furi_check(furi_hal_usb_set_config(&usb_hid, &bad_usb->hid_cfg));
-    } else {
-        furi_check(furi_hal_usb_set_config(&usb_hid, NULL));
+    if(string_size(line) > 0) {
+        ducky_compile_line(compiler, &header, line);
+    }
+    if(file_end) {
+        ducky_emit_op(compiler, DuckyOpEnd);
+        bad_usb->code_stream_end = true;
     }
+    ducky_emit_flush(compiler);
+    string_clear(line);
 
-    storage_file_seek(script_file, 0, true);
-    string_reset(bad_usb->line);
+    bad_usb->code = compiler->code;
+    bad_usb->code_capacity = compiler->code_capacity;
+    bad_usb->code_size = compiler->code_size;
+    bad_usb->code_stream_line_nb = header.line_nb;
+    free(compiler);
 
-    return true;
+    return line_end || file_end;
 }
 
-static int32_t ducky_script_execute_next(BadUsbScript* bad_usb, File* script_file) {
-    int32_t delay_val = 0;
+static bool ducky_script_load(
+    BadUsbScript* bad_usb,
+    Storage* storage,
+    File* script_file,
+    File* code_file) {
+    DuckyCodeHeader header = {0};
+    string_t code_path;
+    string_init(code_path);
+    ducky_script_get_code_path(bad_usb->file_path, code_path);
+
+    ducky_script_hash(bad_usb, script_file, &header);
+
+    bool loaded = ducky_code_open(code_file, code_path, &header);
+    if(!loaded) {
+        FURI_LOG_I(WORKER_TAG, "Compiling to %s", string_get_cstr(code_path));
+        if(ducky_script_compile(bad_usb, script_file, code_file, code_path, &header)) {
+            loaded = ducky_code_open(code_file, code_path, &header);
+        }
+        if(!loaded) {
+            FURI_LOG_W(WORKER_TAG, "Can't write bytecode cache, running from RAM");
+            storage_common_remove(storage, string_get_cstr(code_path));
+            ducky_script_compile_ram(bad_usb, script_file, &header);
+            if(bad_usb->code_stream) {
+                // Script itself is read while running
+                loaded = storage_file_open(
+                    code_file,
+                    string_get_cstr(bad_usb->file_path),
+                    FSAM_READ,
+                    FSOM_OPEN_EXISTING);
+            } else {
+                loaded = true;
+            }
+        }
+    }
+    string_clear(code_path);
 
-    if(bad_usb->repeat_cnt > 0) {
-        bad_usb->repeat_cnt--;
-        delay_val = ducky_parse_line(bad_usb, bad_usb->line_prev);
-        if(delay_val == SCRIPT_STATE_NEXT_LINE) { // Empty line
-            return 0;
-        } else if(delay_val < 0) { // Script error
-            bad_usb->st.error_line = bad_usb->st.line_cur - 1;
-            FURI_LOG_E(WORKER_TAG, "Unknown command at line %lu", bad_usb->st.line_cur - 1);
-            return SCRIPT_STATE_ERROR;
+    if(loaded) {
+        bad_usb->st.line_nb = header.line_nb;
+        if(header.flags & DuckyCodeFlagUsbId) {
+            bad_usb->hid_cfg = header.hid_cfg;
+            furi_check(furi_hal_usb_set_config(&usb_hid, &bad_usb->hid_cfg));
         } else {
-            return (delay_val + bad_usb->defdelay);
+            furi_check(furi_hal_usb_set_config(&usb_hid, NULL));
         }
     }
 
-    string_set(bad_usb->line_prev, bad_usb->line);
-    string_reset(bad_usb->line);
+    return loaded;
+}
 
-    while(1) {
-        if(bad_usb->buf_len == 0) {
-            bad_usb->buf_len = storage_file_read(script_file, bad_usb->file_buf, FILE_BUFFER_LEN);
-            if(storage_file_eof(script_file)) {
-                if((bad_usb->buf_len < FILE_BUFFER_LEN) && (bad_usb->file_end == false)) {
-                    bad_usb->file_buf[bad_usb->buf_len] = '\n';
-                    bad_usb->buf_len++;
-                    bad_usb->file_end = true;
-                }
-            }
+static bool ducky_code_read(BadUsbScript* bad_usb, File* code_file, void* data, size_t size) {
+    uint8_t* out = data;
 
-            bad_usb->buf_start = 0;
-            if(bad_usb->buf_len == 0) return SCRIPT_STATE_END;
+    if(bad_usb->code_stream) {
+        while(bad_usb->pc + size > bad_usb->code_base + bad_usb->code_size) {
+            if(!ducky_code_stream_line(bad_usb, code_file)) return false;
         }
-        for(uint8_t i = bad_usb->buf_start; i < (bad_usb->buf_start + bad_usb->buf_len); i++) {
-            if(bad_usb->file_buf[i] == '\n' && string_size(bad_usb->line) > 0) {
-                bad_usb->st.line_cur++;
-                bad_usb->buf_len = bad_usb->buf_len + bad_usb->buf_start - (i + 1);
-                bad_usb->buf_start = i + 1;
-                delay_val = ducky_parse_line(bad_usb, bad_usb->line);
-                if(delay_val < 0) {
-                    bad_usb->st.error_line = bad_usb->st.line_cur;
-                    FURI_LOG_E(WORKER_TAG, "Unknown command at line %lu", bad_usb->st.line_cur);
+    }
+
+    if(bad_usb->code) {
+        if(bad_usb->pc + size > bad_usb->code_base + bad_usb->code_size) return false;
+        memcpy(out, &bad_usb->code[bad_usb->pc - bad_usb->code_base], size);
+        bad_usb->pc += size;
+        return true;
+    }
+
+    while(size > 0) {
+        if((bad_usb->pc < bad_usb->buf_offset) ||
+           (bad_usb->pc >= bad_usb->buf_offset + bad_usb->buf_len)) {
+            if(!storage_file_seek(code_file, sizeof(DuckyCodeHeader) + bad_usb->pc, true)) {
+                return false;
+            }
+            bad_usb->buf_offset = bad_usb->pc;
+            bad_usb->buf_len = storage_file_read(code_file, bad_usb->file_buf, FILE_BUFFER_LEN);
+            if(bad_usb->buf_len == 0) return false;
+        }
+        size_t buf_pos = bad_usb->pc - bad_usb->buf_offset;
+        size_t chunk_len = MIN(size, bad_usb->buf_len - buf_pos);
+        memcpy(out, &bad_usb->file_buf[buf_pos], chunk_len);
+        out += chunk_len;
+        size -= chunk_len;
+        bad_usb->pc += chunk_len;
+    }
+    return true;
+}
+
+static int32_t ducky_script_run_line(BadUsbScript* bad_usb, File* code_file, bool repeat) {
+    int32_t delay_val = 0;
+    uint8_t op = 0;
+    uint16_t val16 = 0;
+    uint32_t val32 = 0;
+
+    while(1) {
+        uint32_t op_pc = bad_usb->pc;
+        if(!ducky_code_read(bad_usb, code_file, &op, sizeof(op))) return SCRIPT_STATE_ERROR;
+
+        if((op == DuckyOpLine) || (op == DuckyOpEnd)) {
+            bad_usb->pc = op_pc; // Next line starts here
+            return (delay_val + bad_usb->defdelay);
+        } else if(op == DuckyOpKey) {
+            if(!ducky_code_read(bad_usb, code_file, &val16, sizeof(val16)))
+                return SCRIPT_STATE_ERROR;
+            furi_hal_hid_kb_press(val16);
+            furi_hal_hid_kb_release(val16);
+        } else if(op == DuckyOpPress) {
+            if(!ducky_code_read(bad_usb, code_file, &val16, sizeof(val16)))
+                return SCRIPT_STATE_ERROR;
+            furi_hal_hid_kb_press(val16);
+        } else if(op == DuckyOpRelease) {
+            if(!ducky_code_read(bad_usb, code_file, &val16, sizeof(val16)))
+                return SCRIPT_STATE_ERROR;
+            furi_hal_hid_kb_release(val16);
+        } else if(op == DuckyOpString) {
+            uint16_t key_cnt = 0;
+            if(!ducky_code_read(bad_usb, code_file, &key_cnt, sizeof(key_cnt)))
+                return SCRIPT_STATE_ERROR;
+            while(key_cnt > 0) {
+                uint16_t chunk_len = MIN(key_cnt, (uint16_t)TYPE_BUFFER_LEN);
+                if(!ducky_code_read(
+                       bad_usb, code_file, bad_usb->type_buf, chunk_len * sizeof(uint16_t)))
                     return SCRIPT_STATE_ERROR;
-                } else {
-                    return (delay_val + bad_usb->defdelay);
-                }
-            } else {
-                string_push_back(bad_usb->line, bad_usb->file_buf[i]);
+                furi_hal_hid_kb_type(bad_usb->type_buf, chunk_len);
+                key_cnt -= chunk_len;
+            }
+        } else if(op == DuckyOpDelay) {
+            if(!ducky_code_read(bad_usb, code_file, &val32, sizeof(val32)))
+                return SCRIPT_STATE_ERROR;
+            delay_val += (int32_t)val32;
+        } else if(op == DuckyOpDefDelay) {
+            if(!ducky_code_read(bad_usb, code_file, &val32, sizeof(val32)))
+                return SCRIPT_STATE_ERROR;
+            bad_usb->defdelay = val32;
+        } else if(op == DuckyOpRepeat) {
+            if(!ducky_code_read(bad_usb, code_file, &val32, sizeof(val32)))
+                return SCRIPT_STATE_ERROR;
+            if(!repeat) { // REPEAT inside repeated line is ignored
+                bad_usb->repeat_cnt = val32;
+                bad_usb->repeat_pc = bad_usb->line_prev_pc;
             }
+        } else if(op == DuckyOpNumlockOn) {
+            ducky_numlock_on();
+        } else {
+            return SCRIPT_STATE_ERROR; // DuckyOpError or broken code
         }
-        bad_usb->buf_len = 0;
-        if(bad_usb->file_end) return SCRIPT_STATE_END;
     }
 
-    return 0;
+    return SCRIPT_STATE_ERROR;
+}
+
+static int32_t ducky_script_execute_next(BadUsbScript* bad_usb, File* code_file) {
+    int32_t delay_val = 0;
+
+    if(bad_usb->repeat_cnt > 0) {
+        bad_usb->repeat_cnt--;
+        uint32_t next_line_pc = bad_usb->pc;
+        bad_usb->pc = bad_usb->repeat_pc;
+        delay_val = ducky_script_run_line(bad_usb, code_file, true);
+        bad_usb->pc = next_line_pc;
+        if(delay_val < 0) { // Script error
+            bad_usb->st.error_line = bad_usb->st.line_cur - 1;
+            FURI_LOG_E(WORKER_TAG, "Unknown command at line %lu", bad_usb->st.line_cur - 1);
+            return SCRIPT_STATE_ERROR;
+        }
+        return delay_val;
+    }
+
+    uint8_t op = 0;
+    if(!ducky_code_read(bad_usb, code_file, &op, sizeof(op))) return SCRIPT_STATE_ERROR;
+    if(op == DuckyOpEnd) return SCRIPT_STATE_END;
+    if(op != DuckyOpLine) return SCRIPT_STATE_ERROR;
+
+    bad_usb->st.line_cur++;
+    bad_usb->line_prev_pc = bad_usb->line_pc;
+    bad_usb->line_pc = bad_usb->pc;
+    delay_val = ducky_script_run_line(bad_usb, code_file, false);
+    if(delay_val < 0) {
+        bad_usb->st.error_line = bad_usb->st.line_cur;
+        FURI_LOG_E(WORKER_TAG, "Unknown command at line %lu", bad_usb->st.line_cur);
+        return SCRIPT_STATE_ERROR;
+    }
+    return delay_val;
 }
 
 static void bad_usb_hid_state_callback(bool state, void* context) {
@@ -455,9 +922,9 @@ static int32_t bad_usb_worker(void* context) {
     FuriHalUsbInterface* usb_mode_prev = furi_hal_usb_get_config();
 
     FURI_LOG_I(WORKER_TAG, "Init");
-    File* script_file = storage_file_alloc(furi_record_open("storage"));
-    string_init(bad_usb->line);
-    string_init(bad_usb->line_prev);
+    Storage* storage = furi_record_open("storage");
+    File* script_file = storage_file_alloc(storage);
+    File* code_file = storage_file_alloc(storage);
 
     furi_hal_hid_set_state_callback(bad_usb_hid_state_callback, bad_usb);
 
@@ -468,14 +935,19 @@ static int32_t bad_usb_worker(void* context) {
                    string_get_cstr(bad_usb->file_path),
                    FSAM_READ,
                    FSOM_OPEN_EXISTING)) {
-                if((ducky_script_preload(bad_usb, script_file)) && (bad_usb->st.line_nb > 0)) {
+                bool loaded = ducky_script_load(bad_usb, storage, script_file, code_file);
+                storage_file_close(script_file);
+                if(!loaded) {
+                    FURI_LOG_E(WORKER_TAG, "Bytecode load error");
+                    worker_state = BadUsbStateFileError; // Bytecode cache error
+                } else if(bad_usb->st.line_nb > 0) {
                     if(furi_hal_hid_is_connected()) {
                         worker_state = BadUsbStateIdle; // Ready to run
                     } else {
                         worker_state = BadUsbStateNotConnected; // USB not connected
                     }
                 } else {
-                    worker_state = BadUsbStateScriptError; // Script preload error
+                    worker_state = BadUsbStateScriptError; // Empty script
                 }
             } else {
                 FURI_LOG_E(WORKER_TAG, "File open error");
@@ -506,11 +978,14 @@ static int32_t bad_usb_worker(void* context) {
                 DOLPHIN_DEED(DolphinDeedBadUsbPlayScript);
                 delay_val = 0;
                 bad_usb->buf_len = 0;
+                bad_usb->pc = 0;
+                bad_usb->line_pc = 0;
+                bad_usb->line_prev_pc = 0;
                 bad_usb->st.line_cur = 0;
                 bad_usb->defdelay = 0;
                 bad_usb->repeat_cnt = 0;
-                bad_usb->file_end = false;
-                storage_file_seek(script_file, 0, true);
+                if(bad_usb->code_stream) ducky_code_stream_rewind(bad_usb);
+                furi_hal_hid_kb_reset_type_stats();
                 worker_state = BadUsbStateRunning;
             } else if(flags & WorkerEvtDisconnect) {
                 worker_state = BadUsbStateNotConnected; // USB disconnected
@@ -540,7 +1015,7 @@ static int32_t bad_usb_worker(void* context) {
                     continue;
                 }
                 bad_usb->st.state = BadUsbStateRunning;
-                delay_val = ducky_script_execute_next(bad_usb, script_file);
+                delay_val = ducky_script_execute_next(bad_usb, code_file);
                 if(delay_val == SCRIPT_STATE_ERROR) { // Script error
                     delay_val = 0;
                     worker_state = BadUsbStateScriptError;
@@ -550,6 +1025,14 @@ static int32_t bad_usb_worker(void* context) {
                     worker_state = BadUsbStateIdle;
                     bad_usb->st.state = BadUsbStateDone;
                     furi_hal_hid_kb_release_all();
+                    FuriHalHidTypingStats type_stats;
+                    furi_hal_hid_kb_get_type_stats(&type_stats);
+                    FURI_LOG_I(
+                        WORKER_TAG,
+                        "Typed %lu chars in %lu ms, %lu chars/s",
+                        type_stats.chars,
+                        type_stats.time_ms,
+                        type_stats.chars_per_sec);
                     continue;
                 } else if(delay_val > 1000) {
                     bad_usb->st.state = BadUsbStateDelay; // Show long delays
@@ -575,10 +1058,15 @@ static int32_t bad_usb_worker(void* context) {
 
     furi_hal_usb_set_config(usb_mode_prev, NULL);
 
-    storage_file_close(script_file);
+    storage_file_close(code_file);
+    storage_file_free(code_file);
     storage_file_free(script_file);
-    string_clear(bad_usb->line);
-    string_clear(bad_usb->line_prev);
+    furi_record_close("storage");
+
+    if(bad_usb->code) {
+        free(bad_usb->code);
+        bad_usb->code = NULL;
+    }
 
     FURI_LOG_I(WORKER_TAG, "End");
 
@@ -182,12 +182,13 @@ static void bt_rpc_send_bytes_callback(void* context, uint8_t* bytes, size_t byt
     size_t bytes_sent = 0;
     while(bytes_sent < bytes_len) {
         size_t bytes_remain = bytes_len - bytes_sent;
-        if(bytes_remain > bt->max_packet_size) {
-            furi_hal_bt_serial_tx(&bytes[bytes_sent], bt->max_packet_size);
-            bytes_sent += bt->max_packet_size;
-        } else {
-            furi_hal_bt_serial_tx(&bytes[bytes_sent], bytes_remain);
-            bytes_sent += bytes_remain;
+        size_t packet_size = MIN(bytes_remain, bt->max_packet_size);
+        bool packet_sent = furi_hal_bt_serial_tx(&bytes[bytes_sent], packet_size);
+        bytes_sent += packet_size;
+        if(furi_hal_bt_serial_is_tx_windowed()) {
+            // Notifications are queued in controller, serial service waits for free buffers itself
+            if(!packet_sent) break;
+            continue;
         }
         // We want BT_RPC_EVENT_DISCONNECTED to stick, so don't clear
         uint32_t event_flag = furi_event_flag_wait(
@@ -201,6 +202,18 @@ static void bt_rpc_send_bytes_callback(void* context, uint8_t* bytes, size_t byt
     }
 }
 
+static void bt_rpc_log_tx_stats() {
+    FuriHalBtSerialTxStats stats;
+    furi_hal_bt_serial_get_tx_stats(&stats);
+    FURI_LOG_I(
+        TAG,
+        "RPC sent %lu bytes in %lu packets, %lu retries, %lu B/s",
+        stats.bytes,
+        stats.packets,
+        stats.retries,
+        stats.time_ms ? stats.bytes * 1000 / stats.time_ms : 0);
+}
+
 // Called from GAP thread
 static bool bt_on_gap_event_callback(GapEvent event, void* context) {
     furi_assert(context);
@@ -241,6 +254,7 @@ static bool bt_on_gap_event_callback(GapEvent event, void* context) {
     } else if(event.type == GapEventTypeDisconnected) {
         if(bt->profile == BtProfileSerial && bt->rpc_session) {
             FURI_LOG_I(TAG, "Close RPC connection");
+            bt_rpc_log_tx_stats();
             furi_event_flag_set(bt->rpc_event, BT_RPC_EVENT_DISCONNECTED);
             rpc_session_close(bt->rpc_session);
             furi_hal_bt_serial_set_event_callback(0, NULL, NULL);
@@ -303,6 +317,7 @@ static void bt_show_warning(Bt* bt, const char* text) {
 
 static void bt_close_rpc_connection(Bt* bt) {
     if(bt->profile == BtProfileSerial && bt->rpc_session) {
+        bt_rpc_log_tx_stats();
         FURI_LOG_I(TAG, "Close RPC connection");
         furi_event_flag_set(bt->rpc_event, BT_RPC_EVENT_DISCONNECTED);
         rpc_session_close(bt->rpc_session);
@@ -159,6 +159,10 @@ void cli_command_log(Cli* cli, string_t args, void* context) {
 
     furi_hal_console_set_tx_callback(NULL, NULL);
 
+    if(furi_log_is_deferred()) {
+        printf("Dropped records: %lu\r\n", furi_log_get_dropped());
+    }
+
     vStreamBufferDelete(ring);
 }
 
@@ -289,6 +293,20 @@ void cli_command_free_blocks(Cli* cli, string_t args, void* context) {
     UNUSED(context);
 
     memmgr_heap_printf_free_blocks();
+
+    printf("Slab\tPages\tUsed\tPeak\tAllocs\tFallbacks\r\n");
+    for(size_t i = 0; i < memmgr_heap_get_slab_class_count(); i++) {
+        MemmgrHeapSlabStats stats;
+        memmgr_heap_get_slab_stats(i, &stats);
+        printf(
+            "%u\t%u\t%u\t%u\t%lu\t%lu\r\n",
+            stats.object_size,
+            stats.pages,
+            stats.used,
+            stats.peak,
+            (uint32_t)stats.allocs,
+            (uint32_t)stats.fallbacks);
+    }
 }
 
 void cli_command_i2c(Cli* cli, string_t args, void* context) {
@@ -7,6 +7,10 @@
 #include <stdint.h>
 #include <u8g2_glue.h>
 
+#define CANVAS_FLUSH_FLAG_START (1 << 0)
+#define CANVAS_FLUSH_FLAG_EXIT (1 << 1)
+#define CANVAS_FLUSH_FLAGS_ALL (CANVAS_FLUSH_FLAG_START | CANVAS_FLUSH_FLAG_EXIT)
+
 const CanvasFontParameters canvas_font_params[FontTotalNumber] = {
     [FontPrimary] = {.leading_default = 12, .leading_min = 11, .height = 8, .descender = 2},
     [FontSecondary] = {.leading_default = 11, .leading_min = 9, .height = 7, .descender = 2},
@@ -14,6 +18,33 @@ const CanvasFontParameters canvas_font_params[FontTotalNumber] = {
     [FontBigNumbers] = {.leading_default = 18, .leading_min = 16, .height = 15, .descender = 0},
 };
 
+static size_t canvas_get_page_size(Canvas* canvas) {
+    return u8g2_GetBufferTileWidth(&canvas->fb) * 8;
+}
+
+static int32_t canvas_flush_thread(void* context) {
+    Canvas* canvas = context;
+    u8x8_t* u8x8 = u8g2_GetU8x8(&canvas->fb);
+    const uint8_t tile_width = u8g2_GetBufferTileWidth(&canvas->fb);
+    const size_t page_size = canvas_get_page_size(canvas);
+
+    while(1) {
+        uint32_t flags =
+            furi_thread_flags_wait(CANVAS_FLUSH_FLAGS_ALL, FuriFlagWaitAny, FuriWaitForever);
+        if(flags & CANVAS_FLUSH_FLAG_EXIT) break;
+
+        for(uint8_t page = 0; page < u8g2_GetBufferTileHeight(&canvas->fb); page++) {
+            if(canvas->dirty_pages & (1 << page)) {
+                u8x8_DrawTile(u8x8, 0, page, tile_width, &canvas->back_buffer[page * page_size]);
+            }
+        }
+        canvas->dirty_pages = 0;
+        furi_semaphore_release(canvas->flush_idle);
+    }
+
+    return 0;
+}
+
 Canvas* canvas_init() {
     Canvas* canvas = malloc(sizeof(Canvas));
 
@@ -25,6 +56,18 @@ Canvas* canvas_init() {
     // Wake up display
     u8g2_SetPowerSave(&canvas->fb, 0);
 
+    // Background flush
+    canvas->back_buffer = malloc(canvas_get_buffer_size(canvas));
+    canvas->dirty_pages = 0;
+    canvas->full_flush = true;
+    canvas->flush_idle = furi_semaphore_alloc(1, 1);
+    canvas->flush_thread = furi_thread_alloc();
+    furi_thread_set_name(canvas->flush_thread, "CanvasFlush");
+    furi_thread_set_stack_size(canvas->flush_thread, 1024);
+    furi_thread_set_context(canvas->flush_thread, canvas);
+    furi_thread_set_callback(canvas->flush_thread, canvas_flush_thread);
+    furi_thread_start(canvas->flush_thread);
+
     // Clear buffer and send to device
     canvas_clear(canvas);
     canvas_commit(canvas);
@@ -34,6 +77,12 @@ Canvas* canvas_init() {
 
 void canvas_free(Canvas* canvas) {
     furi_assert(canvas);
+    furi_semaphore_acquire(canvas->flush_idle, FuriWaitForever);
+    furi_thread_flags_set(furi_thread_get_id(canvas->flush_thread), CANVAS_FLUSH_FLAG_EXIT);
+    furi_thread_join(canvas->flush_thread);
+    furi_thread_free(canvas->flush_thread);
+    furi_semaphore_free(canvas->flush_idle);
+    free(canvas->back_buffer);
     free(canvas);
 }
 
@@ -49,7 +98,29 @@ void canvas_reset(Canvas* canvas) {
 
 void canvas_commit(Canvas* canvas) {
     furi_assert(canvas);
-    u8g2_SendBuffer(&canvas->fb);
+    const uint8_t* buffer = u8g2_GetBufferPtr(&canvas->fb);
+    const size_t page_size = canvas_get_page_size(canvas);
+
+    // Back buffer is in use until previous frame is sent
+    furi_semaphore_acquire(canvas->flush_idle, FuriWaitForever);
+
+    uint8_t dirty_pages = 0;
+    for(uint8_t page = 0; page < u8g2_GetBufferTileHeight(&canvas->fb); page++) {
+        const size_t offset = page * page_size;
+        if(canvas->full_flush ||
+           memcmp(&canvas->back_buffer[offset], &buffer[offset], page_size) != 0) {
+            memcpy(&canvas->back_buffer[offset], &buffer[offset], page_size);
+            dirty_pages |= (1 << page);
+        }
+    }
+    canvas->full_flush = false;
+
+    if(dirty_pages) {
+        canvas->dirty_pages = dirty_pages;
+        furi_thread_flags_set(furi_thread_get_id(canvas->flush_thread), CANVAS_FLUSH_FLAG_START);
+    } else {
+        furi_semaphore_release(canvas->flush_idle);
+    }
 }
 
 uint8_t* canvas_get_buffer(Canvas* canvas) {
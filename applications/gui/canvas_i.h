@@ -7,6 +7,7 @@
 
 #include "canvas.h"
 #include <u8g2.h>
+#include <furi.h>
 
 /** Canvas structure
  */
@@ -17,6 +18,13 @@ struct Canvas {
     uint8_t offset_y;
     uint8_t width;
     uint8_t height;
+
+    /* Last committed frame, flush thread sends dirty pages from it */
+    uint8_t* back_buffer;
+    uint8_t dirty_pages;
+    bool full_flush;
+    FuriThread* flush_thread;
+    FuriSemaphore* flush_idle;
 };
 
 /** Allocate memory and initialize canvas
@@ -37,7 +45,8 @@ void canvas_free(Canvas* canvas);
  */
 void canvas_reset(Canvas* canvas);
 
-/** Commit canvas. Send buffer to display
+/** Commit canvas. Copy changed display pages to back buffer and send them
+ * in background. Waits only for previous commit to finish.
  *
  * @param      canvas  Canvas instance
  */
@@ -1,5 +1,6 @@
 #include "gui/canvas.h"
 #include "gui_i.h"
+#include <furi_hal.h>
 
 #define TAG "GuiSrv"
 
@@ -19,6 +20,18 @@ ViewPort* gui_view_port_find_enabled(ViewPortArray_t array) {
 
 void gui_update(Gui* gui) {
     furi_assert(gui);
+    FURI_CRITICAL_ENTER();
+    gui->redraw_all = true;
+    gui->update_requests++;
+    FURI_CRITICAL_EXIT();
+    furi_thread_flags_set(gui->thread_id, GUI_THREAD_FLAG_DRAW);
+}
+
+void gui_view_port_update(Gui* gui) {
+    furi_assert(gui);
+    FURI_CRITICAL_ENTER();
+    gui->update_requests++;
+    FURI_CRITICAL_EXIT();
     furi_thread_flags_set(gui->thread_id, GUI_THREAD_FLAG_DRAW);
 }
 
@@ -191,6 +204,57 @@ static void gui_redraw_status_bar(Gui* gui, bool need_attention) {
     }
 }
 
+static bool gui_status_bar_take_dirty(Gui* gui) {
+    bool is_dirty = false;
+    for(size_t layer = GuiLayerStatusBarLeft; layer <= GuiLayerStatusBarRight; layer++) {
+        ViewPortArray_it_t it;
+        ViewPortArray_it(it, gui->layers[layer]);
+        while(!ViewPortArray_end_p(it)) {
+            ViewPort* view_port = *ViewPortArray_ref(it);
+            if(view_port_take_dirty(view_port) && view_port_is_enabled(view_port)) {
+                is_dirty = true;
+            }
+            ViewPortArray_next(it);
+        }
+    }
+    return is_dirty;
+}
+
+static void gui_status_bar_cache_save(Gui* gui, bool need_attention) {
+    const uint8_t* buffer = canvas_get_buffer(gui->canvas);
+    memcpy(gui->status_bar_cache, buffer, GUI_DISPLAY_WIDTH);
+    for(size_t x = 0; x < GUI_DISPLAY_WIDTH; x++) {
+        gui->status_bar_cache[GUI_DISPLAY_WIDTH + x] =
+            buffer[GUI_DISPLAY_WIDTH + x] & GUI_STATUS_BAR_CACHE_PAGE1_MASK;
+    }
+    gui->status_bar_cache_valid = true;
+    gui->status_bar_cache_attention = need_attention;
+    gui->status_bar_cache_tick = furi_get_tick();
+}
+
+static void gui_status_bar_cache_restore(Gui* gui) {
+    uint8_t* buffer = canvas_get_buffer(gui->canvas);
+    memcpy(buffer, gui->status_bar_cache, GUI_DISPLAY_WIDTH);
+    for(size_t x = 0; x < GUI_DISPLAY_WIDTH; x++) {
+        buffer[GUI_DISPLAY_WIDTH + x] =
+            (buffer[GUI_DISPLAY_WIDTH + x] & ~GUI_STATUS_BAR_CACHE_PAGE1_MASK) |
+            gui->status_bar_cache[GUI_DISPLAY_WIDTH + x];
+    }
+}
+
+/* Window layer doesn't touch status bar area, so only there it can be reused */
+static void gui_redraw_status_bar_cached(Gui* gui, bool status_bar_dirty) {
+    if(!status_bar_dirty && gui->status_bar_cache_valid && !gui->status_bar_cache_attention &&
+       (furi_get_tick() - gui->status_bar_cache_tick <
+        furi_ms_to_ticks(GUI_STATUS_BAR_CACHE_TIMEOUT_MS))) {
+        gui_status_bar_cache_restore(gui);
+        gui->stats.status_bar_cached++;
+    } else {
+        gui_redraw_status_bar(gui, false);
+        gui_status_bar_cache_save(gui, false);
+    }
+}
+
 bool gui_redraw_window(Gui* gui) {
     canvas_set_orientation(gui->canvas, CanvasOrientationHorizontal);
     canvas_frame_set(gui->canvas, GUI_WINDOW_X, GUI_WINDOW_Y, GUI_WINDOW_WIDTH, GUI_WINDOW_HEIGHT);
@@ -218,23 +282,65 @@ void gui_redraw(Gui* gui) {
     furi_assert(gui);
     gui_lock(gui);
 
+    FURI_CRITICAL_ENTER();
+    bool redraw_all = gui->redraw_all;
+    uint32_t update_requests = gui->update_requests;
+    gui->redraw_all = false;
+    gui->update_requests = 0;
+    FURI_CRITICAL_EXIT();
+    if(update_requests > 1) {
+        gui->stats.frames_dropped += update_requests - 1;
+    }
+
+    // Take dirty flags before drawing, updates made during draw go to next frame
+    bool status_bar_dirty = gui_status_bar_take_dirty(gui);
+    bool content_dirty = false;
+    ViewPort* fullscreen = gui_view_port_find_enabled(gui->layers[GuiLayerFullscreen]);
+    ViewPort* window = gui_view_port_find_enabled(gui->layers[GuiLayerWindow]);
+    ViewPort* desktop = gui_view_port_find_enabled(gui->layers[GuiLayerDesktop]);
+    if(gui->lockdown) {
+        content_dirty = view_port_take_dirty(desktop);
+        status_bar_dirty = true;
+    } else if(fullscreen) {
+        content_dirty = view_port_take_dirty(fullscreen);
+        status_bar_dirty = false;
+    } else if(window) {
+        content_dirty = view_port_take_dirty(window);
+    } else {
+        content_dirty = view_port_take_dirty(desktop);
+    }
+
+    if(!redraw_all && !content_dirty && !status_bar_dirty) {
+        gui->stats.frames_skipped++;
+        gui_unlock(gui);
+        return;
+    }
+
+    uint32_t frame_start = DWT->CYCCNT;
     canvas_reset(gui->canvas);
 
     if(gui->lockdown) {
         gui_redraw_desktop(gui);
-        bool need_attention =
-            (gui_view_port_find_enabled(gui->layers[GuiLayerWindow]) != 0 ||
-             gui_view_port_find_enabled(gui->layers[GuiLayerFullscreen]) != 0);
+        bool need_attention = (window != NULL || fullscreen != NULL);
         gui_redraw_status_bar(gui, need_attention);
+        gui->status_bar_cache_valid = false;
     } else {
         if(!gui_redraw_fs(gui)) {
-            if(!gui_redraw_window(gui)) {
+            if(gui_redraw_window(gui)) {
+                gui_redraw_status_bar_cached(gui, redraw_all || status_bar_dirty);
+            } else {
                 gui_redraw_desktop(gui);
+                gui_redraw_status_bar(gui, false);
+                gui->status_bar_cache_valid = false;
             }
-            gui_redraw_status_bar(gui, false);
         }
     }
 
+    gui->stats.frame_time_us =
+        (DWT->CYCCNT - frame_start) / furi_hal_cortex_instructions_per_microsecond();
+    gui->stats.frame_time_max_us = MAX(gui->stats.frame_time_max_us, gui->stats.frame_time_us);
+    gui->stats.frames++;
+
     canvas_commit(gui->canvas);
     for
         M_EACH(p, gui->canvas_callback_pair, CanvasCallbackPairArray_t) {
@@ -457,6 +563,15 @@ size_t gui_get_framebuffer_size(Gui* gui) {
     return canvas_get_buffer_size(gui->canvas);
 }
 
+void gui_get_frame_stats(Gui* gui, GuiFrameStats* stats) {
+    furi_assert(gui);
+    furi_assert(stats);
+
+    gui_lock(gui);
+    *stats = gui->stats;
+    gui_unlock(gui);
+}
+
 void gui_set_lockdown(Gui* gui, bool lockdown) {
     furi_assert(gui);
 
@@ -482,6 +597,9 @@ Gui* gui_alloc() {
     // Drawing canvas
     gui->canvas = canvas_init();
     CanvasCallbackPairArray_init(gui->canvas_callback_pair);
+    // Frame scheduler
+    gui->redraw_all = true;
+    gui->status_bar_cache = malloc(GUI_STATUS_BAR_CACHE_SIZE);
 
     // Input
     gui->input_queue = furi_message_queue_alloc(8, sizeof(InputEvent));
@@ -499,9 +617,18 @@ int32_t gui_srv(void* p) {
 
     furi_record_create("gui", gui);
 
+    const uint32_t frame_interval = furi_ms_to_ticks(GUI_FRAME_INTERVAL_MS);
     while(1) {
-        uint32_t flags =
-            furi_thread_flags_wait(GUI_THREAD_FLAG_ALL, FuriFlagWaitAny, FuriWaitForever);
+        // Sleep until next frame is due if redraw is pending
+        uint32_t timeout = FuriWaitForever;
+        if(gui->draw_pending) {
+            uint32_t elapsed = furi_get_tick() - gui->frame_last;
+            timeout = (elapsed < frame_interval) ? (frame_interval - elapsed) : 0;
+        }
+        uint32_t flags = furi_thread_flags_wait(GUI_THREAD_FLAG_ALL, FuriFlagWaitAny, timeout);
+        if(flags & FuriFlagError) {
+            flags = 0;
+        }
         // Process and dispatch input
         if(flags & GUI_THREAD_FLAG_INPUT) {
             // Process till queue become empty
@@ -514,6 +641,11 @@ int32_t gui_srv(void* p) {
         if(flags & GUI_THREAD_FLAG_DRAW) {
             // Clear flags that arrived on input step
             furi_thread_flags_clear(GUI_THREAD_FLAG_DRAW);
+            gui->draw_pending = true;
+        }
+        if(gui->draw_pending && (furi_get_tick() - gui->frame_last >= frame_interval)) {
+            gui->draw_pending = false;
+            gui->frame_last = furi_get_tick();
             gui_redraw(gui);
         }
     }
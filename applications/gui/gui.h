@@ -31,6 +31,16 @@ typedef void (*GuiCanvasCommitCallback)(uint8_t* data, size_t size, void* contex
 
 typedef struct Gui Gui;
 
+/** Gui frame statistics */
+typedef struct {
+    uint32_t frames; /**< Frames drawn */
+    uint32_t frames_skipped; /**< Redraws skipped, nothing visible changed */
+    uint32_t frames_dropped; /**< Redraw requests merged into another frame */
+    uint32_t status_bar_cached; /**< Frames that reused cached status bar */
+    uint32_t frame_time_us; /**< Last frame draw time */
+    uint32_t frame_time_max_us; /**< Longest frame draw time */
+} GuiFrameStats;
+
 /** Add view_port to view_port tree
  *
  * @remark     thread safe
@@ -104,6 +114,13 @@ size_t gui_get_framebuffer_size(Gui* gui);
  */
 void gui_set_lockdown(Gui* gui, bool lockdown);
 
+/** Get frame statistics
+ *
+ * @param      gui    Gui instance
+ * @param      stats  GuiFrameStats to fill
+ */
+void gui_get_frame_stats(Gui* gui, GuiFrameStats* stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -37,6 +37,14 @@
 #define GUI_WINDOW_WIDTH GUI_DISPLAY_WIDTH
 #define GUI_WINDOW_HEIGHT (GUI_DISPLAY_HEIGHT - GUI_WINDOW_Y)
 
+/* Redraw requests within one frame interval are drawn as one frame */
+#define GUI_FRAME_INTERVAL_MS 16
+/* Cached status bar is redrawn at least this often, some icons change without update */
+#define GUI_STATUS_BAR_CACHE_TIMEOUT_MS 1000
+/* Status bar area: page 0 and top rows of page 1 */
+#define GUI_STATUS_BAR_CACHE_SIZE (GUI_DISPLAY_WIDTH * 2)
+#define GUI_STATUS_BAR_CACHE_PAGE1_MASK ((1 << (GUI_STATUS_BAR_HEIGHT - 8)) - 1)
+
 #define GUI_THREAD_FLAG_DRAW (1 << 0)
 #define GUI_THREAD_FLAG_INPUT (1 << 1)
 #define GUI_THREAD_FLAG_ALL (GUI_THREAD_FLAG_DRAW | GUI_THREAD_FLAG_INPUT)
@@ -66,6 +74,19 @@ struct Gui {
     Canvas* canvas;
     CanvasCallbackPairArray_t canvas_callback_pair;
 
+    // Frame scheduler
+    bool redraw_all;
+    bool draw_pending;
+    uint32_t frame_last;
+    uint32_t update_requests;
+    GuiFrameStats stats;
+
+    // Status bar cache, valid only above window layer
+    uint8_t* status_bar_cache;
+    bool status_bar_cache_valid;
+    bool status_bar_cache_attention;
+    uint32_t status_bar_cache_tick;
+
     // Input
     FuriMessageQueue* input_queue;
     FuriPubSub* input_events;
@@ -75,12 +96,18 @@ struct Gui {
 
 ViewPort* gui_view_port_find_enabled(ViewPortArray_t array);
 
-/** Update GUI, request redraw
+/** Update GUI, request full redraw
  *
  * @param      gui   Gui instance
  */
 void gui_update(Gui* gui);
 
+/** Request redraw of updated view ports
+ *
+ * @param      gui   Gui instance
+ */
+void gui_view_port_update(Gui* gui);
+
 void gui_input_events_callback(const void* value, void* ctx);
 
 void gui_lock(Gui* gui);
@@ -1,6 +1,7 @@
 #include "view_port_i.h"
 
 #include <furi.h>
+#include <furi_hal.h>
 
 #include "gui.h"
 #include "gui_i.h"
@@ -97,7 +98,8 @@ void view_port_input_callback_set(
 
 void view_port_update(ViewPort* view_port) {
     furi_assert(view_port);
-    if(view_port->gui && view_port->is_enabled) gui_update(view_port->gui);
+    view_port->is_dirty = true;
+    if(view_port->gui && view_port->is_enabled) gui_view_port_update(view_port->gui);
 }
 
 void view_port_gui_set(ViewPort* view_port, Gui* gui) {
@@ -105,17 +107,41 @@ void view_port_gui_set(ViewPort* view_port, Gui* gui) {
     view_port->gui = gui;
 }
 
+bool view_port_take_dirty(ViewPort* view_port) {
+    if(!view_port) return false;
+    // Update from app thread between read and clear would be lost otherwise
+    FURI_CRITICAL_ENTER();
+    bool is_dirty = view_port->is_dirty;
+    view_port->is_dirty = false;
+    FURI_CRITICAL_EXIT();
+    return is_dirty;
+}
+
 void view_port_draw(ViewPort* view_port, Canvas* canvas) {
     furi_assert(view_port);
     furi_assert(canvas);
     furi_check(view_port->gui);
 
     if(view_port->draw_callback) {
+        uint32_t start = DWT->CYCCNT;
         view_port_setup_canvas_orientation(view_port, canvas);
         view_port->draw_callback(canvas, view_port->draw_callback_context);
+        view_port->draw_time_us =
+            (DWT->CYCCNT - start) / furi_hal_cortex_instructions_per_microsecond();
+        view_port->draw_time_max_us = MAX(view_port->draw_time_max_us, view_port->draw_time_us);
     }
 }
 
+uint32_t view_port_get_draw_time(ViewPort* view_port) {
+    furi_assert(view_port);
+    return view_port->draw_time_us;
+}
+
+uint32_t view_port_get_draw_time_max(ViewPort* view_port) {
+    furi_assert(view_port);
+    return view_port->draw_time_max_us;
+}
+
 void view_port_input(ViewPort* view_port, InputEvent* event) {
     furi_assert(view_port);
     furi_assert(event);
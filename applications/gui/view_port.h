@@ -65,6 +65,22 @@ uint8_t view_port_get_width(ViewPort* view_port);
 void view_port_set_height(ViewPort* view_port, uint8_t height);
 uint8_t view_port_get_height(ViewPort* view_port);
 
+/** Get duration of last draw callback call
+ *
+ * @param      view_port  ViewPort instance
+ *
+ * @return     draw time in microseconds
+ */
+uint32_t view_port_get_draw_time(ViewPort* view_port);
+
+/** Get longest draw callback call duration
+ *
+ * @param      view_port  ViewPort instance
+ *
+ * @return     draw time in microseconds
+ */
+uint32_t view_port_get_draw_time_max(ViewPort* view_port);
+
 /** Enable or disable view_port rendering.
  *
  * @param      view_port  ViewPort instance
@@ -21,6 +21,11 @@ struct ViewPort {
 
     ViewPortInputCallback input_callback;
     void* input_callback_context;
+
+    // Set by view_port_update, cleared by GUI before draw
+    bool is_dirty;
+    uint32_t draw_time_us;
+    uint32_t draw_time_max_us;
 };
 
 /** Set GUI reference.
@@ -32,6 +37,14 @@ struct ViewPort {
  */
 void view_port_gui_set(ViewPort* view_port, Gui* gui);
 
+/** Take dirty flag. Called by GUI before drawing view port.
+ *
+ * @param      view_port  ViewPort instance, can be NULL
+ *
+ * @return     true if view port was updated since last call
+ */
+bool view_port_take_dirty(ViewPort* view_port);
+
 /** Process draw call. Calls draw callback.
  *
  * To be used by GUI, called on tree redraw.
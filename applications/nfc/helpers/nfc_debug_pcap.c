@@ -1,7 +1,7 @@
 #include "nfc_debug_pcap.h"
 
 #include <furi_hal_rtc.h>
-#include <stream_buffer.h>
+#include <furi_hal.h>
 
 #define TAG "NfcDebugPcap"
 
@@ -16,14 +16,36 @@
 #define DATA_PCD_TO_PICC_CRC_DROPPED 0xFA
 
 #define NFC_DEBUG_PCAP_FILENAME "/ext/nfc/debug.pcap"
-#define NFC_DEBUG_PCAP_BUFFER_SIZE 64
+#define NFC_DEBUG_PCAP_BUFFER_SIZE 2048
+#define NFC_DEBUG_PCAP_FLUSH_PERIOD_MS 50
+/* DWT->CYCCNT wraps in 67 s at 64 MHz, longer gaps are measured in ticks */
+#define NFC_DEBUG_PCAP_CYCCNT_SPAN_MS 60000
+
+typedef enum {
+    NfcDebugPcapFlagFlush = (1 << 0),
+    NfcDebugPcapFlagStop = (1 << 1),
+} NfcDebugPcapFlag;
+
+typedef struct {
+    uint8_t data[NFC_DEBUG_PCAP_BUFFER_SIZE];
+    size_t size;
+} NfcDebugPcapBuffer;
 
 struct NfcDebugPcapWorker {
-    bool alive;
+    volatile bool enabled;
     Storage* storage;
     File* file;
-    StreamBufferHandle_t stream;
     FuriThread* thread;
+    /* Records are appended to active buffer, the other one is written by thread */
+    NfcDebugPcapBuffer buffers[2];
+    volatile uint8_t active;
+    volatile bool pending;
+    volatile uint32_t dropped;
+    /* Capture time base */
+    uint32_t start_sec;
+    uint32_t last_tick;
+    uint32_t last_cycles;
+    uint64_t cycles;
 };
 
 static File* nfc_debug_pcap_open(Storage* storage) {
@@ -53,10 +75,63 @@ static File* nfc_debug_pcap_open(Storage* storage) {
     return file;
 }
 
+static uint64_t nfc_debug_pcap_get_time_us(NfcDebugPcapWorker* instance) {
+    uint32_t cycles = DWT->CYCCNT;
+    uint32_t tick = furi_get_tick();
+    uint32_t instructions_per_us = furi_hal_cortex_instructions_per_microsecond();
+    if(tick - instance->last_tick < NFC_DEBUG_PCAP_CYCCNT_SPAN_MS) {
+        instance->cycles += cycles - instance->last_cycles;
+    } else {
+        instance->cycles += (uint64_t)(tick - instance->last_tick) * 1000 * instructions_per_us;
+    }
+    instance->last_tick = tick;
+    instance->last_cycles = cycles;
+    return instance->cycles / instructions_per_us;
+}
+
+/* Swap buffers if the other one is written out, returns false otherwise */
+static bool nfc_debug_pcap_swap(NfcDebugPcapWorker* instance) {
+    if(instance->pending) return false;
+    instance->pending = true;
+    instance->active ^= 1;
+    return true;
+}
+
+static bool nfc_debug_pcap_append(
+    NfcDebugPcapWorker* instance,
+    const void* header,
+    size_t header_size,
+    const uint8_t* data,
+    size_t size) {
+    bool appended = false;
+    bool swapped = false;
+
+    FURI_CRITICAL_ENTER();
+    NfcDebugPcapBuffer* buffer = &instance->buffers[instance->active];
+    if(buffer->size + header_size + size > NFC_DEBUG_PCAP_BUFFER_SIZE) {
+        swapped = nfc_debug_pcap_swap(instance);
+        buffer = &instance->buffers[instance->active];
+    }
+    if(buffer->size + header_size + size <= NFC_DEBUG_PCAP_BUFFER_SIZE) {
+        memcpy(&buffer->data[buffer->size], header, header_size);
+        memcpy(&buffer->data[buffer->size + header_size], data, size);
+        buffer->size += header_size + size;
+        appended = true;
+    }
+    FURI_CRITICAL_EXIT();
+
+    if(swapped) {
+        furi_thread_flags_set(furi_thread_get_id(instance->thread), NfcDebugPcapFlagFlush);
+    }
+    return appended;
+}
+
+/* Called from RF path, never blocks: frames are dropped while both buffers are full */
 static void
     nfc_debug_pcap_write(NfcDebugPcapWorker* instance, uint8_t event, uint8_t* data, uint16_t len) {
-    FuriHalRtcDateTime datetime;
-    furi_hal_rtc_get_datetime(&datetime);
+    if(!instance->enabled) return;
+
+    uint64_t time_us = nfc_debug_pcap_get_time_us(instance);
 
     struct {
         // https://wiki.wireshark.org/Development/LibpcapFileFormat#record-packet-header
@@ -69,16 +144,18 @@ static void
         uint8_t event;
         uint16_t len;
     } __attribute__((__packed__)) pkt_hdr = {
-        .ts_sec = furi_hal_rtc_datetime_to_timestamp(&datetime),
-        .ts_usec = 0,
+        .ts_sec = instance->start_sec + time_us / 1000000,
+        .ts_usec = time_us % 1000000,
         .incl_len = len + 4,
         .orig_len = len + 4,
         .version = 0,
         .event = event,
         .len = len << 8 | len >> 8,
     };
-    xStreamBufferSend(instance->stream, &pkt_hdr, sizeof(pkt_hdr), FuriWaitForever);
-    xStreamBufferSend(instance->stream, data, len, FuriWaitForever);
+
+    if(!nfc_debug_pcap_append(instance, &pkt_hdr, sizeof(pkt_hdr), data, len)) {
+        instance->dropped++;
+    }
 }
 
 static void
@@ -95,16 +172,45 @@ static void
     nfc_debug_pcap_write(instance, event, data, bits / 8);
 }
 
-int32_t nfc_debug_pcap_thread(void* context) {
+static void nfc_debug_pcap_flush(NfcDebugPcapWorker* instance) {
+    NfcDebugPcapBuffer* buffer = &instance->buffers[instance->active ^ 1];
+    if(storage_file_write(instance->file, buffer->data, buffer->size) != buffer->size) {
+        FURI_LOG_E(TAG, "Failed to write pcap data");
+    }
+    // Producer must not see buffer released before it is emptied
+    FURI_CRITICAL_ENTER();
+    buffer->size = 0;
+    instance->pending = false;
+    FURI_CRITICAL_EXIT();
+}
+
+static bool nfc_debug_pcap_swap_partial(NfcDebugPcapWorker* instance) {
+    bool swapped = false;
+    FURI_CRITICAL_ENTER();
+    if(instance->buffers[instance->active].size) {
+        swapped = nfc_debug_pcap_swap(instance);
+    }
+    FURI_CRITICAL_EXIT();
+    return swapped;
+}
+
+static int32_t nfc_debug_pcap_thread(void* context) {
     NfcDebugPcapWorker* instance = context;
-    uint8_t buffer[NFC_DEBUG_PCAP_BUFFER_SIZE];
 
-    while(instance->alive) {
-        size_t ret =
-            xStreamBufferReceive(instance->stream, buffer, NFC_DEBUG_PCAP_BUFFER_SIZE, 50);
-        if(storage_file_write(instance->file, buffer, ret) != ret) {
-            FURI_LOG_E(TAG, "Failed to write pcap data");
+    while(true) {
+        uint32_t flags = furi_thread_flags_wait(
+            NfcDebugPcapFlagFlush | NfcDebugPcapFlagStop,
+            FuriFlagWaitAny,
+            NFC_DEBUG_PCAP_FLUSH_PERIOD_MS);
+        if(instance->pending) {
+            nfc_debug_pcap_flush(instance);
+        }
+        // Write out partially filled buffer when capture goes idle or stops
+        if(((flags & FuriFlagError) || (flags & NfcDebugPcapFlagStop)) &&
+           nfc_debug_pcap_swap_partial(instance)) {
+            nfc_debug_pcap_flush(instance);
         }
+        if(!(flags & FuriFlagError) && (flags & NfcDebugPcapFlagStop)) break;
     }
 
     return 0;
@@ -113,13 +219,17 @@ int32_t nfc_debug_pcap_thread(void* context) {
 NfcDebugPcapWorker* nfc_debug_pcap_alloc(Storage* storage) {
     NfcDebugPcapWorker* instance = malloc(sizeof(NfcDebugPcapWorker));
 
-    instance->alive = true;
+    instance->enabled = true;
 
     instance->storage = storage;
 
     instance->file = nfc_debug_pcap_open(storage);
 
-    instance->stream = xStreamBufferCreate(4096, 1);
+    FuriHalRtcDateTime datetime;
+    furi_hal_rtc_get_datetime(&datetime);
+    instance->start_sec = furi_hal_rtc_datetime_to_timestamp(&datetime);
+    instance->last_tick = furi_get_tick();
+    instance->last_cycles = DWT->CYCCNT;
 
     instance->thread = furi_thread_alloc();
     furi_thread_set_name(instance->thread, "PcapWorker");
@@ -134,12 +244,15 @@ NfcDebugPcapWorker* nfc_debug_pcap_alloc(Storage* storage) {
 void nfc_debug_pcap_free(NfcDebugPcapWorker* instance) {
     furi_assert(instance);
 
-    instance->alive = false;
+    instance->enabled = false;
 
+    furi_thread_flags_set(furi_thread_get_id(instance->thread), NfcDebugPcapFlagStop);
     furi_thread_join(instance->thread);
     furi_thread_free(instance->thread);
 
-    vStreamBufferDelete(instance->stream);
+    if(instance->dropped) {
+        FURI_LOG_W(TAG, "Dropped %d frames", instance->dropped);
+    }
 
     if(instance->file) storage_file_free(instance->file);
 
@@ -148,6 +261,21 @@ void nfc_debug_pcap_free(NfcDebugPcapWorker* instance) {
     free(instance);
 }
 
+void nfc_debug_pcap_set_enabled(NfcDebugPcapWorker* instance, bool enabled) {
+    furi_assert(instance);
+    instance->enabled = enabled;
+}
+
+bool nfc_debug_pcap_is_enabled(NfcDebugPcapWorker* instance) {
+    furi_assert(instance);
+    return instance->enabled;
+}
+
+uint32_t nfc_debug_pcap_get_dropped(NfcDebugPcapWorker* instance) {
+    furi_assert(instance);
+    return instance->dropped;
+}
+
 void nfc_debug_pcap_prepare_tx_rx(
     NfcDebugPcapWorker* instance,
     FuriHalNfcTxRxContext* tx_rx,
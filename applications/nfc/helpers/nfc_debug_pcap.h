@@ -9,6 +9,23 @@ NfcDebugPcapWorker* nfc_debug_pcap_alloc(Storage* storage);
 
 void nfc_debug_pcap_free(NfcDebugPcapWorker* instance);
 
+/** Enable or disable frame capture. Capture is enabled on alloc.
+ *
+ * @param      instance NfcDebugPcapWorker instance
+ * @param      enabled  true to capture frames
+ */
+void nfc_debug_pcap_set_enabled(NfcDebugPcapWorker* instance, bool enabled);
+
+bool nfc_debug_pcap_is_enabled(NfcDebugPcapWorker* instance);
+
+/** Get number of frames dropped because both capture buffers were full
+ *
+ * @param      instance NfcDebugPcapWorker instance
+ *
+ * @return     dropped frames count
+ */
+uint32_t nfc_debug_pcap_get_dropped(NfcDebugPcapWorker* instance);
+
 /** Prepare tx/rx context for debug pcap logging, if enabled.
  *
  * @param      instance NfcDebugPcapWorker* instance, can be NULL
@@ -1,81 +1,267 @@
 #include "nfc_emv_parser.h"
+#include <furi_hal.h>
 #include <flipper_format/flipper_format.h>
+#include <flipper_format/flipper_format_i.h>
+#include <lib/toolbox/args.h>
+
+#define TAG "NfcEmvParser"
+
+#define NFC_EMV_PARSER_KEY_MAX (16)
 
 static const char* nfc_resources_header = "Flipper EMV resources";
 static const uint32_t nfc_resources_file_version = 1;
 
-static bool nfc_emv_parser_search_data(
-    Storage* storage,
-    const char* file_name,
-    string_t key,
-    string_t data) {
-    bool parsed = false;
-    FlipperFormat* file = flipper_format_file_alloc(storage);
+typedef enum {
+    NfcEmvParserTableAid,
+    NfcEmvParserTableCountry,
+    NfcEmvParserTableCurrency,
+    NfcEmvParserTableNum,
+} NfcEmvParserTableType;
+
+static const char* nfc_emv_parser_table_path[NfcEmvParserTableNum] = {
+    [NfcEmvParserTableAid] = "/ext/nfc/assets/aid.nfc",
+    [NfcEmvParserTableCountry] = "/ext/nfc/assets/country_code.nfc",
+    [NfcEmvParserTableCurrency] = "/ext/nfc/assets/currency_code.nfc",
+};
+
+/* Keys and names are stored in pool, entries are sorted by key */
+typedef struct {
+    uint16_t key_offset;
+    uint16_t name_offset;
+    uint8_t key_len;
+} NfcEmvParserEntry;
+
+typedef struct {
+    bool loaded;
+    NfcEmvParserEntry* entries;
+    size_t entries_count;
+    char* pool;
+    size_t pool_size;
+} NfcEmvParserTable;
+
+struct NfcEmvParser {
+    Storage* storage;
+    NfcEmvParserTable tables[NfcEmvParserTableNum];
+};
+
+static int nfc_emv_parser_key_cmp(
+    const uint8_t* key_a,
+    uint8_t key_a_len,
+    const uint8_t* key_b,
+    uint8_t key_b_len) {
+    int result = memcmp(key_a, key_b, MIN(key_a_len, key_b_len));
+    if(!result) result = (int)key_a_len - (int)key_b_len;
+    return result;
+}
+
+static size_t nfc_emv_parser_table_pool_add(
+    NfcEmvParserTable* table,
+    size_t* pool_capacity,
+    const void* data,
+    size_t size) {
+    if(table->pool_size + size > *pool_capacity) {
+        while(table->pool_size + size > *pool_capacity) *pool_capacity *= 2;
+        table->pool = realloc(table->pool, *pool_capacity);
+    }
+    size_t offset = table->pool_size;
+    memcpy(&table->pool[offset], data, size);
+    table->pool_size += size;
+    return offset;
+}
+
+static bool nfc_emv_parser_table_parse_line(
+    NfcEmvParserTable* table,
+    size_t* entries_capacity,
+    size_t* pool_capacity,
+    string_t line) {
+    size_t delimiter = string_search_char(line, ':');
+    if(delimiter == STRING_FAILURE) return false;
+
+    uint8_t key[NFC_EMV_PARSER_KEY_MAX];
+    uint8_t key_len = delimiter / 2;
+    if((delimiter % 2) || !key_len || (key_len > NFC_EMV_PARSER_KEY_MAX)) return false;
+    const char* line_str = string_get_cstr(line);
+    for(size_t i = 0; i < key_len; i++) {
+        if(!args_char_to_hex(line_str[i * 2], line_str[i * 2 + 1], &key[i])) return false;
+    }
+
+    string_right(line, delimiter + 1);
+    string_strim(line);
+    /* Pool offsets are 16 bit */
+    if(table->pool_size + key_len + string_size(line) + 1 > UINT16_MAX) return false;
+
+    if(table->entries_count == *entries_capacity) {
+        *entries_capacity *= 2;
+        table->entries =
+            realloc(table->entries, sizeof(NfcEmvParserEntry) * (*entries_capacity));
+    }
+
+    NfcEmvParserEntry entry = {
+        .key_offset = nfc_emv_parser_table_pool_add(table, pool_capacity, key, key_len),
+        .name_offset = nfc_emv_parser_table_pool_add(
+            table, pool_capacity, string_get_cstr(line), string_size(line) + 1),
+        .key_len = key_len,
+    };
+
+    /* Resource files are mostly sorted, insertion is close to append */
+    size_t pos = table->entries_count++;
+    while(pos > 0) {
+        const NfcEmvParserEntry* prev = &table->entries[pos - 1];
+        if(nfc_emv_parser_key_cmp(
+               (uint8_t*)&table->pool[prev->key_offset], prev->key_len, key, key_len) <= 0)
+            break;
+        table->entries[pos] = *prev;
+        pos--;
+    }
+    table->entries[pos] = entry;
+
+    return true;
+}
+
+static void nfc_emv_parser_table_load(NfcEmvParser* parser, NfcEmvParserTableType type) {
+    NfcEmvParserTable* table = &parser->tables[type];
+    table->loaded = true;
+
+    size_t entries_capacity = 64;
+    size_t pool_capacity = 1024;
+    table->entries = malloc(sizeof(NfcEmvParserEntry) * entries_capacity);
+    table->pool = malloc(pool_capacity);
+
+    FlipperFormat* file = flipper_format_file_alloc(parser->storage);
     string_t temp_str;
     string_init(temp_str);
+    uint32_t start = DWT->CYCCNT;
 
     do {
         // Open file
-        if(!flipper_format_file_open_existing(file, file_name)) break;
+        if(!flipper_format_file_open_existing(file, nfc_emv_parser_table_path[type])) break;
         // Read file header and version
         uint32_t version = 0;
         if(!flipper_format_read_header(file, temp_str, &version)) break;
         if(string_cmp_str(temp_str, nfc_resources_header) ||
            (version != nfc_resources_file_version))
             break;
-        if(!flipper_format_read_string(file, string_get_cstr(key), data)) break;
-        parsed = true;
+        // Read all entries
+        Stream* stream = flipper_format_get_raw_stream(file);
+        while(stream_read_line(stream, temp_str)) {
+            if(string_get_char(temp_str, 0) == '#') continue;
+            nfc_emv_parser_table_parse_line(table, &entries_capacity, &pool_capacity, temp_str);
+        }
     } while(false);
 
+    FURI_LOG_D(
+        TAG,
+        "Loaded %d entries from %s in %d us",
+        table->entries_count,
+        nfc_emv_parser_table_path[type],
+        (DWT->CYCCNT - start) / furi_hal_cortex_instructions_per_microsecond());
+
     string_clear(temp_str);
     flipper_format_free(file);
-    return parsed;
+}
+
+static void nfc_emv_parser_table_free(NfcEmvParserTable* table) {
+    free(table->entries);
+    free(table->pool);
+    memset(table, 0, sizeof(NfcEmvParserTable));
+}
+
+static bool nfc_emv_parser_search_data(
+    NfcEmvParser* parser,
+    NfcEmvParserTableType type,
+    const uint8_t* key,
+    uint8_t key_len,
+    string_t data) {
+    NfcEmvParserTable* table = &parser->tables[type];
+    if(!table->loaded) {
+        nfc_emv_parser_table_load(parser, type);
+    }
+
+    size_t low = 0;
+    size_t high = table->entries_count;
+    while(low < high) {
+        size_t mid = low + (high - low) / 2;
+        const NfcEmvParserEntry* entry = &table->entries[mid];
+        int cmp = nfc_emv_parser_key_cmp(
+            (uint8_t*)&table->pool[entry->key_offset], entry->key_len, key, key_len);
+        if(cmp == 0) {
+            string_set_str(data, &table->pool[entry->name_offset]);
+            return true;
+        } else if(cmp < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return false;
+}
+
+NfcEmvParser* nfc_emv_parser_alloc(Storage* storage) {
+    furi_assert(storage);
+    NfcEmvParser* parser = malloc(sizeof(NfcEmvParser));
+    parser->storage = storage;
+    return parser;
+}
+
+void nfc_emv_parser_free(NfcEmvParser* parser) {
+    furi_assert(parser);
+    for(size_t i = 0; i < NfcEmvParserTableNum; i++) {
+        nfc_emv_parser_table_free(&parser->tables[i]);
+    }
+    free(parser);
 }
 
 bool nfc_emv_parser_get_aid_name(
-    Storage* storage,
-    uint8_t* aid,
+    NfcEmvParser* parser,
+    const uint8_t* aid,
     uint8_t aid_len,
     string_t aid_name) {
-    furi_assert(storage);
-    bool parsed = false;
-    string_t key;
-    string_init(key);
-    for(uint8_t i = 0; i < aid_len; i++) {
-        string_cat_printf(key, "%02X", aid[i]);
-    }
-    if(nfc_emv_parser_search_data(storage, "/ext/nfc/assets/aid.nfc", key, aid_name)) {
-        parsed = true;
-    }
-    string_clear(key);
-    return parsed;
+    furi_assert(parser);
+    return nfc_emv_parser_search_data(parser, NfcEmvParserTableAid, aid, aid_len, aid_name);
 }
 
 bool nfc_emv_parser_get_country_name(
-    Storage* storage,
+    NfcEmvParser* parser,
     uint16_t country_code,
     string_t country_name) {
-    bool parsed = false;
-    string_t key;
-    string_init_printf(key, "%04X", country_code);
-    if(nfc_emv_parser_search_data(storage, "/ext/nfc/assets/country_code.nfc", key, country_name)) {
-        parsed = true;
-    }
-    string_clear(key);
-    return parsed;
+    furi_assert(parser);
+    uint8_t key[2] = {country_code >> 8, country_code & 0xff};
+    return nfc_emv_parser_search_data(
+        parser, NfcEmvParserTableCountry, key, sizeof(key), country_name);
 }
 
 bool nfc_emv_parser_get_currency_name(
-    Storage* storage,
+    NfcEmvParser* parser,
     uint16_t currency_code,
     string_t currency_name) {
-    bool parsed = false;
-    string_t key;
-    string_init_printf(key, "%04X", currency_code);
-    if(nfc_emv_parser_search_data(
-           storage, "/ext/nfc/assets/currency_code.nfc", key, currency_name)) {
-        parsed = true;
+    furi_assert(parser);
+    uint8_t key[2] = {currency_code >> 8, currency_code & 0xff};
+    return nfc_emv_parser_search_data(
+        parser, NfcEmvParserTableCurrency, key, sizeof(key), currency_name);
+}
+
+uint8_t nfc_emv_parser_get_names(
+    NfcEmvParser* parser,
+    const EmvData* emv_data,
+    string_t aid_name,
+    string_t country_name,
+    string_t currency_name) {
+    furi_assert(parser);
+    furi_assert(emv_data);
+    uint8_t found = 0;
+
+    if(aid_name && emv_data->aid_len &&
+       nfc_emv_parser_get_aid_name(parser, emv_data->aid, emv_data->aid_len, aid_name)) {
+        found |= NfcEmvParserFoundAid;
     }
-    string_clear(key);
-    return parsed;
+    if(country_name && emv_data->country_code &&
+       nfc_emv_parser_get_country_name(parser, emv_data->country_code, country_name)) {
+        found |= NfcEmvParserFoundCountry;
+    }
+    if(currency_name && emv_data->currency_code &&
+       nfc_emv_parser_get_currency_name(parser, emv_data->currency_code, currency_name)) {
+        found |= NfcEmvParserFoundCurrency;
+    }
+
+    return found;
 }
@@ -4,38 +4,74 @@
 #include <stdbool.h>
 #include <m-string.h>
 #include <storage/storage.h>
+#include <lib/nfc_protocols/emv.h>
 
-/** Get EMV application name by number
+typedef struct NfcEmvParser NfcEmvParser;
+
+typedef enum {
+    NfcEmvParserFoundAid = (1 << 0),
+    NfcEmvParserFoundCountry = (1 << 1),
+    NfcEmvParserFoundCurrency = (1 << 2),
+} NfcEmvParserFound;
+
+/** Allocate EMV resources parser. Resource files are loaded into sorted
+ * tables on first lookup and kept until parser is freed.
  * @param storage Storage instance
+ * @return NfcEmvParser instance
+ */
+NfcEmvParser* nfc_emv_parser_alloc(Storage* storage);
+
+/** Free EMV resources parser and cached tables
+ * @param parser NfcEmvParser instance
+ */
+void nfc_emv_parser_free(NfcEmvParser* parser);
+
+/** Get EMV application name by number
+ * @param parser NfcEmvParser instance
  * @param aid - AID number array
  * @param aid_len - AID length
  * @param aid_name - string to keep AID name
  * @return - true if AID found, false otherwies
  */
 bool nfc_emv_parser_get_aid_name(
-    Storage* storage,
-    uint8_t* aid,
+    NfcEmvParser* parser,
+    const uint8_t* aid,
     uint8_t aid_len,
     string_t aid_name);
 
 /** Get country name by country code
- * @param storage Storage instance
+ * @param parser NfcEmvParser instance
  * @param country_code - ISO 3166 country code
  * @param country_name - string to keep country name
  * @return - true if country found, false otherwies
  */
 bool nfc_emv_parser_get_country_name(
-    Storage* storage,
+    NfcEmvParser* parser,
     uint16_t country_code,
     string_t country_name);
 
 /** Get currency name by currency code
- * @param storage Storage instance
+ * @param parser NfcEmvParser instance
  * @param currency_code - ISO 3166 currency code
  * @param currency_name - string to keep currency name
  * @return - true if currency found, false otherwies
  */
 bool nfc_emv_parser_get_currency_name(
-    Storage* storage,
+    NfcEmvParser* parser,
     uint16_t currency_code,
     string_t currency_name);
+
+/** Get names of all card fields at once. Fields with zero code are skipped.
+ * @param parser NfcEmvParser instance
+ * @param emv_data - card data
+ * @param aid_name - string to keep AID name, NULL to skip
+ * @param country_name - string to keep country name, NULL to skip
+ * @param currency_name - string to keep currency name, NULL to skip
+ * @return - NfcEmvParserFound flags of found names
+ */
+uint8_t nfc_emv_parser_get_names(
+    NfcEmvParser* parser,
+    const EmvData* emv_data,
+    string_t aid_name,
+    string_t country_name,
+    string_t currency_name);
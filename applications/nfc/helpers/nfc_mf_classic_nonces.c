@@ -0,0 +1,188 @@
+#include "nfc_mf_classic_nonces.h"
+#include <lib/toolbox/path.h>
+
+#define TAG "NfcMfClassicNonces"
+
+#define NFC_MF_CLASSIC_NONCES_MAGIC "MFCN"
+#define NFC_MF_CLASSIC_NONCES_VERSION 2
+
+/* Records are a ring of up to NFC_MF_CLASSIC_NONCES_FILE_MAX entries.
+ * While file is not full, records are appended in capture order. Once full,
+ * head is the oldest record and the next one to be overwritten. */
+typedef struct {
+    char magic[4];
+    uint8_t version;
+    uint8_t record_size;
+    uint16_t head;
+} __attribute__((__packed__)) NfcMfClassicNoncesHeader;
+
+typedef struct {
+    uint32_t cuid;
+    uint32_t nt;
+    uint32_t nr;
+    uint32_t ar;
+    uint8_t sector;
+    uint8_t key_type;
+} __attribute__((__packed__)) NfcMfClassicNoncesRecord;
+
+static bool nfc_mf_classic_nonces_header_is_valid(const NfcMfClassicNoncesHeader* header) {
+    return (memcmp(header->magic, NFC_MF_CLASSIC_NONCES_MAGIC, sizeof(header->magic)) == 0) &&
+           (header->version == NFC_MF_CLASSIC_NONCES_VERSION) &&
+           (header->record_size == sizeof(NfcMfClassicNoncesRecord)) &&
+           (header->head < NFC_MF_CLASSIC_NONCES_FILE_MAX);
+}
+
+/* Opens capture file and reads its header, file with unknown layout is started over */
+static bool nfc_mf_classic_nonces_open(
+    File* file,
+    const char* path,
+    NfcMfClassicNoncesHeader* header,
+    size_t* records_num) {
+    if(!storage_file_open(file, path, FSAM_READ_WRITE, FSOM_OPEN_ALWAYS)) return false;
+
+    uint64_t size = storage_file_size(file);
+    if((size >= sizeof(NfcMfClassicNoncesHeader)) &&
+       (storage_file_read(file, header, sizeof(NfcMfClassicNoncesHeader)) ==
+        sizeof(NfcMfClassicNoncesHeader)) &&
+       nfc_mf_classic_nonces_header_is_valid(header)) {
+        *records_num = MIN(
+            (size - sizeof(NfcMfClassicNoncesHeader)) / sizeof(NfcMfClassicNoncesRecord),
+            (uint64_t)NFC_MF_CLASSIC_NONCES_FILE_MAX);
+        return true;
+    }
+
+    if(size) FURI_LOG_W(TAG, "Unsupported capture file, starting over");
+    memcpy(header->magic, NFC_MF_CLASSIC_NONCES_MAGIC, sizeof(header->magic));
+    header->version = NFC_MF_CLASSIC_NONCES_VERSION;
+    header->record_size = sizeof(NfcMfClassicNoncesRecord);
+    header->head = 0;
+    *records_num = 0;
+    return storage_file_seek(file, 0, true) && storage_file_truncate(file) &&
+           (storage_file_write(file, header, sizeof(NfcMfClassicNoncesHeader)) ==
+            sizeof(NfcMfClassicNoncesHeader));
+}
+
+static bool nfc_mf_classic_nonces_seek(File* file, size_t index) {
+    return storage_file_seek(
+        file,
+        sizeof(NfcMfClassicNoncesHeader) + index * sizeof(NfcMfClassicNoncesRecord),
+        true);
+}
+
+bool nfc_mf_classic_nonces_save(
+    Storage* storage,
+    const char* path,
+    const MfClassicNonce* nonces,
+    size_t count) {
+    furi_assert(storage);
+    furi_assert(path);
+    furi_assert(nonces);
+
+    bool success = false;
+    string_t folder;
+    string_init(folder);
+    path_extract_dirname(path, folder);
+    storage_simply_mkdir(storage, string_get_cstr(folder));
+    string_clear(folder);
+    File* file = storage_file_alloc(storage);
+
+    do {
+        NfcMfClassicNoncesHeader header;
+        size_t records_num = 0;
+        if(!nfc_mf_classic_nonces_open(file, path, &header, &records_num)) break;
+
+        size_t i = 0;
+        for(; i < count; i++) {
+            NfcMfClassicNoncesRecord record = {
+                .cuid = nonces[i].cuid,
+                .nt = nonces[i].nt,
+                .nr = nonces[i].nr,
+                .ar = nonces[i].ar,
+                .sector = nonces[i].sector,
+                .key_type = nonces[i].key_type,
+            };
+            size_t index = records_num;
+            if(records_num == NFC_MF_CLASSIC_NONCES_FILE_MAX) {
+                // Full, replace the oldest one
+                index = header.head;
+                header.head = (header.head + 1) % NFC_MF_CLASSIC_NONCES_FILE_MAX;
+            } else {
+                records_num++;
+            }
+            if(!nfc_mf_classic_nonces_seek(file, index)) break;
+            if(storage_file_write(file, &record, sizeof(record)) != sizeof(record)) break;
+        }
+        if(i != count) break;
+
+        success = storage_file_seek(file, 0, true) &&
+                  (storage_file_write(file, &header, sizeof(header)) == sizeof(header));
+    } while(false);
+
+    if(!success) {
+        FURI_LOG_E(TAG, "Failed to save %d captures", count);
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+
+    return success;
+}
+
+size_t nfc_mf_classic_nonces_load(
+    Storage* storage,
+    const char* path,
+    uint32_t cuid,
+    MfClassicNonce* nonces) {
+    furi_assert(storage);
+    furi_assert(path);
+    furi_assert(nonces);
+
+    size_t found = 0;
+    File* file = storage_file_alloc(storage);
+
+    do {
+        if(!storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) break;
+        NfcMfClassicNoncesHeader header = {};
+        if(storage_file_read(file, &header, sizeof(header)) != sizeof(header)) break;
+        if(!nfc_mf_classic_nonces_header_is_valid(&header)) {
+            FURI_LOG_W(TAG, "Unsupported capture file");
+            break;
+        }
+        size_t records_num = MIN(
+            (storage_file_size(file) - sizeof(header)) / sizeof(NfcMfClassicNoncesRecord),
+            (uint64_t)NFC_MF_CLASSIC_NONCES_FILE_MAX);
+
+        // Oldest to newest: from head to end, then from start to head
+        NfcMfClassicNoncesRecord records[8];
+        const size_t ranges[2][2] = {{header.head, records_num}, {0, header.head}};
+        for(size_t range = 0; range < COUNT_OF(ranges); range++) {
+            size_t index = ranges[range][0];
+            const size_t end = MIN(ranges[range][1], records_num);
+            if((index < end) && !nfc_mf_classic_nonces_seek(file, index)) break;
+            while(index < end) {
+                size_t records_read =
+                    storage_file_read(
+                        file, records, MIN(COUNT_OF(records), end - index) * sizeof(records[0])) /
+                    sizeof(records[0]);
+                if(records_read == 0) break;
+                for(size_t i = 0; i < records_read; i++) {
+                    if(records[i].cuid != cuid) continue;
+                    // Newer captures replace older ones once buffer is full
+                    MfClassicNonce* nonce = &nonces[found % NFC_MF_CLASSIC_NONCES_MAX];
+                    nonce->cuid = records[i].cuid;
+                    nonce->nt = records[i].nt;
+                    nonce->nr = records[i].nr;
+                    nonce->ar = records[i].ar;
+                    nonce->sector = records[i].sector;
+                    nonce->key_type = records[i].key_type;
+                    found++;
+                }
+                index += records_read;
+            }
+        }
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+
+    return MIN(found, (size_t)NFC_MF_CLASSIC_NONCES_MAX);
+}
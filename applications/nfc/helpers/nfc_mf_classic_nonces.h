@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdbool.h>
+#include <storage/storage.h>
+#include <lib/nfc_protocols/mifare_classic.h>
+
+#define NFC_MF_CLASSIC_NONCES_PATH "/ext/nfc/.mf_classic_nonces.bin"
+
+/** Maximum number of captures kept per emulation session or loaded per card */
+#define NFC_MF_CLASSIC_NONCES_MAX (64)
+
+/** Maximum number of captures kept in capture file, oldest are overwritten */
+#define NFC_MF_CLASSIC_NONCES_FILE_MAX (512)
+
+/** Add captured reader authentications to capture file
+ *
+ * @param storage   Storage instance
+ * @param path      capture file path, NFC_MF_CLASSIC_NONCES_PATH
+ * @param nonces    captured authentications
+ * @param count     number of captures
+ *
+ * @return true on success
+ */
+bool nfc_mf_classic_nonces_save(
+    Storage* storage,
+    const char* path,
+    const MfClassicNonce* nonces,
+    size_t count);
+
+/** Load newest captured reader authentications for card
+ *
+ * @param storage   Storage instance
+ * @param path      capture file path, NFC_MF_CLASSIC_NONCES_PATH
+ * @param cuid      card UID
+ * @param nonces    buffer for NFC_MF_CLASSIC_NONCES_MAX captures
+ *
+ * @return number of captures loaded
+ */
+size_t nfc_mf_classic_nonces_load(
+    Storage* storage,
+    const char* path,
+    uint32_t cuid,
+    MfClassicNonce* nonces);
@@ -85,6 +85,13 @@ static bool nfc_rpc_command_callback(RpcAppSystemEvent event, const char* arg, v
                 result = true;
             }
         }
+    } else if(event == RpcAppEventButtonPress) {
+        // Frame trace control, see nfc_debug_pcap
+        if(arg && !strcmp(arg, NFC_RPC_TRACE_START)) {
+            result = nfc_worker_set_trace(nfc->worker, true);
+        } else if(arg && !strcmp(arg, NFC_RPC_TRACE_STOP)) {
+            result = nfc_worker_set_trace(nfc->worker, false);
+        }
     }
 
     return result;
@@ -105,6 +112,9 @@ Nfc* nfc_alloc() {
     // Nfc device
     nfc->dev = nfc_device_alloc();
 
+    // EMV resources, loaded on first lookup
+    nfc->emv_parser = nfc_emv_parser_alloc(nfc->dev->storage);
+
     // Open GUI record
     nfc->gui = furi_record_open("gui");
     view_dispatcher_attach_to_gui(nfc->view_dispatcher, nfc->gui, ViewDispatcherTypeFullscreen);
@@ -168,6 +178,9 @@ Nfc* nfc_alloc() {
 void nfc_free(Nfc* nfc) {
     furi_assert(nfc);
 
+    // EMV resources
+    nfc_emv_parser_free(nfc->emv_parser);
+
     // Nfc device
     nfc_device_free(nfc->dev);
 
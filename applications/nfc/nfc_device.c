@@ -4,6 +4,7 @@
 #include "nfc_types.h"
 
 #include <toolbox/path.h>
+#include <toolbox/version.h>
 #include <flipper_format/flipper_format.h>
 
 static const char* nfc_file_header = "Flipper NFC device";
@@ -12,6 +13,24 @@ static const uint32_t nfc_file_version = 2;
 // Protocols format versions
 static const uint32_t nfc_mifare_classic_data_format_version = 1;
 
+// Binary cache of parsed device data, rebuilt when source file changes
+#define NFC_DEVICE_CACHE_MAGIC "NFCB"
+#define NFC_DEVICE_CACHE_VERSION 2
+#define NFC_DEVICE_CACHE_HASH_BUFFER_SIZE 512
+#define NFC_DEVICE_CACHE_HASH_INIT 2166136261UL
+
+typedef struct {
+    char magic[4];
+    uint8_t version;
+    uint8_t format;
+    uint8_t protocol;
+    uint8_t reserved;
+    uint32_t layout_hash; /* Stored structs sizes and firmware build */
+    uint32_t source_size;
+    uint32_t source_hash;
+    uint32_t data_size;
+} __attribute__((__packed__)) NfcDeviceCacheHeader;
+
 NfcDevice* nfc_device_alloc() {
     NfcDevice* nfc_dev = malloc(sizeof(NfcDevice));
     nfc_dev->storage = furi_record_open("storage");
@@ -315,10 +334,8 @@ static bool nfc_device_save_mifare_df_app(FlipperFormat* file, MifareDesfireAppl
             if(!flipper_format_write_hex(
                    file, string_get_cstr(key), (uint8_t*)&f->access_rights, 2))
                 break;
-            uint16_t size = 0;
             if(f->type == MifareDesfireFileTypeStandard ||
                f->type == MifareDesfireFileTypeBackup) {
-                size = f->settings.data.size;
                 string_printf(key, "%s File %d Size", string_get_cstr(prefix), f->id);
                 if(!flipper_format_write_uint32(
                        file, string_get_cstr(key), &f->settings.data.size, 1))
@@ -342,7 +359,6 @@ static bool nfc_device_save_mifare_df_app(FlipperFormat* file, MifareDesfireAppl
                 if(!flipper_format_write_bool(
                        file, string_get_cstr(key), &f->settings.value.limited_credit_enabled, 1))
                     break;
-                size = 4;
             } else if(
                 f->type == MifareDesfireFileTypeLinearRecord ||
                 f->type == MifareDesfireFileTypeCyclicRecord) {
@@ -358,11 +374,12 @@ static bool nfc_device_save_mifare_df_app(FlipperFormat* file, MifareDesfireAppl
                 if(!flipper_format_write_uint32(
                        file, string_get_cstr(key), &f->settings.record.cur, 1))
                     break;
-                size = f->settings.record.size * f->settings.record.cur;
             }
             if(f->contents) {
                 string_printf(key, "%s File %d", string_get_cstr(prefix), f->id);
-                if(!flipper_format_write_hex(file, string_get_cstr(key), f->contents, size)) break;
+                if(!flipper_format_write_hex(
+                       file, string_get_cstr(key), f->contents, f->contents_size))
+                    break;
             }
             saved_files = true;
         }
@@ -461,6 +478,7 @@ bool nfc_device_load_mifare_df_app(FlipperFormat* file, MifareDesfireApplication
                 uint32_t size;
                 if(!flipper_format_get_value_count(file, string_get_cstr(key), &size)) break;
                 f->contents = malloc(size);
+                f->contents_size = size;
                 if(!flipper_format_read_hex(file, string_get_cstr(key), f->contents, size)) break;
             }
             *file_head = f;
@@ -763,6 +781,176 @@ static void nfc_device_get_shadow_path(string_t orig_path, string_t shadow_path)
     string_cat_printf(shadow_path, "%s", NFC_APP_SHADOW_EXTENSION);
 }
 
+static void nfc_device_get_cache_path(string_t orig_path, string_t cache_path) {
+    nfc_device_get_path_without_ext(orig_path, cache_path);
+    string_cat_printf(cache_path, "%s", NFC_APP_CACHE_EXTENSION);
+}
+
+static uint32_t nfc_device_hash_update(uint32_t hash, const void* data, size_t size) {
+    const uint8_t* bytes = data;
+    for(size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 16777619UL;
+    }
+    return hash;
+}
+
+/* FNV-1a over whole file */
+static bool
+    nfc_device_get_file_hash(Storage* storage, const char* path, uint32_t* size, uint32_t* hash) {
+    bool hashed = false;
+    File* file = storage_file_alloc(storage);
+    uint8_t* buffer = malloc(NFC_DEVICE_CACHE_HASH_BUFFER_SIZE);
+    *size = 0;
+    *hash = NFC_DEVICE_CACHE_HASH_INIT;
+
+    if(storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        uint16_t read = 0;
+        do {
+            read = storage_file_read(file, buffer, NFC_DEVICE_CACHE_HASH_BUFFER_SIZE);
+            *hash = nfc_device_hash_update(*hash, buffer, read);
+            *size += read;
+        } while(read == NFC_DEVICE_CACHE_HASH_BUFFER_SIZE);
+        hashed = (storage_file_get_error(file) == FSE_OK);
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+    free(buffer);
+    return hashed;
+}
+
+/* Size of fixed layout protocol data, DESFire is packed separately */
+static size_t nfc_device_get_cache_data_size(NfcDeviceSaveFormat format) {
+    size_t size = 0;
+    if(format == NfcDeviceSaveFormatBankCard) {
+        size = sizeof(EmvData);
+    } else if(format == NfcDeviceSaveFormatMifareUl) {
+        size = sizeof(MfUltralightData);
+    } else if(format == NfcDeviceSaveFormatMifareClassic) {
+        size = sizeof(MfClassicData);
+    }
+    return size;
+}
+
+/* Cache holds raw structs, so it is only valid for the firmware build that wrote it.
+ * Sizes catch layout changes in builds from uncommitted sources with the same git hash.
+ */
+static uint32_t nfc_device_get_cache_layout_hash() {
+    const uint32_t sizes[] = {
+        sizeof(FuriHalNfcDevData),
+        sizeof(EmvData),
+        sizeof(MfUltralightData),
+        sizeof(MfClassicData),
+        sizeof(MifareDesfireData),
+        sizeof(MifareDesfireFreeMemory),
+        sizeof(MifareDesfireKeySettings),
+        sizeof(MifareDesfireKeyVersion),
+        sizeof(MifareDesfireApplication),
+        sizeof(MifareDesfireFile),
+    };
+    const char* githash = version_get_githash(NULL);
+
+    uint32_t hash = nfc_device_hash_update(NFC_DEVICE_CACHE_HASH_INIT, sizes, sizeof(sizes));
+    return nfc_device_hash_update(hash, githash, strlen(githash));
+}
+
+static void nfc_device_save_cache(
+    NfcDevice* dev,
+    const char* cache_path,
+    uint32_t source_size,
+    uint32_t source_hash) {
+    File* file = storage_file_alloc(dev->storage);
+    uint8_t* df_arena = NULL;
+    bool saved = false;
+
+    do {
+        const void* data = &dev->dev_data.emv_data;
+        size_t data_size = nfc_device_get_cache_data_size(dev->format);
+        if(dev->format == NfcDeviceSaveFormatMifareDesfire) {
+            data_size = mf_df_pack(&dev->dev_data.mf_df_data, NULL);
+            df_arena = malloc(data_size);
+            mf_df_pack(&dev->dev_data.mf_df_data, df_arena);
+            data = df_arena;
+        }
+
+        NfcDeviceCacheHeader header = {
+            .version = NFC_DEVICE_CACHE_VERSION,
+            .format = dev->format,
+            .protocol = dev->dev_data.protocol,
+            .layout_hash = nfc_device_get_cache_layout_hash(),
+            .source_size = source_size,
+            .source_hash = source_hash,
+            .data_size = sizeof(FuriHalNfcDevData) + data_size,
+        };
+        memcpy(header.magic, NFC_DEVICE_CACHE_MAGIC, sizeof(header.magic));
+
+        if(!storage_file_open(file, cache_path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) break;
+        if(storage_file_write(file, &header, sizeof(header)) != sizeof(header)) break;
+        if(storage_file_write(file, &dev->dev_data.nfc_data, sizeof(FuriHalNfcDevData)) !=
+           sizeof(FuriHalNfcDevData))
+            break;
+        if(storage_file_write(file, data, data_size) != data_size) break;
+        saved = true;
+    } while(false);
+
+    storage_file_close(file);
+    if(!saved) {
+        storage_common_remove(dev->storage, cache_path);
+    }
+    storage_file_free(file);
+    free(df_arena);
+}
+
+static bool nfc_device_load_cache(
+    NfcDevice* dev,
+    const char* cache_path,
+    uint32_t source_size,
+    uint32_t source_hash) {
+    File* file = storage_file_alloc(dev->storage);
+    bool loaded = false;
+
+    do {
+        if(!storage_file_open(file, cache_path, FSAM_READ, FSOM_OPEN_EXISTING)) break;
+        NfcDeviceCacheHeader header = {};
+        if(storage_file_read(file, &header, sizeof(header)) != sizeof(header)) break;
+        if(memcmp(header.magic, NFC_DEVICE_CACHE_MAGIC, sizeof(header.magic)) ||
+           (header.version != NFC_DEVICE_CACHE_VERSION) ||
+           (header.layout_hash != nfc_device_get_cache_layout_hash()) ||
+           (header.source_size != source_size) || (header.source_hash != source_hash) ||
+           (header.format > NfcDeviceSaveFormatMifareDesfire) ||
+           (header.data_size < sizeof(FuriHalNfcDevData)))
+            break;
+        // Corrupted header must not make us allocate more than the file holds
+        if(header.data_size != storage_file_size(file) - sizeof(header)) break;
+        size_t data_size = header.data_size - sizeof(FuriHalNfcDevData);
+        if((header.format != NfcDeviceSaveFormatMifareDesfire) &&
+           (data_size != nfc_device_get_cache_data_size(header.format)))
+            break;
+
+        if(storage_file_read(file, &dev->dev_data.nfc_data, sizeof(FuriHalNfcDevData)) !=
+           sizeof(FuriHalNfcDevData))
+            break;
+        if(header.format == NfcDeviceSaveFormatMifareDesfire) {
+            // Whole DESFire tree lands in one allocation
+            uint8_t* arena = malloc(data_size);
+            if((storage_file_read(file, arena, data_size) != data_size) ||
+               !mf_df_unpack(&dev->dev_data.mf_df_data, arena, data_size)) {
+                free(arena);
+                break;
+            }
+        } else {
+            if(storage_file_read(file, &dev->dev_data.emv_data, data_size) != data_size) break;
+        }
+        dev->format = header.format;
+        dev->dev_data.protocol = header.protocol;
+        loaded = true;
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    return loaded;
+}
+
 static bool nfc_device_save_file(
     NfcDevice* dev,
     const char* dev_name,
@@ -843,8 +1031,15 @@ static bool nfc_device_load_data(NfcDevice* dev, string_t path, bool show_dialog
     FuriHalNfcDevData* data = &dev->dev_data.nfc_data;
     uint32_t data_cnt = 0;
     string_t temp_str;
+    string_t source_path;
+    string_t cache_path;
     string_init(temp_str);
+    string_init(source_path);
+    string_init(cache_path);
     bool deprecated_version = false;
+    bool source_hashed = false;
+    uint32_t source_size = 0;
+    uint32_t source_hash = 0;
 
     if(dev->loading_cb) {
         dev->loading_cb(dev->loading_cb_ctx, true);
@@ -855,12 +1050,18 @@ static bool nfc_device_load_data(NfcDevice* dev, string_t path, bool show_dialog
         nfc_device_get_shadow_path(path, temp_str);
         dev->shadow_file_exist =
             storage_common_stat(dev->storage, string_get_cstr(temp_str), NULL) == FSE_OK;
-        // Open shadow file if it exists. If not - open original
-        if(dev->shadow_file_exist) {
-            if(!flipper_format_file_open_existing(file, string_get_cstr(temp_str))) break;
-        } else {
-            if(!flipper_format_file_open_existing(file, string_get_cstr(path))) break;
+        // Use shadow file if it exists. If not - original
+        string_set(source_path, dev->shadow_file_exist ? temp_str : path);
+        // Binary cache is valid as long as source file content is the same
+        nfc_device_get_cache_path(path, cache_path);
+        source_hashed = nfc_device_get_file_hash(
+            dev->storage, string_get_cstr(source_path), &source_size, &source_hash);
+        if(source_hashed &&
+           nfc_device_load_cache(dev, string_get_cstr(cache_path), source_size, source_hash)) {
+            parsed = true;
+            break;
         }
+        if(!flipper_format_file_open_existing(file, string_get_cstr(source_path))) break;
         // Read and verify file header
         uint32_t version = 0;
         if(!flipper_format_read_header(file, temp_str, &version)) break;
@@ -889,6 +1090,9 @@ static bool nfc_device_load_data(NfcDevice* dev, string_t path, bool show_dialog
             if(!nfc_device_load_bank_card_data(file, dev)) break;
         }
         parsed = true;
+        if(source_hashed) {
+            nfc_device_save_cache(dev, string_get_cstr(cache_path), source_size, source_hash);
+        }
     } while(false);
 
     if(dev->loading_cb) {
@@ -903,6 +1107,8 @@ static bool nfc_device_load_data(NfcDevice* dev, string_t path, bool show_dialog
         }
     }
 
+    string_clear(cache_path);
+    string_clear(source_path);
     string_clear(temp_str);
     flipper_format_free(file);
     return parsed;
@@ -991,6 +1197,14 @@ bool nfc_device_delete(NfcDevice* dev, bool use_load_path) {
             }
             if(!storage_simply_remove(dev->storage, string_get_cstr(file_path))) break;
         }
+        // Delete binary cache
+        if(use_load_path && !string_empty_p(dev->load_path)) {
+            nfc_device_get_cache_path(dev->load_path, file_path);
+        } else {
+            string_printf(
+                file_path, "%s/%s%s", NFC_APP_FOLDER, dev->dev_name, NFC_APP_CACHE_EXTENSION);
+        }
+        if(!storage_simply_remove(dev->storage, string_get_cstr(file_path))) break;
         deleted = true;
     } while(0);
 
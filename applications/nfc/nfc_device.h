@@ -17,6 +17,7 @@
 #define NFC_APP_FOLDER "/any/nfc"
 #define NFC_APP_EXTENSION ".nfc"
 #define NFC_APP_SHADOW_EXTENSION ".shd"
+#define NFC_APP_CACHE_EXTENSION ".nfb"
 
 typedef void (*NfcLoadingCallback)(void* context, bool state);
 
@@ -29,6 +29,7 @@
 
 #include <nfc/scenes/nfc_scene.h>
 #include <nfc/helpers/nfc_custom_event.h>
+#include <nfc/helpers/nfc_emv_parser.h>
 
 #include "rpc/rpc_app.h"
 
@@ -36,6 +37,10 @@
 #define NFC_SEND_NOTIFICATION_TRUE (1UL)
 #define NFC_TEXT_STORE_SIZE 128
 
+/* RPC app button press arguments */
+#define NFC_RPC_TRACE_START "trace_start"
+#define NFC_RPC_TRACE_STOP "trace_stop"
+
 typedef enum {
     NfcRpcStateIdle,
     NfcRpcStateEmulating,
@@ -52,6 +57,7 @@ struct Nfc {
     NotificationApp* notifications;
     SceneManager* scene_manager;
     NfcDevice* dev;
+    NfcEmvParser* emv_parser;
     FuriHalNfcDevData dev_edit_data;
 
     char text_store[NFC_TEXT_STORE_SIZE + 1];
@@ -79,6 +79,22 @@ void nfc_worker_stop(NfcWorker* nfc_worker) {
     furi_thread_join(nfc_worker->thread);
 }
 
+bool nfc_worker_set_trace(NfcWorker* nfc_worker, bool enable) {
+    furi_assert(nfc_worker);
+    if(!nfc_worker->debug_pcap_worker) {
+        if(!enable) return true;
+        if(nfc_worker->state != NfcWorkerStateReady) return false;
+        nfc_worker->debug_pcap_worker = nfc_debug_pcap_alloc(nfc_worker->storage);
+    }
+    nfc_debug_pcap_set_enabled(nfc_worker->debug_pcap_worker, enable);
+    FURI_LOG_I(
+        TAG,
+        "Trace %s, %d frames dropped",
+        enable ? "enabled" : "disabled",
+        nfc_debug_pcap_get_dropped(nfc_worker->debug_pcap_worker));
+    return true;
+}
+
 void nfc_worker_change_state(NfcWorker* nfc_worker, NfcWorkerState state) {
     nfc_worker->state = state;
 }
@@ -341,6 +357,88 @@ void nfc_worker_emulate_mifare_ul(NfcWorker* nfc_worker) {
     }
 }
 
+typedef struct {
+    MfClassicNonce* nonces;
+    size_t count;
+} NfcWorkerMfClassicNonces;
+
+/* Run dictionary against captured reader authentications at CPU speed,
+ * keys confirmed offline are stored in per-sector auth contexts */
+static void nfc_worker_mf_classic_check_nonces(
+    NfcWorker* nfc_worker,
+    uint32_t cuid,
+    MfClassicAuthContext* offline_ctx) {
+    NfcWorkerMfClassicNonces captured = {
+        .nonces = malloc(sizeof(MfClassicNonce) * NFC_MF_CLASSIC_NONCES_MAX),
+    };
+    for(size_t i = 0; i < MF_CLASSIC_SECTORS_MAX; i++) {
+        mf_classic_auth_init_context(&offline_ctx[i], cuid, i);
+    }
+
+    captured.count = nfc_mf_classic_nonces_load(
+        nfc_worker->storage, NFC_MF_CLASSIC_NONCES_PATH, cuid, captured.nonces);
+    if(captured.count) {
+        uint32_t start = DWT->CYCCNT;
+        uint32_t keys_checked = 0;
+        uint32_t keys_confirmed = 0;
+        uint64_t keys[CRYPTO1_BATCH_SIZE];
+        size_t keys_count = 0;
+        // Stop once every captured sector and key type is resolved
+        bool unresolved = false;
+        do {
+            keys_count = 0;
+            unresolved = false;
+            while((keys_count < CRYPTO1_BATCH_SIZE) &&
+                  nfc_mf_classic_dict_get_next_key(nfc_worker->dict_stream, &keys[keys_count])) {
+                keys_count++;
+            }
+            keys_checked += keys_count;
+
+            for(size_t i = 0; (i < captured.count) && keys_count; i++) {
+                const MfClassicNonce* nonce = &captured.nonces[i];
+                if(nonce->sector >= MF_CLASSIC_SECTORS_MAX) continue;
+                uint64_t* key = (nonce->key_type == MfClassicKeyA) ?
+                                    &offline_ctx[nonce->sector].key_a :
+                                    &offline_ctx[nonce->sector].key_b;
+                if(*key != MF_CLASSIC_NO_KEY) continue;
+                uint32_t found = crypto1_batch_check_reader_auth(
+                    keys, keys_count, nonce->cuid, nonce->nt, nonce->nr, nonce->ar);
+                if(found) {
+                    *key = keys[__builtin_ctz(found)];
+                    keys_confirmed++;
+                } else {
+                    unresolved = true;
+                }
+            }
+        } while(unresolved && (keys_count == CRYPTO1_BATCH_SIZE) &&
+                (nfc_worker->state == NfcWorkerStateReadMifareClassic));
+        nfc_mf_classic_dict_reset(nfc_worker->dict_stream);
+
+        FURI_LOG_I(
+            TAG,
+            "Checked %d keys against %d captures in %d ms, %d keys confirmed",
+            keys_checked,
+            captured.count,
+            (DWT->CYCCNT - start) / furi_hal_cortex_instructions_per_microsecond() / 1000,
+            keys_confirmed);
+    }
+
+    free(captured.nonces);
+}
+
+/* Keys confirmed offline go first, then dictionary */
+static bool nfc_worker_mf_classic_get_next_key(
+    NfcWorker* nfc_worker,
+    MfClassicAuthContext* offline_ctx,
+    size_t* offline_index,
+    uint64_t* key) {
+    while(*offline_index < 2) {
+        *key = (*offline_index)++ ? offline_ctx->key_b : offline_ctx->key_a;
+        if(*key != MF_CLASSIC_NO_KEY) return true;
+    }
+    return nfc_mf_classic_dict_get_next_key(nfc_worker->dict_stream, key);
+}
+
 void nfc_worker_mifare_classic_dict_attack(NfcWorker* nfc_worker) {
     furi_assert(nfc_worker->callback);
     FuriHalNfcTxRxContext tx_rx_ctx = {};
@@ -388,6 +486,12 @@ void nfc_worker_mifare_classic_dict_attack(NfcWorker* nfc_worker) {
         }
     }
 
+    MfClassicAuthContext* offline_ctx =
+        malloc(sizeof(MfClassicAuthContext) * MF_CLASSIC_SECTORS_MAX);
+    if(nfc_worker->state == NfcWorkerStateReadMifareClassic) {
+        nfc_worker_mf_classic_check_nonces(nfc_worker, reader.cuid, offline_ctx);
+    }
+
     if(nfc_worker->state == NfcWorkerStateReadMifareClassic) {
         bool card_removed_notified = false;
         bool card_found_notified = false;
@@ -398,7 +502,9 @@ void nfc_worker_mifare_classic_dict_attack(NfcWorker* nfc_worker) {
             nfc_worker->callback(event, nfc_worker->context);
             mf_classic_auth_init_context(&auth_ctx, reader.cuid, curr_sector);
             bool sector_key_found = false;
-            while(nfc_mf_classic_dict_get_next_key(nfc_worker->dict_stream, &curr_key)) {
+            size_t offline_index = 0;
+            while(nfc_worker_mf_classic_get_next_key(
+                nfc_worker, &offline_ctx[curr_sector], &offline_index, &curr_key)) {
                 furi_hal_nfc_sleep();
                 if(furi_hal_nfc_activate_nfca(300, &reader.cuid)) {
                     if(!card_found_notified) {
@@ -481,19 +587,33 @@ void nfc_worker_mifare_classic_dict_attack(NfcWorker* nfc_worker) {
         nfc_worker->callback(event, nfc_worker->context);
     }
 
+    free(offline_ctx);
     nfc_mf_classic_dict_close_file(nfc_worker->dict_stream);
     stream_free(nfc_worker->dict_stream);
 }
 
+static void nfc_worker_mf_classic_nonce_callback(const MfClassicNonce* nonce, void* context) {
+    NfcWorkerMfClassicNonces* captured = context;
+    if(captured->count < NFC_MF_CLASSIC_NONCES_MAX) {
+        captured->nonces[captured->count++] = *nonce;
+    }
+}
+
 void nfc_worker_emulate_mifare_classic(NfcWorker* nfc_worker) {
     FuriHalNfcTxRxContext tx_rx = {};
     nfc_debug_pcap_prepare_tx_rx(nfc_worker->debug_pcap_worker, &tx_rx, true);
     FuriHalNfcDevData* nfc_data = &nfc_worker->dev_data->nfc_data;
+    NfcWorkerMfClassicNonces captured = {
+        .nonces = malloc(sizeof(MfClassicNonce) * NFC_MF_CLASSIC_NONCES_MAX),
+    };
     MfClassicEmulator emulator = {
         .cuid = nfc_util_bytes2num(&nfc_data->uid[nfc_data->uid_len - 4], 4),
         .data = nfc_worker->dev_data->mf_classic_data,
         .data_changed = false,
+        .nonce_callback = nfc_worker_mf_classic_nonce_callback,
+        .nonce_context = &captured,
     };
+    mf_classic_emulator_init(&emulator);
     NfcaSignal* nfca_signal = nfca_signal_alloc();
     tx_rx.nfca_signal = nfca_signal;
 
@@ -516,6 +636,22 @@ void nfc_worker_emulate_mifare_classic(NfcWorker* nfc_worker) {
     nfca_signal_free(nfca_signal);
 
     rfal_platform_spi_release();
+
+    if(nfc_worker->debug_pcap_worker && nfc_debug_pcap_is_enabled(nfc_worker->debug_pcap_worker)) {
+        FURI_LOG_I(
+            TAG,
+            "Worst response time %d us",
+            emulator.response_cycles_max / furi_hal_cortex_instructions_per_microsecond());
+    }
+    mf_classic_emulator_deinit(&emulator);
+
+    // Keep reader authentications for offline dictionary check
+    if(captured.count) {
+        FURI_LOG_I(TAG, "Captured %d reader authentications", captured.count);
+        nfc_mf_classic_nonces_save(
+            nfc_worker->storage, NFC_MF_CLASSIC_NONCES_PATH, captured.nonces, captured.count);
+    }
+    free(captured.nonces);
 }
 
 void nfc_worker_read_mifare_desfire(NfcWorker* nfc_worker) {
@@ -59,3 +59,13 @@ void nfc_worker_start(
     void* context);
 
 void nfc_worker_stop(NfcWorker* nfc_worker);
+
+/** Enable or disable pcap trace of NFC frames. Trace is enabled by default in
+ * debug mode, otherwise it can only be turned on while worker is idle.
+ *
+ * @param nfc_worker NfcWorker instance
+ * @param enable true to capture frames
+ *
+ * @return true on success
+ */
+bool nfc_worker_set_trace(NfcWorker* nfc_worker, bool enable);
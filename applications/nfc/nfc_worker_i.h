@@ -15,6 +15,7 @@
 #include <lib/nfc_protocols/nfca.h>
 
 #include "helpers/nfc_mf_classic_dict.h"
+#include "helpers/nfc_mf_classic_nonces.h"
 #include "helpers/nfc_debug_pcap.h"
 
 struct NfcWorker {
@@ -138,27 +138,23 @@ void nfc_scene_device_info_on_enter(void* context) {
             bank_card_set_exp_date(bank_card, emv_data->exp_mon, emv_data->exp_year);
         }
         string_t display_str;
+        string_t country_name;
+        string_t currency_name;
         string_init(display_str);
-        if(emv_data->country_code) {
-            string_t country_name;
-            string_init(country_name);
-            if(nfc_emv_parser_get_country_name(
-                   nfc->dev->storage, emv_data->country_code, country_name)) {
-                string_printf(display_str, "Reg:%s", string_get_cstr(country_name));
-                bank_card_set_country_name(bank_card, string_get_cstr(display_str));
-            }
-            string_clear(country_name);
+        string_init(country_name);
+        string_init(currency_name);
+        uint8_t found = nfc_emv_parser_get_names(
+            nfc->emv_parser, emv_data, NULL, country_name, currency_name);
+        if(found & NfcEmvParserFoundCountry) {
+            string_printf(display_str, "Reg:%s", string_get_cstr(country_name));
+            bank_card_set_country_name(bank_card, string_get_cstr(display_str));
         }
-        if(emv_data->currency_code) {
-            string_t currency_name;
-            string_init(currency_name);
-            if(nfc_emv_parser_get_currency_name(
-                   nfc->dev->storage, emv_data->country_code, currency_name)) {
-                string_printf(display_str, "Cur:%s", string_get_cstr(currency_name));
-                bank_card_set_currency_name(bank_card, string_get_cstr(display_str));
-            }
-            string_clear(currency_name);
+        if(found & NfcEmvParserFoundCurrency) {
+            string_printf(display_str, "Cur:%s", string_get_cstr(currency_name));
+            bank_card_set_currency_name(bank_card, string_get_cstr(display_str));
         }
+        string_clear(currency_name);
+        string_clear(country_name);
         string_clear(display_str);
     }
     scene_manager_set_scene_state(nfc->scene_manager, NfcSceneDeviceInfo, NfcSceneDeviceInfoUid);
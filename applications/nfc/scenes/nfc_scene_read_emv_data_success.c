@@ -47,26 +47,24 @@ void nfc_scene_read_emv_data_success_on_enter(void* context) {
     widget_add_string_element(
         nfc->widget, 64, 13, AlignCenter, AlignTop, FontSecondary, string_get_cstr(pan_str));
     string_clear(pan_str);
-    // Parse country code
+    // Parse country and currency codes
     string_t country_name;
+    string_t currency_name;
     string_init(country_name);
-    if((emv_data->country_code) &&
-       nfc_emv_parser_get_country_name(nfc->dev->storage, emv_data->country_code, country_name)) {
+    string_init(currency_name);
+    uint8_t found =
+        nfc_emv_parser_get_names(nfc->emv_parser, emv_data, NULL, country_name, currency_name);
+    if(found & NfcEmvParserFoundCountry) {
         string_t disp_country;
-        string_init_printf(disp_country, "Reg:%s", country_name);
+        string_init_printf(disp_country, "Reg:%s", string_get_cstr(country_name));
         widget_add_string_element(
             nfc->widget, 7, 23, AlignLeft, AlignTop, FontSecondary, string_get_cstr(disp_country));
         string_clear(disp_country);
     }
     string_clear(country_name);
-    // Parse currency code
-    string_t currency_name;
-    string_init(currency_name);
-    if((emv_data->currency_code) &&
-       nfc_emv_parser_get_currency_name(
-           nfc->dev->storage, emv_data->currency_code, currency_name)) {
+    if(found & NfcEmvParserFoundCurrency) {
         string_t disp_currency;
-        string_init_printf(disp_currency, "Cur:%s", currency_name);
+        string_init_printf(disp_currency, "Cur:%s", string_get_cstr(currency_name));
         widget_add_string_element(
             nfc->widget,
             121,
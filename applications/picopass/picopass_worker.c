@@ -10,6 +10,8 @@
 #include <mbedtls/des.h>
 #include <loclass/optimized_ikeys.h>
 #include <loclass/optimized_cipher.h>
+#include <loclass/optimized_elite.h>
+#include <lib/toolbox/args.h>
 
 #include <platform.h>
 
@@ -70,6 +72,85 @@ static ReturnCode picopass_worker_parse_wiegand(uint8_t* data, PicopassWiegandRe
     return ERR_NONE;
 }
 
+// Loaded once per worker, so file is not opened again on every detect
+static void picopass_worker_dict_load(PicopassWorker* picopass_worker) {
+    if(picopass_worker->dict_keys) return;
+
+    picopass_worker->dict_keys = malloc(PICOPASS_DICT_KEYS_MAX * PICOPASS_BLOCK_LEN);
+    memcpy(picopass_worker->dict_keys, picopass_iclass_key, PICOPASS_BLOCK_LEN);
+    size_t key_count = 1;
+
+    Stream* stream = file_stream_alloc(picopass_worker->storage);
+    string_t line;
+    string_init(line);
+    if(file_stream_open(stream, PICOPASS_DICT_PATH, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        while(key_count < PICOPASS_DICT_KEYS_MAX && stream_read_line(stream, line)) {
+            if(string_get_char(line, 0) == '#') continue;
+            if(string_size(line) < PICOPASS_BLOCK_LEN * 2) continue;
+            uint8_t* key = &picopass_worker->dict_keys[key_count * PICOPASS_BLOCK_LEN];
+            bool key_valid = true;
+            for(size_t i = 0; i < PICOPASS_BLOCK_LEN && key_valid; i++) {
+                key_valid = args_char_to_hex(
+                    string_get_char(line, i * 2), string_get_char(line, i * 2 + 1), &key[i]);
+            }
+            if(key_valid) key_count++;
+        }
+    }
+    string_clear(line);
+    file_stream_close(stream);
+    stream_free(stream);
+
+    // Keytable only depends on key, calculate it once instead of for every card
+    if(key_count > 1) {
+        picopass_worker->dict_keytables = malloc(key_count * 128);
+        for(size_t i = 0; i < key_count; i++) {
+            loclass_hash2(
+                &picopass_worker->dict_keys[i * PICOPASS_BLOCK_LEN],
+                &picopass_worker->dict_keytables[i * 128]);
+        }
+    }
+    picopass_worker->dict_key_count = key_count;
+    if(key_count > 1) {
+        FURI_LOG_D(TAG, "Dictionary loaded, %d keys", key_count);
+    } else {
+        FURI_LOG_D(TAG, "No dictionary, built-in key only");
+    }
+}
+
+static void picopass_worker_dict_free(PicopassWorker* picopass_worker) {
+    free(picopass_worker->dict_keys);
+    free(picopass_worker->dict_keytables);
+    picopass_worker->dict_keys = NULL;
+    picopass_worker->dict_keytables = NULL;
+    picopass_worker->dict_key_count = 0;
+}
+
+// Without dictionary only built-in key is tried, in standard mode
+static size_t picopass_worker_dict_mac_count(PicopassWorker* picopass_worker) {
+    size_t key_count = picopass_worker->dict_key_count;
+    return key_count > 1 ? key_count * 2 : 1;
+}
+
+// Standard MACs for all dictionary keys first, then elite ones
+static void picopass_worker_dict_macs(
+    PicopassWorker* picopass_worker,
+    uint8_t* csn,
+    uint8_t* ccnr,
+    uint8_t* macs) {
+    size_t key_count = picopass_worker->dict_key_count;
+    uint32_t start = DWT->CYCCNT;
+    loclass_opt_doBatchReaderMAC(csn, ccnr, picopass_worker->dict_keys, key_count, false, macs);
+    if(key_count > 1) {
+        loclass_opt_doBatchReaderMAC_keytables(
+            csn, ccnr, picopass_worker->dict_keytables, key_count, &macs[key_count * 4]);
+    }
+    FURI_LOG_D(
+        TAG,
+        "%d MACs in %ld us",
+        picopass_worker_dict_mac_count(picopass_worker),
+        (DWT->CYCCNT - start) / furi_hal_cortex_instructions_per_microsecond());
+}
+
 /***************************** Picopass Worker API *******************************/
 
 PicopassWorker* picopass_worker_alloc() {
@@ -84,6 +165,9 @@ PicopassWorker* picopass_worker_alloc() {
 
     picopass_worker->callback = NULL;
     picopass_worker->context = NULL;
+    picopass_worker->dict_keys = NULL;
+    picopass_worker->dict_keytables = NULL;
+    picopass_worker->dict_key_count = 0;
     picopass_worker->storage = furi_record_open("storage");
 
     picopass_worker_change_state(picopass_worker, PicopassWorkerStateReady);
@@ -96,6 +180,7 @@ void picopass_worker_free(PicopassWorker* picopass_worker) {
 
     furi_thread_free(picopass_worker->thread);
 
+    picopass_worker_dict_free(picopass_worker);
     furi_record_close("storage");
 
     free(picopass_worker);
@@ -165,7 +250,7 @@ ReturnCode picopass_detect_card(int timeout) {
     return ERR_NONE;
 }
 
-ReturnCode picopass_read_card(ApplicationArea* AA1) {
+ReturnCode picopass_read_card(PicopassWorker* picopass_worker, ApplicationArea* AA1) {
     rfalPicoPassIdentifyRes idRes;
     rfalPicoPassSelectRes selRes;
     rfalPicoPassReadCheckRes rcRes;
@@ -173,8 +258,6 @@ ReturnCode picopass_read_card(ApplicationArea* AA1) {
 
     ReturnCode err;
 
-    uint8_t div_key[8] = {0};
-    uint8_t mac[4] = {0};
     uint8_t ccnr[12] = {0};
 
     err = rfalPicoPassPollerIdentify(&idRes);
@@ -196,10 +279,34 @@ ReturnCode picopass_read_card(ApplicationArea* AA1) {
     }
     memcpy(ccnr, rcRes.CCNR, sizeof(rcRes.CCNR)); // last 4 bytes left 0
 
-    loclass_diversifyKey(selRes.CSN, picopass_iclass_key, div_key);
-    loclass_opt_doReaderMAC(ccnr, div_key, mac);
-
-    err = rfalPicoPassPollerCheck(mac, &chkRes);
+    // Card challenge doesn't change between attempts, so MACs for all keys are ready upfront
+    size_t mac_count = picopass_worker_dict_mac_count(picopass_worker);
+    uint8_t* macs = malloc(mac_count * 4);
+    picopass_worker_dict_macs(picopass_worker, selRes.CSN, ccnr, macs);
+
+    uint32_t start = DWT->CYCCNT;
+    for(size_t i = 0; i < mac_count; i++) {
+        if(i > 0) {
+            // Failed check needs new read check before the next attempt
+            err = rfalPicoPassPollerReadCheck(&rcRes);
+            if(err != ERR_NONE) break;
+            if(memcmp(ccnr, rcRes.CCNR, sizeof(rcRes.CCNR)) != 0) {
+                memcpy(ccnr, rcRes.CCNR, sizeof(rcRes.CCNR));
+                picopass_worker_dict_macs(picopass_worker, selRes.CSN, ccnr, macs);
+            }
+        }
+        err = rfalPicoPassPollerCheck(&macs[i * 4], &chkRes);
+        if(err == ERR_NONE) {
+            FURI_LOG_I(
+                TAG,
+                "%s key %d matched in %ld us",
+                i < picopass_worker->dict_key_count ? "Standard" : "Elite",
+                i % picopass_worker->dict_key_count,
+                (DWT->CYCCNT - start) / furi_hal_cortex_instructions_per_microsecond());
+            break;
+        }
+    }
+    free(macs);
     if(err != ERR_NONE) {
         FURI_LOG_E(TAG, "rfalPicoPassPollerCheck error %d", err);
         return err;
@@ -238,6 +345,7 @@ int32_t picopass_worker_task(void* context) {
 
     picopass_worker_enable_field();
     if(picopass_worker->state == PicopassWorkerStateDetect) {
+        picopass_worker_dict_load(picopass_worker);
         picopass_worker_detect(picopass_worker);
     }
     picopass_worker_disable_field(ERR_NONE);
@@ -258,7 +366,7 @@ void picopass_worker_detect(PicopassWorker* picopass_worker) {
     while(picopass_worker->state == PicopassWorkerStateDetect) {
         if(picopass_detect_card(1000) == ERR_NONE) {
             // Process first found device
-            err = picopass_read_card(AA1);
+            err = picopass_read_card(picopass_worker, AA1);
             if(err != ERR_NONE) {
                 FURI_LOG_E(TAG, "picopass_read_card error %d", err);
             }
@@ -6,6 +6,10 @@
 #include <furi.h>
 #include <lib/toolbox/stream/file_stream.h>
 
+/* Shipped from assets/resources, users may append own keys */
+#define PICOPASS_DICT_PATH PICOPASS_APP_FOLDER "/assets/iclass_dict.txt"
+#define PICOPASS_DICT_KEYS_MAX (64)
+
 struct PicopassWorker {
     FuriThread* thread;
     Storage* storage;
@@ -15,6 +19,11 @@ struct PicopassWorker {
     void* context;
 
     PicopassWorkerState state;
+
+    // Dictionary keys, built-in key first, with their elite keytables
+    uint8_t* dict_keys;
+    uint8_t* dict_keytables;
+    size_t dict_key_count;
 };
 
 void picopass_worker_change_state(PicopassWorker* picopass_worker, PicopassWorkerState state);
@@ -22,10 +22,14 @@
 typedef enum {
     RpcEvtNewData = (1 << 0),
     RpcEvtDisconnect = (1 << 1),
+    RpcEvtLaneDone = (1 << 2),
 } RpcEvtFlags;
 
 #define RPC_ALL_EVENTS (RpcEvtNewData | RpcEvtDisconnect)
 
+#define RPC_LANE_QUEUE_SIZE (4)
+#define RPC_LANE_STACK_SIZE (2048)
+
 DICT_DEF2(RpcHandlerDict, pb_size_t, M_DEFAULT_OPLIST, RpcHandler, M_POD_OPLIST)
 
 typedef struct {
@@ -56,6 +60,45 @@ static RpcSystemCallbacks rpc_systems[] = {
         .free = NULL,
     }};
 
+typedef struct {
+    PB_Main* message; /**< NULL stops lane worker */
+    RpcHandler handler;
+    uint32_t tick;
+    uint32_t barrier[RpcLaneCount]; /**< Commands of other lanes to finish before this one */
+} RpcLaneMessage;
+
+typedef struct {
+    RpcSession* session;
+    RpcLane lane;
+    FuriThread* thread;
+    FuriMessageQueue* queue;
+    uint32_t queued; /**< Changed by session thread only */
+    volatile uint32_t done; /**< Changed by lane thread only */
+    RpcLaneStats stats;
+} RpcSessionLane;
+
+/* Event for waiting lane about done command of another lane. Event flag is owned
+ * by session, so it outlives lane threads, which stop one by one. */
+#define RPC_LANE_EVENT(waiting, done) (1UL << ((waiting)*RpcLaneCount + (done)))
+
+/* Lanes, commands of which must finish before a command of this lane starts.
+ * Storage, app and gui commands depend on each other (file written before app
+ * loads it, app started before input is sent), only system lane runs freely.
+ */
+static const uint8_t rpc_lane_barriers[RpcLaneCount] = {
+    [RpcLaneSystem] = 0,
+    [RpcLaneStorage] = (1 << RpcLaneApp) | (1 << RpcLaneGui),
+    [RpcLaneGui] = (1 << RpcLaneStorage) | (1 << RpcLaneApp),
+    [RpcLaneApp] = (1 << RpcLaneStorage) | (1 << RpcLaneGui),
+};
+
+static const char* rpc_lane_names[RpcLaneCount] = {
+    [RpcLaneSystem] = "system",
+    [RpcLaneStorage] = "storage",
+    [RpcLaneGui] = "gui",
+    [RpcLaneApp] = "app",
+};
+
 struct RpcSession {
     Rpc* rpc;
 
@@ -74,10 +117,13 @@ struct RpcSession {
     RpcSessionClosedCallback closed_callback;
     RpcSessionTerminatedCallback terminated_callback;
     void* context;
+
+    RpcSessionLane lanes[RpcLaneCount];
+    FuriEventFlag* lane_event; /**< Lane to lane done signals, see RPC_LANE_EVENT */
 };
 
 struct Rpc {
-    FuriMutex* busy_mutex;
+    FuriMutex* lane_mutex[RpcLaneCount];
 };
 
 static bool content_callback(pb_istream_t* stream, const pb_field_t* field, void** arg);
@@ -482,12 +528,134 @@ static bool content_callback(pb_istream_t* stream, const pb_field_t* field, void
     return true;
 }
 
+static PB_Main* rpc_session_message_alloc(RpcSession* session) {
+    PB_Main* message = malloc(sizeof(PB_Main));
+    message->cb_content.funcs.decode = content_callback;
+    message->cb_content.arg = session;
+    return message;
+}
+
+static int32_t rpc_session_lane_worker(void* context) {
+    furi_assert(context);
+    RpcSessionLane* lane = context;
+    RpcSession* session = lane->session;
+    FuriMutex* lane_mutex = session->rpc->lane_mutex[lane->lane];
+    RpcLaneMessage lane_message;
+
+    while(1) {
+        furi_check(
+            furi_message_queue_get(lane->queue, &lane_message, FuriWaitForever) == FuriStatusOk);
+        if(!lane_message.message) break;
+
+        // Keep order with commands of dependent lanes received before this one
+        for(size_t i = 0; i < RpcLaneCount; ++i) {
+            if(!(rpc_lane_barriers[lane->lane] & (1 << i))) continue;
+            while((int32_t)(session->lanes[i].done - lane_message.barrier[i]) < 0) {
+                furi_event_flag_wait(
+                    session->lane_event,
+                    RPC_LANE_EVENT(lane->lane, i),
+                    FuriFlagWaitAny,
+                    FuriWaitForever);
+            }
+        }
+
+        furi_check(furi_mutex_acquire(lane_mutex, FuriWaitForever) == FuriStatusOk);
+        lane_message.handler.message_handler(lane_message.message, lane_message.handler.context);
+        furi_check(furi_mutex_release(lane_mutex) == FuriStatusOk);
+
+        pb_release(&PB_Main_msg, lane_message.message);
+        free(lane_message.message);
+
+        uint32_t latency = furi_get_tick() - lane_message.tick;
+        FURI_CRITICAL_ENTER();
+        lane->stats.commands++;
+        lane->stats.latency_total += latency;
+        lane->stats.latency_max = MAX(lane->stats.latency_max, latency);
+        FURI_CRITICAL_EXIT();
+
+        lane->done++;
+        furi_thread_flags_set(furi_thread_get_id(session->thread), RpcEvtLaneDone);
+        for(size_t i = 0; i < RpcLaneCount; ++i) {
+            if(rpc_lane_barriers[i] & (1 << lane->lane)) {
+                furi_event_flag_set(session->lane_event, RPC_LANE_EVENT(i, lane->lane));
+            }
+        }
+    }
+
+    return 0;
+}
+
+static void rpc_session_lanes_start(RpcSession* session) {
+    session->lane_event = furi_event_flag_alloc();
+    for(size_t i = 0; i < RpcLaneCount; ++i) {
+        RpcSessionLane* lane = &session->lanes[i];
+        lane->session = session;
+        lane->lane = i;
+        lane->queue = furi_message_queue_alloc(RPC_LANE_QUEUE_SIZE, sizeof(RpcLaneMessage));
+        lane->thread = furi_thread_alloc();
+        furi_thread_set_name(lane->thread, "RpcLaneWorker");
+        furi_thread_set_stack_size(lane->thread, RPC_LANE_STACK_SIZE);
+        furi_thread_set_context(lane->thread, lane);
+        furi_thread_set_callback(lane->thread, rpc_session_lane_worker);
+        furi_thread_start(lane->thread);
+    }
+}
+
+static void rpc_session_lanes_stop(RpcSession* session) {
+    RpcLaneMessage lane_message = {.message = NULL};
+    for(size_t i = 0; i < RpcLaneCount; ++i) {
+        RpcSessionLane* lane = &session->lanes[i];
+        // Commands already in queue are finished before worker exits
+        furi_check(
+            furi_message_queue_put(lane->queue, &lane_message, FuriWaitForever) == FuriStatusOk);
+        furi_thread_join(lane->thread);
+        furi_thread_free(lane->thread);
+        furi_message_queue_free(lane->queue);
+    }
+    furi_event_flag_free(session->lane_event);
+}
+
+/* Wait till every lane is done with commands received so far */
+static void rpc_session_lanes_drain(RpcSession* session) {
+    for(size_t i = 0; i < RpcLaneCount; ++i) {
+        RpcSessionLane* lane = &session->lanes[i];
+        while(lane->done != lane->queued) {
+            furi_thread_flags_wait(RpcEvtLaneDone, FuriFlagWaitAny, FuriWaitForever);
+        }
+    }
+}
+
+static void rpc_session_dispatch(RpcSession* session, RpcHandler* handler) {
+    if(handler->lane == RpcLaneSession) {
+        rpc_session_lanes_drain(session);
+        handler->message_handler(session->decoded_message, handler->context);
+        return;
+    }
+
+    furi_assert(handler->lane < RpcLaneCount);
+    RpcSessionLane* lane = &session->lanes[handler->lane];
+    RpcLaneMessage lane_message = {
+        .message = session->decoded_message,
+        .handler = *handler,
+        .tick = furi_get_tick(),
+    };
+    for(size_t i = 0; i < RpcLaneCount; ++i) {
+        lane_message.barrier[i] = session->lanes[i].queued;
+    }
+    lane->queued++;
+    furi_check(
+        furi_message_queue_put(lane->queue, &lane_message, FuriWaitForever) == FuriStatusOk);
+
+    // Lane worker owns decoded message now, next one is decoded into a new buffer
+    session->decoded_message = rpc_session_message_alloc(session);
+}
+
 static int32_t rpc_session_worker(void* context) {
     furi_assert(context);
     RpcSession* session = (RpcSession*)context;
-    Rpc* rpc = session->rpc;
 
     FURI_LOG_D(TAG, "Session started");
+    rpc_session_lanes_start(session);
 
     while(1) {
         pb_istream_t istream = {
@@ -508,9 +676,7 @@ static int32_t rpc_session_worker(void* context) {
                 RpcHandlerDict_get(session->handlers, session->decoded_message->which_content);
 
             if(handler && handler->message_handler) {
-                furi_check(furi_mutex_acquire(rpc->busy_mutex, FuriWaitForever) == FuriStatusOk);
-                handler->message_handler(session->decoded_message, handler->context);
-                furi_check(furi_mutex_release(rpc->busy_mutex) == FuriStatusOk);
+                rpc_session_dispatch(session, handler);
             } else if(session->decoded_message->which_content == 0) {
                 /* Receiving zeroes means message is 0-length, which
                  * is valid for proto3: all fields are filled with default values.
@@ -524,6 +690,7 @@ static int32_t rpc_session_worker(void* context) {
                     TAG,
                     "Message(%d) decoded, but not implemented",
                     session->decoded_message->which_content);
+                rpc_session_lanes_drain(session);
                 rpc_send_and_release_empty(
                     session,
                     session->decoded_message->command_id,
@@ -550,6 +717,7 @@ static int32_t rpc_session_worker(void* context) {
                  */
                 FURI_LOG_E(TAG, "Decode failed, error: \'%.128s\'", PB_GET_ERROR(&istream));
                 session->decode_error = true;
+                rpc_session_lanes_drain(session);
                 rpc_send_and_release_empty(session, 0, PB_CommandStatus_ERROR_DECODE);
                 furi_mutex_acquire(session->callbacks_mutex, FuriWaitForever);
                 if(session->closed_callback) {
@@ -567,6 +735,8 @@ static int32_t rpc_session_worker(void* context) {
         }
     }
 
+    rpc_session_lanes_stop(session);
+
     return 0;
 }
 
@@ -609,9 +779,7 @@ RpcSession* rpc_session_open(Rpc* rpc) {
     session->decode_error = false;
     RpcHandlerDict_init(session->handlers);
 
-    session->decoded_message = malloc(sizeof(PB_Main));
-    session->decoded_message->cb_content.funcs.decode = content_callback;
-    session->decoded_message->cb_content.arg = session;
+    session->decoded_message = rpc_session_message_alloc(session);
 
     session->system_contexts = malloc(COUNT_OF(rpc_systems) * sizeof(void*));
     for(size_t i = 0; i < COUNT_OF(rpc_systems); ++i) {
@@ -622,6 +790,7 @@ RpcSession* rpc_session_open(Rpc* rpc) {
         .message_handler = rpc_close_session_process,
         .decode_submessage = NULL,
         .context = session,
+        .lane = RpcLaneSession,
     };
     rpc_add_handler(session, PB_Main_stop_session_tag, &rpc_handler);
 
@@ -653,7 +822,9 @@ int32_t rpc_srv(void* p) {
     UNUSED(p);
     Rpc* rpc = malloc(sizeof(Rpc));
 
-    rpc->busy_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    for(size_t i = 0; i < RpcLaneCount; ++i) {
+        rpc->lane_mutex[i] = furi_mutex_alloc(FuriMutexTypeNormal);
+    }
 
     Cli* cli = furi_record_open("cli");
     cli_add_command(
@@ -666,10 +837,26 @@ int32_t rpc_srv(void* p) {
 
 void rpc_add_handler(RpcSession* session, pb_size_t message_tag, RpcHandler* handler) {
     furi_assert(RpcHandlerDict_get(session->handlers, message_tag) == NULL);
+    furi_assert(handler->lane <= RpcLaneSession);
 
     RpcHandlerDict_set_at(session->handlers, message_tag, *handler);
 }
 
+const char* rpc_lane_get_name(RpcLane lane) {
+    furi_assert(lane < RpcLaneCount);
+    return rpc_lane_names[lane];
+}
+
+void rpc_session_get_lane_stats(RpcSession* session, RpcLane lane, RpcLaneStats* stats) {
+    furi_assert(session);
+    furi_assert(lane < RpcLaneCount);
+    furi_assert(stats);
+
+    FURI_CRITICAL_ENTER();
+    *stats = session->lanes[lane].stats;
+    FURI_CRITICAL_EXIT();
+}
+
 void rpc_send(RpcSession* session, PB_Main* message) {
     furi_assert(session);
     furi_assert(message);
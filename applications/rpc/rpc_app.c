@@ -213,6 +213,7 @@ void* rpc_system_app_alloc(RpcSession* session) {
         .message_handler = NULL,
         .decode_submessage = NULL,
         .context = rpc_app,
+        .lane = RpcLaneApp,
     };
 
     rpc_handler.message_handler = rpc_system_app_start_process;
@@ -200,6 +200,7 @@ void* rpc_system_gpio_alloc(RpcSession* session) {
         .message_handler = NULL,
         .decode_submessage = NULL,
         .context = session,
+        .lane = RpcLaneSystem,
     };
 
     rpc_handler.message_handler = rpc_system_gpio_set_pin_mode;
@@ -12,6 +12,10 @@ typedef enum {
 
 #define RpcGuiWorkerFlagAny (RpcGuiWorkerFlagTransmit | RpcGuiWorkerFlagExit)
 
+/* Delta frame control byte: literal XOR bytes or run of unchanged bytes */
+#define RPC_GUI_DELTA_RUN_FLAG 0x80
+#define RPC_GUI_DELTA_MAX_RUN 128
+
 typedef struct {
     RpcSession* session;
     Gui* gui;
@@ -23,6 +27,10 @@ typedef struct {
     // Transmit
     PB_Main* transmit_frame;
     FuriThread* transmit_thread;
+    FuriMutex* screen_mutex;
+    uint8_t* screen_frame;
+    uint8_t* sent_frame;
+    bool sent_frame_valid;
 
     bool virtual_display_not_empty;
     bool is_streaming;
@@ -34,15 +42,71 @@ static void
     furi_assert(context);
 
     RpcGuiSystem* rpc_gui = (RpcGuiSystem*)context;
-    uint8_t* buffer = rpc_gui->transmit_frame->content.gui_screen_frame.data->bytes;
 
-    furi_assert(size == rpc_gui->transmit_frame->content.gui_screen_frame.data->size);
+    furi_assert(size == gui_get_framebuffer_size(rpc_gui->gui));
 
-    memcpy(buffer, data, size);
+    furi_check(furi_mutex_acquire(rpc_gui->screen_mutex, FuriWaitForever) == FuriStatusOk);
+    memcpy(rpc_gui->screen_frame, data, size);
+    furi_check(furi_mutex_release(rpc_gui->screen_mutex) == FuriStatusOk);
 
     furi_thread_flags_set(furi_thread_get_id(rpc_gui->transmit_thread), RpcGuiWorkerFlagTransmit);
 }
 
+size_t rpc_system_gui_screen_delta_encode(
+    const uint8_t* frame,
+    const uint8_t* prev_frame,
+    size_t size,
+    uint8_t* output,
+    size_t output_size) {
+    size_t input_pos = 0;
+    size_t output_pos = 0;
+
+    while(input_pos < size) {
+        const bool unchanged = frame[input_pos] == prev_frame[input_pos];
+        size_t run = 1;
+        while((input_pos + run < size) && (run < RPC_GUI_DELTA_MAX_RUN) &&
+              ((frame[input_pos + run] == prev_frame[input_pos + run]) == unchanged)) {
+            run++;
+        }
+
+        const size_t token_size = unchanged ? 1 : 1 + run;
+        if(output_pos + token_size > output_size) {
+            return 0;
+        }
+
+        if(unchanged) {
+            output[output_pos++] = RPC_GUI_DELTA_RUN_FLAG | (run - 1);
+        } else {
+            output[output_pos++] = run - 1;
+            for(size_t i = 0; i < run; i++) {
+                output[output_pos++] = frame[input_pos + i] ^ prev_frame[input_pos + i];
+            }
+        }
+        input_pos += run;
+    }
+
+    return output_pos;
+}
+
+/* Encodes latest screen into transmit frame, returns false if nothing changed */
+static bool rpc_system_gui_screen_stream_prepare_frame(RpcGuiSystem* rpc_gui) {
+    PB_Gui_ScreenFrame* screen_frame = &rpc_gui->transmit_frame->content.gui_screen_frame;
+    const size_t framebuffer_size = gui_get_framebuffer_size(rpc_gui->gui);
+    bool changed = false;
+
+    furi_check(furi_mutex_acquire(rpc_gui->screen_mutex, FuriWaitForever) == FuriStatusOk);
+    if(!rpc_gui->sent_frame_valid ||
+       memcmp(rpc_gui->screen_frame, rpc_gui->sent_frame, framebuffer_size) != 0) {
+        memcpy(screen_frame->data->bytes, rpc_gui->screen_frame, framebuffer_size);
+        memcpy(rpc_gui->sent_frame, rpc_gui->screen_frame, framebuffer_size);
+        rpc_gui->sent_frame_valid = true;
+        changed = true;
+    }
+    furi_check(furi_mutex_release(rpc_gui->screen_mutex) == FuriStatusOk);
+
+    return changed;
+}
+
 static int32_t rpc_system_gui_screen_stream_frame_transmit_thread(void* context) {
     furi_assert(context);
 
@@ -51,12 +115,13 @@ static int32_t rpc_system_gui_screen_stream_frame_transmit_thread(void* context)
     while(true) {
         uint32_t flags =
             furi_thread_flags_wait(RpcGuiWorkerFlagAny, FuriFlagWaitAny, FuriWaitForever);
-        if(flags & RpcGuiWorkerFlagTransmit) {
-            rpc_send(rpc_gui->session, rpc_gui->transmit_frame);
-        }
         if(flags & RpcGuiWorkerFlagExit) {
             break;
         }
+
+        if(rpc_system_gui_screen_stream_prepare_frame(rpc_gui)) {
+            rpc_send(rpc_gui->session, rpc_gui->transmit_frame);
+        }
     }
 
     return 0;
@@ -87,6 +152,11 @@ static void rpc_system_gui_start_screen_stream_process(const PB_Main* request, v
         rpc_gui->transmit_frame->content.gui_screen_frame.data =
             malloc(PB_BYTES_ARRAY_T_ALLOCSIZE(framebuffer_size));
         rpc_gui->transmit_frame->content.gui_screen_frame.data->size = framebuffer_size;
+        // Latest and last sent screen
+        rpc_gui->screen_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+        rpc_gui->screen_frame = malloc(framebuffer_size);
+        rpc_gui->sent_frame = malloc(framebuffer_size);
+        rpc_gui->sent_frame_valid = false;
         // Transmission thread for async TX
         rpc_gui->transmit_thread = furi_thread_alloc();
         furi_thread_set_name(rpc_gui->transmit_thread, "GuiRpcWorker");
@@ -124,6 +194,9 @@ static void rpc_system_gui_stop_screen_stream_process(const PB_Main* request, vo
         pb_release(&PB_Main_msg, rpc_gui->transmit_frame);
         free(rpc_gui->transmit_frame);
         rpc_gui->transmit_frame = NULL;
+        furi_mutex_free(rpc_gui->screen_mutex);
+        free(rpc_gui->screen_frame);
+        free(rpc_gui->sent_frame);
     }
 
     rpc_send_and_release_empty(session, request->command_id, PB_CommandStatus_OK);
@@ -324,6 +397,7 @@ void* rpc_system_gui_alloc(RpcSession* session) {
         .message_handler = NULL,
         .decode_submessage = NULL,
         .context = rpc_gui,
+        .lane = RpcLaneGui,
     };
 
     rpc_handler.message_handler = rpc_system_gui_start_screen_stream_process;
@@ -373,6 +447,9 @@ void rpc_system_gui_free(void* context) {
         pb_release(&PB_Main_msg, rpc_gui->transmit_frame);
         free(rpc_gui->transmit_frame);
         rpc_gui->transmit_frame = NULL;
+        furi_mutex_free(rpc_gui->screen_mutex);
+        free(rpc_gui->screen_frame);
+        free(rpc_gui->sent_frame);
     }
     furi_record_close("gui");
     free(rpc_gui);
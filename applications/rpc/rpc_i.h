@@ -11,10 +11,32 @@ typedef void* (*RpcSystemAlloc)(RpcSession* session);
 typedef void (*RpcSystemFree)(void* context);
 typedef void (*PBMessageHandler)(const PB_Main* msg_request, void* context);
 
+/** Subsystem lanes. Every lane has its own worker thread and queue, so system commands
+ * run in parallel with the rest. Storage, gui and app commands keep their order across
+ * lanes: a command waits for dependent lanes to finish commands received before it.
+ * Same lane of different sessions never runs at the same time.
+ */
+typedef enum {
+    RpcLaneSystem,
+    RpcLaneStorage,
+    RpcLaneGui,
+    RpcLaneApp,
+    RpcLaneCount,
+    /** No worker, runs in session thread after all commands received before it are done */
+    RpcLaneSession = RpcLaneCount,
+} RpcLane;
+
+typedef struct {
+    uint32_t commands; /**< Handled commands */
+    uint32_t latency_total; /**< Sum of command latencies, ms */
+    uint32_t latency_max; /**< Worst command latency, ms */
+} RpcLaneStats;
+
 typedef struct {
     bool (*decode_submessage)(pb_istream_t* stream, const pb_field_t* field, void** arg);
     PBMessageHandler message_handler;
     void* context;
+    RpcLane lane;
 } RpcHandler;
 
 void rpc_send(RpcSession* session, PB_Main* main_message);
@@ -25,6 +47,13 @@ void rpc_send_and_release_empty(RpcSession* session, uint32_t command_id, PB_Com
 
 void rpc_add_handler(RpcSession* session, pb_size_t message_tag, RpcHandler* handler);
 
+const char* rpc_lane_get_name(RpcLane lane);
+
+/** Get latency statistics of session lane. Latency is counted from command
+ * being decoded till its handler return, so it includes time spent in queue.
+ */
+void rpc_session_get_lane_stats(RpcSession* session, RpcLane lane, RpcLaneStats* stats);
+
 void* rpc_system_system_alloc(RpcSession* session);
 void* rpc_system_storage_alloc(RpcSession* session);
 void rpc_system_storage_free(void* ctx);
@@ -32,6 +61,19 @@ void* rpc_system_app_alloc(RpcSession* session);
 void rpc_system_app_free(void* ctx);
 void* rpc_system_gui_alloc(RpcSession* session);
 void rpc_system_gui_free(void* ctx);
+
+/** XOR frame against previous one. Control byte 0x00-0x7F is followed by 1-128 literal
+ * XOR bytes, 0x80-0xFF stands for 1-128 unchanged bytes. Not sent yet: protocol has no
+ * field to negotiate delta frames.
+ *
+ * @return encoded size or 0 if it doesn't fit into output
+ */
+size_t rpc_system_gui_screen_delta_encode(
+    const uint8_t* frame,
+    const uint8_t* prev_frame,
+    size_t size,
+    uint8_t* output,
+    size_t output_size);
 void* rpc_system_gpio_alloc(RpcSession* session);
 void rpc_system_gpio_free(void* ctx);
 
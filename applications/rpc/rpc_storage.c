@@ -651,6 +651,7 @@ void* rpc_system_storage_alloc(RpcSession* session) {
         .message_handler = NULL,
         .decode_submessage = NULL,
         .context = rpc_storage,
+        .lane = RpcLaneStorage,
     };
 
     rpc_handler.message_handler = rpc_system_storage_info_process;
@@ -12,6 +12,7 @@
 typedef struct {
     RpcSession* session;
     PB_Main* response;
+    bool more_follows;
 } RpcSystemContext;
 
 static void rpc_system_system_ping_process(const PB_Main* request, void* context) {
@@ -81,13 +82,41 @@ static void rpc_system_system_device_info_callback(
     char* str_key = strdup(key);
     char* str_value = strdup(value);
 
-    ctx->response->has_next = !last;
+    ctx->response->has_next = !last || ctx->more_follows;
     ctx->response->content.system_device_info_response.key = str_key;
     ctx->response->content.system_device_info_response.value = str_value;
 
     rpc_send_and_release(ctx->session, ctx->response);
 }
 
+static void rpc_system_system_lane_stats_info(RpcSystemContext* ctx) {
+    char key[32];
+    char value[16];
+
+    for(size_t i = 0; i < RpcLaneCount; ++i) {
+        RpcLaneStats stats;
+        rpc_session_get_lane_stats(ctx->session, i, &stats);
+        const char* name = rpc_lane_get_name(i);
+        bool last = (i == RpcLaneCount - 1);
+
+        snprintf(key, sizeof(key), "rpc_%s_commands", name);
+        snprintf(value, sizeof(value), "%lu", stats.commands);
+        rpc_system_system_device_info_callback(key, value, false, ctx);
+
+        snprintf(key, sizeof(key), "rpc_%s_latency_avg_ms", name);
+        snprintf(
+            value,
+            sizeof(value),
+            "%lu",
+            stats.commands ? stats.latency_total / stats.commands : 0);
+        rpc_system_system_device_info_callback(key, value, false, ctx);
+
+        snprintf(key, sizeof(key), "rpc_%s_latency_max_ms", name);
+        snprintf(value, sizeof(value), "%lu", stats.latency_max);
+        rpc_system_system_device_info_callback(key, value, last, ctx);
+    }
+}
+
 static void rpc_system_system_device_info_process(const PB_Main* request, void* context) {
     furi_assert(request);
     furi_assert(request->which_content == PB_Main_system_device_info_request_tag);
@@ -105,9 +134,14 @@ static void rpc_system_system_device_info_process(const PB_Main* request, void*
     RpcSystemContext device_info_context = {
         .session = session,
         .response = response,
+        .more_follows = true,
     };
     furi_hal_info_get(rpc_system_system_device_info_callback, &device_info_context);
 
+    // RPC command latency per lane goes after hardware info
+    device_info_context.more_follows = false;
+    rpc_system_system_lane_stats_info(&device_info_context);
+
     free(response);
 }
 
@@ -297,20 +331,15 @@ void* rpc_system_system_alloc(RpcSession* session) {
         .message_handler = NULL,
         .decode_submessage = NULL,
         .context = session,
+        .lane = RpcLaneSystem,
     };
 
     rpc_handler.message_handler = rpc_system_system_ping_process;
     rpc_add_handler(session, PB_Main_system_ping_request_tag, &rpc_handler);
 
-    rpc_handler.message_handler = rpc_system_system_reboot_process;
-    rpc_add_handler(session, PB_Main_system_reboot_request_tag, &rpc_handler);
-
     rpc_handler.message_handler = rpc_system_system_device_info_process;
     rpc_add_handler(session, PB_Main_system_device_info_request_tag, &rpc_handler);
 
-    rpc_handler.message_handler = rpc_system_system_factory_reset_process;
-    rpc_add_handler(session, PB_Main_system_factory_reset_request_tag, &rpc_handler);
-
     rpc_handler.message_handler = rpc_system_system_get_datetime_process;
     rpc_add_handler(session, PB_Main_system_get_datetime_request_tag, &rpc_handler);
 
@@ -326,6 +355,15 @@ void* rpc_system_system_alloc(RpcSession* session) {
     rpc_handler.message_handler = rpc_system_system_get_power_info_process;
     rpc_add_handler(session, PB_Main_system_power_info_request_tag, &rpc_handler);
 
+    // Storage commands sent before these must be complete, so they don't run on a lane
+    rpc_handler.lane = RpcLaneSession;
+
+    rpc_handler.message_handler = rpc_system_system_reboot_process;
+    rpc_add_handler(session, PB_Main_system_reboot_request_tag, &rpc_handler);
+
+    rpc_handler.message_handler = rpc_system_system_factory_reset_process;
+    rpc_add_handler(session, PB_Main_system_factory_reset_request_tag, &rpc_handler);
+
 #ifdef APP_UPDATER
     rpc_handler.message_handler = rpc_system_system_update_request_process;
     rpc_add_handler(session, PB_Main_system_update_request_tag, &rpc_handler);
@@ -33,7 +33,7 @@ static void storage_app_sd_icon_draw_callback(Canvas* canvas, void* context) {
 
 Storage* storage_app_alloc() {
     Storage* app = malloc(sizeof(Storage));
-    app->message_queue = furi_message_queue_alloc(8, sizeof(StorageMessage));
+    app->message_queue = furi_message_queue_alloc(16, sizeof(StorageMessage));
     app->pubsub = furi_pubsub_alloc();
 
     for(uint8_t i = 0; i < STORAGE_COUNT; i++) {
@@ -287,6 +287,62 @@ FS_Error storage_int_backup(Storage* api, const char* dstname);
  */
 FS_Error storage_int_restore(Storage* api, const char* dstname);
 
+/******************* Async Functions *******************/
+
+typedef enum {
+    StorageAsyncTypeRead,
+    StorageAsyncTypeWrite,
+    StorageAsyncTypeStat,
+} StorageAsyncType;
+
+typedef struct StorageAsyncRequest StorageAsyncRequest;
+
+/** Async request completion callback. Called from storage thread,
+ * must be short and must not call storage API.
+ * @param request completed request
+ * @param context callback context
+ */
+typedef void (*StorageAsyncCallback)(StorageAsyncRequest* request, void* context);
+
+/** Async request, owned by caller and must stay valid until completion.
+ * Requests to the same file may be reordered by offset and merged,
+ * but never across an overlapping write.
+ */
+struct StorageAsyncRequest {
+    StorageAsyncType type;
+    /** Read, write: open file. File position after completion is undefined. */
+    File* file;
+    /** Read, write: absolute offset in file */
+    uint32_t offset;
+    /** Read: destination buffer. Write: source buffer, not modified. */
+    void* buff;
+    /** Read, write: number of bytes */
+    uint16_t size;
+    /** Stat: path */
+    const char* path;
+    /** Stat: file info, can be NULL */
+    FileInfo* fileinfo;
+
+    /** Optional completion callback */
+    StorageAsyncCallback callback;
+    void* context;
+    /** Optional event flag, event_flag_mask is set on completion */
+    FuriEventFlag* event_flag;
+    uint32_t event_flag_mask;
+
+    /** Result: bytes read or written */
+    uint16_t bytes_done;
+    /** Result: operation error */
+    FS_Error error;
+};
+
+/** Queues request and returns without waiting for it.
+ * Blocks only if storage queue is full.
+ * @param storage pointer to the api
+ * @param request request to queue
+ */
+void storage_async_submit(Storage* storage, StorageAsyncRequest* request);
+
 /***************** Simplified Functions ******************/
 
 /**
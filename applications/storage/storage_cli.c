@@ -69,6 +69,16 @@ static void storage_cli_info(Cli* cli, string_t path) {
                 sd_api_get_fs_type_text(sd_info.fs_type),
                 sd_info.kb_total,
                 sd_info.kb_free);
+
+            const uint32_t cache_lookups = sd_info.cache_hits + sd_info.cache_misses;
+            printf(
+                "Cache: %lu hits, %lu misses, %lu%% hit rate\r\n"
+                "Cache: %lu sectors written back in %lu commands\r\n",
+                sd_info.cache_hits,
+                sd_info.cache_misses,
+                cache_lookups ? (uint32_t)((uint64_t)sd_info.cache_hits * 100 / cache_lookups) : 0,
+                sd_info.cache_written_back,
+                sd_info.cache_write_commands);
         }
     } else {
         storage_cli_print_usage();
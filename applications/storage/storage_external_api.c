@@ -325,6 +325,28 @@ bool storage_dir_rewind(File* file) {
     return S_RETURN_BOOL;
 }
 
+/****************** ASYNC ******************/
+
+void storage_async_submit(Storage* storage, StorageAsyncRequest* request) {
+    furi_assert(storage);
+    furi_assert(request);
+
+    request->bytes_done = 0;
+    request->error = FSE_OK;
+
+    StorageMessage message = {
+        .semaphore = NULL,
+        .command = StorageCommandAsync,
+        .data = NULL,
+        .return_data = NULL,
+        .async_request = request,
+    };
+
+    furi_check(
+        furi_message_queue_put(storage->message_queue, &message, FuriWaitForever) ==
+        FuriStatusOk);
+}
+
 /****************** COMMON ******************/
 
 FS_Error storage_common_stat(Storage* storage, const char* path, FileInfo* fileinfo) {
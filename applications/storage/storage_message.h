@@ -120,6 +120,7 @@ typedef enum {
     StorageCommandSDUnmount,
     StorageCommandSDInfo,
     StorageCommandSDStatus,
+    StorageCommandAsync,
 } StorageCommand;
 
 typedef struct {
@@ -127,6 +128,7 @@ typedef struct {
     StorageCommand command;
     SAData* data;
     SAReturn* return_data;
+    StorageAsyncRequest* async_request;
 } StorageMessage;
 
 #ifdef __cplusplus
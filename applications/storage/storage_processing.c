@@ -8,6 +8,9 @@
     ret = _storage->fs_api->_fn; \
     storage_data_unlock(_storage);
 
+#define STORAGE_ASYNC_BATCH_MAX 16
+#define STORAGE_ASYNC_MERGE_SIZE 512
+
 #define ST_CALL(_storage, _fn)   \
     storage_data_lock(_storage); \
     ret = _storage->api._fn;     \
@@ -571,11 +574,188 @@ void storage_process_message_internal(Storage* app, StorageMessage* message) {
     case StorageCommandSDStatus:
         message->return_data->error_value = storage_process_sd_status(app);
         break;
+    case StorageCommandAsync:
+        furi_crash("Async request in sync path");
+        break;
     }
 
     furi_semaphore_release(message->semaphore);
 }
 
+/****************** Async requests processing ******************/
+
+static bool storage_async_overlaps(const StorageAsyncRequest* a, const StorageAsyncRequest* b) {
+    return (a->offset < b->offset + b->size) && (b->offset < a->offset + a->size);
+}
+
+/* Can b be moved ahead of a */
+static bool storage_async_can_swap(const StorageAsyncRequest* a, const StorageAsyncRequest* b) {
+    if(a->type == StorageAsyncTypeStat || b->type == StorageAsyncTypeStat) {
+        return false;
+    }
+    if(a->file != b->file) {
+        return true;
+    }
+    if(a->type == StorageAsyncTypeRead && b->type == StorageAsyncTypeRead) {
+        return true;
+    }
+    return !storage_async_overlaps(a, b);
+}
+
+static bool storage_async_is_before(const StorageAsyncRequest* a, const StorageAsyncRequest* b) {
+    if(a->file != b->file) {
+        return (uint32_t)a->file < (uint32_t)b->file;
+    }
+    return a->offset < b->offset;
+}
+
+/* Group requests by file and sort by offset, keeping conflicting requests in order */
+static void storage_async_sort(StorageAsyncRequest** requests, size_t count) {
+    for(size_t i = 1; i < count; i++) {
+        StorageAsyncRequest* request = requests[i];
+        size_t pos = i;
+        while(pos > 0 && storage_async_is_before(request, requests[pos - 1]) &&
+              storage_async_can_swap(requests[pos - 1], request)) {
+            requests[pos] = requests[pos - 1];
+            pos--;
+        }
+        requests[pos] = request;
+    }
+}
+
+static void storage_async_complete(StorageAsyncRequest* request) {
+    if(request->callback) {
+        request->callback(request, request->context);
+    }
+    if(request->event_flag) {
+        furi_event_flag_set(request->event_flag, request->event_flag_mask);
+    }
+}
+
+/* Number of requests starting at first that can be done as one file operation */
+static size_t storage_async_merge_count(StorageAsyncRequest** requests, size_t count) {
+    const StorageAsyncRequest* first = requests[0];
+    size_t merge_count = 1;
+    size_t merge_size = first->size;
+
+    if(first->type == StorageAsyncTypeStat) {
+        return 1;
+    }
+
+    while(merge_count < count) {
+        const StorageAsyncRequest* prev = requests[merge_count - 1];
+        const StorageAsyncRequest* next = requests[merge_count];
+        if((next->type != first->type) || (next->file != first->file) ||
+           (next->offset != prev->offset + prev->size) ||
+           (merge_size + next->size > STORAGE_ASYNC_MERGE_SIZE)) {
+            break;
+        }
+        merge_size += next->size;
+        merge_count++;
+    }
+
+    return merge_count;
+}
+
+static void
+    storage_async_process_file_op(Storage* app, StorageAsyncRequest** requests, size_t count) {
+    StorageAsyncRequest* first = requests[0];
+    File* file = first->file;
+    uint16_t bytes_done = 0;
+    uint16_t size = 0;
+
+    for(size_t i = 0; i < count; i++) {
+        size += requests[i]->size;
+    }
+
+    do {
+        if(storage_process_file_tell(app, file) != first->offset) {
+            if(!storage_process_file_seek(app, file, first->offset, true)) break;
+        }
+
+        if(count == 1) {
+            if(first->type == StorageAsyncTypeRead) {
+                bytes_done = storage_process_file_read(app, file, first->buff, size);
+            } else {
+                bytes_done = storage_process_file_write(app, file, first->buff, size);
+            }
+            break;
+        }
+
+        /* Adjacent small requests go through one bounce buffer */
+        uint8_t* buffer = malloc(size);
+        if(first->type == StorageAsyncTypeRead) {
+            bytes_done = storage_process_file_read(app, file, buffer, size);
+        } else {
+            for(size_t i = 0, pos = 0; i < count; pos += requests[i]->size, i++) {
+                memcpy(&buffer[pos], requests[i]->buff, requests[i]->size);
+            }
+            bytes_done = storage_process_file_write(app, file, buffer, size);
+        }
+
+        for(size_t i = 0, pos = 0; i < count; pos += requests[i]->size, i++) {
+            if(first->type == StorageAsyncTypeRead && pos < bytes_done) {
+                memcpy(requests[i]->buff, &buffer[pos], MIN(requests[i]->size, bytes_done - pos));
+            }
+        }
+        free(buffer);
+    } while(false);
+
+    for(size_t i = 0, pos = 0; i < count; pos += requests[i]->size, i++) {
+        requests[i]->error = file->error_id;
+        requests[i]->bytes_done = (pos < bytes_done) ? MIN(requests[i]->size, bytes_done - pos) : 0;
+    }
+}
+
+static void storage_async_process_batch(Storage* app, StorageAsyncRequest** requests, size_t count) {
+    storage_async_sort(requests, count);
+
+    size_t i = 0;
+    while(i < count) {
+        size_t merge_count = storage_async_merge_count(&requests[i], count - i);
+
+        if(requests[i]->type == StorageAsyncTypeStat) {
+            requests[i]->error =
+                storage_process_common_stat(app, requests[i]->path, requests[i]->fileinfo);
+        } else {
+            storage_async_process_file_op(app, &requests[i], merge_count);
+        }
+
+        for(size_t j = 0; j < merge_count; j++) {
+            storage_async_complete(requests[i + j]);
+        }
+        i += merge_count;
+    }
+}
+
+/* Collects async requests queued behind the first one, up to next sync message */
+static void storage_process_async(Storage* app, StorageAsyncRequest* request) {
+    StorageAsyncRequest* requests[STORAGE_ASYNC_BATCH_MAX];
+    size_t count = 0;
+    requests[count++] = request;
+
+    StorageMessage message;
+    bool sync_pending = false;
+    while(count < STORAGE_ASYNC_BATCH_MAX &&
+          furi_message_queue_get(app->message_queue, &message, 0) == FuriStatusOk) {
+        if(message.command != StorageCommandAsync) {
+            sync_pending = true;
+            break;
+        }
+        requests[count++] = message.async_request;
+    }
+
+    storage_async_process_batch(app, requests, count);
+
+    if(sync_pending) {
+        storage_process_message_internal(app, &message);
+    }
+}
+
 void storage_process_message(Storage* app, StorageMessage* message) {
-    storage_process_message_internal(app, message);
+    if(message->command == StorageCommandAsync) {
+        storage_process_async(app, message->async_request);
+    } else {
+        storage_process_message_internal(app, message);
+    }
 }
@@ -24,6 +24,10 @@ typedef struct {
     uint16_t sector_size;
     char label[SD_LABEL_LENGTH];
     FS_Error error;
+    uint32_t cache_hits;
+    uint32_t cache_misses;
+    uint32_t cache_written_back;
+    uint32_t cache_write_commands;
 } SDInfo;
 
 const char* sd_api_get_fs_type_text(SDFsType fs_type);
@@ -51,6 +51,8 @@ static bool sd_mount_card(StorageData* storage, bool notify) {
             // bsp error
             storage->status = StorageStatusErrorInternal;
         } else {
+            // card could have been swapped, cached sectors are stale
+            sector_cache_reset(USER_GetSectorCache());
             SDError status = f_mount(sd_data->fs, sd_data->path, 1);
 
             if(status == FR_OK || status == FR_NO_FILESYSTEM) {
@@ -106,6 +108,15 @@ FS_Error sd_unmount_card(StorageData* storage) {
 
     // TODO do i need to close the files?
 
+    // write back cached sectors if card is still there
+    if(hal_sd_detect()) {
+        disk_ioctl(sd_data->fs->drv, CTRL_SYNC, NULL);
+    }
+    uint32_t dropped = sector_cache_reset(USER_GetSectorCache());
+    if(dropped) {
+        FURI_LOG_E(TAG, "%d cached sectors not written back", dropped);
+    }
+
     f_mount(0, sd_data->path, 0);
     storage_data_unlock(storage);
     return storage_ext_parse_error(error);
@@ -208,6 +219,13 @@ FS_Error sd_card_info(StorageData* storage, SDInfo* sd_info) {
         sd_info->cluster_size = fs->csize;
         sd_info->sector_size = sector_size;
 #endif
+
+        SectorCacheStats cache_stats;
+        sector_cache_get_stats(USER_GetSectorCache(), &cache_stats);
+        sd_info->cache_hits = cache_stats.hits;
+        sd_info->cache_misses = cache_stats.misses;
+        sd_info->cache_written_back = cache_stats.written_back;
+        sd_info->cache_write_commands = cache_stats.write_commands;
     }
 
     return storage_ext_parse_error(error);
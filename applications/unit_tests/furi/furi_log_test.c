@@ -0,0 +1,88 @@
+#include <stdio.h>
+#include <string.h>
+#include <furi.h>
+#include <furi_hal.h>
+#include "../minunit.h"
+
+#define FURI_LOG_TEST_OUTPUT_SIZE 1024
+#define FURI_LOG_TEST_TIMEOUT_MS 500
+
+static char furi_log_test_output[FURI_LOG_TEST_OUTPUT_SIZE];
+static volatile size_t furi_log_test_output_length = 0;
+
+static void furi_log_test_puts(const char* data) {
+    size_t length = strlen(data);
+    size_t position = furi_log_test_output_length;
+    length = MIN(length, sizeof(furi_log_test_output) - 1 - position);
+    memcpy(&furi_log_test_output[position], data, length);
+    furi_log_test_output[position + length] = '\0';
+    furi_log_test_output_length = position + length;
+}
+
+/* Wait for drain thread to print expected text */
+static bool furi_log_test_wait_output(const char* expected) {
+    for(size_t i = 0; i < FURI_LOG_TEST_TIMEOUT_MS; i++) {
+        if(strstr(furi_log_test_output, expected)) return true;
+        furi_delay_ms(1);
+    }
+    return false;
+}
+
+void test_furi_log_deferred() {
+    const bool deferred = furi_log_is_deferred();
+    furi_log_test_output[0] = '\0';
+    furi_log_test_output_length = 0;
+    furi_log_set_puts(furi_log_test_puts);
+    furi_log_set_deferred(true);
+
+    /* Captured arguments are formatted same as printf does */
+    char expected[160];
+    const char* word = "deferred";
+    snprintf(
+        expected,
+        sizeof(expected),
+        "[LogTest] %d %5u %-10s| %lld %zu %08lX %c %.2f %*d %.3s %%\r\n",
+        -42,
+        7u,
+        word,
+        -1234567890123LL,
+        (size_t)65535,
+        0xDEADBEEFUL,
+        'Z',
+        3.14159,
+        6,
+        -12,
+        word);
+    furi_log_print(
+        FuriLogLevelError,
+        "[LogTest] %d %5u %-10s| %lld %zu %08lX %c %.2f %*d %.3s %%\r\n",
+        -42,
+        7u,
+        word,
+        -1234567890123LL,
+        (size_t)65535,
+        0xDEADBEEFUL,
+        'Z',
+        3.14159,
+        6,
+        -12,
+        word);
+    bool formatted = furi_log_test_wait_output(expected);
+
+    /* Strings longer than deferred limit are clipped visibly, shorter ones are intact */
+    const char* long_string = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    const char* fit_string = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKL";
+    furi_log_print(FuriLogLevelError, "[LogTest] long <%s>\r\n", long_string);
+    furi_log_print(FuriLogLevelError, "[LogTest] fit <%s>\r\n", fit_string);
+    bool clipped = furi_log_test_wait_output(
+        "[LogTest] long <0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKL\xe2\x80\xa6>\r\n");
+    bool intact = furi_log_test_wait_output(
+        "[LogTest] fit <0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKL>\r\n");
+
+    furi_log_set_deferred(deferred);
+    furi_log_set_puts(furi_hal_console_puts);
+
+    mu_assert(formatted, "deferred arguments formatted incorrectly");
+    mu_assert(clipped, "truncated string is not marked");
+    mu_assert(intact, "string within limit is altered");
+}
@@ -10,6 +10,7 @@
 // we also test that we are linking against stdlib
 extern size_t memmgr_get_free_heap(void);
 extern size_t memmgr_get_minimum_free_heap(void);
+extern size_t memmgr_heap_get_max_free_block();
 
 // current heap managment realization consume:
 // X bytes after allocate and 0 bytes after allocate and free,
@@ -98,3 +99,64 @@ void test_furi_memmgr() {
     free(original_ptr);
     free(ptr);
 }
+
+void test_furi_memmgr_slab() {
+    uint8_t* ptrs[64];
+    const size_t count = sizeof(ptrs) / sizeof(ptrs[0]);
+
+    const size_t heap_size_old = memmgr_get_free_heap();
+    const size_t max_block_old = memmgr_heap_get_max_free_block();
+
+    // small allocations of all size classes, interleaved
+    for(size_t i = 0; i < count; i++) {
+        size_t size = (i * 37) % 256 + 1;
+        ptrs[i] = malloc(size);
+        mu_assert_pointers_not_eq(ptrs[i], NULL);
+        for(size_t j = 0; j < size; j++) {
+            mu_assert_int_eq(ptrs[i][j], 0);
+        }
+        memset(ptrs[i], i, size);
+    }
+
+    // no allocation overwrote another
+    for(size_t i = 0; i < count; i++) {
+        size_t size = (i * 37) % 256 + 1;
+        for(size_t j = 0; j < size; j++) {
+            mu_assert_int_eq(ptrs[i][j], i);
+        }
+    }
+
+    // free every second and reallocate, freed objects must be reused
+    for(size_t i = 0; i < count; i += 2) {
+        free(ptrs[i]);
+    }
+    for(size_t i = 0; i < count; i += 2) {
+        size_t size = (i * 37) % 256 + 1;
+        ptrs[i] = malloc(size);
+        mu_assert_pointers_not_eq(ptrs[i], NULL);
+        for(size_t j = 0; j < size; j++) {
+            mu_assert_int_eq(ptrs[i][j], 0);
+        }
+    }
+
+    // growing slab object copies only old object, not its neighbours
+    const size_t grow_old_size = (1 * 37) % 256 + 1;
+    ptrs[1] = realloc(ptrs[1], 200);
+    mu_assert_pointers_not_eq(ptrs[1], NULL);
+    for(size_t j = 0; j < 200; j++) {
+        mu_assert_int_eq(ptrs[1][j], (j < grow_old_size) ? 1 : 0);
+    }
+    ptrs[1] = realloc(ptrs[1], 8);
+    mu_assert_pointers_not_eq(ptrs[1], NULL);
+    for(size_t j = 0; j < 8; j++) {
+        mu_assert_int_eq(ptrs[1][j], 1);
+    }
+
+    for(size_t i = 0; i < count; i++) {
+        free(ptrs[i]);
+    }
+
+    mu_assert(heap_equal(memmgr_get_free_heap(), heap_size_old), "slab leaked");
+    mu_assert(
+        memmgr_heap_get_max_free_block() >= max_block_old, "small allocations fragmented heap");
+}
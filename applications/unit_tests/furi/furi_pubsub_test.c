@@ -43,3 +43,93 @@ void test_furi_pubsub() {
     // delete pubsub case
     furi_pubsub_free(test_pubsub);
 }
+
+static FuriPubSub* test_pubsub_self = NULL;
+static FuriPubSubSubscription* test_pubsub_self_subscription = NULL;
+static uint32_t test_pubsub_self_count = 0;
+
+void test_pubsub_self_unsubscribe_handler(const void* arg, void* ctx) {
+    UNUSED(arg);
+    UNUSED(ctx);
+    test_pubsub_self_count++;
+    // subscriber can leave from its own callback
+    furi_pubsub_unsubscribe(test_pubsub_self, test_pubsub_self_subscription);
+}
+
+void test_furi_pubsub_queue() {
+    FuriPubSubSubscriptionStats stats;
+    uint32_t value = 0;
+
+    test_pubsub_self = furi_pubsub_alloc();
+    FuriMessageQueue* queue = furi_message_queue_alloc(2, sizeof(uint32_t));
+
+    // deferred subscriber
+    FuriPubSubSubscription* queue_subscription =
+        furi_pubsub_subscribe_queue(test_pubsub_self, queue);
+    test_pubsub_self_subscription = furi_pubsub_subscribe(
+        test_pubsub_self, test_pubsub_self_unsubscribe_handler, (void*)&context_value);
+
+    furi_pubsub_publish(test_pubsub_self, (void*)&notify_value_0);
+    furi_pubsub_publish(test_pubsub_self, (void*)&notify_value_1);
+    furi_pubsub_publish(test_pubsub_self, (void*)&notify_value_1);
+
+    // unsubscribed after first message
+    mu_assert_int_eq(1, test_pubsub_self_count);
+
+    // messages copied to queue, third one dropped
+    mu_assert_int_eq(FuriStatusOk, furi_message_queue_get(queue, &value, 0));
+    mu_assert_int_eq(notify_value_0, value);
+    mu_assert_int_eq(FuriStatusOk, furi_message_queue_get(queue, &value, 0));
+    mu_assert_int_eq(notify_value_1, value);
+    mu_assert_int_not_eq(FuriStatusOk, furi_message_queue_get(queue, &value, 0));
+
+    furi_pubsub_subscription_get_stats(queue_subscription, &stats);
+    mu_assert_int_eq(2, stats.count);
+    mu_assert_int_eq(1, stats.dropped);
+
+    furi_pubsub_unsubscribe(test_pubsub_self, queue_subscription);
+    furi_message_queue_free(queue);
+    furi_pubsub_free(test_pubsub_self);
+}
+
+typedef struct {
+    FuriPubSub* pubsub;
+    volatile bool entered;
+    volatile bool left;
+} TestPubSubSlow;
+
+static void test_pubsub_slow_handler(const void* arg, void* ctx) {
+    UNUSED(arg);
+    TestPubSubSlow* slow = ctx;
+    slow->entered = true;
+    furi_delay_ms(50);
+    slow->left = true;
+}
+
+static int32_t test_pubsub_slow_publisher(void* context) {
+    TestPubSubSlow* slow = context;
+    furi_pubsub_publish(slow->pubsub, (void*)&notify_value_0);
+    return 0;
+}
+
+void test_furi_pubsub_unsubscribe_wait() {
+    TestPubSubSlow slow = {.pubsub = furi_pubsub_alloc()};
+    FuriPubSubSubscription* subscription =
+        furi_pubsub_subscribe(slow.pubsub, test_pubsub_slow_handler, &slow);
+
+    FuriThread* thread = furi_thread_alloc();
+    furi_thread_set_name(thread, "PubSubTest");
+    furi_thread_set_stack_size(thread, 1024);
+    furi_thread_set_callback(thread, test_pubsub_slow_publisher);
+    furi_thread_set_context(thread, &slow);
+    furi_thread_start(thread);
+
+    // unsubscribe returns only after callback in publisher thread is done
+    while(!slow.entered) furi_delay_tick(1);
+    furi_pubsub_unsubscribe(slow.pubsub, subscription);
+    mu_check(slow.left);
+
+    furi_thread_join(thread);
+    furi_thread_free(thread);
+    furi_pubsub_free(slow.pubsub);
+}
@@ -8,8 +8,13 @@ void test_furi_create_open();
 void test_furi_valuemutex();
 void test_furi_concurrent_access();
 void test_furi_pubsub();
+void test_furi_pubsub_queue();
+void test_furi_pubsub_unsubscribe_wait();
 
 void test_furi_memmgr();
+void test_furi_memmgr_slab();
+void test_furi_thread_arena();
+void test_furi_log_deferred();
 
 static int foo = 0;
 
@@ -38,12 +43,32 @@ MU_TEST(mu_test_furi_pubsub) {
     test_furi_pubsub();
 }
 
+MU_TEST(mu_test_furi_pubsub_queue) {
+    test_furi_pubsub_queue();
+}
+
+MU_TEST(mu_test_furi_pubsub_unsubscribe_wait) {
+    test_furi_pubsub_unsubscribe_wait();
+}
+
 MU_TEST(mu_test_furi_memmgr) {
     // this test is not accurate, but gives a basic understanding
     // that memory management is working fine
     test_furi_memmgr();
 }
 
+MU_TEST(mu_test_furi_memmgr_slab) {
+    test_furi_memmgr_slab();
+}
+
+MU_TEST(mu_test_furi_thread_arena) {
+    test_furi_thread_arena();
+}
+
+MU_TEST(mu_test_furi_log_deferred) {
+    test_furi_log_deferred();
+}
+
 MU_TEST_SUITE(test_suite) {
     MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
 
@@ -53,7 +78,12 @@ MU_TEST_SUITE(test_suite) {
     MU_RUN_TEST(mu_test_furi_create_open);
     MU_RUN_TEST(mu_test_furi_valuemutex);
     MU_RUN_TEST(mu_test_furi_pubsub);
+    MU_RUN_TEST(mu_test_furi_pubsub_queue);
+    MU_RUN_TEST(mu_test_furi_pubsub_unsubscribe_wait);
     MU_RUN_TEST(mu_test_furi_memmgr);
+    MU_RUN_TEST(mu_test_furi_memmgr_slab);
+    MU_RUN_TEST(mu_test_furi_thread_arena);
+    MU_RUN_TEST(mu_test_furi_log_deferred);
 }
 
 int run_minunit_test_furi() {
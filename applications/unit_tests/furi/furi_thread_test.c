@@ -0,0 +1,58 @@
+#include <furi.h>
+#include "../minunit.h"
+
+#define ARENA_TEST_LEFT_SIZE 300
+#define ARENA_TEST_COUNT 32
+
+static int32_t furi_thread_arena_test_thread(void* context) {
+    void** left = context;
+
+    // freed allocations are not counted
+    void* ptrs[ARENA_TEST_COUNT];
+    for(size_t i = 0; i < ARENA_TEST_COUNT; i++) {
+        ptrs[i] = malloc(i + 1);
+    }
+    for(size_t i = 0; i < ARENA_TEST_COUNT; i++) {
+        free(ptrs[i]);
+    }
+
+    // left to other thread
+    *left = malloc(ARENA_TEST_LEFT_SIZE);
+    memset(*left, 0xA5, ARENA_TEST_LEFT_SIZE);
+    return 0;
+}
+
+static void test_furi_thread_arena_run(bool release) {
+    void* left = NULL;
+    FuriThread* thread = furi_thread_alloc();
+    furi_thread_set_name(thread, "ArenaTest");
+    furi_thread_set_stack_size(thread, 1024);
+    furi_thread_set_callback(thread, furi_thread_arena_test_thread);
+    furi_thread_set_context(thread, &left);
+    furi_thread_enable_heap_arena(thread, release);
+
+    size_t heap_before = memmgr_get_free_heap();
+    furi_thread_start(thread);
+    furi_thread_join(thread);
+    // let idle task free thread stack
+    furi_delay_ms(10);
+
+    mu_assert_pointers_not_eq(left, NULL);
+    mu_assert_int_eq(ARENA_TEST_LEFT_SIZE, furi_thread_get_heap_size(thread));
+
+    if(release) {
+        // released on exit, can't be touched anymore
+        mu_assert(memmgr_get_free_heap() >= heap_before - 64, "arena was not released");
+    } else {
+        // still owned by us
+        mu_assert_int_eq(0xA5, ((uint8_t*)left)[ARENA_TEST_LEFT_SIZE - 1]);
+        free(left);
+    }
+
+    furi_thread_free(thread);
+}
+
+void test_furi_thread_arena() {
+    test_furi_thread_arena_run(false);
+    test_furi_thread_arena_run(true);
+}
@@ -0,0 +1,186 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include "../minunit.h"
+
+#define CRYPTO_TEST_LARGE_SIZE (4096 + 7)
+
+/* NIST SP 800-38A F.5.5 CTR-AES256.Encrypt */
+static const uint8_t crypto_test_ctr_key[FURI_HAL_CRYPTO_KEY_SIZE] = {
+    0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe, 0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+    0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7, 0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4,
+};
+
+static const uint8_t crypto_test_ctr_iv[FURI_HAL_CRYPTO_CTR_IV_SIZE] = {
+    0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff,
+};
+
+static const uint8_t crypto_test_ctr_plain[64] = {
+    0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+    0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+    0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+    0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10,
+};
+
+static const uint8_t crypto_test_ctr_cipher[64] = {
+    0x60, 0x1e, 0xc3, 0x13, 0x77, 0x57, 0x89, 0xa5, 0xb7, 0xa7, 0xf5, 0x04, 0xbb, 0xf3, 0xd2, 0x28,
+    0xf4, 0x43, 0xe3, 0xca, 0x4d, 0x62, 0xb5, 0x9a, 0xca, 0x84, 0xe9, 0x90, 0xca, 0xca, 0xf5, 0xc5,
+    0x2b, 0x09, 0x30, 0xda, 0xa2, 0x3d, 0xe9, 0x4c, 0xe8, 0x70, 0x17, 0xba, 0x2d, 0x84, 0x98, 0x8d,
+    0xdf, 0xc9, 0xc5, 0x8d, 0xb6, 0x7a, 0xad, 0xa6, 0x13, 0xc2, 0xdd, 0x08, 0x45, 0x79, 0x41, 0xa6,
+};
+
+/* GCM spec test case 16, AES-256 with partial last blocks of AAD and payload */
+static const uint8_t crypto_test_gcm_key[FURI_HAL_CRYPTO_KEY_SIZE] = {
+    0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08,
+    0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08,
+};
+
+static const uint8_t crypto_test_gcm_iv[FURI_HAL_CRYPTO_GCM_IV_SIZE] = {
+    0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad, 0xde, 0xca, 0xf8, 0x88,
+};
+
+static const uint8_t crypto_test_gcm_aad[20] = {
+    0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 0xfe, 0xed,
+    0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 0xab, 0xad, 0xda, 0xd2,
+};
+
+static const uint8_t crypto_test_gcm_plain[60] = {
+    0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5, 0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26,
+    0x9a, 0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda, 0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31,
+    0x8a, 0x72, 0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53, 0x2f, 0xcf, 0x0e, 0x24, 0x49,
+    0xa6, 0xb5, 0x25, 0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57, 0xba, 0x63, 0x7b, 0x39,
+};
+
+static const uint8_t crypto_test_gcm_cipher[60] = {
+    0x52, 0x2d, 0xc1, 0xf0, 0x99, 0x56, 0x7d, 0x07, 0xf4, 0x7f, 0x37, 0xa3, 0x2a, 0x84, 0x42,
+    0x7d, 0x64, 0x3a, 0x8c, 0xdc, 0xbf, 0xe5, 0xc0, 0xc9, 0x75, 0x98, 0xa2, 0xbd, 0x25, 0x55,
+    0xd1, 0xaa, 0x8c, 0xb0, 0x8e, 0x48, 0x59, 0x0d, 0xbb, 0x3d, 0xa7, 0xb0, 0x8b, 0x10, 0x56,
+    0x82, 0x88, 0x38, 0xc5, 0xf6, 0x1e, 0x63, 0x93, 0xba, 0x7a, 0x0a, 0xbc, 0xc9, 0xf6, 0x62,
+};
+
+static const uint8_t crypto_test_gcm_tag[FURI_HAL_CRYPTO_GCM_TAG_SIZE] = {
+    0x76, 0xfc, 0x6e, 0xce, 0x0f, 0x4e, 0x17, 0x68, 0xcd, 0xdf, 0x88, 0x53, 0xbb, 0x2d, 0x55, 0x1b,
+};
+
+MU_TEST(furi_hal_crypto_ctr_test) {
+    uint8_t output[sizeof(crypto_test_ctr_plain)];
+
+    mu_check(furi_hal_crypto_ctr(
+        crypto_test_ctr_key,
+        crypto_test_ctr_iv,
+        crypto_test_ctr_plain,
+        output,
+        sizeof(crypto_test_ctr_plain)));
+    mu_assert_int_eq(memcmp(crypto_test_ctr_cipher, output, sizeof(crypto_test_ctr_cipher)), 0);
+
+    // Stream in parts, in place, with partial last part
+    memcpy(output, crypto_test_ctr_cipher, sizeof(output));
+    mu_check(furi_hal_crypto_ctr_start(crypto_test_ctr_key, crypto_test_ctr_iv));
+    mu_check(furi_hal_crypto_ctr_update(output, output, 16));
+    mu_check(furi_hal_crypto_ctr_update(&output[16], &output[16], 32));
+    mu_check(furi_hal_crypto_ctr_update(&output[48], &output[48], 13));
+    furi_hal_crypto_ctr_finish();
+    mu_assert_int_eq(memcmp(crypto_test_ctr_plain, output, 61), 0);
+}
+
+MU_TEST(furi_hal_crypto_gcm_test) {
+    uint8_t output[sizeof(crypto_test_gcm_plain)];
+    uint8_t tag[FURI_HAL_CRYPTO_GCM_TAG_SIZE];
+
+    mu_check(furi_hal_crypto_gcm_encrypt(
+        crypto_test_gcm_key,
+        crypto_test_gcm_iv,
+        crypto_test_gcm_aad,
+        sizeof(crypto_test_gcm_aad),
+        crypto_test_gcm_plain,
+        output,
+        sizeof(crypto_test_gcm_plain),
+        tag));
+    mu_assert_int_eq(memcmp(crypto_test_gcm_cipher, output, sizeof(crypto_test_gcm_cipher)), 0);
+    mu_assert_int_eq(memcmp(crypto_test_gcm_tag, tag, sizeof(crypto_test_gcm_tag)), 0);
+
+    mu_check(furi_hal_crypto_gcm_decrypt(
+        crypto_test_gcm_key,
+        crypto_test_gcm_iv,
+        crypto_test_gcm_aad,
+        sizeof(crypto_test_gcm_aad),
+        crypto_test_gcm_cipher,
+        output,
+        sizeof(crypto_test_gcm_cipher),
+        crypto_test_gcm_tag));
+    mu_assert_int_eq(memcmp(crypto_test_gcm_plain, output, sizeof(crypto_test_gcm_plain)), 0);
+
+    // Tampered tag must be rejected
+    tag[0] ^= 0x01;
+    mu_check(!furi_hal_crypto_gcm_decrypt(
+        crypto_test_gcm_key,
+        crypto_test_gcm_iv,
+        crypto_test_gcm_aad,
+        sizeof(crypto_test_gcm_aad),
+        crypto_test_gcm_cipher,
+        output,
+        sizeof(crypto_test_gcm_cipher),
+        tag));
+}
+
+MU_TEST(furi_hal_crypto_dma_test) {
+    // Aligned buffers go through DMA, odd offset forces block by block path
+    uint8_t* plain = malloc(CRYPTO_TEST_LARGE_SIZE);
+    uint8_t* dma_output = malloc(CRYPTO_TEST_LARGE_SIZE);
+    uint8_t* cpu_output = malloc(CRYPTO_TEST_LARGE_SIZE + 1);
+    furi_hal_random_fill_buf(plain, CRYPTO_TEST_LARGE_SIZE);
+
+    mu_check(furi_hal_crypto_ctr(
+        crypto_test_ctr_key, crypto_test_ctr_iv, plain, dma_output, CRYPTO_TEST_LARGE_SIZE));
+    mu_check(furi_hal_crypto_ctr(
+        crypto_test_ctr_key, crypto_test_ctr_iv, plain, &cpu_output[1], CRYPTO_TEST_LARGE_SIZE));
+    mu_assert_int_eq(memcmp(dma_output, &cpu_output[1], CRYPTO_TEST_LARGE_SIZE), 0);
+
+    uint8_t dma_tag[FURI_HAL_CRYPTO_GCM_TAG_SIZE];
+    uint8_t cpu_tag[FURI_HAL_CRYPTO_GCM_TAG_SIZE];
+    mu_check(furi_hal_crypto_gcm_encrypt(
+        crypto_test_gcm_key,
+        crypto_test_gcm_iv,
+        NULL,
+        0,
+        plain,
+        dma_output,
+        CRYPTO_TEST_LARGE_SIZE,
+        dma_tag));
+    mu_check(furi_hal_crypto_gcm_encrypt(
+        crypto_test_gcm_key,
+        crypto_test_gcm_iv,
+        NULL,
+        0,
+        plain,
+        &cpu_output[1],
+        CRYPTO_TEST_LARGE_SIZE,
+        cpu_tag));
+    mu_assert_int_eq(memcmp(dma_output, &cpu_output[1], CRYPTO_TEST_LARGE_SIZE), 0);
+    mu_assert_int_eq(memcmp(dma_tag, cpu_tag, FURI_HAL_CRYPTO_GCM_TAG_SIZE), 0);
+
+    mu_check(furi_hal_crypto_gcm_decrypt(
+        crypto_test_gcm_key,
+        crypto_test_gcm_iv,
+        NULL,
+        0,
+        dma_output,
+        dma_output,
+        CRYPTO_TEST_LARGE_SIZE,
+        dma_tag));
+    mu_assert_int_eq(memcmp(plain, dma_output, CRYPTO_TEST_LARGE_SIZE), 0);
+
+    free(cpu_output);
+    free(dma_output);
+    free(plain);
+}
+
+MU_TEST_SUITE(furi_hal_crypto_suite) {
+    MU_RUN_TEST(furi_hal_crypto_ctr_test);
+    MU_RUN_TEST(furi_hal_crypto_gcm_test);
+    MU_RUN_TEST(furi_hal_crypto_dma_test);
+}
+
+int run_minunit_test_furi_hal_crypto() {
+    MU_RUN_SUITE(furi_hal_crypto_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,99 @@
+#include "../minunit.h"
+#include <furi.h>
+#include <storage/storage.h>
+#include <update_util/lfs_backup.h>
+
+#define LFS_BACKUP_TEST_DIR "/ext/unit_tests_lfs_backup"
+#define LFS_BACKUP_TEST_ARCHIVE LFS_BACKUP_TEST_DIR "/" LFS_BACKUP_DEFAULT_FILENAME
+#define LFS_BACKUP_TEST_OLD_ARCHIVE LFS_BACKUP_TEST_DIR "/old.tar"
+#define LFS_BACKUP_TEST_FILE "/int/.lfs_backup_test"
+#define LFS_BACKUP_TEST_EXTRA_FILE "/int/.lfs_backup_test_extra"
+
+static void lfs_backup_test_write(Storage* storage, const char* path, const char* data) {
+    File* file = storage_file_alloc(storage);
+    furi_check(storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    furi_check(storage_file_write(file, data, strlen(data)) == strlen(data));
+    storage_file_close(file);
+    storage_file_free(file);
+}
+
+static bool lfs_backup_test_check(Storage* storage, const char* path, const char* data) {
+    char buffer[16] = {0};
+    File* file = storage_file_alloc(storage);
+    bool result = storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING) &&
+                  (storage_file_read(file, buffer, sizeof(buffer) - 1) == strlen(data)) &&
+                  !strcmp(buffer, data);
+    storage_file_close(file);
+    storage_file_free(file);
+    return result;
+}
+
+static void lfs_backup_test_setup() {
+    Storage* storage = furi_record_open("storage");
+    storage_simply_remove_recursive(storage, LFS_BACKUP_TEST_DIR);
+    furi_check(storage_simply_mkdir(storage, LFS_BACKUP_TEST_DIR));
+    furi_record_close("storage");
+}
+
+static void lfs_backup_test_teardown() {
+    Storage* storage = furi_record_open("storage");
+    storage_simply_remove(storage, LFS_BACKUP_TEST_FILE);
+    storage_simply_remove(storage, LFS_BACKUP_TEST_EXTRA_FILE);
+    storage_simply_remove_recursive(storage, LFS_BACKUP_TEST_DIR);
+    furi_record_close("storage");
+}
+
+MU_TEST(test_lfs_backup_incremental_restore) {
+    Storage* storage = furi_record_open("storage");
+
+    lfs_backup_test_write(storage, LFS_BACKUP_TEST_FILE, "base");
+    mu_check(lfs_backup_create(storage, LFS_BACKUP_TEST_ARCHIVE));
+
+    lfs_backup_test_write(storage, LFS_BACKUP_TEST_FILE, "increment");
+    mu_check(lfs_backup_create_incremental(storage, LFS_BACKUP_TEST_ARCHIVE));
+    mu_check(
+        storage_common_stat(storage, LFS_BACKUP_TEST_ARCHIVE LFS_BACKUP_INCREMENT_SUFFIX, NULL) ==
+        FSE_OK);
+
+    lfs_backup_test_write(storage, LFS_BACKUP_TEST_FILE, "lost");
+    mu_check(lfs_backup_unpack(storage, LFS_BACKUP_TEST_ARCHIVE));
+    mu_check(lfs_backup_test_check(storage, LFS_BACKUP_TEST_FILE, "increment"));
+
+    furi_record_close("storage");
+}
+
+MU_TEST(test_lfs_backup_replaced_base) {
+    Storage* storage = furi_record_open("storage");
+
+    lfs_backup_test_write(storage, LFS_BACKUP_TEST_FILE, "base");
+    mu_check(lfs_backup_create(storage, LFS_BACKUP_TEST_ARCHIVE));
+    lfs_backup_test_write(storage, LFS_BACKUP_TEST_FILE, "increment");
+    mu_check(lfs_backup_create_incremental(storage, LFS_BACKUP_TEST_ARCHIVE));
+
+    /* Older archive of different size copied over base, snapshot is stale now */
+    lfs_backup_test_write(storage, LFS_BACKUP_TEST_FILE, "old");
+    lfs_backup_test_write(storage, LFS_BACKUP_TEST_EXTRA_FILE, "extra");
+    mu_check(lfs_backup_create(storage, LFS_BACKUP_TEST_OLD_ARCHIVE));
+    mu_check(storage_simply_remove(storage, LFS_BACKUP_TEST_ARCHIVE));
+    mu_check(
+        storage_common_copy(storage, LFS_BACKUP_TEST_OLD_ARCHIVE, LFS_BACKUP_TEST_ARCHIVE) ==
+        FSE_OK);
+
+    lfs_backup_test_write(storage, LFS_BACKUP_TEST_FILE, "lost");
+    mu_check(lfs_backup_unpack(storage, LFS_BACKUP_TEST_ARCHIVE));
+    mu_check(lfs_backup_test_check(storage, LFS_BACKUP_TEST_FILE, "old"));
+
+    furi_record_close("storage");
+}
+
+MU_TEST_SUITE(test_lfs_backup_suite) {
+    MU_SUITE_CONFIGURE(&lfs_backup_test_setup, &lfs_backup_test_teardown);
+
+    MU_RUN_TEST(test_lfs_backup_incremental_restore);
+    MU_RUN_TEST(test_lfs_backup_replaced_base);
+}
+
+int run_minunit_test_lfs_backup() {
+    MU_RUN_SUITE(test_lfs_backup_suite);
+    return MU_EXIT_CODE;
+}
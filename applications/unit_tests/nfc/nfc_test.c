@@ -3,7 +3,10 @@
 #include <applications/storage/storage.h>
 #include <lib/flipper_format/flipper_format.h>
 #include <lib/nfc_protocols/nfca.h>
+#include <lib/nfc_protocols/crypto1.h>
+#include <lib/nfc_protocols/nfc_util.h>
 #include <lib/digital_signal/digital_signal.h>
+#include <applications/nfc/helpers/nfc_mf_classic_nonces.h>
 
 #include <lib/flipper_format/flipper_format_i.h>
 #include <lib/toolbox/stream/file_stream.h>
@@ -15,6 +18,7 @@
 #define NFC_TEST_RESOURCES_DIR "/ext/unit_tests/nfc/"
 #define NFC_TEST_SIGNAL_SHORT_FILE "nfc_nfca_signal_short.nfc"
 #define NFC_TEST_SIGNAL_LONG_FILE "nfc_nfca_signal_long.nfc"
+#define NFC_TEST_NONCES_FILE "/ext/.unit_tests_nfc_nonces.bin"
 
 static const char* nfc_test_file_type = "Flipper NFC test";
 static const uint32_t nfc_test_file_version = 1;
@@ -170,10 +174,186 @@ MU_TEST(nfc_digital_signal_test) {
         "NFC long digital signal test failed\r\n");
 }
 
+MU_TEST(nfc_crypto1_batch_test) {
+    uint64_t keys[CRYPTO1_BATCH_SIZE];
+    uint32_t seed = 0x12345678;
+    for(size_t i = 0; i < CRYPTO1_BATCH_SIZE; i++) {
+        seed = prng_successor(seed, 32);
+        keys[i] = ((uint64_t)seed << 16 ^ prng_successor(seed, 16)) & 0xFFFFFFFFFFFF;
+    }
+    keys[21] = keys[5];
+
+    /* Reader side of authentication with keys[5] */
+    const uint32_t cuid = 0xDEADBEEF;
+    const uint32_t nt = 0x01020304;
+    const uint32_t nr = 0xCAFEBABE;
+    Crypto1 crypto;
+    crypto1_init(&crypto, keys[5]);
+    crypto1_word(&crypto, cuid ^ nt, 0);
+    const uint32_t nr_enc = nr ^ crypto1_word(&crypto, nr, 0);
+    const uint32_t ar_enc = prng_successor(nt, 64) ^ crypto1_word(&crypto, 0, 0);
+
+    uint32_t expected = 0;
+    for(size_t i = 0; i < CRYPTO1_BATCH_SIZE; i++) {
+        expected |= (uint32_t)crypto1_check_reader_auth(keys[i], cuid, nt, nr_enc, ar_enc) << i;
+    }
+    mu_assert_int_eq((1 << 5) | (1 << 21), expected);
+
+    uint32_t start = DWT->CYCCNT;
+    uint32_t found =
+        crypto1_batch_check_reader_auth(keys, CRYPTO1_BATCH_SIZE, cuid, nt, nr_enc, ar_enc);
+    uint32_t time = (DWT->CYCCNT - start) / furi_hal_cortex_instructions_per_microsecond();
+    mu_assert_int_eq(expected, found);
+    FURI_LOG_I(TAG, "Crypto1 batch of %d keys: %d us", CRYPTO1_BATCH_SIZE, time);
+
+    found = crypto1_batch_check_reader_auth(keys, 16, cuid, nt, nr_enc, ar_enc);
+    mu_assert_int_eq(1 << 5, found);
+    found = crypto1_batch_check_reader_auth(keys, 32, cuid, nt, nr_enc, ar_enc ^ 1);
+    mu_assert_int_eq(0, found);
+}
+
+MU_TEST(nfc_crypto1_keystream_test) {
+    Crypto1 reference;
+    Crypto1 crypto;
+    Crypto1Keystream keystream;
+    crypto1_init(&reference, 0xA0A1A2A3A4A5);
+    crypto1_word(&reference, 0xDEADBEEF, 0);
+    crypto = reference;
+    crypto1_keystream_reset(&keystream);
+
+    /* Read response, then ACK, then read response with buffer filled ahead */
+    uint8_t plain[18];
+    uint8_t encrypted[18];
+    uint8_t parity[3];
+    const uint16_t frame_bits[] = {sizeof(plain) * 8, 4, sizeof(plain) * 8};
+    for(size_t frame = 0; frame < COUNT_OF(frame_bits); frame++) {
+        for(size_t i = 0; i < sizeof(plain); i++) {
+            plain[i] = frame * 0x40 + i;
+        }
+        if(frame == 2) {
+            crypto1_keystream_fill(&crypto, &keystream);
+        }
+        const uint16_t bits = frame_bits[frame];
+        crypto1_keystream_encrypt(&crypto, &keystream, plain, bits, encrypted, parity);
+
+        if(bits < 8) {
+            uint8_t expected = 0;
+            for(size_t i = 0; i < bits; i++) {
+                expected |= (crypto1_bit(&reference, 0, 0) ^ FURI_BIT(plain[0], i)) << i;
+            }
+            mu_assert_int_eq(expected, encrypted[0]);
+        } else {
+            for(size_t i = 0; i < bits / 8; i++) {
+                mu_assert_int_eq(crypto1_byte(&reference, 0, 0) ^ plain[i], encrypted[i]);
+                uint8_t expected_parity = crypto1_filter(reference.odd) ^
+                                          nfc_util_odd_parity8(plain[i]);
+                mu_assert_int_eq(expected_parity & 0x01, FURI_BIT(parity[i / 8], 7 - i % 8));
+            }
+        }
+    }
+
+    uint8_t decrypted[18];
+    crypto1_keystream_decrypt(&crypto, &keystream, encrypted, sizeof(encrypted) * 8, decrypted);
+    for(size_t i = 0; i < sizeof(decrypted); i++) {
+        mu_assert_int_eq(crypto1_byte(&reference, 0, 0) ^ encrypted[i], decrypted[i]);
+    }
+}
+
+static void
+    nfc_test_nonces_fill(MfClassicNonce* nonces, size_t count, uint32_t cuid, uint32_t nt) {
+    for(size_t i = 0; i < count; i++) {
+        nonces[i].cuid = cuid;
+        nonces[i].nt = nt + i;
+        nonces[i].nr = ~(nt + i);
+        nonces[i].ar = 0xA5A5A5A5;
+        nonces[i].sector = i % 16;
+        nonces[i].key_type = (i & 1) ? MfClassicKeyB : MfClassicKeyA;
+    }
+}
+
+MU_TEST(nfc_mf_classic_nonces_filter_test) {
+    Storage* storage = nfc_test->storage;
+    storage_simply_remove(storage, NFC_TEST_NONCES_FILE);
+    MfClassicNonce* saved = malloc(sizeof(MfClassicNonce) * NFC_MF_CLASSIC_NONCES_MAX);
+    MfClassicNonce* loaded = malloc(sizeof(MfClassicNonce) * NFC_MF_CLASSIC_NONCES_MAX);
+
+    mu_assert_int_eq(
+        0, nfc_mf_classic_nonces_load(storage, NFC_TEST_NONCES_FILE, 0x11223344, loaded));
+
+    /* Captures of two cards interleaved, only requested card is loaded */
+    nfc_test_nonces_fill(saved, 4, 0x11223344, 0x1000);
+    mu_assert(nfc_mf_classic_nonces_save(storage, NFC_TEST_NONCES_FILE, saved, 4), "save failed");
+    nfc_test_nonces_fill(saved, 3, 0xDEADBEEF, 0x2000);
+    mu_assert(nfc_mf_classic_nonces_save(storage, NFC_TEST_NONCES_FILE, saved, 3), "save failed");
+    nfc_test_nonces_fill(saved, 2, 0x11223344, 0x1004);
+    mu_assert(nfc_mf_classic_nonces_save(storage, NFC_TEST_NONCES_FILE, saved, 2), "save failed");
+
+    mu_assert_int_eq(
+        6, nfc_mf_classic_nonces_load(storage, NFC_TEST_NONCES_FILE, 0x11223344, loaded));
+    for(size_t i = 0; i < 6; i++) {
+        mu_assert_int_eq(0x11223344, loaded[i].cuid);
+        mu_assert_int_eq(0x1000 + i, loaded[i].nt);
+        mu_assert_int_eq(~(0x1000 + i), loaded[i].nr);
+        mu_assert_int_eq(0xA5A5A5A5, loaded[i].ar);
+    }
+    mu_assert_int_eq(3, loaded[4].sector);
+    mu_assert_int_eq(MfClassicKeyB, loaded[5].key_type);
+    mu_assert_int_eq(
+        3, nfc_mf_classic_nonces_load(storage, NFC_TEST_NONCES_FILE, 0xDEADBEEF, loaded));
+    mu_assert_int_eq(0x2002, loaded[2].nt);
+
+    free(loaded);
+    free(saved);
+    storage_simply_remove(storage, NFC_TEST_NONCES_FILE);
+}
+
+MU_TEST(nfc_mf_classic_nonces_bound_test) {
+    Storage* storage = nfc_test->storage;
+    storage_simply_remove(storage, NFC_TEST_NONCES_FILE);
+    MfClassicNonce* saved = malloc(sizeof(MfClassicNonce) * NFC_MF_CLASSIC_NONCES_MAX);
+    MfClassicNonce* loaded = malloc(sizeof(MfClassicNonce) * NFC_MF_CLASSIC_NONCES_MAX);
+
+    /* Fill file past its bound, oldest captures are overwritten */
+    const size_t total = NFC_MF_CLASSIC_NONCES_FILE_MAX + NFC_MF_CLASSIC_NONCES_MAX / 2;
+    for(size_t i = 0; i < total; i += NFC_MF_CLASSIC_NONCES_MAX) {
+        nfc_test_nonces_fill(saved, NFC_MF_CLASSIC_NONCES_MAX, 0x11223344, i);
+        mu_assert(
+            nfc_mf_classic_nonces_save(
+                storage, NFC_TEST_NONCES_FILE, saved, MIN(NFC_MF_CLASSIC_NONCES_MAX, total - i)),
+            "save failed");
+    }
+    FileInfo info_full;
+    FileInfo info;
+    mu_assert_int_eq(FSE_OK, storage_common_stat(storage, NFC_TEST_NONCES_FILE, &info_full));
+    nfc_test_nonces_fill(saved, NFC_MF_CLASSIC_NONCES_MAX, 0xDEADBEEF, 0);
+    mu_assert(
+        nfc_mf_classic_nonces_save(storage, NFC_TEST_NONCES_FILE, saved, 1), "save failed");
+    mu_assert_int_eq(FSE_OK, storage_common_stat(storage, NFC_TEST_NONCES_FILE, &info));
+    mu_assert(info.size == info_full.size, "capture file is not bound");
+
+    /* Newest captures are loaded in capture order */
+    mu_assert_int_eq(
+        NFC_MF_CLASSIC_NONCES_MAX,
+        nfc_mf_classic_nonces_load(storage, NFC_TEST_NONCES_FILE, 0x11223344, loaded));
+    size_t oldest_index = total % NFC_MF_CLASSIC_NONCES_MAX;
+    for(size_t i = 0; i < NFC_MF_CLASSIC_NONCES_MAX; i++) {
+        const MfClassicNonce* nonce = &loaded[(oldest_index + i) % NFC_MF_CLASSIC_NONCES_MAX];
+        mu_assert_int_eq(total - NFC_MF_CLASSIC_NONCES_MAX + i, nonce->nt);
+    }
+
+    free(loaded);
+    free(saved);
+    storage_simply_remove(storage, NFC_TEST_NONCES_FILE);
+}
+
 MU_TEST_SUITE(nfc) {
     nfc_test_alloc();
 
     MU_RUN_TEST(nfc_digital_signal_test);
+    MU_RUN_TEST(nfc_crypto1_batch_test);
+    MU_RUN_TEST(nfc_crypto1_keystream_test);
+    MU_RUN_TEST(nfc_mf_classic_nonces_filter_test);
+    MU_RUN_TEST(nfc_mf_classic_nonces_bound_test);
 
     nfc_test_free();
 }
@@ -1316,6 +1316,39 @@ MU_TEST(test_storage_md5sum) {
     test_storage_md5sum_run(TEST_DIR "file2.txt", ++command_id, md5sum2, PB_CommandStatus_OK);
 }
 
+MU_TEST(test_storage_md5sum_ping_concurrent) {
+    char md5sum[MD5SUM_SIZE * 2 + 1] = {0};
+    test_create_file(TEST_DIR "file1.txt", 64 * 1024);
+    test_storage_calculate_md5sum(TEST_DIR "file1.txt", md5sum);
+
+    MsgList_t input_msg_list;
+    MsgList_init(input_msg_list);
+    MsgList_t expected_msg_list;
+    MsgList_init(expected_msg_list);
+
+    uint32_t md5sum_id = ++command_id;
+    test_rpc_create_simple_message(
+        MsgList_push_new(input_msg_list),
+        PB_Main_storage_md5sum_request_tag,
+        TEST_DIR "file1.txt",
+        md5sum_id);
+    test_rpc_add_ping_to_list(input_msg_list, PING_REQUEST, ++command_id);
+
+    /* ping is received after md5sum, but answered while storage lane still reads file */
+    test_rpc_add_ping_to_list(expected_msg_list, PING_RESPONSE, command_id);
+    test_rpc_create_simple_message(
+        MsgList_push_new(expected_msg_list),
+        PB_Main_storage_md5sum_response_tag,
+        md5sum,
+        md5sum_id);
+
+    test_rpc_encode_and_feed(input_msg_list, 0);
+    test_rpc_decode_and_compare(expected_msg_list, 0);
+
+    test_rpc_free_msg_list(input_msg_list);
+    test_rpc_free_msg_list(expected_msg_list);
+}
+
 static void test_rpc_storage_rename_run(
     const char* old_path,
     const char* new_path,
@@ -1419,11 +1452,142 @@ MU_TEST(test_system_protobuf_version) {
     test_rpc_free_msg_list(expected_msg_list);
 }
 
+MU_TEST(test_system_device_info_lane_stats) {
+    MsgList_t input_msg_list;
+    MsgList_init(input_msg_list);
+    MsgList_t expected_msg_list;
+    MsgList_init(expected_msg_list);
+
+    test_rpc_add_ping_to_list(input_msg_list, PING_REQUEST, ++command_id);
+    test_rpc_add_ping_to_list(expected_msg_list, PING_RESPONSE, command_id);
+    test_rpc_encode_and_feed(input_msg_list, 0);
+    test_rpc_decode_and_compare(expected_msg_list, 0);
+
+    PB_Main request = {
+        .command_id = ++command_id,
+        .command_status = PB_CommandStatus_OK,
+        .cb_content.funcs.decode = NULL,
+        .has_next = false,
+        .which_content = PB_Main_system_device_info_request_tag,
+    };
+    test_rpc_encode_and_feed_one(&request, 0);
+
+    rpc_session[0].timeout = xTaskGetTickCount() + MAX_RECEIVE_OUTPUT_TIMEOUT;
+    pb_istream_t istream = {
+        .callback = test_rpc_pb_stream_read,
+        .state = &rpc_session[0],
+        .errmsg = NULL,
+        .bytes_left = 0x7FFFFFFF,
+    };
+    PB_Main result = {.cb_content.funcs.decode = NULL};
+    bool has_next = true;
+    bool system_commands_found = false;
+    while(has_next) {
+        if(!pb_decode_ex(&istream, &PB_Main_msg, &result, PB_DECODE_DELIMITED)) {
+            mu_fail("device info response not complete");
+            break;
+        }
+        mu_check(result.command_id == command_id);
+        mu_check(result.which_content == PB_Main_system_device_info_response_tag);
+        const char* key = result.content.system_device_info_response.key;
+        const char* value = result.content.system_device_info_response.value;
+        if(!strcmp(key, "rpc_system_commands")) {
+            /* ping is counted before device info runs, both go to system lane */
+            mu_check(atoi(value) >= 1);
+            system_commands_found = true;
+        }
+        has_next = result.has_next;
+        pb_release(&PB_Main_msg, &result);
+    }
+    mu_check(system_commands_found);
+
+    test_rpc_free_msg_list(input_msg_list);
+    test_rpc_free_msg_list(expected_msg_list);
+}
+
+#define TEST_GUI_FRAME_SIZE 1024
+
+static bool test_rpc_gui_delta_decode(
+    const uint8_t* delta,
+    size_t delta_size,
+    const uint8_t* prev_frame,
+    uint8_t* frame,
+    size_t size) {
+    size_t delta_pos = 0;
+    size_t frame_pos = 0;
+    memcpy(frame, prev_frame, size);
+
+    while(delta_pos < delta_size) {
+        uint8_t control = delta[delta_pos++];
+        size_t run = (control & 0x7F) + 1;
+        if(frame_pos + run > size) return false;
+        if(!(control & 0x80)) {
+            if(delta_pos + run > delta_size) return false;
+            for(size_t i = 0; i < run; i++) {
+                frame[frame_pos + i] ^= delta[delta_pos++];
+            }
+        }
+        frame_pos += run;
+    }
+
+    return frame_pos == size;
+}
+
+MU_TEST(test_gui_screen_delta_encode) {
+    uint8_t* prev_frame = malloc(TEST_GUI_FRAME_SIZE);
+    uint8_t* frame = malloc(TEST_GUI_FRAME_SIZE);
+    uint8_t* decoded = malloc(TEST_GUI_FRAME_SIZE);
+    uint8_t* delta = malloc(TEST_GUI_FRAME_SIZE);
+
+    for(size_t i = 0; i < TEST_GUI_FRAME_SIZE; i++) {
+        prev_frame[i] = i * 7;
+    }
+
+    // Same frame: unchanged runs of 128 bytes only
+    memcpy(frame, prev_frame, TEST_GUI_FRAME_SIZE);
+    size_t size = rpc_system_gui_screen_delta_encode(
+        frame, prev_frame, TEST_GUI_FRAME_SIZE, delta, TEST_GUI_FRAME_SIZE - 1);
+    mu_assert_int_eq(TEST_GUI_FRAME_SIZE / 128, size);
+    mu_check(test_rpc_gui_delta_decode(delta, size, prev_frame, decoded, TEST_GUI_FRAME_SIZE));
+    mu_assert_int_eq(0, memcmp(frame, decoded, TEST_GUI_FRAME_SIZE));
+
+    // Unchanged and changed runs longer than 128 bytes, short runs at the end
+    for(size_t i = 300; i < 600; i++) {
+        frame[i] = ~prev_frame[i];
+    }
+    for(size_t i = 1000; i < TEST_GUI_FRAME_SIZE; i += 3) {
+        frame[i] = ~prev_frame[i];
+    }
+    size = rpc_system_gui_screen_delta_encode(
+        frame, prev_frame, TEST_GUI_FRAME_SIZE, delta, TEST_GUI_FRAME_SIZE - 1);
+    mu_check(size > 0);
+    mu_check(test_rpc_gui_delta_decode(delta, size, prev_frame, decoded, TEST_GUI_FRAME_SIZE));
+    mu_assert_int_eq(0, memcmp(frame, decoded, TEST_GUI_FRAME_SIZE));
+
+    // Every other byte changed, delta is larger than raw frame
+    for(size_t i = 0; i < TEST_GUI_FRAME_SIZE; i++) {
+        frame[i] = (i % 2) ? ~prev_frame[i] : prev_frame[i];
+    }
+    size = rpc_system_gui_screen_delta_encode(
+        frame, prev_frame, TEST_GUI_FRAME_SIZE, delta, TEST_GUI_FRAME_SIZE - 1);
+    mu_assert_int_eq(0, size);
+
+    free(delta);
+    free(decoded);
+    free(frame);
+    free(prev_frame);
+}
+
+MU_TEST_SUITE(test_rpc_gui) {
+    MU_RUN_TEST(test_gui_screen_delta_encode);
+}
+
 MU_TEST_SUITE(test_rpc_system) {
     MU_SUITE_CONFIGURE(&test_rpc_setup, &test_rpc_teardown);
 
     MU_RUN_TEST(test_ping);
     MU_RUN_TEST(test_system_protobuf_version);
+    MU_RUN_TEST(test_system_device_info_lane_stats);
 }
 
 MU_TEST_SUITE(test_rpc_storage) {
@@ -1443,6 +1607,7 @@ MU_TEST_SUITE(test_rpc_storage) {
 
     DISABLE_TEST(MU_RUN_TEST(test_storage_interrupt_continuous_same_system););
     MU_RUN_TEST(test_storage_interrupt_continuous_another_system);
+    MU_RUN_TEST(test_storage_md5sum_ping_concurrent);
 }
 
 static void test_app_create_request(
@@ -1783,6 +1948,7 @@ int run_minunit_test_rpc() {
     }
     furi_record_close("storage");
     MU_RUN_SUITE(test_rpc_system);
+    MU_RUN_SUITE(test_rpc_gui);
     MU_RUN_SUITE(test_rpc_app);
     MU_RUN_SUITE(test_rpc_session);
 
@@ -0,0 +1,192 @@
+#include "../minunit.h"
+#include <furi.h>
+#include <sector_cache.h>
+
+#define SECTOR_CACHE_TEST_WRITES_MAX 8
+
+typedef struct {
+    uint32_t sector[SECTOR_CACHE_TEST_WRITES_MAX];
+    uint32_t count[SECTOR_CACHE_TEST_WRITES_MAX];
+    size_t calls;
+    bool data_valid;
+} SectorCacheTestWrites;
+
+static SectorCache* cache = NULL;
+static SectorCacheTestWrites writes;
+static uint8_t sector_data[SECTOR_CACHE_SECTOR_SIZE];
+
+static bool sector_cache_test_write_cb(
+    void* context,
+    uint32_t sector,
+    const uint8_t* const* data,
+    uint32_t count) {
+    SectorCacheTestWrites* record = context;
+    furi_check(record->calls < SECTOR_CACHE_TEST_WRITES_MAX);
+    record->sector[record->calls] = sector;
+    record->count[record->calls] = count;
+    record->calls++;
+    for(size_t i = 0; i < count; i++) {
+        if(data[i][0] != (uint8_t)(sector + i)) record->data_valid = false;
+    }
+    return true;
+}
+
+static const uint8_t* sector_cache_test_data(uint32_t sector) {
+    memset(sector_data, sector, sizeof(sector_data));
+    return sector_data;
+}
+
+static bool sector_cache_test_cached(uint32_t sector) {
+    uint8_t data[SECTOR_CACHE_SECTOR_SIZE];
+    return sector_cache_read(cache, sector, data) && (data[0] == (uint8_t)sector) &&
+           (data[SECTOR_CACHE_SECTOR_SIZE - 1] == (uint8_t)sector);
+}
+
+static void sector_cache_test_setup() {
+    memset(&writes, 0, sizeof(writes));
+    writes.data_valid = true;
+    cache = sector_cache_alloc(sector_cache_test_write_cb, &writes);
+}
+
+static void sector_cache_test_teardown() {
+    sector_cache_free(cache);
+    cache = NULL;
+}
+
+MU_TEST(test_sector_cache_lru) {
+    for(uint32_t i = 0; i < SECTOR_CACHE_SECTORS; i++) {
+        mu_check(sector_cache_write(cache, i, sector_cache_test_data(i), false, false));
+    }
+    mu_check(sector_cache_test_cached(0));
+
+    /* Sector 0 was used last, sector 1 is the oldest one now */
+    mu_check(sector_cache_write(
+        cache, SECTOR_CACHE_SECTORS, sector_cache_test_data(SECTOR_CACHE_SECTORS), false, false));
+    mu_check(!sector_cache_test_cached(1));
+    mu_check(sector_cache_test_cached(0));
+    for(uint32_t i = 2; i <= SECTOR_CACHE_SECTORS; i++) {
+        mu_check(sector_cache_test_cached(i));
+    }
+
+    SectorCacheStats stats;
+    sector_cache_get_stats(cache, &stats);
+    mu_assert_int_eq(SECTOR_CACHE_SECTORS + 1, stats.hits);
+    mu_assert_int_eq(1, stats.misses);
+    mu_assert_int_eq(0, writes.calls);
+}
+
+MU_TEST(test_sector_cache_pinned) {
+    const uint32_t pinned_base = 100;
+    const uint32_t data_base = 200;
+    for(uint32_t i = 0; i < SECTOR_CACHE_PINNED_MAX; i++) {
+        mu_check(sector_cache_write(
+            cache, pinned_base + i, sector_cache_test_data(pinned_base + i), false, true));
+    }
+
+    /* Long sequential read doesn't push pinned sectors out */
+    for(uint32_t i = 0; i < SECTOR_CACHE_SECTORS * 2; i++) {
+        mu_check(sector_cache_write(
+            cache, data_base + i, sector_cache_test_data(data_base + i), false, false));
+    }
+    for(uint32_t i = 0; i < SECTOR_CACHE_PINNED_MAX; i++) {
+        mu_check(sector_cache_test_cached(pinned_base + i));
+    }
+
+    /* Cached data sector turned into metadata takes quota from oldest pinned sector */
+    const uint32_t retagged = data_base + SECTOR_CACHE_SECTORS * 2 - 1;
+    mu_check(sector_cache_write(cache, retagged, sector_cache_test_data(retagged), false, true));
+    for(uint32_t i = 0; i < SECTOR_CACHE_SECTORS; i++) {
+        mu_check(sector_cache_write(cache, i, sector_cache_test_data(i), false, false));
+    }
+    mu_check(!sector_cache_test_cached(pinned_base));
+    for(uint32_t i = 1; i < SECTOR_CACHE_PINNED_MAX; i++) {
+        mu_check(sector_cache_test_cached(pinned_base + i));
+    }
+    mu_check(sector_cache_test_cached(retagged));
+
+    /* New pinned sector replaces least recently used pinned one once quota is used up */
+    const uint32_t pinned_new = pinned_base + SECTOR_CACHE_PINNED_MAX;
+    mu_check(
+        sector_cache_write(cache, pinned_new, sector_cache_test_data(pinned_new), false, true));
+    mu_check(!sector_cache_test_cached(pinned_base + 1));
+    mu_check(sector_cache_test_cached(pinned_new));
+    mu_check(sector_cache_test_cached(retagged));
+}
+
+MU_TEST(test_sector_cache_merge_dirty) {
+    const uint32_t first = 8;
+    const uint32_t count = 4;
+    mu_check(sector_cache_write(cache, first + 2, sector_cache_test_data(first + 2), true, false));
+    mu_check(sector_cache_write(cache, first + 5, sector_cache_test_data(first + 5), true, false));
+    mu_check(sector_cache_write(cache, first, sector_cache_test_data(first), false, false));
+
+    /* Only dirty sectors within requested range are applied */
+    uint8_t* data = malloc(count * SECTOR_CACHE_SECTOR_SIZE);
+    memset(data, 0xFF, count * SECTOR_CACHE_SECTOR_SIZE);
+    sector_cache_merge_dirty(cache, first, count, data);
+    for(uint32_t i = 0; i < count; i++) {
+        const uint8_t expected = (i == 2) ? (uint8_t)(first + 2) : 0xFF;
+        mu_assert_int_eq(expected, data[i * SECTOR_CACHE_SECTOR_SIZE]);
+        mu_assert_int_eq(expected, data[(i + 1) * SECTOR_CACHE_SECTOR_SIZE - 1]);
+    }
+    free(data);
+
+    /* Sectors written directly to card are clean again */
+    data = malloc(SECTOR_CACHE_SECTOR_SIZE);
+    memset(data, first + 2, SECTOR_CACHE_SECTOR_SIZE);
+    sector_cache_update(cache, first + 2, 1, data);
+    memset(data, 0xFF, SECTOR_CACHE_SECTOR_SIZE);
+    sector_cache_merge_dirty(cache, first + 2, 1, data);
+    mu_assert_int_eq(0xFF, data[0]);
+    free(data);
+
+    mu_check(sector_cache_flush(cache));
+    mu_assert_int_eq(1, writes.calls);
+    mu_assert_int_eq(first + 5, writes.sector[0]);
+}
+
+MU_TEST(test_sector_cache_flush_runs) {
+    const uint32_t sectors[] = {22, 20, 30, 21, 24};
+    for(size_t i = 0; i < COUNT_OF(sectors); i++) {
+        const uint8_t* data = sector_cache_test_data(sectors[i]);
+        mu_check(sector_cache_write(cache, sectors[i], data, true, false));
+    }
+    mu_check(sector_cache_write(cache, 23, sector_cache_test_data(23), false, false));
+
+    /* Adjacent dirty sectors go with one command, in ascending order */
+    mu_check(sector_cache_flush(cache));
+    mu_assert_int_eq(3, writes.calls);
+    mu_assert_int_eq(20, writes.sector[0]);
+    mu_assert_int_eq(3, writes.count[0]);
+    mu_assert_int_eq(24, writes.sector[1]);
+    mu_assert_int_eq(1, writes.count[1]);
+    mu_assert_int_eq(30, writes.sector[2]);
+    mu_assert_int_eq(1, writes.count[2]);
+    mu_check(writes.data_valid);
+
+    SectorCacheStats stats;
+    sector_cache_get_stats(cache, &stats);
+    mu_assert_int_eq(COUNT_OF(sectors), stats.written_back);
+    mu_assert_int_eq(3, stats.write_commands);
+
+    /* Nothing left to write, data is still cached */
+    mu_check(sector_cache_flush(cache));
+    mu_assert_int_eq(3, writes.calls);
+    mu_check(sector_cache_test_cached(20));
+    mu_assert_int_eq(0, sector_cache_reset(cache));
+    mu_check(!sector_cache_test_cached(20));
+}
+
+MU_TEST_SUITE(test_sector_cache_suite) {
+    MU_SUITE_CONFIGURE(&sector_cache_test_setup, &sector_cache_test_teardown);
+
+    MU_RUN_TEST(test_sector_cache_lru);
+    MU_RUN_TEST(test_sector_cache_pinned);
+    MU_RUN_TEST(test_sector_cache_merge_dirty);
+    MU_RUN_TEST(test_sector_cache_flush_runs);
+}
+
+int run_minunit_test_sector_cache() {
+    MU_RUN_SUITE(test_sector_cache_suite);
+    return MU_EXIT_CODE;
+}
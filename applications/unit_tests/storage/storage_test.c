@@ -307,9 +307,97 @@ MU_TEST_SUITE(storage_rename) {
     furi_record_close("storage");
 }
 
+#define STORAGE_ASYNC_FILE "/ext/async_file.test"
+#define STORAGE_ASYNC_CHUNKS 8
+#define STORAGE_ASYNC_CHUNK_SIZE 64
+
+static void storage_async_count_callback(StorageAsyncRequest* request, void* context) {
+    UNUSED(request);
+    uint32_t* completed = context;
+    (*completed)++;
+}
+
+MU_TEST(storage_async_read_write) {
+    Storage* storage = furi_record_open("storage");
+    File* file = storage_file_alloc(storage);
+    FuriEventFlag* event = furi_event_flag_alloc();
+    StorageAsyncRequest requests[STORAGE_ASYNC_CHUNKS];
+    uint8_t buffers[STORAGE_ASYNC_CHUNKS][STORAGE_ASYNC_CHUNK_SIZE];
+    uint32_t completed = 0;
+
+    mu_check(storage_file_open(file, STORAGE_ASYNC_FILE, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
+
+    // queue writes in reverse order, storage must put them in place
+    for(size_t i = 0; i < STORAGE_ASYNC_CHUNKS; i++) {
+        size_t chunk = STORAGE_ASYNC_CHUNKS - 1 - i;
+        memset(buffers[i], 'A' + chunk, STORAGE_ASYNC_CHUNK_SIZE);
+        requests[i] = (StorageAsyncRequest){
+            .type = StorageAsyncTypeWrite,
+            .file = file,
+            .offset = chunk * STORAGE_ASYNC_CHUNK_SIZE,
+            .buff = buffers[i],
+            .size = STORAGE_ASYNC_CHUNK_SIZE,
+            .event_flag = event,
+            .event_flag_mask = (1 << i),
+        };
+        storage_async_submit(storage, &requests[i]);
+    }
+
+    uint32_t all_flags = (1 << STORAGE_ASYNC_CHUNKS) - 1;
+    mu_assert_int_eq(
+        all_flags, furi_event_flag_wait(event, all_flags, FuriFlagWaitAll, FuriWaitForever));
+    for(size_t i = 0; i < STORAGE_ASYNC_CHUNKS; i++) {
+        mu_assert_int_eq(FSE_OK, requests[i].error);
+        mu_assert_int_eq(STORAGE_ASYNC_CHUNK_SIZE, requests[i].bytes_done);
+    }
+    mu_assert_int_eq(STORAGE_ASYNC_CHUNKS * STORAGE_ASYNC_CHUNK_SIZE, storage_file_size(file));
+
+    // read back with callbacks, last request goes past end of file
+    memset(buffers, 0, sizeof(buffers));
+    for(size_t i = 0; i < STORAGE_ASYNC_CHUNKS; i++) {
+        requests[i] = (StorageAsyncRequest){
+            .type = StorageAsyncTypeRead,
+            .file = file,
+            .offset = i * STORAGE_ASYNC_CHUNK_SIZE + STORAGE_ASYNC_CHUNK_SIZE / 2,
+            .buff = buffers[i],
+            .size = STORAGE_ASYNC_CHUNK_SIZE,
+            .callback = storage_async_count_callback,
+            .context = &completed,
+        };
+        storage_async_submit(storage, &requests[i]);
+    }
+
+    // sync call is served after async requests queued before it
+    FileInfo fileinfo;
+    mu_assert_int_eq(FSE_OK, storage_common_stat(storage, STORAGE_ASYNC_FILE, &fileinfo));
+    mu_assert_int_eq(STORAGE_ASYNC_CHUNKS, completed);
+
+    for(size_t i = 0; i < STORAGE_ASYNC_CHUNKS; i++) {
+        size_t expected_size = (i == STORAGE_ASYNC_CHUNKS - 1) ? STORAGE_ASYNC_CHUNK_SIZE / 2 :
+                                                                 STORAGE_ASYNC_CHUNK_SIZE;
+        mu_assert_int_eq(expected_size, requests[i].bytes_done);
+        mu_assert_int_eq('A' + i, buffers[i][0]);
+        mu_assert_int_eq('A' + i, buffers[i][STORAGE_ASYNC_CHUNK_SIZE / 2 - 1]);
+        if(i < STORAGE_ASYNC_CHUNKS - 1) {
+            mu_assert_int_eq('A' + i + 1, buffers[i][STORAGE_ASYNC_CHUNK_SIZE / 2]);
+        }
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_event_flag_free(event);
+    mu_check(storage_simply_remove(storage, STORAGE_ASYNC_FILE));
+    furi_record_close("storage");
+}
+
+MU_TEST_SUITE(storage_async) {
+    MU_RUN_TEST(storage_async_read_write);
+}
+
 int run_minunit_test_storage() {
     MU_RUN_SUITE(storage_file);
     MU_RUN_SUITE(storage_dir);
     MU_RUN_SUITE(storage_rename);
+    MU_RUN_SUITE(storage_async);
     return MU_EXIT_CODE;
 }
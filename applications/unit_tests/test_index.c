@@ -20,6 +20,9 @@ int run_minunit_test_storage();
 int run_minunit_test_subghz();
 int run_minunit_test_dirwalk();
 int run_minunit_test_nfc();
+int run_minunit_test_furi_hal_crypto();
+int run_minunit_test_lfs_backup();
+int run_minunit_test_sector_cache();
 
 typedef int (*UnitTestEntry)();
 
@@ -39,6 +42,9 @@ const UnitTest unit_tests[] = {
     {.name = "subghz", .entry = run_minunit_test_subghz},
     {.name = "infrared", .entry = run_minunit_test_infrared},
     {.name = "nfc", .entry = run_minunit_test_nfc},
+    {.name = "furi_hal_crypto", .entry = run_minunit_test_furi_hal_crypto},
+    {.name = "lfs_backup", .entry = run_minunit_test_lfs_backup},
+    {.name = "sector_cache", .entry = run_minunit_test_sector_cache},
 };
 
 void minunit_print_progress() {
@@ -75,7 +75,8 @@ static UpdateTaskStageGroup update_task_get_task_groups(UpdateTask* update_task)
     if(update_manifest_has_obdata(manifest)) {
         ret |= UpdateTaskStageGroupOptionBytes;
     }
-    if(!string_empty_p(manifest->firmware_dfu_image)) {
+    if(!string_empty_p(manifest->firmware_dfu_image) ||
+       !string_empty_p(manifest->firmware_delta_image)) {
         ret |= UpdateTaskStageGroupFirmware;
     }
     if(!string_empty_p(manifest->resource_bundle)) {
@@ -305,11 +306,16 @@ bool update_task_parse_manifest(UpdateTask* update_task) {
         }
 
         update_task_set_progress(update_task, UpdateTaskStageProgress, 60);
-        if((update_task->state.groups & UpdateTaskStageGroupFirmware) &&
+        if(!string_empty_p(manifest->firmware_dfu_image) &&
            !update_task_check_file_exists(update_task, manifest->firmware_dfu_image)) {
             break;
         }
 
+        if(!string_empty_p(manifest->firmware_delta_image) &&
+           !update_task_check_file_exists(update_task, manifest->firmware_delta_image)) {
+            break;
+        }
+
         update_task_set_progress(update_task, UpdateTaskStageProgress, 80);
         if((update_task->state.groups & UpdateTaskStageGroupRadio) &&
            (!update_task_check_file_exists(update_task, manifest->radio_image) ||
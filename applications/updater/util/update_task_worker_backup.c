@@ -22,19 +22,17 @@
 
 static bool update_task_pre_update(UpdateTask* update_task) {
     bool success = false;
-    string_t backup_file_path;
-    string_init(backup_file_path);
-    path_concat(
-        string_get_cstr(update_task->update_path), LFS_BACKUP_DEFAULT_FILENAME, backup_file_path);
 
     update_task_set_progress(update_task, UpdateTaskStageLfsBackup, 0);
     /* to avoid bootloops */
     furi_hal_rtc_set_boot_mode(FuriHalRtcBootModeNormal);
-    if((success = lfs_backup_create(update_task->storage, string_get_cstr(backup_file_path)))) {
+    /* Update packages come in their own directories, snapshot from previous update is only
+     * found at fixed location */
+    if((success = lfs_backup_create_incremental(
+            update_task->storage, LFS_BACKUP_DEFAULT_LOCATION))) {
         furi_hal_rtc_set_boot_mode(FuriHalRtcBootModeUpdate);
     }
 
-    string_clear(backup_file_path);
     return success;
 }
 
@@ -63,12 +61,9 @@ static bool update_task_post_update(UpdateTask* update_task) {
 
     TarArchive* archive = tar_archive_alloc(update_task->storage);
     do {
-        path_concat(
-            string_get_cstr(update_task->update_path), LFS_BACKUP_DEFAULT_FILENAME, file_path);
-
         update_task_set_progress(update_task, UpdateTaskStageLfsRestore, 0);
 
-        CHECK_RESULT(lfs_backup_unpack(update_task->storage, string_get_cstr(file_path)));
+        CHECK_RESULT(lfs_backup_unpack(update_task->storage, LFS_BACKUP_DEFAULT_LOCATION));
 
         if(update_task->state.groups & UpdateTaskStageGroupResources) {
             TarUnpackProgress progress = {
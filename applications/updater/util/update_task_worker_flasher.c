@@ -6,6 +6,7 @@
 #include <storage/storage.h>
 #include <toolbox/path.h>
 #include <update_util/dfu_file.h>
+#include <update_util/delta_file.h>
 #include <update_util/lfs_backup.h>
 #include <update_util/update_operation.h>
 #include <toolbox/tar/tar_archive.h>
@@ -87,6 +88,79 @@ static bool update_task_write_dfu(UpdateTask* update_task) {
     return success;
 }
 
+/* Checks that delta package can be applied on top of current flash contents.
+ * Never touches flash, so DFU image can still be used if this fails.
+ */
+static bool update_task_validate_delta(UpdateTask* update_task, DeltaFileHeader* header) {
+    UpdateManifest* manifest = update_task->manifest;
+    bool success = false;
+    do {
+        update_task_set_progress(update_task, UpdateTaskStageValidateDFUImage, 0);
+        CHECK_RESULT(update_task_open_file(update_task, manifest->firmware_delta_image));
+        CHECK_RESULT(
+            crc32_calc_file(update_task->file, &update_task_file_progress, update_task) ==
+            manifest->firmware_delta_crc);
+        CHECK_RESULT(delta_file_read_header(update_task->file, header));
+        CHECK_RESULT(header->base_crc == manifest->firmware_delta_base_crc);
+
+        if(delta_file_validate_target(header, NULL, NULL)) {
+            FURI_LOG_W(TAG, "Flash already matches delta target");
+            success = true;
+            break;
+        }
+
+        CHECK_RESULT(delta_file_validate_base(header, &update_task_file_progress, update_task));
+        success = true;
+    } while(false);
+
+    if(!success) {
+        FURI_LOG_W(TAG, "Delta base mismatch");
+    }
+    return success;
+}
+
+static bool update_task_write_delta(UpdateTask* update_task, const DeltaFileHeader* header) {
+    DfuUpdateTask page_task = {
+        .address_cb = &check_address_boundaries,
+        .progress_cb = &update_task_file_progress,
+        .task_cb = &furi_hal_flash_program_page,
+        .context = update_task,
+    };
+
+    bool success = false;
+    do {
+        update_task_set_progress(update_task, UpdateTaskStageFlashWrite, 0);
+        /* Flash may already hold target image if previous attempt was interrupted */
+        if(!delta_file_validate_target(header, NULL, NULL)) {
+            CHECK_RESULT(delta_file_process_records(&page_task, update_task->file, header));
+        }
+
+        update_task_set_progress(update_task, UpdateTaskStageFlashValidate, 0);
+        CHECK_RESULT(
+            delta_file_validate_target(header, &update_task_file_progress, update_task));
+        success = true;
+    } while(false);
+
+    return success;
+}
+
+static bool update_task_write_firmware(UpdateTask* update_task) {
+    UpdateManifest* manifest = update_task->manifest;
+
+    if(!string_empty_p(manifest->firmware_delta_image)) {
+        DeltaFileHeader header = {0};
+        if(update_task_validate_delta(update_task, &header)) {
+            return update_task_write_delta(update_task, &header);
+        }
+    }
+
+    if(!string_empty_p(manifest->firmware_dfu_image)) {
+        return update_task_write_dfu(update_task);
+    }
+
+    return false;
+}
+
 static bool update_task_write_stack_data(UpdateTask* update_task) {
     furi_check(storage_file_is_open(update_task->file));
     const size_t FLASH_PAGE_SIZE = furi_hal_flash_get_page_size();
@@ -336,7 +410,7 @@ int32_t update_task_worker_flash_writer(void* context) {
         }
 
         if(update_task->state.groups & UpdateTaskStageGroupFirmware) {
-            CHECK_RESULT(update_task_write_dfu(update_task));
+            CHECK_RESULT(update_task_write_firmware(update_task));
         }
 
         furi_hal_rtc_set_boot_mode(FuriHalRtcBootModePostUpdate);
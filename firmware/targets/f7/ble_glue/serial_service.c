@@ -6,6 +6,10 @@
 
 #define TAG "BtSerialSvc"
 
+#define SERIAL_SVC_TX_POOL_AVAILABLE (1UL << 0)
+#define SERIAL_SVC_TX_POOL_TIMEOUT (100)
+#define SERIAL_SVC_TX_RETRIES_MAX (50)
+
 typedef struct {
     uint16_t svc_handle;
     uint16_t rx_char_handle;
@@ -16,6 +20,11 @@ typedef struct {
     uint16_t bytes_ready_to_receive;
     SerialServiceEventCallback callback;
     void* context;
+    // Windowed TX, used when client subscribed to notifications instead of indications
+    volatile bool tx_windowed;
+    volatile bool tx_pool_full;
+    FuriEventFlag* tx_event;
+    SerialServiceTxStats tx_stats;
 } SerialSvc;
 
 static SerialSvc* serial_svc = NULL;
@@ -41,6 +50,13 @@ static SVCCTL_EvtAckStatus_t serial_svc_event_handler(void* event) {
                 // Descriptor handle
                 ret = SVCCTL_EvtAckFlowEnable;
                 FURI_LOG_D(TAG, "RX descriptor event");
+            } else if(attribute_modified->Attr_Handle == serial_svc->tx_char_handle + 2) {
+                // Client characteristic configuration: bit 0 notifications, bit 1 indications
+                serial_svc->tx_windowed = attribute_modified->Attr_Data[0] & 0x01;
+                serial_svc->tx_pool_full = false;
+                FURI_LOG_D(
+                    TAG, "TX %s", serial_svc->tx_windowed ? "notifications" : "indications");
+                ret = SVCCTL_EvtAckFlowEnable;
             } else if(attribute_modified->Attr_Handle == serial_svc->rx_char_handle + 1) {
                 FURI_LOG_D(TAG, "Received %d bytes", attribute_modified->Attr_Data_Length);
                 if(serial_svc->callback) {
@@ -77,6 +93,12 @@ static SVCCTL_EvtAckStatus_t serial_svc_event_handler(void* event) {
                 serial_svc->callback(event, serial_svc->context);
             }
             ret = SVCCTL_EvtAckFlowEnable;
+        } else if(blecore_evt->ecode == ACI_GATT_TX_POOL_AVAILABLE_VSEVT_CODE) {
+            aci_gatt_tx_pool_available_event_rp0* tx_pool_available =
+                (aci_gatt_tx_pool_available_event_rp0*)blecore_evt->data;
+            FURI_LOG_T(TAG, "TX pool available: %d", tx_pool_available->Available_Buffers);
+            serial_svc->tx_pool_full = false;
+            furi_event_flag_set(serial_svc->tx_event, SERIAL_SVC_TX_POOL_AVAILABLE);
         }
     }
     return ret;
@@ -117,7 +139,7 @@ void serial_svc_start() {
         UUID_TYPE_128,
         (const Char_UUID_t*)char_tx_uuid,
         SERIAL_SVC_DATA_LEN_MAX,
-        CHAR_PROP_READ | CHAR_PROP_INDICATE,
+        CHAR_PROP_READ | CHAR_PROP_INDICATE | CHAR_PROP_NOTIFY,
         ATTR_PERMISSION_AUTHEN_READ,
         GATT_DONT_NOTIFY_EVENTS,
         10,
@@ -143,6 +165,7 @@ void serial_svc_start() {
     }
     // Allocate buffer size mutex
     serial_svc->buff_size_mtx = furi_mutex_alloc(FuriMutexTypeNormal);
+    serial_svc->tx_event = furi_event_flag_alloc();
 }
 
 void serial_svc_set_callbacks(
@@ -154,6 +177,15 @@ void serial_svc_set_callbacks(
     serial_svc->context = context;
     serial_svc->buff_size = buff_size;
     serial_svc->bytes_ready_to_receive = buff_size;
+    // Bonded client configuration is restored without attribute modified event, read it
+    uint8_t cccd[2] = {0};
+    uint16_t cccd_len = 0;
+    uint16_t cccd_value_len = 0;
+    tBleStatus status = aci_gatt_read_handle_value(
+        serial_svc->tx_char_handle + 2, 0, sizeof(cccd), &cccd_len, &cccd_value_len, cccd);
+    serial_svc->tx_windowed = (status == BLE_STATUS_SUCCESS) && (cccd[0] & 0x01);
+    serial_svc->tx_pool_full = false;
+    memset(&serial_svc->tx_stats, 0, sizeof(SerialServiceTxStats));
     uint32_t buff_size_reversed = REVERSE_BYTES_U32(serial_svc->buff_size);
     aci_gatt_update_char_value(
         serial_svc->svc_handle,
@@ -205,6 +237,7 @@ void serial_svc_stop() {
         }
         // Delete buffer size mutex
         furi_mutex_free(serial_svc->buff_size_mtx);
+        furi_event_flag_free(serial_svc->tx_event);
         free(serial_svc);
         serial_svc = NULL;
     }
@@ -214,31 +247,73 @@ bool serial_svc_is_started() {
     return serial_svc != NULL;
 }
 
-bool serial_svc_update_tx(uint8_t* data, uint16_t data_len) {
-    if(data_len > SERIAL_SVC_DATA_LEN_MAX) {
-        return false;
-    }
-
+static tBleStatus
+    serial_svc_update_tx_value(uint8_t* data, uint16_t data_len, uint8_t update_type) {
+    tBleStatus result = BLE_STATUS_SUCCESS;
     for(uint16_t remained = data_len; remained > 0;) {
         uint8_t value_len = MIN(SERIAL_SVC_CHAR_VALUE_LEN_MAX, remained);
         uint16_t value_offset = data_len - remained;
         remained -= value_len;
 
-        tBleStatus result = aci_gatt_update_char_value_ext(
+        result = aci_gatt_update_char_value_ext(
             0,
             serial_svc->svc_handle,
             serial_svc->tx_char_handle,
-            remained ? 0x00 : 0x02,
+            remained ? 0x00 : update_type,
             data_len,
             value_offset,
             value_len,
             data + value_offset);
 
-        if(result) {
-            FURI_LOG_E(TAG, "Failed updating TX characteristic: %d", result);
-            return false;
+        if(result) break;
+    }
+    return result;
+}
+
+bool serial_svc_update_tx(uint8_t* data, uint16_t data_len) {
+    if(data_len > SERIAL_SVC_DATA_LEN_MAX) {
+        return false;
+    }
+
+    uint32_t start = furi_get_tick();
+    // Notifications are sent without waiting for client, as many as controller can buffer.
+    // Indications are confirmed by client one by one, see SerialServiceEventTypeDataSent.
+    bool windowed = serial_svc->tx_windowed;
+    tBleStatus result = BLE_STATUS_SUCCESS;
+    for(size_t retry = 0; retry <= SERIAL_SVC_TX_RETRIES_MAX; retry++) {
+        if(serial_svc->tx_pool_full) {
+            // Out of credits, wait till stack reports free buffers
+            furi_event_flag_wait(
+                serial_svc->tx_event,
+                SERIAL_SVC_TX_POOL_AVAILABLE,
+                FuriFlagWaitAny,
+                SERIAL_SVC_TX_POOL_TIMEOUT);
         }
+        result = serial_svc_update_tx_value(data, data_len, windowed ? 0x01 : 0x02);
+        if(result != BLE_STATUS_INSUFFICIENT_RESOURCES) break;
+        serial_svc->tx_pool_full = true;
+        serial_svc->tx_stats.retries++;
+    }
+
+    if(result) {
+        FURI_LOG_E(TAG, "Failed updating TX characteristic: %d", result);
+        return false;
     }
 
+    serial_svc->tx_stats.bytes += data_len;
+    serial_svc->tx_stats.packets++;
+    serial_svc->tx_stats.time_ms += furi_get_tick() - start;
+
     return true;
 }
+
+bool serial_svc_is_tx_windowed() {
+    furi_assert(serial_svc);
+    return serial_svc->tx_windowed;
+}
+
+void serial_svc_get_tx_stats(SerialServiceTxStats* stats) {
+    furi_assert(serial_svc);
+    furi_assert(stats);
+    *stats = serial_svc->tx_stats;
+}
@@ -27,6 +27,13 @@ typedef struct {
 
 typedef uint16_t (*SerialServiceEventCallback)(SerialServiceEvent event, void* context);
 
+typedef struct {
+    uint32_t bytes; /**< Sent bytes */
+    uint32_t packets; /**< Sent notifications and indications */
+    uint32_t retries; /**< Sends repeated because controller buffers were full */
+    uint32_t time_ms; /**< Time spent sending */
+} SerialServiceTxStats;
+
 void serial_svc_start();
 
 void serial_svc_set_callbacks(
@@ -42,6 +49,10 @@ bool serial_svc_is_started();
 
 bool serial_svc_update_tx(uint8_t* data, uint16_t data_len);
 
+bool serial_svc_is_tx_windowed();
+
+void serial_svc_get_tx_stats(SerialServiceTxStats* stats);
+
 #ifdef __cplusplus
 }
 #endif
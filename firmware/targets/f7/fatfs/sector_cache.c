@@ -0,0 +1,238 @@
+#include "sector_cache.h"
+
+#include <furi.h>
+
+typedef enum {
+    SectorCacheLineValid = (1 << 0),
+    SectorCacheLineDirty = (1 << 1),
+    SectorCacheLinePinned = (1 << 2),
+} SectorCacheLineFlag;
+
+typedef struct {
+    uint32_t sector;
+    uint32_t last_use;
+    uint8_t flags;
+} SectorCacheLine;
+
+struct SectorCache {
+    SectorCacheLine lines[SECTOR_CACHE_SECTORS];
+    uint8_t* data;
+    uint32_t use_counter;
+    SectorCacheStats stats;
+    SectorCacheWriteCallback write_cb;
+    void* context;
+};
+
+static inline uint8_t* sector_cache_line_data(SectorCache* cache, size_t index) {
+    return &cache->data[index * SECTOR_CACHE_SECTOR_SIZE];
+}
+
+static int32_t sector_cache_find(SectorCache* cache, uint32_t sector) {
+    for(size_t i = 0; i < SECTOR_CACHE_SECTORS; i++) {
+        if((cache->lines[i].flags & SectorCacheLineValid) && (cache->lines[i].sector == sector)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void sector_cache_touch(SectorCache* cache, size_t index) {
+    cache->lines[index].last_use = ++cache->use_counter;
+}
+
+static size_t sector_cache_pinned_count(SectorCache* cache) {
+    size_t pinned_count = 0;
+    for(size_t i = 0; i < SECTOR_CACHE_SECTORS; i++) {
+        if(cache->lines[i].flags & SectorCacheLinePinned) pinned_count++;
+    }
+    return pinned_count;
+}
+
+/* Least recently used valid line with matching pinned state, -1 if none */
+static int32_t sector_cache_find_lru(SectorCache* cache, bool pinned) {
+    int32_t lru = -1;
+    for(size_t i = 0; i < SECTOR_CACHE_SECTORS; i++) {
+        const SectorCacheLine* line = &cache->lines[i];
+        if(!(line->flags & SectorCacheLineValid)) continue;
+        if(!!(line->flags & SectorCacheLinePinned) != pinned) continue;
+        if((lru < 0) || ((int32_t)(line->last_use - cache->lines[lru].last_use) < 0)) {
+            lru = i;
+        }
+    }
+    return lru;
+}
+
+/* Free line, least recently used unpinned line if none, any line if all are pinned */
+static int32_t sector_cache_find_victim(SectorCache* cache) {
+    for(size_t i = 0; i < SECTOR_CACHE_SECTORS; i++) {
+        if(!(cache->lines[i].flags & SectorCacheLineValid)) {
+            return i;
+        }
+    }
+
+    int32_t victim = sector_cache_find_lru(cache, false);
+    if(victim < 0) {
+        victim = sector_cache_find_lru(cache, true);
+    }
+
+    return victim;
+}
+
+SectorCache* sector_cache_alloc(SectorCacheWriteCallback write_cb, void* context) {
+    furi_assert(write_cb);
+    SectorCache* cache = malloc(sizeof(SectorCache));
+    cache->data = malloc(SECTOR_CACHE_SECTORS * SECTOR_CACHE_SECTOR_SIZE);
+    cache->write_cb = write_cb;
+    cache->context = context;
+    return cache;
+}
+
+void sector_cache_free(SectorCache* cache) {
+    furi_assert(cache);
+    free(cache->data);
+    free(cache);
+}
+
+uint32_t sector_cache_reset(SectorCache* cache) {
+    furi_assert(cache);
+
+    uint32_t dropped = 0;
+    for(size_t i = 0; i < SECTOR_CACHE_SECTORS; i++) {
+        if(cache->lines[i].flags & SectorCacheLineDirty) dropped++;
+        cache->lines[i].flags = 0;
+    }
+    return dropped;
+}
+
+bool sector_cache_read(SectorCache* cache, uint32_t sector, uint8_t* data) {
+    furi_assert(cache);
+
+    int32_t index = sector_cache_find(cache, sector);
+    if(index < 0) {
+        cache->stats.misses++;
+        return false;
+    }
+
+    memcpy(data, sector_cache_line_data(cache, index), SECTOR_CACHE_SECTOR_SIZE);
+    sector_cache_touch(cache, index);
+    cache->stats.hits++;
+    return true;
+}
+
+bool sector_cache_write(
+    SectorCache* cache,
+    uint32_t sector,
+    const uint8_t* data,
+    bool dirty,
+    bool pinned) {
+    furi_assert(cache);
+
+    int32_t index = sector_cache_find(cache, sector);
+    /* Pinned lines never exceed the quota, least recently used pinned one gives way */
+    const bool quota_used = pinned &&
+                            (sector_cache_pinned_count(cache) >= SECTOR_CACHE_PINNED_MAX);
+    if(index < 0) {
+        index = quota_used ? sector_cache_find_lru(cache, true) : sector_cache_find_victim(cache);
+        if((cache->lines[index].flags & SectorCacheLineDirty) && !sector_cache_flush(cache)) {
+            return false;
+        }
+        cache->lines[index].sector = sector;
+        cache->lines[index].flags = SectorCacheLineValid;
+    } else if(quota_used && !(cache->lines[index].flags & SectorCacheLinePinned)) {
+        /* Cached data sector turned into metadata, demote instead of evicting */
+        cache->lines[sector_cache_find_lru(cache, true)].flags &= ~SectorCacheLinePinned;
+    }
+
+    SectorCacheLine* line = &cache->lines[index];
+    memcpy(sector_cache_line_data(cache, index), data, SECTOR_CACHE_SECTOR_SIZE);
+    if(dirty) line->flags |= SectorCacheLineDirty;
+    if(pinned) line->flags |= SectorCacheLinePinned;
+    sector_cache_touch(cache, index);
+
+    return true;
+}
+
+void sector_cache_update(
+    SectorCache* cache,
+    uint32_t sector,
+    uint32_t count,
+    const uint8_t* data) {
+    furi_assert(cache);
+
+    for(size_t i = 0; i < SECTOR_CACHE_SECTORS; i++) {
+        SectorCacheLine* line = &cache->lines[i];
+        if((line->flags & SectorCacheLineValid) && (line->sector - sector < count)) {
+            memcpy(
+                sector_cache_line_data(cache, i),
+                &data[(line->sector - sector) * SECTOR_CACHE_SECTOR_SIZE],
+                SECTOR_CACHE_SECTOR_SIZE);
+            line->flags &= ~SectorCacheLineDirty;
+        }
+    }
+}
+
+void sector_cache_merge_dirty(
+    SectorCache* cache,
+    uint32_t sector,
+    uint32_t count,
+    uint8_t* data) {
+    furi_assert(cache);
+
+    for(size_t i = 0; i < SECTOR_CACHE_SECTORS; i++) {
+        const SectorCacheLine* line = &cache->lines[i];
+        if((line->flags & SectorCacheLineDirty) && (line->sector - sector < count)) {
+            memcpy(
+                &data[(line->sector - sector) * SECTOR_CACHE_SECTOR_SIZE],
+                sector_cache_line_data(cache, i),
+                SECTOR_CACHE_SECTOR_SIZE);
+        }
+    }
+}
+
+bool sector_cache_flush(SectorCache* cache) {
+    furi_assert(cache);
+
+    /* Dirty lines sorted by sector */
+    uint8_t order[SECTOR_CACHE_SECTORS];
+    size_t dirty_count = 0;
+    for(size_t i = 0; i < SECTOR_CACHE_SECTORS; i++) {
+        if(!(cache->lines[i].flags & SectorCacheLineDirty)) continue;
+        size_t pos = dirty_count++;
+        while((pos > 0) && (cache->lines[order[pos - 1]].sector > cache->lines[i].sector)) {
+            order[pos] = order[pos - 1];
+            pos--;
+        }
+        order[pos] = i;
+    }
+
+    const uint8_t* run_data[SECTOR_CACHE_SECTORS];
+    size_t run_start = 0;
+    while(run_start < dirty_count) {
+        const uint32_t first_sector = cache->lines[order[run_start]].sector;
+        size_t run_length = 0;
+        while((run_start + run_length < dirty_count) &&
+              (cache->lines[order[run_start + run_length]].sector == first_sector + run_length)) {
+            run_data[run_length] = sector_cache_line_data(cache, order[run_start + run_length]);
+            run_length++;
+        }
+
+        if(!cache->write_cb(cache->context, first_sector, run_data, run_length)) {
+            return false;
+        }
+
+        for(size_t i = 0; i < run_length; i++) {
+            cache->lines[order[run_start + i]].flags &= ~SectorCacheLineDirty;
+        }
+        cache->stats.written_back += run_length;
+        cache->stats.write_commands++;
+        run_start += run_length;
+    }
+
+    return true;
+}
+
+void sector_cache_get_stats(SectorCache* cache, SectorCacheStats* stats) {
+    furi_assert(cache);
+    furi_assert(stats);
+    *stats = cache->stats;
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of cached sectors */
+#ifndef SECTOR_CACHE_SECTORS
+#define SECTOR_CACHE_SECTORS 8
+#endif
+
+/** Maximum number of lines holding pinned (FAT and directory) sectors.
+ * Remaining lines are shared with file data, so a long sequential read
+ * can't flush filesystem metadata out of the cache.
+ */
+#ifndef SECTOR_CACHE_PINNED_MAX
+#define SECTOR_CACHE_PINNED_MAX (SECTOR_CACHE_SECTORS / 2)
+#endif
+
+/** Keep single sector writes in cache until sync or eviction.
+ * Sectors FatFS has already passed to disk_write, including FAT and directory
+ * updates, then stay in RAM until f_sync/f_close or eviction. Card pulled in
+ * between loses them and can be left with FAT and directory out of step, so
+ * write-back is off by default.
+ */
+#ifndef SECTOR_CACHE_WRITE_BACK
+#define SECTOR_CACHE_WRITE_BACK 0
+#endif
+
+#define SECTOR_CACHE_SECTOR_SIZE 512
+
+typedef struct SectorCache SectorCache;
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t written_back; /**< Dirty sectors written to card */
+    uint32_t write_commands; /**< Card write commands issued for them */
+} SectorCacheStats;
+
+/** Write run of adjacent sectors to card
+ *
+ * @param context   callback context
+ * @param sector    first sector
+ * @param data      per-sector data pointers
+ * @param count     number of sectors
+ *
+ * @return true on success
+ */
+typedef bool (*SectorCacheWriteCallback)(
+    void* context,
+    uint32_t sector,
+    const uint8_t* const* data,
+    uint32_t count);
+
+/** Allocate sector cache
+ *
+ * @param write_cb  called to write dirty sectors back
+ * @param context   callback context
+ *
+ * @return SectorCache instance
+ */
+SectorCache* sector_cache_alloc(SectorCacheWriteCallback write_cb, void* context);
+
+/** Free sector cache, dirty sectors are dropped
+ *
+ * @param cache     SectorCache instance
+ */
+void sector_cache_free(SectorCache* cache);
+
+/** Drop all cached sectors, including dirty ones. Use on card change.
+ *
+ * @param cache     SectorCache instance
+ *
+ * @return number of dirty sectors dropped
+ */
+uint32_t sector_cache_reset(SectorCache* cache);
+
+/** Look up single sector, counts towards hit rate
+ *
+ * @param cache     SectorCache instance
+ * @param sector    sector number
+ * @param data      buffer to copy sector data to
+ *
+ * @return true if sector was cached
+ */
+bool sector_cache_read(SectorCache* cache, uint32_t sector, uint8_t* data);
+
+/** Store single sector, evicting least recently used line
+ *
+ * @param cache     SectorCache instance
+ * @param sector    sector number
+ * @param data      sector data
+ * @param dirty     sector is not on card yet
+ * @param pinned    sector holds FAT or directory data
+ *
+ * @return false if evicted dirty sectors could not be written back
+ */
+bool sector_cache_write(
+    SectorCache* cache,
+    uint32_t sector,
+    const uint8_t* data,
+    bool dirty,
+    bool pinned);
+
+/** Refresh cached copies of sectors written directly to card
+ *
+ * @param cache     SectorCache instance
+ * @param sector    first sector
+ * @param count     number of sectors
+ * @param data      data written
+ */
+void sector_cache_update(
+    SectorCache* cache,
+    uint32_t sector,
+    uint32_t count,
+    const uint8_t* data);
+
+/** Apply dirty cached sectors on top of data read directly from card
+ *
+ * @param cache     SectorCache instance
+ * @param sector    first sector
+ * @param count     number of sectors
+ * @param data      data read
+ */
+void sector_cache_merge_dirty(
+    SectorCache* cache,
+    uint32_t sector,
+    uint32_t count,
+    uint8_t* data);
+
+/** Write all dirty sectors back, adjacent ones with a single command
+ *
+ * @param cache     SectorCache instance
+ *
+ * @return true on success
+ */
+bool sector_cache_flush(SectorCache* cache);
+
+/** Get cache statistics
+ *
+ * @param cache     SectorCache instance
+ * @param stats     SectorCacheStats to fill
+ */
+void sector_cache_get_stats(SectorCache* cache, SectorCacheStats* stats);
+
+#ifdef __cplusplus
+}
+#endif
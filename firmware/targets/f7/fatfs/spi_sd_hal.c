@@ -84,6 +84,28 @@ void SD_IO_WriteReadData(const uint8_t* DataIn, uint8_t* DataOut, uint16_t DataL
     SPIx_WriteReadData(DataIn, DataOut, DataLength);
 }
 
+/**
+ * @brief  Read data block from the SD with DMA, clocking out dummy bytes
+ * @param  DataOut: Pointer to data buffer for read data
+ * @param  DataLength: number of bytes to read
+ * @retval None
+ */
+void SD_IO_ReadData(uint8_t* DataOut, uint16_t DataLength) {
+    furi_check(furi_hal_spi_bus_trx_dma(
+        furi_hal_sd_spi_handle, NULL, DataOut, DataLength, SpiTimeout));
+}
+
+/**
+ * @brief  Write data block to the SD with DMA, discarding received bytes
+ * @param  DataIn: Pointer to data buffer to write
+ * @param  DataLength: number of bytes to write
+ * @retval None
+ */
+void SD_IO_WriteData(const uint8_t* DataIn, uint16_t DataLength) {
+    furi_check(furi_hal_spi_bus_trx_dma(
+        furi_hal_sd_spi_handle, DataIn, NULL, DataLength, SpiTimeout));
+}
+
 /**
  * @brief  Write a byte on the SD.
  * @param  Data: byte to send.
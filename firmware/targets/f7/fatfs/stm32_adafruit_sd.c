@@ -161,7 +161,7 @@ typedef enum {
 #define SD_TOKEN_START_DATA_SINGLE_BLOCK_WRITE \
     0xFE /* Data token start byte, Start Single Block Write */
 #define SD_TOKEN_START_DATA_MULTIPLE_BLOCK_WRITE \
-    0xFD /* Data token start byte, Start Multiple Block Write */
+    0xFC /* Data token start byte, Start Multiple Block Write */
 #define SD_TOKEN_STOP_DATA_MULTIPLE_BLOCK_WRITE \
     0xFD /* Data toke stop byte, Stop Multiple Block Write */
 
@@ -268,6 +268,7 @@ static uint8_t SD_GetDataResponse(void);
 static uint8_t SD_GoIdleState(void);
 static SD_CmdAnswer_typedef SD_SendCmd(uint8_t Cmd, uint32_t Arg, uint8_t Crc, uint8_t Answer);
 static uint8_t SD_WaitData(uint8_t data);
+static uint8_t SD_StopTransmission(void);
 static uint8_t SD_ReadData(void);
 /** @defgroup STM32_ADAFRUIT_SD_Private_Function_Prototypes
   * @{
@@ -409,7 +410,8 @@ uint8_t BSP_SD_GetCardInfo(SD_CardInfo* pCardInfo) {
 }
 
 /**
-  * @brief  Reads block(s) from a specified address in the SD card, in polling mode. 
+  * @brief  Reads block(s) from a specified address in the SD card. Data is received with DMA,
+  *         runs of blocks are read with one CMD18.
   * @param  pData: Pointer to the buffer that will contain the data to transmit
   * @param  ReadAddr: Address from where data is to be read. The address is counted 
   *                   in blocks of 512bytes
@@ -423,9 +425,10 @@ uint8_t
     uint32_t offset = 0;
     uint32_t addr;
     uint8_t retr = BSP_SD_ERROR;
-    uint8_t* ptr = NULL;
     SD_CmdAnswer_typedef response;
     uint16_t BlockSize = 512;
+    bool multi_block = (NumOfBlocks > 1);
+    bool stop_required = false;
 
     /* Send CMD16 (SD_CMD_SET_BLOCKLEN) to set the size of the block and 
      Check if the SD acknowledged the set block length command: R1 response (0x00: no errors) */
@@ -436,78 +439,75 @@ uint8_t
         goto error;
     }
 
-    ptr = malloc(sizeof(uint8_t) * BlockSize);
-    if(ptr == NULL) {
-        goto error;
-    }
-    memset(ptr, SD_DUMMY_BYTE, sizeof(uint8_t) * BlockSize);
-
     /* Initialize the address */
     addr = (ReadAddr * ((flag_SDHC == 1) ? 1 : BlockSize));
 
+    /* Send CMD18 (SD_CMD_READ_MULT_BLOCK) for a run of blocks or CMD17 (SD_CMD_READ_SINGLE_BLOCK)
+     for one block. Check if the SD acknowledged the read command: R1 response (0x00: no errors) */
+    response = SD_SendCmd(
+        multi_block ? SD_CMD_READ_MULT_BLOCK : SD_CMD_READ_SINGLE_BLOCK,
+        addr,
+        0xFF,
+        SD_ANSWER_R1_EXPECTED);
+    if(response.r1 != SD_R1_NO_ERROR) {
+        goto error;
+    }
+    stop_required = multi_block;
+
     /* Data transfer */
     while(NumOfBlocks--) {
-        /* Send CMD17 (SD_CMD_READ_SINGLE_BLOCK) to read one block */
-        /* Check if the SD acknowledged the read block command: R1 response (0x00: no errors) */
-        response = SD_SendCmd(SD_CMD_READ_SINGLE_BLOCK, addr, 0xFF, SD_ANSWER_R1_EXPECTED);
-        if(response.r1 != SD_R1_NO_ERROR) {
-            goto error;
-        }
-
         /* Now look for the data token to signify the start of the data */
-        if(SD_WaitData(SD_TOKEN_START_DATA_SINGLE_BLOCK_READ) == BSP_SD_OK) {
-            /* Read the SD block data : read NumByteToRead data */
-            SD_IO_WriteReadData(ptr, (uint8_t*)pData + offset, BlockSize);
-
-            /* Set next read address*/
-            offset += BlockSize;
-            addr = ((flag_SDHC == 1) ? (addr + 1) : (addr + BlockSize));
-
-            /* get CRC bytes (not really needed by us, but required by SD) */
-            SD_IO_WriteByte(SD_DUMMY_BYTE);
-            SD_IO_WriteByte(SD_DUMMY_BYTE);
-        } else {
+        if(SD_WaitData(SD_TOKEN_START_DATA_MULTIPLE_BLOCK_READ) != BSP_SD_OK) {
             goto error;
         }
 
-        /* End the command data read cycle */
-        SD_IO_CSState(1);
+        /* Read the SD block data : read NumByteToRead data */
+        SD_IO_ReadData((uint8_t*)pData + offset, BlockSize);
+        offset += BlockSize;
+
+        /* get CRC bytes (not really needed by us, but required by SD) */
+        SD_IO_WriteByte(SD_DUMMY_BYTE);
         SD_IO_WriteByte(SD_DUMMY_BYTE);
     }
 
     retr = BSP_SD_OK;
 
 error:
+    if(stop_required) {
+        /* Card keeps sending blocks until CMD12 */
+        if(SD_StopTransmission() != SD_R1_NO_ERROR) {
+            retr = BSP_SD_ERROR;
+        }
+    }
+
     /* Send dummy byte: 8 Clock pulses of delay */
     SD_IO_CSState(1);
     SD_IO_WriteByte(SD_DUMMY_BYTE);
-    if(ptr != NULL) free(ptr);
 
     /* Return the reponse */
     return retr;
 }
 
 /**
-  * @brief  Writes block(s) to a specified address in the SD card, in polling mode. 
-  * @param  pData: Pointer to the buffer that will contain the data to transmit
-  * @param  WriteAddr: Address from where data is to be written. The address is counted 
-  *                   in blocks of 512bytes
+  * @brief  Writes block(s) from either one contiguous buffer or a list of per-block buffers.
+  * @param  pData: Pointer to contiguous data, used when pBlocks is NULL
+  * @param  pBlocks: Pointers to data of each block
+  * @param  WriteAddr: Address from where data is to be written, in blocks of 512bytes
   * @param  NumOfBlocks: Number of SD blocks to write
-  * @param  Timeout: This parameter is used for compatibility with BSP implementation
   * @retval SD status
   */
-uint8_t BSP_SD_WriteBlocks(
-    uint32_t* pData,
+static uint8_t SD_WriteBlocks(
+    const uint8_t* pData,
+    const uint8_t* const* pBlocks,
     uint32_t WriteAddr,
-    uint32_t NumOfBlocks,
-    uint32_t Timeout) {
-    UNUSED(Timeout); // FIXME!
-    uint32_t offset = 0;
+    uint32_t NumOfBlocks) {
+    uint32_t block = 0;
     uint32_t addr;
     uint8_t retr = BSP_SD_ERROR;
-    uint8_t* ptr = NULL;
     SD_CmdAnswer_typedef response;
     uint16_t BlockSize = 512;
+    bool multi_block = (NumOfBlocks > 1);
+    bool stop_required = false;
 
     /* Send CMD16 (SD_CMD_SET_BLOCKLEN) to set the size of the block and 
      Check if the SD acknowledged the set block length command: R1 response (0x00: no errors) */
@@ -518,54 +518,57 @@ uint8_t BSP_SD_WriteBlocks(
         goto error;
     }
 
-    ptr = malloc(sizeof(uint8_t) * BlockSize);
-    if(ptr == NULL) {
+    /* Initialize the address */
+    addr = (WriteAddr * ((flag_SDHC == 1) ? 1 : BlockSize));
+
+    /* Send CMD25 (SD_CMD_WRITE_MULT_BLOCK) for a run of blocks or CMD24 (SD_CMD_WRITE_SINGLE_BLOCK)
+     for one block. Check if the SD acknowledged the write command: R1 response (0x00: no errors) */
+    response = SD_SendCmd(
+        multi_block ? SD_CMD_WRITE_MULT_BLOCK : SD_CMD_WRITE_SINGLE_BLOCK,
+        addr,
+        0xFF,
+        SD_ANSWER_R1_EXPECTED);
+    if(response.r1 != SD_R1_NO_ERROR) {
         goto error;
     }
+    stop_required = multi_block;
 
-    /* Initialize the address */
-    addr = (WriteAddr * ((flag_SDHC == 1) ? 1 : BlockSize));
+    /* Send dummy byte for NWR timing : one byte between CMDWRITE and TOKEN */
+    SD_IO_WriteByte(SD_DUMMY_BYTE);
+    SD_IO_WriteByte(SD_DUMMY_BYTE);
 
     /* Data transfer */
     while(NumOfBlocks--) {
-        /* Send CMD24 (SD_CMD_WRITE_SINGLE_BLOCK) to write blocks  and
-       Check if the SD acknowledged the write block command: R1 response (0x00: no errors) */
-        response = SD_SendCmd(SD_CMD_WRITE_SINGLE_BLOCK, addr, 0xFF, SD_ANSWER_R1_EXPECTED);
-        if(response.r1 != SD_R1_NO_ERROR) {
-            goto error;
-        }
-
-        /* Send dummy byte for NWR timing : one byte between CMDWRITE and TOKEN */
-        SD_IO_WriteByte(SD_DUMMY_BYTE);
-        SD_IO_WriteByte(SD_DUMMY_BYTE);
-
         /* Send the data token to signify the start of the data */
-        SD_IO_WriteByte(SD_TOKEN_START_DATA_SINGLE_BLOCK_WRITE);
+        SD_IO_WriteByte(
+            multi_block ? SD_TOKEN_START_DATA_MULTIPLE_BLOCK_WRITE :
+                          SD_TOKEN_START_DATA_SINGLE_BLOCK_WRITE);
 
         /* Write the block data to SD */
-        SD_IO_WriteReadData((uint8_t*)pData + offset, ptr, BlockSize);
-
-        /* Set next write address */
-        offset += BlockSize;
-        addr = ((flag_SDHC == 1) ? (addr + 1) : (addr + BlockSize));
+        SD_IO_WriteData(pBlocks ? pBlocks[block] : &pData[block * BlockSize], BlockSize);
+        block++;
 
         /* Put CRC bytes (not really needed by us, but required by SD) */
         SD_IO_WriteByte(SD_DUMMY_BYTE);
         SD_IO_WriteByte(SD_DUMMY_BYTE);
 
-        /* Read data response */
+        /* Read data response, waits until block is programmed */
         if(SD_GetDataResponse() != SD_DATA_OK) {
             /* Set response value to failure */
             goto error;
         }
-
-        SD_IO_CSState(1);
-        SD_IO_WriteByte(SD_DUMMY_BYTE);
     }
     retr = BSP_SD_OK;
 
 error:
-    if(ptr != NULL) free(ptr);
+    if(stop_required) {
+        /* Send stop token and wait until card finishes programming */
+        SD_IO_WriteByte(SD_TOKEN_STOP_DATA_MULTIPLE_BLOCK_WRITE);
+        SD_IO_WriteByte(SD_DUMMY_BYTE);
+        while(SD_IO_WriteByte(SD_DUMMY_BYTE) != 0xFF)
+            ;
+    }
+
     /* Send dummy byte: 8 Clock pulses of delay */
     SD_IO_CSState(1);
     SD_IO_WriteByte(SD_DUMMY_BYTE);
@@ -574,6 +577,43 @@ error:
     return retr;
 }
 
+/**
+  * @brief  Writes block(s) to a specified address in the SD card. Data is sent with DMA,
+  *         runs of blocks are written with one CMD25. 
+  * @param  pData: Pointer to the buffer that will contain the data to transmit
+  * @param  WriteAddr: Address from where data is to be written. The address is counted 
+  *                   in blocks of 512bytes
+  * @param  NumOfBlocks: Number of SD blocks to write
+  * @param  Timeout: This parameter is used for compatibility with BSP implementation
+  * @retval SD status
+  */
+uint8_t BSP_SD_WriteBlocks(
+    uint32_t* pData,
+    uint32_t WriteAddr,
+    uint32_t NumOfBlocks,
+    uint32_t Timeout) {
+    UNUSED(Timeout); // FIXME!
+    return SD_WriteBlocks((const uint8_t*)pData, NULL, WriteAddr, NumOfBlocks);
+}
+
+/**
+  * @brief  Writes adjacent blocks stored in separate buffers with one CMD25.
+  * @param  pBlocks: Pointers to data of each block
+  * @param  WriteAddr: Address from where data is to be written. The address is counted 
+  *                   in blocks of 512bytes
+  * @param  NumOfBlocks: Number of SD blocks to write
+  * @param  Timeout: This parameter is used for compatibility with BSP implementation
+  * @retval SD status
+  */
+uint8_t BSP_SD_WriteBlocksList(
+    const uint8_t* const* pBlocks,
+    uint32_t WriteAddr,
+    uint32_t NumOfBlocks,
+    uint32_t Timeout) {
+    UNUSED(Timeout); // FIXME!
+    return SD_WriteBlocks(NULL, pBlocks, WriteAddr, NumOfBlocks);
+}
+
 /**
   * @brief  Erases the specified memory area of the given SD card. 
   * @param  StartAddr: Start address in Blocks (Size of a block is 512bytes)
@@ -1086,6 +1126,28 @@ uint8_t SD_WaitData(uint8_t data) {
     return BSP_SD_OK;
 }
 
+/**
+  * @brief  Sends CMD12 to end multiple block read. CS must be low.
+  * @retval R1 response
+  */
+uint8_t SD_StopTransmission(void) {
+    uint8_t frame[SD_CMD_LENGTH] = {(SD_CMD_STOP_TRANSMISSION | 0x40), 0, 0, 0, 0, 0xFF};
+    uint8_t frameout[SD_CMD_LENGTH];
+    uint8_t r1;
+
+    SD_IO_WriteReadData(frame, frameout, SD_CMD_LENGTH);
+
+    /* Skip stuff byte, card may still be clocking out data */
+    SD_IO_WriteByte(SD_DUMMY_BYTE);
+    r1 = SD_ReadData();
+
+    /* R1b: wait IO line return 0xFF */
+    while(SD_IO_WriteByte(SD_DUMMY_BYTE) != 0xFF)
+        ;
+
+    return r1;
+}
+
 /**
   * @}
   */
@@ -203,6 +203,11 @@ uint8_t
     BSP_SD_ReadBlocks(uint32_t* pData, uint32_t ReadAddr, uint32_t NumOfBlocks, uint32_t Timeout);
 uint8_t
     BSP_SD_WriteBlocks(uint32_t* pData, uint32_t WriteAddr, uint32_t NumOfBlocks, uint32_t Timeout);
+uint8_t BSP_SD_WriteBlocksList(
+    const uint8_t* const* pBlocks,
+    uint32_t WriteAddr,
+    uint32_t NumOfBlocks,
+    uint32_t Timeout);
 uint8_t BSP_SD_Erase(uint32_t StartAddr, uint32_t EndAddr);
 uint8_t BSP_SD_GetCardState(void);
 uint8_t BSP_SD_GetCardInfo(SD_CardInfo* pCardInfo);
@@ -213,6 +218,8 @@ void SD_SPI_Fast_Init(void);
 void SD_IO_Init(void);
 void SD_IO_CSState(uint8_t state);
 void SD_IO_WriteReadData(const uint8_t* DataIn, uint8_t* DataOut, uint16_t DataLength);
+void SD_IO_ReadData(uint8_t* DataOut, uint16_t DataLength);
+void SD_IO_WriteData(const uint8_t* DataIn, uint16_t DataLength);
 uint8_t SD_IO_WriteByte(uint8_t Data);
 
 /* Link function for HAL delay */
@@ -35,6 +35,8 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "user_diskio.h"
+#include "sector_cache.h"
+#include "fatfs.h"
 #include <furi_hal.h>
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -53,6 +55,32 @@ static DSTATUS User_CheckStatus(BYTE lun) {
     return Stat;
 }
 
+/* FatFS reads and writes FAT and directory sectors through the volume window only */
+static inline bool User_IsMetadata(const BYTE* buff) {
+    return buff == USERFatFS.win;
+}
+
+/* Called with SD bus acquired */
+static bool
+    User_WriteBack(void* context, uint32_t sector, const uint8_t* const* data, uint32_t count) {
+    UNUSED(context);
+    if(BSP_SD_WriteBlocksList(data, sector, count, SD_DATATIMEOUT) != MSD_OK) {
+        return false;
+    }
+    /* wait until the Write operation is finished */
+    while(BSP_SD_GetCardState() != MSD_OK) {
+    }
+    return true;
+}
+
+SectorCache* USER_GetSectorCache(void) {
+    static SectorCache* cache = NULL;
+    if(!cache) {
+        cache = sector_cache_alloc(User_WriteBack, NULL);
+    }
+    return cache;
+}
+
 /* USER CODE END DECL */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -87,6 +115,7 @@ Diskio_drvTypeDef USER_Driver = {
   */
 DSTATUS USER_initialize(BYTE pdrv) {
     /* USER CODE BEGIN INIT */
+    sector_cache_reset(USER_GetSectorCache());
 
     furi_hal_spi_acquire(&furi_hal_spi_bus_handle_sd_fast);
     furi_hal_sd_spi_handle = &furi_hal_spi_bus_handle_sd_fast;
@@ -125,12 +154,21 @@ DRESULT USER_read(BYTE pdrv, BYTE* buff, DWORD sector, UINT count) {
     UNUSED(pdrv);
     DRESULT res = RES_ERROR;
 
+    /* Multi-sector requests are file data, don't let them wipe the cache */
+    if((count == 1) && sector_cache_read(USER_GetSectorCache(), sector, buff)) {
+        return RES_OK;
+    }
+
     furi_hal_spi_acquire(&furi_hal_spi_bus_handle_sd_fast);
     furi_hal_sd_spi_handle = &furi_hal_spi_bus_handle_sd_fast;
 
+    /* Contiguous sectors are read with one multi-block command, no need to poll card state */
     if(BSP_SD_ReadBlocks((uint32_t*)buff, (uint32_t)(sector), count, SD_DATATIMEOUT) == MSD_OK) {
-        /* wait until the read operation is finished */
-        while(BSP_SD_GetCardState() != MSD_OK) {
+        if(count == 1) {
+            /* Data is valid even if evicted dirty sectors failed to write, they stay cached */
+            sector_cache_write(USER_GetSectorCache(), sector, buff, false, User_IsMetadata(buff));
+        } else {
+            sector_cache_merge_dirty(USER_GetSectorCache(), sector, count, buff);
         }
         res = RES_OK;
     }
@@ -160,10 +198,21 @@ DRESULT USER_write(BYTE pdrv, const BYTE* buff, DWORD sector, UINT count) {
     furi_hal_spi_acquire(&furi_hal_spi_bus_handle_sd_fast);
     furi_hal_sd_spi_handle = &furi_hal_spi_bus_handle_sd_fast;
 
-    if(BSP_SD_WriteBlocks((uint32_t*)buff, (uint32_t)(sector), count, SD_DATATIMEOUT) == MSD_OK) {
+    if(SECTOR_CACHE_WRITE_BACK && (count == 1)) {
+        /* Written on sync or eviction, together with adjacent dirty sectors */
+        if(sector_cache_write(USER_GetSectorCache(), sector, buff, true, User_IsMetadata(buff))) {
+            res = RES_OK;
+        }
+    } else if(
+        BSP_SD_WriteBlocks((uint32_t*)buff, (uint32_t)(sector), count, SD_DATATIMEOUT) == MSD_OK) {
         /* wait until the Write operation is finished */
         while(BSP_SD_GetCardState() != MSD_OK) {
         }
+        if(count == 1) {
+            sector_cache_write(USER_GetSectorCache(), sector, buff, false, User_IsMetadata(buff));
+        } else {
+            sector_cache_update(USER_GetSectorCache(), sector, count, buff);
+        }
         res = RES_OK;
     }
 
@@ -197,7 +246,7 @@ DRESULT USER_ioctl(BYTE pdrv, BYTE cmd, void* buff) {
     switch(cmd) {
     /* Make sure that no pending write process */
     case CTRL_SYNC:
-        res = RES_OK;
+        res = sector_cache_flush(USER_GetSectorCache()) ? RES_OK : RES_ERROR;
         break;
 
     /* Get number of sectors on the disk (DWORD) */
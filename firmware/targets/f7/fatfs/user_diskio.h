@@ -32,11 +32,15 @@ extern "C" {
 /* Includes ------------------------------------------------------------------*/
 #include "stm32_adafruit_sd.h"
 #include "fatfs/ff_gen_drv.h"
+#include "sector_cache.h"
 /* Exported types ------------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
 extern Diskio_drvTypeDef USER_Driver;
 
+/** SD card sector cache, allocated on first use */
+SectorCache* USER_GetSectorCache(void);
+
 /* USER CODE END 0 */
 
 #ifdef __cplusplus
@@ -38,6 +38,14 @@ bool furi_hal_bt_serial_tx(uint8_t* data, uint16_t size) {
     return serial_svc_update_tx(data, size);
 }
 
+bool furi_hal_bt_serial_is_tx_windowed() {
+    return serial_svc_is_tx_windowed();
+}
+
+void furi_hal_bt_serial_get_tx_stats(FuriHalBtSerialTxStats* stats) {
+    serial_svc_get_tx_stats(stats);
+}
+
 void furi_hal_bt_serial_stop() {
     // Stop all services
     if(dev_info_svc_is_started()) {
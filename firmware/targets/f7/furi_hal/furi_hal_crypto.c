@@ -1,8 +1,10 @@
 #include <furi_hal_crypto.h>
 #include <furi_hal_bt.h>
 #include <furi_hal_random.h>
+#include <furi_hal_interrupt.h>
 #include <stm32wbxx_ll_cortex.h>
 #include <stm32wbxx_ll_bus.h>
+#include <stm32wbxx_ll_dma.h>
 #include <furi.h>
 #include <shci.h>
 
@@ -20,11 +22,47 @@
 #define CRYPTO_MODE_DECRYPT_INIT (AES_CR_MODE_0 | AES_CR_MODE_1)
 
 #define CRYPTO_DATATYPE_32B 0U
+#define CRYPTO_DATATYPE_8B (AES_CR_DATATYPE_1)
 #define CRYPTO_KEYSIZE_256B (AES_CR_KEYSIZE)
 #define CRYPTO_AES_CBC (AES_CR_CHMOD_0)
+#define CRYPTO_AES_CTR (AES_CR_CHMOD_1)
+#define CRYPTO_AES_GCM (AES_CR_CHMOD_0 | AES_CR_CHMOD_1)
+
+#define CRYPTO_GCM_PHASE_INIT 0U
+#define CRYPTO_GCM_PHASE_HEADER (AES_CR_GCMPH_0)
+#define CRYPTO_GCM_PHASE_PAYLOAD (AES_CR_GCMPH_1)
+#define CRYPTO_GCM_PHASE_FINAL (AES_CR_GCMPH_0 | AES_CR_GCMPH_1)
+
+/* DMA1 channels 1-2 are taken by infrared, subghz and digital signal, DMA2 3-4 by spi */
+#define CRYPTO_DMA DMA2
+#define CRYPTO_DMA_IN_CHANNEL LL_DMA_CHANNEL_5
+#define CRYPTO_DMA_OUT_CHANNEL LL_DMA_CHANNEL_6
+#define CRYPTO_DMA_OUT_IRQ FuriHalInterruptIdDma2Ch6
+#define CRYPTO_DMA_IN_DEF CRYPTO_DMA, CRYPTO_DMA_IN_CHANNEL
+#define CRYPTO_DMA_OUT_DEF CRYPTO_DMA, CRYPTO_DMA_OUT_CHANNEL
+/* Smaller buffers are faster to feed by hand than to set up DMA for */
+#define CRYPTO_DMA_MIN_SIZE (4 * CRYPTO_BLK_LEN)
+/* DMA transfer length is counted in words */
+#define CRYPTO_DMA_MAX_SIZE ((UINT16_MAX / 4) * CRYPTO_BLK_LEN)
+
+typedef enum {
+    CryptoStreamModeNone,
+    CryptoStreamModeCtr,
+    CryptoStreamModeGcm,
+} CryptoStreamMode;
+
+typedef struct {
+    CryptoStreamMode mode;
+    bool decrypt;
+    bool tail_done; /**< Partial block was processed, no more data allowed */
+    size_t aad_size;
+    size_t payload_size;
+} CryptoStream;
 
 static FuriMutex* furi_hal_crypto_mutex = NULL;
+static FuriSemaphore* furi_hal_crypto_dma_completed = NULL;
 static bool furi_hal_crypto_mode_init_done = false;
+static CryptoStream furi_hal_crypto_stream = {0};
 
 static const uint8_t enclave_signature_iv[ENCLAVE_FACTORY_KEY_SLOTS][16] = {
     {0xac, 0x5d, 0x68, 0xb8, 0x79, 0x74, 0xfc, 0x7f, 0x45, 0x02, 0x82, 0xf1, 0x48, 0x7e, 0x75, 0x8a},
@@ -65,8 +103,18 @@ static const uint8_t enclave_signature_expected[ENCLAVE_FACTORY_KEY_SLOTS][ENCLA
     {0xc9, 0xf7, 0x03, 0xf1, 0x6c, 0x65, 0xad, 0x49, 0x74, 0xbe, 0x00, 0x54, 0xfd, 0xa6, 0x9c, 0x32},
 };
 
+static void furi_hal_crypto_dma_isr(void* context) {
+    UNUSED(context);
+    if(LL_DMA_IsActiveFlag_TC6(CRYPTO_DMA)) {
+        LL_DMA_ClearFlag_TC6(CRYPTO_DMA);
+        furi_semaphore_release(furi_hal_crypto_dma_completed);
+    }
+}
+
 void furi_hal_crypto_init() {
     furi_hal_crypto_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    furi_hal_crypto_dma_completed = furi_semaphore_alloc(1, 0);
+    furi_hal_interrupt_set_isr(CRYPTO_DMA_OUT_IRQ, furi_hal_crypto_dma_isr, NULL);
     FURI_LOG_I(TAG, "Init OK");
 }
 
@@ -204,17 +252,35 @@ static void crypto_key_init(uint32_t* key, uint32_t* iv) {
     AES1->IVR0 = iv[3];
 }
 
-static bool crypto_process_block(uint32_t* in, uint32_t* out, uint8_t blk_len) {
-    furi_check((blk_len <= 4) && (blk_len > 0));
+/* Plain key and IV are byte streams, engine swaps data bytes to match */
+static void crypto_key_init_bswap(const uint8_t* key, const uint8_t* iv, uint32_t chaining_mode) {
+    uint32_t key_words[FURI_HAL_CRYPTO_KEY_SIZE / sizeof(uint32_t)];
+    uint32_t iv_words[CRYPTO_BLK_LEN / sizeof(uint32_t)];
+    memcpy(key_words, key, FURI_HAL_CRYPTO_KEY_SIZE);
+    memcpy(iv_words, iv, CRYPTO_BLK_LEN);
 
-    for(uint8_t i = 0; i < 4; i++) {
-        if(i < blk_len) {
-            AES1->DINR = in[i];
-        } else {
-            AES1->DINR = 0;
-        }
-    }
+    CLEAR_BIT(AES1->CR, AES_CR_EN);
+    MODIFY_REG(
+        AES1->CR,
+        AES_CR_DATATYPE | AES_CR_KEYSIZE | AES_CR_CHMOD | AES_CR_MODE | AES_CR_GCMPH,
+        CRYPTO_DATATYPE_8B | CRYPTO_KEYSIZE_256B | chaining_mode);
+
+    AES1->KEYR7 = __builtin_bswap32(key_words[0]);
+    AES1->KEYR6 = __builtin_bswap32(key_words[1]);
+    AES1->KEYR5 = __builtin_bswap32(key_words[2]);
+    AES1->KEYR4 = __builtin_bswap32(key_words[3]);
+    AES1->KEYR3 = __builtin_bswap32(key_words[4]);
+    AES1->KEYR2 = __builtin_bswap32(key_words[5]);
+    AES1->KEYR1 = __builtin_bswap32(key_words[6]);
+    AES1->KEYR0 = __builtin_bswap32(key_words[7]);
+
+    AES1->IVR3 = __builtin_bswap32(iv_words[0]);
+    AES1->IVR2 = __builtin_bswap32(iv_words[1]);
+    AES1->IVR1 = __builtin_bswap32(iv_words[2]);
+    AES1->IVR0 = __builtin_bswap32(iv_words[3]);
+}
 
+static bool crypto_wait_ccf() {
     uint32_t countdown = CRYPTO_TIMEOUT;
     while(!READ_BIT(AES1->SR, AES_SR_CCF)) {
         if(LL_SYSTICK_IsActiveCounterFlag()) {
@@ -226,6 +292,23 @@ static bool crypto_process_block(uint32_t* in, uint32_t* out, uint8_t blk_len) {
     }
 
     SET_BIT(AES1->CR, AES_CR_CCFC);
+    return true;
+}
+
+static bool crypto_process_block(uint32_t* in, uint32_t* out, uint8_t blk_len) {
+    furi_check((blk_len <= 4) && (blk_len > 0));
+
+    for(uint8_t i = 0; i < 4; i++) {
+        if(i < blk_len) {
+            AES1->DINR = in[i];
+        } else {
+            AES1->DINR = 0;
+        }
+    }
+
+    if(!crypto_wait_ccf()) {
+        return false;
+    }
 
     uint32_t out_temp[4];
     for(uint8_t i = 0; i < 4; i++) {
@@ -236,6 +319,104 @@ static bool crypto_process_block(uint32_t* in, uint32_t* out, uint8_t blk_len) {
     return true;
 }
 
+/* Number of leading bytes that can go through DMA: whole blocks, word aligned buffers */
+static size_t crypto_dma_size(const uint8_t* input, const uint8_t* output, size_t size) {
+    if((furi_hal_crypto_dma_completed == NULL) || FURI_IS_ISR() ||
+       (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)) {
+        return 0;
+    }
+    if((((uint32_t)input | (uint32_t)output) % sizeof(uint32_t)) || size < CRYPTO_DMA_MIN_SIZE) {
+        return 0;
+    }
+    return size - (size % CRYPTO_BLK_LEN);
+}
+
+static bool crypto_process_dma(const uint8_t* input, uint8_t* output, size_t size) {
+    furi_assert(size % CRYPTO_BLK_LEN == 0);
+    furi_assert(size <= CRYPTO_DMA_MAX_SIZE);
+
+    LL_DMA_InitTypeDef dma_config = {0};
+    dma_config.PeriphOrM2MSrcAddress = (uint32_t)&AES1->DINR;
+    dma_config.MemoryOrM2MDstAddress = (uint32_t)input;
+    dma_config.Direction = LL_DMA_DIRECTION_MEMORY_TO_PERIPH;
+    dma_config.Mode = LL_DMA_MODE_NORMAL;
+    dma_config.PeriphOrM2MSrcIncMode = LL_DMA_PERIPH_NOINCREMENT;
+    dma_config.MemoryOrM2MDstIncMode = LL_DMA_MEMORY_INCREMENT;
+    dma_config.PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_WORD;
+    dma_config.MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_WORD;
+    dma_config.NbData = size / sizeof(uint32_t);
+    dma_config.PeriphRequest = LL_DMAMUX_REQ_AES1_IN;
+    dma_config.Priority = LL_DMA_PRIORITY_MEDIUM;
+    LL_DMA_Init(CRYPTO_DMA_IN_DEF, &dma_config);
+
+    dma_config.PeriphOrM2MSrcAddress = (uint32_t)&AES1->DOUTR;
+    dma_config.MemoryOrM2MDstAddress = (uint32_t)output;
+    dma_config.Direction = LL_DMA_DIRECTION_PERIPH_TO_MEMORY;
+    dma_config.PeriphRequest = LL_DMAMUX_REQ_AES1_OUT;
+    dma_config.Priority = LL_DMA_PRIORITY_HIGH;
+    LL_DMA_Init(CRYPTO_DMA_OUT_DEF, &dma_config);
+
+    LL_DMA_ClearFlag_TC5(CRYPTO_DMA);
+    LL_DMA_ClearFlag_TC6(CRYPTO_DMA);
+    LL_DMA_EnableIT_TC(CRYPTO_DMA_OUT_DEF);
+
+    LL_DMA_EnableChannel(CRYPTO_DMA_OUT_DEF);
+    LL_DMA_EnableChannel(CRYPTO_DMA_IN_DEF);
+    SET_BIT(AES1->CR, AES_CR_DMAINEN | AES_CR_DMAOUTEN);
+
+    bool ret = (furi_semaphore_acquire(furi_hal_crypto_dma_completed, CRYPTO_TIMEOUT) ==
+                FuriStatusOk);
+
+    CLEAR_BIT(AES1->CR, AES_CR_DMAINEN | AES_CR_DMAOUTEN);
+    LL_DMA_DisableIT_TC(CRYPTO_DMA_OUT_DEF);
+    LL_DMA_DisableChannel(CRYPTO_DMA_IN_DEF);
+    LL_DMA_DisableChannel(CRYPTO_DMA_OUT_DEF);
+    // Completion that raced with timeout
+    furi_semaphore_acquire(furi_hal_crypto_dma_completed, 0);
+    // Last block sets CCF even when its output was taken by DMA
+    SET_BIT(AES1->CR, AES_CR_CCFC);
+
+    return ret;
+}
+
+/* Feed whole blocks through DMA, the rest block by block */
+static bool crypto_process(const uint8_t* input, uint8_t* output, size_t size) {
+    size_t dma_size = crypto_dma_size(input, output, size);
+    size_t i = 0;
+
+    while(i < dma_size) {
+        size_t chunk_size = MIN(dma_size - i, (size_t)CRYPTO_DMA_MAX_SIZE);
+        if(!crypto_process_dma(&input[i], &output[i], chunk_size)) {
+            return false;
+        }
+        i += chunk_size;
+    }
+
+    for(; i < size; i += CRYPTO_BLK_LEN) {
+        size_t blk_len = size - i;
+        if(blk_len > CRYPTO_BLK_LEN) {
+            blk_len = CRYPTO_BLK_LEN;
+        }
+        if(!crypto_process_block((uint32_t*)&input[i], (uint32_t*)&output[i], blk_len / 4)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Partial last block of byte stream modes, zero padded */
+static bool crypto_process_tail(const uint8_t* input, uint8_t* output, size_t size) {
+    furi_assert(size < CRYPTO_BLK_LEN);
+    uint32_t block[4] = {0};
+    memcpy(block, input, size);
+    if(!crypto_process_block(block, block, 4)) {
+        return false;
+    }
+    memcpy(output, block, size);
+    return true;
+}
+
 bool furi_hal_crypto_store_load_key(uint8_t slot, const uint8_t* iv) {
     furi_assert(slot > 0 && slot <= 100);
     furi_assert(furi_hal_crypto_mutex);
@@ -283,16 +464,7 @@ bool furi_hal_crypto_encrypt(const uint8_t* input, uint8_t* output, size_t size)
 
     MODIFY_REG(AES1->CR, AES_CR_MODE, CRYPTO_MODE_ENCRYPT);
 
-    for(size_t i = 0; i < size; i += CRYPTO_BLK_LEN) {
-        size_t blk_len = size - i;
-        if(blk_len > CRYPTO_BLK_LEN) {
-            blk_len = CRYPTO_BLK_LEN;
-        }
-        state = crypto_process_block((uint32_t*)&input[i], (uint32_t*)&output[i], blk_len / 4);
-        if(state == false) {
-            break;
-        }
-    }
+    state = crypto_process(input, output, size);
 
     CLEAR_BIT(AES1->CR, AES_CR_EN);
 
@@ -307,36 +479,240 @@ bool furi_hal_crypto_decrypt(const uint8_t* input, uint8_t* output, size_t size)
 
         SET_BIT(AES1->CR, AES_CR_EN);
 
-        uint32_t countdown = CRYPTO_TIMEOUT;
-        while(!READ_BIT(AES1->SR, AES_SR_CCF)) {
-            if(LL_SYSTICK_IsActiveCounterFlag()) {
-                countdown--;
-            }
-            if(countdown == 0) {
-                return false;
-            }
+        if(!crypto_wait_ccf()) {
+            return false;
         }
 
-        SET_BIT(AES1->CR, AES_CR_CCFC);
-
         furi_hal_crypto_mode_init_done = true;
     }
 
     MODIFY_REG(AES1->CR, AES_CR_MODE, CRYPTO_MODE_DECRYPT);
     SET_BIT(AES1->CR, AES_CR_EN);
 
-    for(size_t i = 0; i < size; i += CRYPTO_BLK_LEN) {
-        size_t blk_len = size - i;
-        if(blk_len > CRYPTO_BLK_LEN) {
-            blk_len = CRYPTO_BLK_LEN;
+    state = crypto_process(input, output, size);
+
+    CLEAR_BIT(AES1->CR, AES_CR_EN);
+
+    return state;
+}
+
+static void crypto_stream_start(CryptoStreamMode mode, bool decrypt) {
+    furi_assert(furi_hal_crypto_mutex);
+    furi_check(furi_mutex_acquire(furi_hal_crypto_mutex, FuriWaitForever) == FuriStatusOk);
+
+    furi_hal_crypto_stream.mode = mode;
+    furi_hal_crypto_stream.decrypt = decrypt;
+    furi_hal_crypto_stream.tail_done = false;
+    furi_hal_crypto_stream.aad_size = 0;
+    furi_hal_crypto_stream.payload_size = 0;
+}
+
+static bool crypto_stream_update(const uint8_t* input, uint8_t* output, size_t size) {
+    furi_check(!furi_hal_crypto_stream.tail_done);
+
+    size_t tail_size = size % CRYPTO_BLK_LEN;
+    size_t blocks_size = size - tail_size;
+
+    bool state = crypto_process(input, output, blocks_size);
+    if(state && tail_size) {
+        // GCM tag is calculated over ciphertext, engine must drop padding of last block
+        bool gcm_encrypt = (furi_hal_crypto_stream.mode == CryptoStreamModeGcm) &&
+                           !furi_hal_crypto_stream.decrypt;
+        if(gcm_encrypt) {
+            MODIFY_REG(
+                AES1->CR, AES_CR_NPBLB, (CRYPTO_BLK_LEN - tail_size) << AES_CR_NPBLB_Pos);
         }
-        state = crypto_process_block((uint32_t*)&input[i], (uint32_t*)&output[i], blk_len / 4);
-        if(state == false) {
-            break;
+        state = crypto_process_tail(&input[blocks_size], &output[blocks_size], tail_size);
+        if(gcm_encrypt) {
+            CLEAR_BIT(AES1->CR, AES_CR_NPBLB);
         }
+        furi_hal_crypto_stream.tail_done = true;
     }
 
+    furi_hal_crypto_stream.payload_size += size;
+    return state;
+}
+
+static void crypto_stream_finish() {
     CLEAR_BIT(AES1->CR, AES_CR_EN);
 
+    // Wipe plain key from engine
+    FURI_CRITICAL_ENTER();
+    LL_AHB2_GRP1_ForceReset(LL_AHB2_GRP1_PERIPH_AES1);
+    LL_AHB2_GRP1_ReleaseReset(LL_AHB2_GRP1_PERIPH_AES1);
+    FURI_CRITICAL_EXIT();
+
+    furi_hal_crypto_stream.mode = CryptoStreamModeNone;
+    furi_check(furi_mutex_release(furi_hal_crypto_mutex) == FuriStatusOk);
+}
+
+bool furi_hal_crypto_ctr_start(const uint8_t* key, const uint8_t* iv) {
+    furi_assert(key);
+    furi_assert(iv);
+
+    crypto_stream_start(CryptoStreamModeCtr, false);
+    crypto_key_init_bswap(key, iv, CRYPTO_AES_CTR);
+    SET_BIT(AES1->CR, AES_CR_EN);
+
+    return true;
+}
+
+bool furi_hal_crypto_ctr_update(const uint8_t* input, uint8_t* output, size_t size) {
+    furi_assert(furi_hal_crypto_stream.mode == CryptoStreamModeCtr);
+    return crypto_stream_update(input, output, size);
+}
+
+void furi_hal_crypto_ctr_finish() {
+    furi_assert(furi_hal_crypto_stream.mode == CryptoStreamModeCtr);
+    crypto_stream_finish();
+}
+
+bool furi_hal_crypto_ctr(
+    const uint8_t* key,
+    const uint8_t* iv,
+    const uint8_t* input,
+    uint8_t* output,
+    size_t size) {
+    if(!furi_hal_crypto_ctr_start(key, iv)) {
+        return false;
+    }
+    bool state = furi_hal_crypto_ctr_update(input, output, size);
+    furi_hal_crypto_ctr_finish();
     return state;
 }
+
+static bool crypto_gcm_header(const uint8_t* aad, size_t aad_size) {
+    for(size_t i = 0; i < aad_size; i += CRYPTO_BLK_LEN) {
+        uint32_t block[4] = {0};
+        memcpy(block, &aad[i], MIN(aad_size - i, (size_t)CRYPTO_BLK_LEN));
+        for(uint8_t j = 0; j < 4; j++) {
+            AES1->DINR = block[j];
+        }
+        if(!crypto_wait_ccf()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool furi_hal_crypto_gcm_start(
+    const uint8_t* key,
+    const uint8_t* iv,
+    const uint8_t* aad,
+    size_t aad_size,
+    bool decrypt) {
+    furi_assert(key);
+    furi_assert(iv);
+    furi_assert(aad || !aad_size);
+
+    crypto_stream_start(CryptoStreamModeGcm, decrypt);
+    furi_hal_crypto_stream.aad_size = aad_size;
+
+    // Payload counter starts at 2, counter block 1 encrypts the tag
+    uint8_t iv_block[CRYPTO_BLK_LEN] = {0};
+    memcpy(iv_block, iv, FURI_HAL_CRYPTO_GCM_IV_SIZE);
+    iv_block[CRYPTO_BLK_LEN - 1] = 2;
+    crypto_key_init_bswap(key, iv_block, CRYPTO_AES_GCM);
+    MODIFY_REG(AES1->CR, AES_CR_MODE, decrypt ? CRYPTO_MODE_DECRYPT : CRYPTO_MODE_ENCRYPT);
+
+    // Init phase calculates hash subkey
+    MODIFY_REG(AES1->CR, AES_CR_GCMPH, CRYPTO_GCM_PHASE_INIT);
+    SET_BIT(AES1->CR, AES_CR_EN);
+    bool state = crypto_wait_ccf();
+
+    if(state && aad_size) {
+        MODIFY_REG(AES1->CR, AES_CR_GCMPH, CRYPTO_GCM_PHASE_HEADER);
+        SET_BIT(AES1->CR, AES_CR_EN);
+        state = crypto_gcm_header(aad, aad_size);
+    }
+
+    if(state) {
+        MODIFY_REG(AES1->CR, AES_CR_GCMPH, CRYPTO_GCM_PHASE_PAYLOAD);
+        SET_BIT(AES1->CR, AES_CR_EN);
+    } else {
+        crypto_stream_finish();
+    }
+
+    return state;
+}
+
+bool furi_hal_crypto_gcm_update(const uint8_t* input, uint8_t* output, size_t size) {
+    furi_assert(furi_hal_crypto_stream.mode == CryptoStreamModeGcm);
+    return crypto_stream_update(input, output, size);
+}
+
+bool furi_hal_crypto_gcm_finish(uint8_t* tag) {
+    furi_assert(furi_hal_crypto_stream.mode == CryptoStreamModeGcm);
+    furi_assert(tag);
+
+    MODIFY_REG(AES1->CR, AES_CR_GCMPH, CRYPTO_GCM_PHASE_FINAL);
+    SET_BIT(AES1->CR, AES_CR_EN);
+
+    // Bit lengths block, swapped back by engine
+    uint64_t aad_bits = (uint64_t)furi_hal_crypto_stream.aad_size * 8;
+    uint64_t payload_bits = (uint64_t)furi_hal_crypto_stream.payload_size * 8;
+    AES1->DINR = __builtin_bswap32(aad_bits >> 32);
+    AES1->DINR = __builtin_bswap32(aad_bits);
+    AES1->DINR = __builtin_bswap32(payload_bits >> 32);
+    AES1->DINR = __builtin_bswap32(payload_bits);
+
+    bool state = crypto_wait_ccf();
+    if(state) {
+        uint32_t tag_words[FURI_HAL_CRYPTO_GCM_TAG_SIZE / sizeof(uint32_t)];
+        for(uint8_t i = 0; i < COUNT_OF(tag_words); i++) {
+            tag_words[i] = AES1->DOUTR;
+        }
+        memcpy(tag, tag_words, FURI_HAL_CRYPTO_GCM_TAG_SIZE);
+    }
+
+    crypto_stream_finish();
+    return state;
+}
+
+bool furi_hal_crypto_gcm_encrypt(
+    const uint8_t* key,
+    const uint8_t* iv,
+    const uint8_t* aad,
+    size_t aad_size,
+    const uint8_t* input,
+    uint8_t* output,
+    size_t size,
+    uint8_t* tag) {
+    if(!furi_hal_crypto_gcm_start(key, iv, aad, aad_size, false)) {
+        return false;
+    }
+    bool state = furi_hal_crypto_gcm_update(input, output, size);
+    state = furi_hal_crypto_gcm_finish(tag) && state;
+    return state;
+}
+
+bool furi_hal_crypto_gcm_decrypt(
+    const uint8_t* key,
+    const uint8_t* iv,
+    const uint8_t* aad,
+    size_t aad_size,
+    const uint8_t* input,
+    uint8_t* output,
+    size_t size,
+    const uint8_t* tag) {
+    furi_assert(tag);
+
+    if(!furi_hal_crypto_gcm_start(key, iv, aad, aad_size, true)) {
+        return false;
+    }
+    bool state = furi_hal_crypto_gcm_update(input, output, size);
+    uint8_t calculated_tag[FURI_HAL_CRYPTO_GCM_TAG_SIZE];
+    state = furi_hal_crypto_gcm_finish(calculated_tag) && state;
+
+    // Constant time compare, don't leak matching tag prefix
+    uint8_t diff = 0;
+    for(size_t i = 0; i < FURI_HAL_CRYPTO_GCM_TAG_SIZE; i++) {
+        diff |= calculated_tag[i] ^ tag[i];
+    }
+    if(!state || diff) {
+        // Never hand out unauthenticated plaintext
+        memset(output, 0, size);
+        return false;
+    }
+    return true;
+}
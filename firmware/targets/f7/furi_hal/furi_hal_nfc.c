@@ -503,6 +503,11 @@ static bool furi_hal_nfc_transparent_tx_rx(FuriHalNfcTxRxContext* tx_rx, uint16_
     furi_hal_gpio_init(&gpio_nfc_irq_rfid_pull, GpioModeInput, GpioPullDown, GpioSpeedVeryHigh);
     st25r3916ClearAndEnableInterrupts(ST25R3916_IRQ_MASK_RXE);
 
+    // Receiver is unmasked and RXE armed, answer is not lost while callback runs
+    if(tx_rx->idle_callback) {
+        tx_rx->idle_callback(tx_rx->idle_context);
+    }
+
     uint32_t irq = 0;
     uint8_t rxe = 0;
     uint32_t start = DWT->CYCCNT;
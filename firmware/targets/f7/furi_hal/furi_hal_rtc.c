@@ -157,6 +157,8 @@ void furi_hal_rtc_init() {
     LL_RTC_Init(RTC, &RTC_InitStruct);
 
     furi_log_set_level(furi_hal_rtc_get_log_level());
+    // Format logs in caller context only when debugging
+    furi_log_set_deferred(!furi_hal_rtc_is_flag_set(FuriHalRtcFlagDebug));
 
     FURI_LOG_I(TAG, "Init OK");
 }
@@ -191,6 +193,7 @@ void furi_hal_rtc_set_flag(FuriHalRtcFlag flag) {
 
     if(flag & FuriHalRtcFlagDebug) {
         furi_hal_debug_enable();
+        furi_log_set_deferred(false);
     }
 }
 
@@ -202,6 +205,7 @@ void furi_hal_rtc_reset_flag(FuriHalRtcFlag flag) {
 
     if(flag & FuriHalRtcFlagDebug) {
         furi_hal_debug_disable();
+        furi_log_set_deferred(true);
     }
 }
 
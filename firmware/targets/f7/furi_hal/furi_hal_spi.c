@@ -1,6 +1,7 @@
 #include "furi_hal_spi.h"
 #include "furi_hal_resources.h"
 #include <furi_hal_power.h>
+#include <furi_hal_interrupt.h>
 
 #include <stdbool.h>
 #include <string.h>
@@ -9,9 +10,33 @@
 #include <stm32wbxx_ll_spi.h>
 #include <stm32wbxx_ll_utils.h>
 #include <stm32wbxx_ll_cortex.h>
+#include <stm32wbxx_ll_dma.h>
 
 #define TAG "FuriHalSpi"
 
+/* DMA1 channels 1-2 are taken by infrared, subghz and digital signal */
+#define SPI_DMA DMA2
+#define SPI_DMA_RX_CHANNEL LL_DMA_CHANNEL_3
+#define SPI_DMA_TX_CHANNEL LL_DMA_CHANNEL_4
+#define SPI_DMA_RX_IRQ FuriHalInterruptIdDma2Ch3
+#define SPI_DMA_RX_DEF SPI_DMA, SPI_DMA_RX_CHANNEL
+#define SPI_DMA_TX_DEF SPI_DMA, SPI_DMA_TX_CHANNEL
+
+/* DMA channels are shared between buses */
+static FuriMutex* spi_dma_lock = NULL;
+static FuriSemaphore* spi_dma_completed = NULL;
+/* Clocked out when there is no tx data, sink for unwanted rx data */
+static uint8_t spi_dma_dummy_tx = 0xFF;
+static uint8_t spi_dma_dummy_rx = 0;
+
+static void furi_hal_spi_dma_isr(void* context) {
+    UNUSED(context);
+    if(LL_DMA_IsActiveFlag_TC3(SPI_DMA)) {
+        LL_DMA_ClearFlag_TC3(SPI_DMA);
+        furi_semaphore_release(spi_dma_completed);
+    }
+}
+
 void furi_hal_spi_init_early() {
     furi_hal_spi_bus_init(&furi_hal_spi_bus_d);
     furi_hal_spi_bus_handle_init(&furi_hal_spi_bus_handle_display);
@@ -30,6 +55,10 @@ void furi_hal_spi_init() {
     furi_hal_spi_bus_handle_init(&furi_hal_spi_bus_handle_sd_fast);
     furi_hal_spi_bus_handle_init(&furi_hal_spi_bus_handle_sd_slow);
 
+    spi_dma_lock = furi_mutex_alloc(FuriMutexTypeNormal);
+    spi_dma_completed = furi_semaphore_alloc(1, 0);
+    furi_hal_interrupt_set_isr(SPI_DMA_RX_IRQ, furi_hal_spi_dma_isr, NULL);
+
     FURI_LOG_I(TAG, "Init OK");
 }
 
@@ -167,3 +196,90 @@ bool furi_hal_spi_bus_trx(
 
     return ret;
 }
+
+/* Byte-by-byte fallback for contexts where we can't wait for DMA */
+static bool furi_hal_spi_bus_trx_poll(
+    FuriHalSpiBusHandle* handle,
+    const uint8_t* tx_buffer,
+    uint8_t* rx_buffer,
+    size_t size,
+    uint32_t timeout) {
+    for(size_t i = 0; i < size; i++) {
+        uint8_t tx_byte = tx_buffer ? tx_buffer[i] : spi_dma_dummy_tx;
+        uint8_t rx_byte = 0;
+        if(!furi_hal_spi_bus_trx(handle, &tx_byte, &rx_byte, 1, timeout)) return false;
+        if(rx_buffer) rx_buffer[i] = rx_byte;
+    }
+    return true;
+}
+
+bool furi_hal_spi_bus_trx_dma(
+    FuriHalSpiBusHandle* handle,
+    const uint8_t* tx_buffer,
+    uint8_t* rx_buffer,
+    size_t size,
+    uint32_t timeout) {
+    furi_assert(handle);
+    furi_assert(handle->bus->current_handle == handle);
+    furi_assert(size > 0);
+    furi_assert(size <= UINT16_MAX);
+
+    if((spi_dma_lock == NULL) || FURI_IS_ISR() ||
+       (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)) {
+        return furi_hal_spi_bus_trx_poll(handle, tx_buffer, rx_buffer, size, timeout);
+    }
+
+    SPI_TypeDef* spi = handle->bus->spi;
+    furi_check(furi_mutex_acquire(spi_dma_lock, FuriWaitForever) == FuriStatusOk);
+
+    LL_DMA_InitTypeDef dma_config = {0};
+    dma_config.PeriphOrM2MSrcAddress = LL_SPI_DMA_GetRegAddr(spi);
+    dma_config.MemoryOrM2MDstAddress =
+        rx_buffer ? (uint32_t)rx_buffer : (uint32_t)&spi_dma_dummy_rx;
+    dma_config.Direction = LL_DMA_DIRECTION_PERIPH_TO_MEMORY;
+    dma_config.Mode = LL_DMA_MODE_NORMAL;
+    dma_config.PeriphOrM2MSrcIncMode = LL_DMA_PERIPH_NOINCREMENT;
+    dma_config.MemoryOrM2MDstIncMode =
+        rx_buffer ? LL_DMA_MEMORY_INCREMENT : LL_DMA_MEMORY_NOINCREMENT;
+    dma_config.PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_BYTE;
+    dma_config.MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_BYTE;
+    dma_config.NbData = size;
+    dma_config.PeriphRequest = (spi == SPI1) ? LL_DMAMUX_REQ_SPI1_RX : LL_DMAMUX_REQ_SPI2_RX;
+    dma_config.Priority = LL_DMA_PRIORITY_HIGH;
+    LL_DMA_Init(SPI_DMA_RX_DEF, &dma_config);
+
+    dma_config.MemoryOrM2MDstAddress =
+        tx_buffer ? (uint32_t)tx_buffer : (uint32_t)&spi_dma_dummy_tx;
+    dma_config.Direction = LL_DMA_DIRECTION_MEMORY_TO_PERIPH;
+    dma_config.MemoryOrM2MDstIncMode =
+        tx_buffer ? LL_DMA_MEMORY_INCREMENT : LL_DMA_MEMORY_NOINCREMENT;
+    dma_config.PeriphRequest = (spi == SPI1) ? LL_DMAMUX_REQ_SPI1_TX : LL_DMAMUX_REQ_SPI2_TX;
+    dma_config.Priority = LL_DMA_PRIORITY_MEDIUM;
+    LL_DMA_Init(SPI_DMA_TX_DEF, &dma_config);
+
+    LL_DMA_ClearFlag_TC3(SPI_DMA);
+    LL_DMA_ClearFlag_TC4(SPI_DMA);
+    LL_DMA_EnableIT_TC(SPI_DMA_RX_DEF);
+
+    // RX request first, so no byte is lost when TX starts clocking
+    LL_SPI_EnableDMAReq_RX(spi);
+    LL_DMA_EnableChannel(SPI_DMA_RX_DEF);
+    LL_DMA_EnableChannel(SPI_DMA_TX_DEF);
+    LL_SPI_EnableDMAReq_TX(spi);
+
+    bool ret = (furi_semaphore_acquire(spi_dma_completed, timeout) == FuriStatusOk);
+
+    LL_SPI_DisableDMAReq_TX(spi);
+    LL_SPI_DisableDMAReq_RX(spi);
+    LL_DMA_DisableIT_TC(SPI_DMA_RX_DEF);
+    LL_DMA_DisableChannel(SPI_DMA_TX_DEF);
+    LL_DMA_DisableChannel(SPI_DMA_RX_DEF);
+    // Completion that raced with timeout
+    furi_semaphore_acquire(spi_dma_completed, 0);
+
+    furi_hal_spi_bus_end_txrx(handle, timeout);
+
+    furi_check(furi_mutex_release(spi_dma_lock) == FuriStatusOk);
+
+    return ret;
+}
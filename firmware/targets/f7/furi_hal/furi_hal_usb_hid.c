@@ -259,6 +259,11 @@ static bool hid_connected = false;
 static HidStateCallback callback;
 static void* cb_ctx;
 static uint8_t led_state;
+static uint32_t hid_type_interval = 0;
+static uint32_t hid_type_last_tick = 0;
+static uint32_t hid_type_chars = 0;
+static uint32_t hid_type_reports = 0;
+static uint32_t hid_type_ticks = 0;
 
 bool furi_hal_hid_is_connected() {
     return hid_connected;
@@ -311,6 +316,75 @@ bool furi_hal_hid_kb_release_all() {
     return hid_send_report(ReportIdKeyboard);
 }
 
+static bool hid_type_send_report() {
+    if(hid_type_interval > 0) {
+        uint32_t elapsed = furi_get_tick() - hid_type_last_tick;
+        if(elapsed < hid_type_interval) furi_delay_tick(hid_type_interval - elapsed);
+    }
+    bool state = hid_send_report(ReportIdKeyboard);
+    hid_type_last_tick = furi_get_tick();
+    hid_type_reports++;
+    return state;
+}
+
+void furi_hal_hid_kb_set_type_interval(uint32_t interval) {
+    hid_type_interval = furi_ms_to_ticks(interval);
+}
+
+bool furi_hal_hid_kb_type(const uint16_t* buttons, size_t count) {
+    furi_assert(buttons);
+    uint8_t key_nb = 0;
+    for(; key_nb < HID_KB_MAX_KEYS; key_nb++) {
+        if(hid_report.keyboard.btn[key_nb] == 0) break;
+    }
+    if(key_nb == HID_KB_MAX_KEYS) return false; // No free slot for typed keys
+
+    const uint8_t mods_held = hid_report.keyboard.mods;
+    const uint32_t tick_start = furi_get_tick();
+    bool state = true;
+
+    for(size_t i = 0; (i < count) && state; i++) {
+        uint8_t key = buttons[i] & 0xFF;
+        if(key == HID_KEYBOARD_NONE) continue;
+
+        // Release of previous key is merged into press of the next one.
+        // Same key twice in a row needs a separate release report.
+        if(hid_report.keyboard.btn[key_nb] == key) {
+            hid_report.keyboard.btn[key_nb] = 0;
+            hid_report.keyboard.mods = mods_held;
+            state = hid_type_send_report();
+            if(!state) break;
+        }
+
+        hid_report.keyboard.btn[key_nb] = key;
+        hid_report.keyboard.mods = mods_held | (buttons[i] >> 8);
+        state = hid_type_send_report();
+        if(state) hid_type_chars++;
+    }
+
+    hid_report.keyboard.btn[key_nb] = 0;
+    hid_report.keyboard.mods = mods_held;
+    state &= hid_type_send_report();
+
+    hid_type_ticks += furi_get_tick() - tick_start;
+    return state;
+}
+
+void furi_hal_hid_kb_get_type_stats(FuriHalHidTypingStats* stats) {
+    furi_assert(stats);
+    stats->chars = hid_type_chars;
+    stats->reports = hid_type_reports;
+    stats->time_ms = (uint64_t)hid_type_ticks * 1000 / furi_kernel_get_tick_frequency();
+    stats->chars_per_sec =
+        (stats->time_ms > 0) ? (uint64_t)stats->chars * 1000 / stats->time_ms : 0;
+}
+
+void furi_hal_hid_kb_reset_type_stats() {
+    hid_type_chars = 0;
+    hid_type_reports = 0;
+    hid_type_ticks = 0;
+}
+
 bool furi_hal_hid_mouse_move(int8_t dx, int8_t dy) {
     hid_report.mouse.x = dx;
     hid_report.mouse.y = dy;
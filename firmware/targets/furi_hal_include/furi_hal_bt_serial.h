@@ -7,6 +7,9 @@
 /** Serial service callback type */
 typedef SerialServiceEventCallback FuriHalBtSerialCallback;
 
+/** Serial service transmit statistics */
+typedef SerialServiceTxStats FuriHalBtSerialTxStats;
+
 /** Start Serial Profile
  */
 void furi_hal_bt_serial_start();
@@ -38,3 +41,17 @@ void furi_hal_bt_serial_notify_buffer_is_empty();
  * @return      true on success
  */
 bool furi_hal_bt_serial_tx(uint8_t* data, uint16_t size);
+
+/** Check if data is sent with notifications without waiting for client
+ * confirmation. Otherwise every packet is an indication and next packet can be
+ * sent only after SerialServiceEventTypeDataSent.
+ *
+ * @return      true if client subscribed to notifications
+ */
+bool furi_hal_bt_serial_is_tx_windowed();
+
+/** Get transmit statistics of current connection
+ *
+ * @param stats FuriHalBtSerialTxStats instance
+ */
+void furi_hal_bt_serial_get_tx_stats(FuriHalBtSerialTxStats* stats);
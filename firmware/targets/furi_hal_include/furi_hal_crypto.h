@@ -8,6 +8,21 @@
 #include <stdint.h>
 #include <stddef.h>
 
+/** AES block size in bytes */
+#define FURI_HAL_CRYPTO_BLOCK_SIZE 16
+
+/** AES-256 key size in bytes, used by CTR and GCM modes */
+#define FURI_HAL_CRYPTO_KEY_SIZE 32
+
+/** CTR initial counter block size in bytes */
+#define FURI_HAL_CRYPTO_CTR_IV_SIZE 16
+
+/** GCM nonce size in bytes */
+#define FURI_HAL_CRYPTO_GCM_IV_SIZE 12
+
+/** GCM authentication tag size in bytes */
+#define FURI_HAL_CRYPTO_GCM_TAG_SIZE 16
+
 /** FuriHalCryptoKey Type */
 typedef enum {
     FuriHalCryptoKeyTypeMaster, /**< Master key */
@@ -82,3 +97,133 @@ bool furi_hal_crypto_encrypt(const uint8_t* input, uint8_t* output, size_t size)
  * @return     true on success
  */
 bool furi_hal_crypto_decrypt(const uint8_t* input, uint8_t* output, size_t size);
+
+/** Start CTR stream with plain key
+ *
+ * AES engine is locked until furi_hal_crypto_ctr_finish is called. Buffers of 64 bytes and
+ * more are fed to AES engine through DMA when both are 4 bytes aligned.
+ *
+ * @param[in]  key   pointer to FURI_HAL_CRYPTO_KEY_SIZE bytes AES-256 key
+ * @param[in]  iv    pointer to FURI_HAL_CRYPTO_CTR_IV_SIZE bytes initial counter block,
+ *                   only last 32 bits are incremented
+ *
+ * @return     true on success
+ */
+bool furi_hal_crypto_ctr_start(const uint8_t* key, const uint8_t* iv);
+
+/** Encrypt or decrypt next part of CTR stream
+ *
+ * Size must be multiple of FURI_HAL_CRYPTO_BLOCK_SIZE, except for the last part
+ *
+ * @param      input   pointer to input data
+ * @param      output  pointer to output data, can be the same as input
+ * @param      size    input/output buffer size in bytes
+ *
+ * @return     true on success
+ */
+bool furi_hal_crypto_ctr_update(const uint8_t* input, uint8_t* output, size_t size);
+
+/** Finish CTR stream, clear key and unlock AES engine */
+void furi_hal_crypto_ctr_finish();
+
+/** Encrypt or decrypt data in CTR mode
+ *
+ * @param[in]  key     pointer to FURI_HAL_CRYPTO_KEY_SIZE bytes AES-256 key
+ * @param[in]  iv      pointer to FURI_HAL_CRYPTO_CTR_IV_SIZE bytes initial counter block
+ * @param      input   pointer to input data
+ * @param      output  pointer to output data, can be the same as input
+ * @param      size    input/output buffer size in bytes
+ *
+ * @return     true on success
+ */
+bool furi_hal_crypto_ctr(
+    const uint8_t* key,
+    const uint8_t* iv,
+    const uint8_t* input,
+    uint8_t* output,
+    size_t size);
+
+/** Start GCM stream with plain key
+ *
+ * AES engine is locked until furi_hal_crypto_gcm_finish is called
+ *
+ * @param[in]  key       pointer to FURI_HAL_CRYPTO_KEY_SIZE bytes AES-256 key
+ * @param[in]  iv        pointer to FURI_HAL_CRYPTO_GCM_IV_SIZE bytes nonce
+ * @param[in]  aad       pointer to additional authenticated data, can be NULL
+ * @param      aad_size  additional authenticated data size in bytes
+ * @param      decrypt   true to decrypt, false to encrypt
+ *
+ * @return     true on success
+ */
+bool furi_hal_crypto_gcm_start(
+    const uint8_t* key,
+    const uint8_t* iv,
+    const uint8_t* aad,
+    size_t aad_size,
+    bool decrypt);
+
+/** Encrypt or decrypt next part of GCM stream
+ *
+ * Size must be multiple of FURI_HAL_CRYPTO_BLOCK_SIZE, except for the last part
+ *
+ * @param      input   pointer to input data
+ * @param      output  pointer to output data, can be the same as input
+ * @param      size    input/output buffer size in bytes
+ *
+ * @return     true on success
+ */
+bool furi_hal_crypto_gcm_update(const uint8_t* input, uint8_t* output, size_t size);
+
+/** Finish GCM stream, clear key and unlock AES engine
+ *
+ * @param      tag   pointer to FURI_HAL_CRYPTO_GCM_TAG_SIZE bytes buffer for tag
+ *
+ * @return     true on success
+ */
+bool furi_hal_crypto_gcm_finish(uint8_t* tag);
+
+/** Encrypt data in GCM mode
+ *
+ * @param[in]  key       pointer to FURI_HAL_CRYPTO_KEY_SIZE bytes AES-256 key
+ * @param[in]  iv        pointer to FURI_HAL_CRYPTO_GCM_IV_SIZE bytes nonce
+ * @param[in]  aad       pointer to additional authenticated data, can be NULL
+ * @param      aad_size  additional authenticated data size in bytes
+ * @param      input     pointer to input data
+ * @param      output    pointer to output data, can be the same as input
+ * @param      size      input/output buffer size in bytes
+ * @param      tag       pointer to FURI_HAL_CRYPTO_GCM_TAG_SIZE bytes buffer for tag
+ *
+ * @return     true on success
+ */
+bool furi_hal_crypto_gcm_encrypt(
+    const uint8_t* key,
+    const uint8_t* iv,
+    const uint8_t* aad,
+    size_t aad_size,
+    const uint8_t* input,
+    uint8_t* output,
+    size_t size,
+    uint8_t* tag);
+
+/** Decrypt data in GCM mode and verify tag
+ *
+ * @param[in]  key       pointer to FURI_HAL_CRYPTO_KEY_SIZE bytes AES-256 key
+ * @param[in]  iv        pointer to FURI_HAL_CRYPTO_GCM_IV_SIZE bytes nonce
+ * @param[in]  aad       pointer to additional authenticated data, can be NULL
+ * @param      aad_size  additional authenticated data size in bytes
+ * @param      input     pointer to input data
+ * @param      output    pointer to output data, can be the same as input
+ * @param      size      input/output buffer size in bytes
+ * @param[in]  tag       pointer to FURI_HAL_CRYPTO_GCM_TAG_SIZE bytes expected tag
+ *
+ * @return     true on success, false on error or tag mismatch
+ */
+bool furi_hal_crypto_gcm_decrypt(
+    const uint8_t* key,
+    const uint8_t* iv,
+    const uint8_t* aad,
+    size_t aad_size,
+    const uint8_t* input,
+    uint8_t* output,
+    size_t size,
+    const uint8_t* tag);
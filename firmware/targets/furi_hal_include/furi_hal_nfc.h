@@ -83,6 +83,8 @@ typedef struct {
 typedef void (
     *FuriHalNfcTxRxSniffCallback)(uint8_t* data, uint16_t bits, bool crc_dropped, void* context);
 
+typedef void (*FuriHalNfcTxRxIdleCallback)(void* context);
+
 typedef struct {
     uint8_t tx_data[FURI_HAL_NFC_DATA_BUFF_SIZE];
     uint8_t tx_parity[FURI_HAL_NFC_PARITY_BUFF_SIZE];
@@ -96,6 +98,10 @@ typedef struct {
     FuriHalNfcTxRxSniffCallback sniff_tx;
     FuriHalNfcTxRxSniffCallback sniff_rx;
     void* sniff_context;
+
+    /** Called in transparent mode after frame is sent, while the other side prepares answer */
+    FuriHalNfcTxRxIdleCallback idle_callback;
+    void* idle_context;
 } FuriHalNfcTxRxContext;
 
 /** Init nfc
@@ -162,6 +162,14 @@ typedef struct {
 
 typedef void (*HidStateCallback)(bool state, void* context);
 
+/** Keyboard typing statistics, see furi_hal_hid_kb_type */
+typedef struct {
+    uint32_t chars; /**< keys typed */
+    uint32_t reports; /**< keyboard reports sent */
+    uint32_t time_ms; /**< time spent typing */
+    uint32_t chars_per_sec; /**< average typing speed */
+} FuriHalHidTypingStats;
+
 /** ASCII to keycode conversion macro */
 #define HID_ASCII_TO_KEY(x) (((uint8_t)x < 128) ? (hid_asciimap[(uint8_t)x]) : HID_KEYBOARD_NONE)
 
@@ -215,6 +223,38 @@ bool furi_hal_hid_kb_release(uint16_t button);
  */
 bool furi_hal_hid_kb_release_all();
 
+/** Type sequence of keys: press and release each one in turn
+ *
+ * Release of a key is merged into the report that presses the next one, so
+ * each key costs one report instead of two. Reports go out as fast as host
+ * polls the endpoint, unless slowed down with
+ * furi_hal_hid_kb_set_type_interval. Keys and modifiers held with
+ * furi_hal_hid_kb_press stay pressed.
+ *
+ * @param      buttons  key codes with modifiers
+ * @param      count    number of keys
+ *
+ * @return     true if all reports were sent
+ */
+bool furi_hal_hid_kb_type(const uint16_t* buttons, size_t count);
+
+/** Set minimal interval between reports sent by furi_hal_hid_kb_type
+ *
+ * @param      interval  interval in ms, 0 - host polling rate
+ */
+void furi_hal_hid_kb_set_type_interval(uint32_t interval);
+
+/** Get keyboard typing statistics
+ *
+ * @param      stats  statistics output
+ */
+void furi_hal_hid_kb_get_type_stats(FuriHalHidTypingStats* stats);
+
+/** Reset keyboard typing statistics
+ *
+ */
+void furi_hal_hid_kb_reset_type_stats();
+
 /** Set mouse movement and send HID report
  *
  * @param      dx  x coordinate delta
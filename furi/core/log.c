@@ -1,19 +1,459 @@
 #include "log.h"
 #include "check.h"
 #include "mutex.h"
+#include "thread.h"
 #include <furi_hal.h>
 
 #define FURI_LOG_LEVEL_DEFAULT FuriLogLevelInfo
 
+/* Deferred mode: records hold format pointer and raw arguments, formatting
+ * is done by drain thread. Ring size must be power of 2.
+ */
+#define FURI_LOG_DEFERRED_RING_SIZE 2048
+#define FURI_LOG_DEFERRED_RECORD_MAX 192
+#define FURI_LOG_DEFERRED_STRING_MAX 48
+#define FURI_LOG_DEFERRED_STRING_TRUNCATED (1 << 7) /* Flag in string length byte */
+#define FURI_LOG_DEFERRED_ELLIPSIS "\xe2\x80\xa6"
+#define FURI_LOG_DEFERRED_LINE_SIZE 128
+#define FURI_LOG_DEFERRED_SPEC_MAX 16
+#define FURI_LOG_DEFERRED_ALIGN sizeof(void*)
+#define FURI_LOG_DEFERRED_FLAG_DATA (1 << 0)
+
+typedef enum {
+    FuriLogArgNone, /* %% */
+    FuriLogArgInt,
+    FuriLogArgLong,
+    FuriLogArgLongLong,
+    FuriLogArgSize,
+    FuriLogArgPointer,
+    FuriLogArgDouble,
+    FuriLogArgString,
+    FuriLogArgInvalid, /* Unsupported conversion, rest of format is printed as is */
+} FuriLogArgType;
+
+typedef enum {
+    FuriLogRecordFlagPad = (1 << 0), /* Skip to ring start */
+    FuriLogRecordFlagTruncated = (1 << 1),
+} FuriLogRecordFlag;
+
+typedef struct {
+    uint16_t size; /* Header and arguments, without alignment */
+    uint8_t level;
+    uint8_t flags;
+    uint32_t timestamp;
+    const char* format;
+} FuriLogRecord;
+
 typedef struct {
     FuriLogLevel log_level;
     FuriLogPuts puts;
     FuriLogTimestamp timetamp;
     FuriMutex* mutex;
+
+    bool deferred;
+    uint8_t* ring;
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t dropped;
+    uint32_t dropped_reported;
+    FuriThread* thread;
 } FuriLogParams;
 
 static FuriLogParams furi_log;
 
+static inline size_t furi_log_deferred_align(size_t size) {
+    return (size + FURI_LOG_DEFERRED_ALIGN - 1) & ~(FURI_LOG_DEFERRED_ALIGN - 1);
+}
+
+/* Parse conversion spec starting with '%', same parser is used on both ends */
+static size_t furi_log_spec_parse(const char* spec, FuriLogArgType* type, uint8_t* stars) {
+    size_t i = 1;
+    *stars = 0;
+    *type = FuriLogArgInvalid;
+
+    while(spec[i] && strchr("-+ #0", spec[i])) i++;
+    if(spec[i] == '*') {
+        (*stars)++;
+        i++;
+    } else {
+        while(spec[i] >= '0' && spec[i] <= '9') i++;
+    }
+    if(spec[i] == '.') {
+        i++;
+        if(spec[i] == '*') {
+            (*stars)++;
+            i++;
+        } else {
+            while(spec[i] >= '0' && spec[i] <= '9') i++;
+        }
+    }
+
+    FuriLogArgType integer = FuriLogArgInt;
+    if(spec[i] == 'h') {
+        i++;
+        if(spec[i] == 'h') i++;
+    } else if(spec[i] == 'l') {
+        i++;
+        integer = FuriLogArgLong;
+        if(spec[i] == 'l') {
+            i++;
+            integer = FuriLogArgLongLong;
+        }
+    } else if(spec[i] == 'j') {
+        i++;
+        integer = FuriLogArgLongLong;
+    } else if(spec[i] == 'z' || spec[i] == 't') {
+        i++;
+        integer = FuriLogArgSize;
+    }
+
+    if(i + 1 >= FURI_LOG_DEFERRED_SPEC_MAX) return i;
+    switch(spec[i]) {
+    case '%':
+        if(i == 1) *type = FuriLogArgNone;
+        break;
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+    case 'c':
+        *type = integer;
+        break;
+    case 'p':
+        *type = FuriLogArgPointer;
+        break;
+    case 's':
+        *type = FuriLogArgString;
+        break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+        *type = FuriLogArgDouble;
+        break;
+    default:
+        return i;
+    }
+
+    return i + 1;
+}
+
+static size_t furi_log_arg_size(FuriLogArgType type) {
+    switch(type) {
+    case FuriLogArgInt:
+        return sizeof(unsigned int);
+    case FuriLogArgLong:
+        return sizeof(unsigned long);
+    case FuriLogArgLongLong:
+        return sizeof(unsigned long long);
+    case FuriLogArgSize:
+        return sizeof(size_t);
+    case FuriLogArgPointer:
+        return sizeof(void*);
+    case FuriLogArgDouble:
+        return sizeof(double);
+    default:
+        return 0;
+    }
+}
+
+/* Store arguments after record header, returns false if they didn't fit */
+static bool
+    furi_log_deferred_capture(uint8_t* buffer, size_t* size, const char* format, va_list args) {
+    const size_t buffer_size = FURI_LOG_DEFERRED_RECORD_MAX;
+
+    for(const char* p = format; *p; p++) {
+        if(*p != '%') continue;
+
+        FuriLogArgType type;
+        uint8_t stars;
+        p += furi_log_spec_parse(p, &type, &stars) - 1;
+        if(type == FuriLogArgInvalid) break;
+
+        for(uint8_t i = 0; i < stars; i++) {
+            int star = va_arg(args, int);
+            if(*size + sizeof(int) > buffer_size) return false;
+            memcpy(&buffer[*size], &star, sizeof(int));
+            *size += sizeof(int);
+        }
+
+        union {
+            unsigned int i;
+            unsigned long l;
+            unsigned long long ll;
+            size_t z;
+            void* p;
+            double d;
+        } value;
+
+        switch(type) {
+        case FuriLogArgInt:
+            value.i = va_arg(args, unsigned int);
+            break;
+        case FuriLogArgLong:
+            value.l = va_arg(args, unsigned long);
+            break;
+        case FuriLogArgLongLong:
+            value.ll = va_arg(args, unsigned long long);
+            break;
+        case FuriLogArgSize:
+            value.z = va_arg(args, size_t);
+            break;
+        case FuriLogArgPointer:
+            value.p = va_arg(args, void*);
+            break;
+        case FuriLogArgDouble:
+            value.d = va_arg(args, double);
+            break;
+        case FuriLogArgString: {
+            const char* string = va_arg(args, const char*);
+            if(!string) string = "(null)";
+            size_t length = strnlen(string, FURI_LOG_DEFERRED_STRING_MAX + 1);
+            uint8_t truncated = 0;
+            if(length > FURI_LOG_DEFERRED_STRING_MAX) {
+                length = FURI_LOG_DEFERRED_STRING_MAX;
+                truncated = FURI_LOG_DEFERRED_STRING_TRUNCATED;
+            }
+            if(*size + 1 + length > buffer_size) return false;
+            buffer[(*size)++] = length | truncated;
+            memcpy(&buffer[*size], string, length);
+            *size += length;
+            continue;
+        }
+        default:
+            continue;
+        }
+
+        size_t arg_size = furi_log_arg_size(type);
+        if(*size + arg_size > buffer_size) return false;
+        memcpy(&buffer[*size], &value, arg_size);
+        *size += arg_size;
+    }
+
+    return true;
+}
+
+static void furi_log_deferred_write(FuriLogLevel level, const char* format, va_list args) {
+    uint8_t buffer[FURI_LOG_DEFERRED_RECORD_MAX] __attribute__((aligned(sizeof(void*))));
+    FuriLogRecord* record = (FuriLogRecord*)buffer;
+    size_t size = sizeof(FuriLogRecord);
+
+    record->level = level;
+    record->flags = 0;
+    record->timestamp = furi_log.timetamp();
+    record->format = format;
+    if(!furi_log_deferred_capture(buffer, &size, format, args)) {
+        record->flags |= FuriLogRecordFlagTruncated;
+    }
+    record->size = size;
+
+    const size_t aligned = furi_log_deferred_align(size);
+    bool notify = false;
+
+    FURI_CRITICAL_ENTER();
+    const uint32_t head = furi_log.head;
+    const uint32_t used = head - furi_log.tail;
+    const size_t offset = head & (FURI_LOG_DEFERRED_RING_SIZE - 1);
+    const size_t contiguous = FURI_LOG_DEFERRED_RING_SIZE - offset;
+    const size_t pad = (contiguous < aligned) ? contiguous : 0;
+
+    if(pad + aligned > FURI_LOG_DEFERRED_RING_SIZE - used) {
+        furi_log.dropped++;
+    } else {
+        if(pad) {
+            FuriLogRecord* pad_record = (FuriLogRecord*)&furi_log.ring[offset];
+            pad_record->size = pad;
+            pad_record->flags = FuriLogRecordFlagPad;
+        }
+        memcpy(&furi_log.ring[(head + pad) & (FURI_LOG_DEFERRED_RING_SIZE - 1)], buffer, size);
+        furi_log.head = head + pad + aligned;
+        notify = (used == 0);
+    }
+    FURI_CRITICAL_EXIT();
+
+    if(notify) {
+        furi_thread_flags_set(furi_thread_get_id(furi_log.thread), FURI_LOG_DEFERRED_FLAG_DATA);
+    }
+}
+
+static void furi_log_deferred_flush(char* line, size_t* length) {
+    if(*length) {
+        line[*length] = '\0';
+        furi_log.puts(line);
+        *length = 0;
+    }
+}
+
+static void furi_log_deferred_print(const FuriLogRecord* record) {
+    char line[FURI_LOG_DEFERRED_LINE_SIZE];
+    char spec[FURI_LOG_DEFERRED_SPEC_MAX + 24];
+    const uint8_t* payload = (const uint8_t*)record;
+    size_t position = sizeof(FuriLogRecord);
+    size_t length = snprintf(line, sizeof(line), "%lu ", (uint32_t)record->timestamp);
+
+    const char* p = record->format;
+    bool raw = false;
+    while(*p) {
+        if(length + 1 >= sizeof(line)) furi_log_deferred_flush(line, &length);
+
+        if(raw || *p != '%') {
+            line[length++] = *p++;
+            continue;
+        }
+
+        FuriLogArgType type;
+        uint8_t stars;
+        size_t spec_length = furi_log_spec_parse(p, &type, &stars);
+        if(type == FuriLogArgNone) {
+            line[length++] = '%';
+            p += spec_length;
+            continue;
+        } else if(type == FuriLogArgInvalid) {
+            /* Arguments were not captured past this point, print rest as is */
+            raw = true;
+            continue;
+        }
+
+        /* Substitute '*' with stored values */
+        size_t spec_position = 0;
+        bool complete = true;
+        for(size_t i = 0; i < spec_length; i++) {
+            if(p[i] == '*') {
+                int star;
+                if(position + sizeof(int) > record->size) {
+                    complete = false;
+                    break;
+                }
+                memcpy(&star, &payload[position], sizeof(int));
+                position += sizeof(int);
+                spec_position += snprintf(
+                    &spec[spec_position], sizeof(spec) - spec_position, "%d", star);
+            } else {
+                spec[spec_position++] = p[i];
+            }
+        }
+        spec[spec_position] = '\0';
+
+        union {
+            unsigned int i;
+            unsigned long l;
+            unsigned long long ll;
+            size_t z;
+            void* p;
+            double d;
+        } value;
+        char string[FURI_LOG_DEFERRED_STRING_MAX + sizeof(FURI_LOG_DEFERRED_ELLIPSIS)];
+        size_t arg_size = (type == FuriLogArgString) ? 1 : furi_log_arg_size(type);
+
+        if(!complete || (position + arg_size > record->size)) break;
+        if(type == FuriLogArgString) {
+            const uint8_t string_info = payload[position++];
+            size_t string_length = string_info & ~FURI_LOG_DEFERRED_STRING_TRUNCATED;
+            if(position + string_length > record->size) break;
+            memcpy(string, &payload[position], string_length);
+            string[string_length] = '\0';
+            position += string_length;
+            /* Make clipped argument visible */
+            if(string_info & FURI_LOG_DEFERRED_STRING_TRUNCATED) {
+                strcat(string, FURI_LOG_DEFERRED_ELLIPSIS);
+            }
+        } else {
+            memcpy(&value, &payload[position], arg_size);
+            position += arg_size;
+        }
+
+        /* Leave room for formatted value */
+        if(length + 64 >= sizeof(line)) furi_log_deferred_flush(line, &length);
+        size_t space = sizeof(line) - length;
+        int written = 0;
+        switch(type) {
+        case FuriLogArgInt:
+            written = snprintf(&line[length], space, spec, value.i);
+            break;
+        case FuriLogArgLong:
+            written = snprintf(&line[length], space, spec, value.l);
+            break;
+        case FuriLogArgLongLong:
+            written = snprintf(&line[length], space, spec, value.ll);
+            break;
+        case FuriLogArgSize:
+            written = snprintf(&line[length], space, spec, value.z);
+            break;
+        case FuriLogArgPointer:
+            written = snprintf(&line[length], space, spec, value.p);
+            break;
+        case FuriLogArgDouble:
+            written = snprintf(&line[length], space, spec, value.d);
+            break;
+        case FuriLogArgString:
+            written = snprintf(&line[length], space, spec, string);
+            break;
+        default:
+            break;
+        }
+        if(written > 0) length += MIN((size_t)written, space - 1);
+        p += spec_length;
+    }
+
+    furi_log_deferred_flush(line, &length);
+    if(*p) {
+        furi_log.puts(" [truncated]\r\n");
+    }
+}
+
+static int32_t furi_log_deferred_thread(void* context) {
+    UNUSED(context);
+    uint8_t buffer[FURI_LOG_DEFERRED_RECORD_MAX] __attribute__((aligned(sizeof(void*))));
+    const FuriLogRecord* record = (const FuriLogRecord*)buffer;
+
+    while(true) {
+        furi_thread_flags_wait(FURI_LOG_DEFERRED_FLAG_DATA, FuriFlagWaitAny, FuriWaitForever);
+
+        while(furi_log.tail != furi_log.head) {
+            const uint32_t tail = furi_log.tail;
+            const FuriLogRecord* ring_record =
+                (const FuriLogRecord*)&furi_log.ring[tail & (FURI_LOG_DEFERRED_RING_SIZE - 1)];
+            if(ring_record->flags & FuriLogRecordFlagPad) {
+                furi_log.tail = tail + ring_record->size;
+                continue;
+            }
+
+            /* Release ring space before formatting */
+            memcpy(buffer, ring_record, ring_record->size);
+            asm volatile("" ::: "memory");
+            furi_log.tail = tail + furi_log_deferred_align(record->size);
+
+            if(furi_mutex_acquire(furi_log.mutex, FuriWaitForever) == FuriStatusOk) {
+                furi_log_deferred_print(record);
+                furi_mutex_release(furi_log.mutex);
+            }
+        }
+
+        const uint32_t dropped = furi_log.dropped;
+        if(dropped != furi_log.dropped_reported &&
+           furi_mutex_acquire(furi_log.mutex, FuriWaitForever) == FuriStatusOk) {
+            char line[FURI_LOG_DEFERRED_LINE_SIZE];
+            snprintf(
+                line,
+                sizeof(line),
+                "%lu " FURI_LOG_CLR_W "[W][Log]: " FURI_LOG_CLR_RESET "%lu records dropped\r\n",
+                furi_log.timetamp(),
+                dropped - furi_log.dropped_reported);
+            furi_log.dropped_reported = dropped;
+            furi_log.puts(line);
+            furi_mutex_release(furi_log.mutex);
+        }
+    }
+
+    return 0;
+}
+
 void furi_log_init() {
     // Set default logging parameters
     furi_log.log_level = FURI_LOG_LEVEL_DEFAULT;
@@ -23,7 +463,13 @@ void furi_log_init() {
 }
 
 void furi_log_print(FuriLogLevel level, const char* format, ...) {
-    if(level <= furi_log.log_level &&
+    if(level <= furi_log.log_level && furi_log.deferred) {
+        va_list args;
+        va_start(args, format);
+        furi_log_deferred_write(level, format, args);
+        va_end(args);
+    } else if(
+        level <= furi_log.log_level &&
        furi_mutex_acquire(furi_log.mutex, FuriWaitForever) == FuriStatusOk) {
         string_t string;
 
@@ -60,6 +506,27 @@ void furi_log_set_puts(FuriLogPuts puts) {
     furi_log.puts = puts;
 }
 
+void furi_log_set_deferred(bool deferred) {
+    if(deferred && !furi_log.thread) {
+        furi_log.ring = malloc(FURI_LOG_DEFERRED_RING_SIZE);
+        furi_log.thread = furi_thread_alloc();
+        furi_thread_set_name(furi_log.thread, "LogDrain");
+        furi_thread_set_stack_size(furi_log.thread, 2048);
+        furi_thread_set_priority(furi_log.thread, FuriThreadPriorityLow);
+        furi_thread_set_callback(furi_log.thread, furi_log_deferred_thread);
+        furi_thread_start(furi_log.thread);
+    }
+    furi_log.deferred = deferred;
+}
+
+bool furi_log_is_deferred() {
+    return furi_log.deferred;
+}
+
+uint32_t furi_log_get_dropped() {
+    return furi_log.dropped;
+}
+
 void furi_log_set_timestamp(FuriLogTimestamp timestamp) {
     furi_assert(timestamp);
     furi_log.timetamp = timestamp;
@@ -6,6 +6,7 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <stdarg.h>
 
 #ifdef __cplusplus
@@ -70,6 +71,30 @@ FuriLogLevel furi_log_get_level();
  */
 void furi_log_set_puts(FuriLogPuts puts);
 
+/** Set deferred mode. In deferred mode log records are stored in ring
+ * buffer as format pointer and raw arguments, formatting and output are done
+ * by low priority thread. Records that don't fit in ring are dropped.
+ *
+ * @warning    format must be a string literal, strings passed as arguments
+ *             are copied and truncated to 48 characters, truncated ones are
+ *             printed with trailing "…"
+ *
+ * @param[in]  deferred  true to enable deferred mode
+ */
+void furi_log_set_deferred(bool deferred);
+
+/** Get deferred mode
+ *
+ * @return     true if deferred mode is enabled
+ */
+bool furi_log_is_deferred();
+
+/** Get number of records dropped in deferred mode
+ *
+ * @return     dropped record count
+ */
+uint32_t furi_log_get_dropped();
+
 /** Set timestamp callback
  *
  * @param[in]  timestamp  The timestamp callback
@@ -1,5 +1,6 @@
 #include "memmgr.h"
 #include "common_defines.h"
+#include "memmgr_heap.h"
 #include <string.h>
 
 extern void* pvPortMalloc(size_t xSize);
@@ -24,7 +25,8 @@ void* realloc(void* ptr, size_t size) {
 
     void* p = pvPortMalloc(size);
     if(ptr != NULL) {
-        memcpy(p, ptr, size);
+        // Old block may be smaller, slab objects are packed next to each other
+        memcpy(p, ptr, MIN(size, memmgr_heap_get_block_size(ptr)));
         vPortFree(ptr);
     }
 
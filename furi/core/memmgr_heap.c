@@ -157,6 +157,8 @@ void memmgr_heap_disable_thread_trace(FuriThreadId thread_id) {
     (void)xTaskResumeAll();
 }
 
+static inline MemmgrHeapArena* memmgr_heap_arena_get(TaskHandle_t task);
+
 size_t memmgr_heap_get_thread_memory(FuriThreadId thread_id) {
     size_t leftovers = MEMMGR_HEAP_UNKNOWN;
     vTaskSuspendAll();
@@ -182,6 +184,11 @@ size_t memmgr_heap_get_thread_memory(FuriThreadId thread_id) {
                     }
                 }
             }
+        } else {
+            /* Not traced, but may own arena: it is only released by owner after
+             * unbinding, which can't happen while scheduler is suspended */
+            MemmgrHeapArena* arena = memmgr_heap_arena_get((TaskHandle_t)thread_id);
+            if(arena) leftovers = memmgr_heap_arena_get_size(arena);
         }
         memmgr_heap_thread_trace_depth--;
     }
@@ -218,6 +225,338 @@ static inline void traceFREE(void* pointer, size_t size) {
     }
 }
 
+/* Slab front-end: small allocations are served from fixed size class pages.
+ * Pages are carved from the end of the heap on init, page index is derived
+ * from object address, so both allocation and free are O(1).
+ */
+#define MEMMGR_SLAB_PAGE_NONE 0xFF
+
+typedef struct {
+    void* free_list; /* Freed objects, linked through first word */
+    uint16_t used; /* Objects handed out */
+    uint16_t carved; /* Objects ever taken from page, rest is untouched */
+    uint8_t class_id;
+    uint8_t prev;
+    uint8_t next;
+} MemmgrSlabPage;
+
+typedef struct {
+    uint16_t object_size;
+    uint16_t objects_per_page;
+    uint8_t partial; /* Pages of this class with free objects */
+    MemmgrHeapSlabStats stats;
+} MemmgrSlabClass;
+
+static const uint16_t memmgr_slab_class_size[] = {16, 32, 48, 64, 96, 128, 192, 256};
+#define MEMMGR_SLAB_CLASS_COUNT COUNT_OF(memmgr_slab_class_size)
+#define MEMMGR_SLAB_OBJECT_MAX 256
+#define MEMMGR_SLAB_SIZE (MEMMGR_SLAB_PAGES * MEMMGR_SLAB_PAGE_SIZE)
+
+static uint8_t* memmgr_slab_base = NULL;
+static MemmgrSlabPage memmgr_slab_pages[MEMMGR_SLAB_PAGES];
+static MemmgrSlabClass memmgr_slab_classes[MEMMGR_SLAB_CLASS_COUNT];
+/* Size class lookup, indexed by (size - 1) / 16 */
+static uint8_t memmgr_slab_class_lookup[MEMMGR_SLAB_OBJECT_MAX / 16];
+static uint8_t memmgr_slab_free_pages = MEMMGR_SLAB_PAGE_NONE;
+static size_t memmgr_slab_used_bytes = 0;
+
+static void memmgr_slab_init(uint8_t* base) {
+    memmgr_slab_base = base;
+
+    for(size_t i = 0; i < MEMMGR_SLAB_PAGES; i++) {
+        memmgr_slab_pages[i].class_id = MEMMGR_SLAB_PAGE_NONE;
+        memmgr_slab_pages[i].next = (i + 1 < MEMMGR_SLAB_PAGES) ? i + 1 : MEMMGR_SLAB_PAGE_NONE;
+    }
+    memmgr_slab_free_pages = 0;
+
+    size_t class_id = 0;
+    for(size_t i = 0; i < COUNT_OF(memmgr_slab_class_lookup); i++) {
+        while(memmgr_slab_class_size[class_id] < (i + 1) * 16) class_id++;
+        memmgr_slab_class_lookup[i] = class_id;
+    }
+    for(size_t i = 0; i < MEMMGR_SLAB_CLASS_COUNT; i++) {
+        memmgr_slab_classes[i].object_size = memmgr_slab_class_size[i];
+        memmgr_slab_classes[i].objects_per_page =
+            MEMMGR_SLAB_PAGE_SIZE / memmgr_slab_class_size[i];
+        memmgr_slab_classes[i].partial = MEMMGR_SLAB_PAGE_NONE;
+        memmgr_slab_classes[i].stats.object_size = memmgr_slab_class_size[i];
+    }
+}
+
+static inline bool memmgr_slab_contains(const void* pointer) {
+    return memmgr_slab_base && ((uint8_t*)pointer >= memmgr_slab_base) &&
+           ((uint8_t*)pointer < memmgr_slab_base + MEMMGR_SLAB_SIZE);
+}
+
+static void memmgr_slab_partial_push(MemmgrSlabClass* slab_class, uint8_t page_id) {
+    MemmgrSlabPage* page = &memmgr_slab_pages[page_id];
+    page->prev = MEMMGR_SLAB_PAGE_NONE;
+    page->next = slab_class->partial;
+    if(slab_class->partial != MEMMGR_SLAB_PAGE_NONE) {
+        memmgr_slab_pages[slab_class->partial].prev = page_id;
+    }
+    slab_class->partial = page_id;
+}
+
+static void memmgr_slab_partial_remove(MemmgrSlabClass* slab_class, uint8_t page_id) {
+    MemmgrSlabPage* page = &memmgr_slab_pages[page_id];
+    if(page->prev != MEMMGR_SLAB_PAGE_NONE) {
+        memmgr_slab_pages[page->prev].next = page->next;
+    } else {
+        slab_class->partial = page->next;
+    }
+    if(page->next != MEMMGR_SLAB_PAGE_NONE) {
+        memmgr_slab_pages[page->next].prev = page->prev;
+    }
+}
+
+/* Must be called with scheduler suspended, returns NULL if no page is available */
+static void* memmgr_slab_alloc(size_t size, size_t* object_size) {
+    MemmgrSlabClass* slab_class = &memmgr_slab_classes[memmgr_slab_class_lookup[(size - 1) / 16]];
+    uint8_t page_id = slab_class->partial;
+
+    if(page_id == MEMMGR_SLAB_PAGE_NONE) {
+        page_id = memmgr_slab_free_pages;
+        if(page_id == MEMMGR_SLAB_PAGE_NONE) {
+            slab_class->stats.fallbacks++;
+            return NULL;
+        }
+        memmgr_slab_free_pages = memmgr_slab_pages[page_id].next;
+        memmgr_slab_pages[page_id].class_id = slab_class - memmgr_slab_classes;
+        memmgr_slab_partial_push(slab_class, page_id);
+        slab_class->stats.pages++;
+    }
+
+    MemmgrSlabPage* page = &memmgr_slab_pages[page_id];
+    void* pointer = page->free_list;
+    if(pointer) {
+        page->free_list = *(void**)pointer;
+    } else {
+        pointer = memmgr_slab_base + page_id * MEMMGR_SLAB_PAGE_SIZE +
+                  page->carved * slab_class->object_size;
+        page->carved++;
+    }
+
+    page->used++;
+    if(page->used == slab_class->objects_per_page) {
+        memmgr_slab_partial_remove(slab_class, page_id);
+    }
+
+    slab_class->stats.used++;
+    slab_class->stats.allocs++;
+    if(slab_class->stats.used > slab_class->stats.peak) {
+        slab_class->stats.peak = slab_class->stats.used;
+    }
+    memmgr_slab_used_bytes += slab_class->object_size;
+
+    *object_size = slab_class->object_size;
+    return pointer;
+}
+
+/* Must be called with scheduler suspended */
+static size_t memmgr_slab_free(void* pointer) {
+    size_t offset = (uint8_t*)pointer - memmgr_slab_base;
+    uint8_t page_id = offset / MEMMGR_SLAB_PAGE_SIZE;
+    MemmgrSlabPage* page = &memmgr_slab_pages[page_id];
+    furi_check(page->class_id < MEMMGR_SLAB_CLASS_COUNT);
+    MemmgrSlabClass* slab_class = &memmgr_slab_classes[page->class_id];
+    furi_check((offset % MEMMGR_SLAB_PAGE_SIZE) % slab_class->object_size == 0);
+    furi_check(page->used > 0);
+
+    if(page->used == slab_class->objects_per_page) {
+        memmgr_slab_partial_push(slab_class, page_id);
+    }
+    page->used--;
+    slab_class->stats.used--;
+    memmgr_slab_used_bytes -= slab_class->object_size;
+
+    if(page->used == 0) {
+        /* Return empty page to pool, so it can be reused by another class */
+        memmgr_slab_partial_remove(slab_class, page_id);
+        page->class_id = MEMMGR_SLAB_PAGE_NONE;
+        page->free_list = NULL;
+        page->carved = 0;
+        page->next = memmgr_slab_free_pages;
+        memmgr_slab_free_pages = page_id;
+        slab_class->stats.pages--;
+    } else {
+        *(void**)pointer = page->free_list;
+        page->free_list = pointer;
+    }
+
+    return slab_class->object_size;
+}
+
+/* Free heap and slab bytes */
+static inline size_t memmgr_heap_free_bytes() {
+    return xFreeBytesRemaining + MEMMGR_SLAB_SIZE - memmgr_slab_used_bytes;
+}
+
+size_t memmgr_heap_get_slab_class_count() {
+    return MEMMGR_SLAB_CLASS_COUNT;
+}
+
+void memmgr_heap_get_slab_stats(size_t class_id, MemmgrHeapSlabStats* stats) {
+    furi_assert(class_id < MEMMGR_SLAB_CLASS_COUNT);
+    furi_assert(stats);
+    vTaskSuspendAll();
+    *stats = memmgr_slab_classes[class_id].stats;
+    (void)xTaskResumeAll();
+}
+
+/* Thread arena: heap blocks allocated by thread are linked into arena list,
+ * so accounting is O(1) and remaining blocks can be reported or released
+ * on thread exit. Arena is bound to thread through TLS pointer.
+ */
+#define MEMMGR_HEAP_ARENA_TLS_INDEX 0
+/* Top bit is clear, so never equal to allocated BlockLink_t size */
+#define MEMMGR_HEAP_ARENA_MAGIC 0x4172656EUL
+
+typedef struct MemmgrHeapArenaBlock {
+    struct MemmgrHeapArenaBlock* prev;
+    struct MemmgrHeapArenaBlock* next;
+    MemmgrHeapArena* arena;
+    void* caller;
+    size_t size;
+    uint32_t magic; /* Must be last, right before user data */
+} MemmgrHeapArenaBlock;
+
+struct MemmgrHeapArena {
+    MemmgrHeapArenaBlock* blocks;
+    size_t size;
+    size_t peak;
+    size_t count;
+};
+
+static inline MemmgrHeapArena* memmgr_heap_arena_get(TaskHandle_t task) {
+    return pvTaskGetThreadLocalStoragePointer(task, MEMMGR_HEAP_ARENA_TLS_INDEX);
+}
+
+static inline MemmgrHeapArena* memmgr_heap_arena_current() {
+    if(xTaskGetCurrentTaskHandle() == NULL) return NULL;
+    return memmgr_heap_arena_get(NULL);
+}
+
+/* Must be called with scheduler suspended */
+static void* memmgr_heap_arena_link(
+    MemmgrHeapArena* arena,
+    MemmgrHeapArenaBlock* block,
+    size_t size,
+    void* caller) {
+    block->prev = NULL;
+    block->next = arena->blocks;
+    if(arena->blocks) arena->blocks->prev = block;
+    arena->blocks = block;
+    block->arena = arena;
+    block->caller = caller;
+    block->size = size;
+    block->magic = MEMMGR_HEAP_ARENA_MAGIC;
+
+    arena->size += size;
+    arena->count++;
+    if(arena->size > arena->peak) arena->peak = arena->size;
+
+    return block + 1;
+}
+
+/* Must be called with scheduler suspended */
+static void memmgr_heap_arena_unlink(MemmgrHeapArenaBlock* block) {
+    MemmgrHeapArena* arena = block->arena;
+    if(!arena) return;
+
+    if(block->prev) {
+        block->prev->next = block->next;
+    } else {
+        arena->blocks = block->next;
+    }
+    if(block->next) block->next->prev = block->prev;
+    block->arena = NULL;
+
+    arena->size -= block->size;
+    arena->count--;
+}
+
+MemmgrHeapArena* memmgr_heap_arena_alloc() {
+    MemmgrHeapArena* arena = pvPortMalloc(sizeof(MemmgrHeapArena));
+    return arena;
+}
+
+void memmgr_heap_arena_free(
+    MemmgrHeapArena* arena,
+    bool release,
+    MemmgrHeapArenaLeakCallback callback,
+    void* context) {
+    furi_assert(arena);
+
+    while(true) {
+        MemmgrHeapArenaBlock* block;
+        size_t size = 0;
+        void* caller = NULL;
+        vTaskSuspendAll();
+        {
+            block = arena->blocks;
+            if(block) {
+                memmgr_heap_arena_unlink(block);
+                /* Header can't be read after resume, owner may free block meanwhile */
+                size = block->size;
+                caller = block->caller;
+            }
+        }
+        (void)xTaskResumeAll();
+
+        if(!block) break;
+        if(callback) callback(block + 1, size, caller, context);
+        /* Unlinked blocks are plain heap blocks now, owner can still free them */
+        if(release) vPortFree(block + 1);
+    }
+
+    vPortFree(arena);
+}
+
+void memmgr_heap_arena_enter(MemmgrHeapArena* arena) {
+    furi_assert(arena);
+    furi_assert(memmgr_heap_arena_current() == NULL);
+    vTaskSetThreadLocalStoragePointer(NULL, MEMMGR_HEAP_ARENA_TLS_INDEX, arena);
+}
+
+void memmgr_heap_arena_exit() {
+    vTaskSetThreadLocalStoragePointer(NULL, MEMMGR_HEAP_ARENA_TLS_INDEX, NULL);
+}
+
+size_t memmgr_heap_arena_get_size(MemmgrHeapArena* arena) {
+    furi_assert(arena);
+    return arena->size;
+}
+
+size_t memmgr_heap_arena_get_peak(MemmgrHeapArena* arena) {
+    furi_assert(arena);
+    return arena->peak;
+}
+
+size_t memmgr_heap_arena_get_count(MemmgrHeapArena* arena) {
+    furi_assert(arena);
+    return arena->count;
+}
+
+size_t memmgr_heap_get_block_size(void* pointer) {
+    furi_assert(pointer);
+
+    if(memmgr_slab_contains(pointer)) {
+        size_t page_id = ((uint8_t*)pointer - memmgr_slab_base) / MEMMGR_SLAB_PAGE_SIZE;
+        furi_check(memmgr_slab_pages[page_id].class_id < MEMMGR_SLAB_CLASS_COUNT);
+        return memmgr_slab_classes[memmgr_slab_pages[page_id].class_id].object_size;
+    }
+
+    MemmgrHeapArenaBlock* arena_block = (MemmgrHeapArenaBlock*)pointer - 1;
+    if(arena_block->magic == MEMMGR_HEAP_ARENA_MAGIC) {
+        return arena_block->size;
+    }
+
+    BlockLink_t* link = (void*)((uint8_t*)pointer - xHeapStructSize);
+    furi_check((link->xBlockSize & xBlockAllocatedBit) != 0);
+    return (link->xBlockSize & ~xBlockAllocatedBit) - xHeapStructSize;
+}
+
 size_t memmgr_heap_get_max_free_block() {
     size_t max_free_size = 0;
     BlockLink_t* pxBlock;
@@ -339,6 +678,7 @@ void* pvPortMalloc(size_t xWantedSize) {
     BlockLink_t *pxBlock, *pxPreviousBlock, *pxNewBlockLink;
     void* pvReturn = NULL;
     size_t to_wipe = xWantedSize;
+    void* caller = __builtin_return_address(0);
 
 #ifdef HEAP_PRINT_DEBUG
     BlockLink_t* print_heap_block = NULL;
@@ -361,6 +701,29 @@ void* pvPortMalloc(size_t xWantedSize) {
         mtCOVERAGE_TEST_MARKER();
     }
 
+    /* Arena blocks carry list header and are never taken from slab */
+    MemmgrHeapArena* arena = memmgr_heap_arena_current();
+    if(arena && (xWantedSize > 0)) {
+        xWantedSize += sizeof(MemmgrHeapArenaBlock);
+    } else if((xWantedSize > 0) && (xWantedSize <= MEMMGR_SLAB_OBJECT_MAX)) {
+        size_t object_size = 0;
+        vTaskSuspendAll();
+        {
+            pvReturn = memmgr_slab_alloc(xWantedSize, &object_size);
+            if(pvReturn) {
+                if(memmgr_heap_free_bytes() < xMinimumEverFreeBytesRemaining) {
+                    xMinimumEverFreeBytesRemaining = memmgr_heap_free_bytes();
+                }
+                traceMALLOC(pvReturn, object_size);
+            }
+        }
+        (void)xTaskResumeAll();
+
+        if(pvReturn) {
+            return memset(pvReturn, 0, object_size);
+        }
+    }
+
     vTaskSuspendAll();
     {
         /* Check the requested block size is not so large that the top bit is
@@ -431,8 +794,8 @@ void* pvPortMalloc(size_t xWantedSize) {
 
                     xFreeBytesRemaining -= pxBlock->xBlockSize;
 
-                    if(xFreeBytesRemaining < xMinimumEverFreeBytesRemaining) {
-                        xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+                    if(memmgr_heap_free_bytes() < xMinimumEverFreeBytesRemaining) {
+                        xMinimumEverFreeBytesRemaining = memmgr_heap_free_bytes();
                     } else {
                         mtCOVERAGE_TEST_MARKER();
                     }
@@ -455,6 +818,10 @@ void* pvPortMalloc(size_t xWantedSize) {
             mtCOVERAGE_TEST_MARKER();
         }
 
+        if(arena && pvReturn) {
+            pvReturn = memmgr_heap_arena_link(arena, pvReturn, to_wipe, caller);
+        }
+
         traceMALLOC(pvReturn, xWantedSize);
     }
     (void)xTaskResumeAll();
@@ -486,7 +853,26 @@ void vPortFree(void* pv) {
     uint8_t* puc = (uint8_t*)pv;
     BlockLink_t* pxLink;
 
-    if(pv != NULL) {
+    if(memmgr_slab_contains(pv)) {
+        vTaskSuspendAll();
+        {
+            size_t object_size = memmgr_slab_free(pv);
+            traceFREE(pv, object_size);
+        }
+        (void)xTaskResumeAll();
+    } else if(pv != NULL) {
+        MemmgrHeapArenaBlock* arena_block = (MemmgrHeapArenaBlock*)pv - 1;
+        if(arena_block->magic == MEMMGR_HEAP_ARENA_MAGIC) {
+            vTaskSuspendAll();
+            {
+                memmgr_heap_arena_unlink(arena_block);
+                traceFREE(pv, arena_block->size);
+            }
+            (void)xTaskResumeAll();
+            pv = arena_block;
+            puc = (uint8_t*)pv;
+        }
+
         /* The memory being freed will have an BlockLink_t structure immediately
         before it. */
         puc -= xHeapStructSize;
@@ -542,7 +928,7 @@ size_t xPortGetTotalHeapSize(void) {
 /*-----------------------------------------------------------*/
 
 size_t xPortGetFreeHeapSize(void) {
-    return xFreeBytesRemaining;
+    return memmgr_heap_free_bytes();
 }
 /*-----------------------------------------------------------*/
 
@@ -560,7 +946,7 @@ static void prvHeapInit(void) {
     BlockLink_t* pxFirstFreeBlock;
     uint8_t* pucAlignedHeap;
     size_t uxAddress;
-    size_t xTotalHeapSize = (size_t)&__heap_end__ - (size_t)&__heap_start__;
+    size_t xTotalHeapSize;
 
     /* Ensure the heap starts on a correctly aligned boundary. */
     uxAddress = (size_t)ucHeap;
@@ -568,11 +954,15 @@ static void prvHeapInit(void) {
     if((uxAddress & portBYTE_ALIGNMENT_MASK) != 0) {
         uxAddress += (portBYTE_ALIGNMENT - 1);
         uxAddress &= ~((size_t)portBYTE_ALIGNMENT_MASK);
-        xTotalHeapSize -= uxAddress - (size_t)ucHeap;
     }
 
     pucAlignedHeap = (uint8_t*)uxAddress;
 
+    /* Slab pages are placed at the end of the heap space */
+    uxAddress = ((size_t)&__heap_end__ - MEMMGR_SLAB_SIZE) & ~((size_t)portBYTE_ALIGNMENT_MASK);
+    memmgr_slab_init((uint8_t*)uxAddress);
+    xTotalHeapSize = uxAddress - (size_t)pucAlignedHeap;
+
     /* xStart is used to hold a pointer to the first item in the list of free
     blocks.  The void cast is used to prevent compiler warnings. */
     xStart.pxNextFreeBlock = (void*)pucAlignedHeap;
@@ -594,8 +984,8 @@ static void prvHeapInit(void) {
     pxFirstFreeBlock->pxNextFreeBlock = pxEnd;
 
     /* Only one block exists - and it covers the entire usable heap space. */
-    xMinimumEverFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
     xFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
+    xMinimumEverFreeBytesRemaining = memmgr_heap_free_bytes();
 
     /* Work out the position of the top bit in a size_t variable. */
     xBlockAllocatedBit = ((size_t)1) << ((sizeof(size_t) * heapBITS_PER_BYTE) - 1);
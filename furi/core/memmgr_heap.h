@@ -14,6 +14,38 @@ extern "C" {
 
 #define MEMMGR_HEAP_UNKNOWN 0xFFFFFFFF
 
+/** Slab page size, allocations up to 256 bytes are served from slab pages */
+#ifndef MEMMGR_SLAB_PAGE_SIZE
+#define MEMMGR_SLAB_PAGE_SIZE 512
+#endif
+
+/** Number of slab pages, shared by all size classes. Must be less than 255 */
+#ifndef MEMMGR_SLAB_PAGES
+#define MEMMGR_SLAB_PAGES 32
+#endif
+
+/** Slab size class statistics */
+typedef struct {
+    size_t object_size; /**< Size class */
+    size_t pages; /**< Pages owned by class */
+    size_t used; /**< Objects allocated right now */
+    size_t peak; /**< Maximum objects allocated at once */
+    size_t allocs; /**< Total allocations */
+    size_t fallbacks; /**< Allocations served by heap, no free page */
+} MemmgrHeapSlabStats;
+
+/** Thread arena, groups heap blocks allocated by thread */
+typedef struct MemmgrHeapArena MemmgrHeapArena;
+
+/** Arena leak callback
+ *
+ * @param      pointer  - leaked block
+ * @param      size     - requested size
+ * @param      caller   - return address of malloc call
+ * @param      context  - callback context
+ */
+typedef void (*MemmgrHeapArenaLeakCallback)(void* pointer, size_t size, void* caller, void* context);
+
 /** Memmgr heap enable thread allocation tracking
  *
  * @param      thread_id  - thread id to track
@@ -27,13 +59,25 @@ void memmgr_heap_enable_thread_trace(FuriThreadId taks_handle);
 void memmgr_heap_disable_thread_trace(FuriThreadId taks_handle);
 
 /** Memmgr heap get allocatred thread memory
+ *
+ * Thread must have heap trace or heap arena enabled
  *
  * @param      thread_id  - thread id to track
  *
- * @return     bytes allocated right now
+ * @return     bytes allocated right now, MEMMGR_HEAP_UNKNOWN if not tracked
  */
 size_t memmgr_heap_get_thread_memory(FuriThreadId taks_handle);
 
+/** Memmgr heap get usable size of allocated block
+ *
+ * Slab objects report their size class, so result may exceed requested size.
+ *
+ * @param      pointer  pointer returned by malloc
+ *
+ * @return     size_t usable block size in bytes
+ */
+size_t memmgr_heap_get_block_size(void* pointer);
+
 /** Memmgr heap get the max contiguous block size on the heap
  *
  * @return     size_t max contiguous block size
@@ -44,6 +88,74 @@ size_t memmgr_heap_get_max_free_block();
  */
 void memmgr_heap_printf_free_blocks();
 
+/** Memmgr heap allocate thread arena
+ *
+ * @return     MemmgrHeapArena instance
+ */
+MemmgrHeapArena* memmgr_heap_arena_alloc();
+
+/** Memmgr heap free thread arena. Arena must not be bound to any thread.
+ *
+ * @param      arena     - MemmgrHeapArena instance
+ * @param      release   - free remaining blocks, otherwise they are left to
+ *                         their owners as plain heap blocks
+ * @param      callback  - called for every remaining block, can be NULL
+ * @param      context   - callback context
+ */
+void memmgr_heap_arena_free(
+    MemmgrHeapArena* arena,
+    bool release,
+    MemmgrHeapArenaLeakCallback callback,
+    void* context);
+
+/** Memmgr heap bind arena to current thread, following allocations made by
+ * this thread go to arena. Blocks can be freed by any thread.
+ *
+ * @param      arena  - MemmgrHeapArena instance
+ */
+void memmgr_heap_arena_enter(MemmgrHeapArena* arena);
+
+/** Memmgr heap unbind arena from current thread
+ */
+void memmgr_heap_arena_exit();
+
+/** Memmgr heap get arena allocated memory
+ *
+ * @param      arena  - MemmgrHeapArena instance
+ *
+ * @return     bytes allocated right now
+ */
+size_t memmgr_heap_arena_get_size(MemmgrHeapArena* arena);
+
+/** Memmgr heap get arena peak allocated memory
+ *
+ * @param      arena  - MemmgrHeapArena instance
+ *
+ * @return     bytes
+ */
+size_t memmgr_heap_arena_get_peak(MemmgrHeapArena* arena);
+
+/** Memmgr heap get arena block count
+ *
+ * @param      arena  - MemmgrHeapArena instance
+ *
+ * @return     blocks allocated right now
+ */
+size_t memmgr_heap_arena_get_count(MemmgrHeapArena* arena);
+
+/** Memmgr heap get number of slab size classes
+ *
+ * @return     size_t size class count
+ */
+size_t memmgr_heap_get_slab_class_count();
+
+/** Memmgr heap get slab size class statistics
+ *
+ * @param      class_id  - size class index, less than class count
+ * @param      stats     - MemmgrHeapSlabStats to fill
+ */
+void memmgr_heap_get_slab_stats(size_t class_id, MemmgrHeapSlabStats* stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -2,28 +2,164 @@
 #include "memmgr.h"
 #include "check.h"
 #include "mutex.h"
+#include "thread.h"
+#include "kernel.h"
+#include "semaphore.h"
 
-#include <m-list.h>
+#include <furi_hal.h>
 
 struct FuriPubSubSubscription {
     FuriPubSubCallback callback;
     void* callback_context;
+    FuriMessageQueue* queue;
+
+    volatile bool active;
+    uint32_t refs; /* Snapshots holding subscription */
+    FuriThreadId unsubscriber;
+    FuriSemaphore* unsubscribed; /* Released by last delivery in other thread */
+
+    FuriPubSubSubscriptionStats stats;
 };
 
-LIST_DEF(FuriPubSubSubscriptionList, FuriPubSubSubscription, M_POD_OPLIST);
+/* Immutable subscriber list, replaced on subscribe/unsubscribe.
+ * Publishers hold a reference while they iterate it without lock.
+ */
+typedef struct {
+    uint32_t refs;
+    size_t count;
+    FuriPubSubSubscription* items[];
+} FuriPubSubSnapshot;
+
+/* Delivery in progress, lives on publisher stack */
+typedef struct FuriPubSubDelivery {
+    FuriPubSubSubscription* item;
+    FuriThreadId thread;
+    struct FuriPubSubDelivery* next;
+} FuriPubSubDelivery;
+
+static FuriPubSubDelivery* furi_pubsub_deliveries = NULL;
 
 struct FuriPubSub {
-    FuriPubSubSubscriptionList_t items;
-    FuriMutex* mutex;
+    FuriPubSubSnapshot* snapshot;
+    FuriMutex* mutex; /* Serializes snapshot updates */
 };
 
+static FuriPubSubSnapshot* furi_pubsub_snapshot_alloc(size_t count) {
+    FuriPubSubSnapshot* snapshot =
+        malloc(sizeof(FuriPubSubSnapshot) + count * sizeof(FuriPubSubSubscription*));
+    snapshot->refs = 1;
+    snapshot->count = count;
+    return snapshot;
+}
+
+static FuriPubSubSnapshot* furi_pubsub_snapshot_acquire(FuriPubSub* pubsub) {
+    FURI_CRITICAL_ENTER();
+    FuriPubSubSnapshot* snapshot = pubsub->snapshot;
+    snapshot->refs++;
+    FURI_CRITICAL_EXIT();
+    return snapshot;
+}
+
+static void furi_pubsub_subscription_acquire(FuriPubSubSubscription* item) {
+    FURI_CRITICAL_ENTER();
+    item->refs++;
+    FURI_CRITICAL_EXIT();
+}
+
+static void furi_pubsub_subscription_release(FuriPubSubSubscription* item) {
+    FURI_CRITICAL_ENTER();
+    bool last = (--item->refs == 0);
+    FURI_CRITICAL_EXIT();
+    if(last) free(item);
+}
+
+static void furi_pubsub_snapshot_release(FuriPubSubSnapshot* snapshot) {
+    FURI_CRITICAL_ENTER();
+    bool last = (--snapshot->refs == 0);
+    FURI_CRITICAL_EXIT();
+
+    if(last) {
+        for(size_t i = 0; i < snapshot->count; i++) {
+            furi_pubsub_subscription_release(snapshot->items[i]);
+        }
+        free(snapshot);
+    }
+}
+
+/* Must be called with mutex taken, returns previous snapshot */
+static FuriPubSubSnapshot* furi_pubsub_snapshot_replace(
+    FuriPubSub* pubsub,
+    FuriPubSubSubscription* add,
+    FuriPubSubSubscription* remove) {
+    FuriPubSubSnapshot* current = pubsub->snapshot;
+    FuriPubSubSnapshot* snapshot = furi_pubsub_snapshot_alloc(current->count + (add ? 1 : 0));
+
+    size_t count = 0;
+    for(size_t i = 0; i < current->count; i++) {
+        if(current->items[i] == remove) continue;
+        snapshot->items[count++] = current->items[i];
+    }
+    if(add) snapshot->items[count++] = add;
+    snapshot->count = count;
+
+    for(size_t i = 0; i < snapshot->count; i++) {
+        furi_pubsub_subscription_acquire(snapshot->items[i]);
+    }
+
+    FURI_CRITICAL_ENTER();
+    pubsub->snapshot = snapshot;
+    FURI_CRITICAL_EXIT();
+
+    return current;
+}
+
+static bool furi_pubsub_delivery_begin(FuriPubSubDelivery* delivery) {
+    FURI_CRITICAL_ENTER();
+    bool active = delivery->item->active;
+    if(active) {
+        delivery->next = furi_pubsub_deliveries;
+        furi_pubsub_deliveries = delivery;
+    }
+    FURI_CRITICAL_EXIT();
+    return active;
+}
+
+/* Delivery to item in progress in thread other than given one, call in critical section */
+static bool furi_pubsub_delivery_pending(FuriPubSubSubscription* item, FuriThreadId thread) {
+    for(FuriPubSubDelivery* it = furi_pubsub_deliveries; it; it = it->next) {
+        if(it->item == item && it->thread != thread) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void furi_pubsub_delivery_end(FuriPubSubDelivery* delivery) {
+    FuriPubSubSubscription* item = delivery->item;
+    FuriSemaphore* unsubscribed = NULL;
+
+    FURI_CRITICAL_ENTER();
+    FuriPubSubDelivery** it = &furi_pubsub_deliveries;
+    while(*it != delivery) it = &(*it)->next;
+    *it = delivery->next;
+    if(item->unsubscribed && !furi_pubsub_delivery_pending(item, item->unsubscriber)) {
+        unsubscribed = item->unsubscribed;
+        item->unsubscribed = NULL;
+    }
+    FURI_CRITICAL_EXIT();
+
+    if(unsubscribed) {
+        furi_semaphore_release(unsubscribed);
+    }
+}
+
 FuriPubSub* furi_pubsub_alloc() {
     FuriPubSub* pubsub = malloc(sizeof(FuriPubSub));
 
     pubsub->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
     furi_assert(pubsub->mutex);
 
-    FuriPubSubSubscriptionList_init(pubsub->items);
+    pubsub->snapshot = furi_pubsub_snapshot_alloc(0);
 
     return pubsub;
 }
@@ -31,28 +167,48 @@ FuriPubSub* furi_pubsub_alloc() {
 void furi_pubsub_free(FuriPubSub* pubsub) {
     furi_assert(pubsub);
 
-    furi_check(FuriPubSubSubscriptionList_size(pubsub->items) == 0);
+    furi_check(pubsub->snapshot->count == 0);
 
-    FuriPubSubSubscriptionList_clear(pubsub->items);
+    furi_pubsub_snapshot_release(pubsub->snapshot);
 
     furi_mutex_free(pubsub->mutex);
 
     free(pubsub);
 }
 
+static FuriPubSubSubscription*
+    furi_pubsub_subscribe_item(FuriPubSub* pubsub, FuriPubSubSubscription* item) {
+    furi_assert(pubsub);
+
+    item->active = true;
+
+    furi_check(furi_mutex_acquire(pubsub->mutex, FuriWaitForever) == FuriStatusOk);
+    FuriPubSubSnapshot* previous = furi_pubsub_snapshot_replace(pubsub, item, NULL);
+    furi_check(furi_mutex_release(pubsub->mutex) == FuriStatusOk);
+
+    furi_pubsub_snapshot_release(previous);
+
+    return item;
+}
+
 FuriPubSubSubscription*
     furi_pubsub_subscribe(FuriPubSub* pubsub, FuriPubSubCallback callback, void* callback_context) {
-    furi_check(furi_mutex_acquire(pubsub->mutex, FuriWaitForever) == FuriStatusOk);
-    // put uninitialized item to the list
-    FuriPubSubSubscription* item = FuriPubSubSubscriptionList_push_raw(pubsub->items);
+    furi_assert(callback);
 
-    // initialize item
+    FuriPubSubSubscription* item = malloc(sizeof(FuriPubSubSubscription));
     item->callback = callback;
     item->callback_context = callback_context;
 
-    furi_check(furi_mutex_release(pubsub->mutex) == FuriStatusOk);
+    return furi_pubsub_subscribe_item(pubsub, item);
+}
 
-    return item;
+FuriPubSubSubscription* furi_pubsub_subscribe_queue(FuriPubSub* pubsub, FuriMessageQueue* queue) {
+    furi_assert(queue);
+
+    FuriPubSubSubscription* item = malloc(sizeof(FuriPubSubSubscription));
+    item->queue = queue;
+
+    return furi_pubsub_subscribe_item(pubsub, item);
 }
 
 void furi_pubsub_unsubscribe(FuriPubSub* pubsub, FuriPubSubSubscription* pubsub_subscription) {
@@ -62,34 +218,95 @@ void furi_pubsub_unsubscribe(FuriPubSub* pubsub, FuriPubSubSubscription* pubsub_
     furi_check(furi_mutex_acquire(pubsub->mutex, FuriWaitForever) == FuriStatusOk);
     bool result = false;
 
-    // iterate over items
-    FuriPubSubSubscriptionList_it_t it;
-    for(FuriPubSubSubscriptionList_it(it, pubsub->items); !FuriPubSubSubscriptionList_end_p(it);
-        FuriPubSubSubscriptionList_next(it)) {
-        const FuriPubSubSubscription* item = FuriPubSubSubscriptionList_cref(it);
-
-        // if the iterator is equal to our element
-        if(item == pubsub_subscription) {
-            FuriPubSubSubscriptionList_remove(pubsub->items, it);
+    FuriPubSubSnapshot* current = pubsub->snapshot;
+    for(size_t i = 0; i < current->count; i++) {
+        if(current->items[i] == pubsub_subscription) {
             result = true;
             break;
         }
     }
 
+    FuriPubSubSnapshot* previous = NULL;
+    if(result) {
+        previous = furi_pubsub_snapshot_replace(pubsub, NULL, pubsub_subscription);
+    }
+
     furi_check(furi_mutex_release(pubsub->mutex) == FuriStatusOk);
     furi_check(result);
+
+    // Publishers may still hold older snapshot, wait for them to leave callback
+    FuriThreadId thread = furi_thread_get_current_id();
+    FURI_CRITICAL_ENTER();
+    pubsub_subscription->active = false;
+    bool pending = furi_pubsub_delivery_pending(pubsub_subscription, thread);
+    FURI_CRITICAL_EXIT();
+
+    if(pending) {
+        FuriSemaphore* unsubscribed = furi_semaphore_alloc(1, 0);
+        FURI_CRITICAL_ENTER();
+        pending = furi_pubsub_delivery_pending(pubsub_subscription, thread);
+        if(pending) {
+            pubsub_subscription->unsubscriber = thread;
+            pubsub_subscription->unsubscribed = unsubscribed;
+        }
+        FURI_CRITICAL_EXIT();
+        if(pending) {
+            furi_check(furi_semaphore_acquire(unsubscribed, FuriWaitForever) == FuriStatusOk);
+        }
+        furi_semaphore_free(unsubscribed);
+    }
+
+    // Subscription is freed with last snapshot holding it
+    furi_pubsub_snapshot_release(previous);
 }
 
 void furi_pubsub_publish(FuriPubSub* pubsub, void* message) {
-    furi_check(furi_mutex_acquire(pubsub->mutex, FuriWaitForever) == FuriStatusOk);
+    furi_assert(pubsub);
+
+    FuriPubSubSnapshot* snapshot = furi_pubsub_snapshot_acquire(pubsub);
+    FuriPubSubDelivery delivery = {.thread = furi_thread_get_current_id()};
 
     // iterate over subscribers
-    FuriPubSubSubscriptionList_it_t it;
-    for(FuriPubSubSubscriptionList_it(it, pubsub->items); !FuriPubSubSubscriptionList_end_p(it);
-        FuriPubSubSubscriptionList_next(it)) {
-        const FuriPubSubSubscription* item = FuriPubSubSubscriptionList_cref(it);
-        item->callback(message, item->callback_context);
+    for(size_t i = 0; i < snapshot->count; i++) {
+        FuriPubSubSubscription* item = snapshot->items[i];
+        delivery.item = item;
+        if(!furi_pubsub_delivery_begin(&delivery)) continue;
+
+        if(item->queue) {
+            FuriStatus status = furi_message_queue_put(item->queue, message, 0);
+            FURI_CRITICAL_ENTER();
+            if(status == FuriStatusOk) {
+                item->stats.count++;
+            } else {
+                item->stats.dropped++;
+            }
+            FURI_CRITICAL_EXIT();
+        } else {
+            uint32_t start = DWT->CYCCNT;
+            item->callback(message, item->callback_context);
+            uint32_t time =
+                (DWT->CYCCNT - start) / furi_hal_cortex_instructions_per_microsecond();
+            // Callback may run in several publishers at once
+            FURI_CRITICAL_ENTER();
+            item->stats.count++;
+            item->stats.time_total_us += time;
+            item->stats.time_max_us = MAX(item->stats.time_max_us, time);
+            FURI_CRITICAL_EXIT();
+        }
+
+        furi_pubsub_delivery_end(&delivery);
     }
 
-    furi_check(furi_mutex_release(pubsub->mutex) == FuriStatusOk);
+    furi_pubsub_snapshot_release(snapshot);
+}
+
+void furi_pubsub_subscription_get_stats(
+    FuriPubSubSubscription* pubsub_subscription,
+    FuriPubSubSubscriptionStats* stats) {
+    furi_assert(pubsub_subscription);
+    furi_assert(stats);
+
+    FURI_CRITICAL_ENTER();
+    *stats = pubsub_subscription->stats;
+    FURI_CRITICAL_EXIT();
 }
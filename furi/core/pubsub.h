@@ -4,6 +4,8 @@
  */
 #pragma once
 
+#include "message_queue.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -17,6 +19,14 @@ typedef struct FuriPubSub FuriPubSub;
 /** FuriPubSubSubscription type */
 typedef struct FuriPubSubSubscription FuriPubSubSubscription;
 
+/** FuriPubSubSubscription delivery statistics */
+typedef struct {
+    uint32_t count; /**< Messages delivered */
+    uint32_t dropped; /**< Messages dropped, subscription queue was full */
+    uint32_t time_total_us; /**< Time spent in callback */
+    uint32_t time_max_us; /**< Longest callback run */
+} FuriPubSubSubscriptionStats;
+
 /** Allocate FuriPubSub
  *
  * Reentrable, Not threadsafe, one owner
@@ -33,6 +43,9 @@ void furi_pubsub_free(FuriPubSub* pubsub);
 
 /** Subscribe to FuriPubSub
  * 
+ * Callback runs in publisher thread. Publishers don't serialize with each
+ * other, so callback may run concurrently when several threads publish, it
+ * must protect its own state.
  * Threadsafe, Reentrable
  * 
  * @param      pubsub            pointer to FuriPubSub instance
@@ -44,9 +57,25 @@ void furi_pubsub_free(FuriPubSub* pubsub);
 FuriPubSubSubscription*
     furi_pubsub_subscribe(FuriPubSub* pubsub, FuriPubSubCallback callback, void* callback_context);
 
+/** Subscribe to FuriPubSub with deferred delivery
+ *
+ * Messages are copied to queue instead of calling callback in publisher
+ * context. Queue message size must match published message size, messages
+ * are dropped if queue is full.
+ *
+ * Threadsafe, Reentrable
+ *
+ * @param      pubsub  pointer to FuriPubSub instance
+ * @param      queue   FuriMessageQueue instance, must outlive subscription
+ *
+ * @return     pointer to FuriPubSubSubscription instance
+ */
+FuriPubSubSubscription* furi_pubsub_subscribe_queue(FuriPubSub* pubsub, FuriMessageQueue* queue);
+
 /** Unsubscribe from FuriPubSub
  * 
- * No use of `pubsub_subscription` allowed after call of this method
+ * No use of `pubsub_subscription` allowed after call of this method.
+ * Waits for deliveries to this subscription in other threads to complete.
  * Threadsafe, Reentrable.
  *
  * @param      pubsub               pointer to FuriPubSub instance
@@ -56,6 +85,8 @@ void furi_pubsub_unsubscribe(FuriPubSub* pubsub, FuriPubSubSubscription* pubsub_
 
 /** Publish message to FuriPubSub
  *
+ * Subscribers are called without lock held, so subscribe and unsubscribe
+ * don't wait for slow subscribers.
  * Threadsafe, Reentrable.
  * 
  * @param      pubsub   pointer to FuriPubSub instance
@@ -63,6 +94,15 @@ void furi_pubsub_unsubscribe(FuriPubSub* pubsub, FuriPubSubSubscription* pubsub_
  */
 void furi_pubsub_publish(FuriPubSub* pubsub, void* message);
 
+/** Get subscription delivery statistics
+ *
+ * @param      pubsub_subscription  pointer to FuriPubSubSubscription instance
+ * @param      stats                FuriPubSubSubscriptionStats to fill
+ */
+void furi_pubsub_subscription_get_stats(
+    FuriPubSubSubscription* pubsub_subscription,
+    FuriPubSubSubscriptionStats* stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -4,10 +4,13 @@
 #include "memmgr_heap.h"
 #include "check.h"
 #include "common_defines.h"
+#include "log.h"
 
 #include <task.h>
 #include <m-string.h>
 
+#define TAG "FuriThread"
+
 #define THREAD_NOTIFY_INDEX 1 // Index 0 is used for stream buffers
 
 struct FuriThread {
@@ -26,6 +29,8 @@ struct FuriThread {
 
     TaskHandle_t task_handle;
     bool heap_trace_enabled;
+    bool heap_arena_enabled;
+    bool heap_arena_release;
     size_t heap_size;
 };
 
@@ -43,6 +48,21 @@ static void furi_thread_set_state(FuriThread* thread, FuriThreadState state) {
     }
 }
 
+static void furi_thread_heap_arena_leak_callback(
+    void* pointer,
+    size_t size,
+    void* caller,
+    void* context) {
+    FuriThread* thread = context;
+    FURI_LOG_W(
+        TAG,
+        "%s: %u bytes at %p left, allocated from %p",
+        thread->name ? thread->name : "",
+        size,
+        pointer,
+        caller);
+}
+
 static void furi_thread_body(void* context) {
     furi_assert(context);
     FuriThread* thread = context;
@@ -54,14 +74,27 @@ static void furi_thread_body(void* context) {
     if(thread->heap_trace_enabled == true) {
         memmgr_heap_enable_thread_trace((FuriThreadId)task_handle);
     }
+    MemmgrHeapArena* arena = NULL;
+    if(thread->heap_arena_enabled == true) {
+        arena = memmgr_heap_arena_alloc();
+        memmgr_heap_arena_enter(arena);
+    }
 
     thread->ret = thread->callback(thread->context);
 
-    if(thread->heap_trace_enabled == true) {
+    if(thread->heap_trace_enabled == true || arena) {
         furi_delay_ms(33);
+    }
+    if(thread->heap_trace_enabled == true) {
         thread->heap_size = memmgr_heap_get_thread_memory((FuriThreadId)task_handle);
         memmgr_heap_disable_thread_trace((FuriThreadId)task_handle);
     }
+    if(arena) {
+        memmgr_heap_arena_exit();
+        thread->heap_size = memmgr_heap_arena_get_size(arena);
+        memmgr_heap_arena_free(
+            arena, thread->heap_arena_release, furi_thread_heap_arena_leak_callback, thread);
+    }
 
     furi_assert(thread->state == FuriThreadStateRunning);
     furi_thread_set_state(thread, FuriThreadStateStopped);
@@ -183,9 +216,24 @@ void furi_thread_disable_heap_trace(FuriThread* thread) {
     thread->heap_trace_enabled = false;
 }
 
+void furi_thread_enable_heap_arena(FuriThread* thread, bool release) {
+    furi_assert(thread);
+    furi_assert(thread->state == FuriThreadStateStopped);
+    furi_assert(thread->heap_arena_enabled == false);
+    thread->heap_arena_enabled = true;
+    thread->heap_arena_release = release;
+}
+
+void furi_thread_disable_heap_arena(FuriThread* thread) {
+    furi_assert(thread);
+    furi_assert(thread->state == FuriThreadStateStopped);
+    furi_assert(thread->heap_arena_enabled == true);
+    thread->heap_arena_enabled = false;
+}
+
 size_t furi_thread_get_heap_size(FuriThread* thread) {
     furi_assert(thread);
-    furi_assert(thread->heap_trace_enabled == true);
+    furi_assert(thread->heap_trace_enabled == true || thread->heap_arena_enabled == true);
     return thread->heap_size;
 }
 
@@ -151,6 +151,25 @@ void furi_thread_enable_heap_trace(FuriThread* thread);
  */
 void furi_thread_disable_heap_trace(FuriThread* thread);
 
+/** Enable heap arena. Memory allocated by thread is grouped in arena, heap
+ * size is counted in O(1) and blocks left on exit are logged with their
+ * size and call site.
+ *
+ * @warning    release frees blocks left on exit. Use it only if thread doesn't
+ *             hand its allocations over to other threads, this includes
+ *             containers of services grown from thread context.
+ *
+ * @param      thread   FuriThread instance
+ * @param      release  free blocks left on exit
+ */
+void furi_thread_enable_heap_arena(FuriThread* thread, bool release);
+
+/** Disable heap arena
+ *
+ * @param      thread  FuriThread instance
+ */
+void furi_thread_disable_heap_arena(FuriThread* thread);
+
 /** Get thread heap size
  *
  * @param      thread  FuriThread instance
@@ -311,3 +311,48 @@ void loclass_iclass_calc_div_key(uint8_t *csn, uint8_t *key, uint8_t *div_key, b
         loclass_diversifyKey(csn, key, div_key);
     }
 }
+
+static void loclass_opt_batchMAC(uint8_t *csn, uint8_t *cc_nr_p, const uint8_t *key, uint8_t *mac) {
+    uint8_t div_key[8] = {0};
+    loclass_diversifyKey(csn, key, div_key);
+    // loclass_opt_output only writes 4 bytes, MAC goes straight to output
+    loclass_opt_MAC(div_key, cc_nr_p, mac);
+}
+
+static void loclass_opt_batchSelectEliteKey(const uint8_t *keytable, const uint8_t *key_index, uint8_t *key_sel_p) {
+    uint8_t key_sel[8] = { 0 };
+    for (uint8_t i = 0; i < 8 ; i++)
+        key_sel[i] = keytable[key_index[i]];
+
+    //Permute from iclass format to standard format
+    loclass_permutekey_rev(key_sel, key_sel_p);
+}
+
+void loclass_opt_doBatchReaderMAC(uint8_t *csn, uint8_t *cc_nr_p, const uint8_t *keys, size_t key_count, bool elite, uint8_t *macs) {
+    uint8_t key_index[8] = {0};
+    if (elite)
+        loclass_hash1(csn, key_index);
+
+    for (size_t n = 0; n < key_count; n++) {
+        const uint8_t *key = keys + n * 8;
+        uint8_t key_sel_p[8] = { 0 };
+        if (elite) {
+            uint8_t keytable[128] = {0};
+            loclass_hash2((uint8_t *)key, keytable);
+            loclass_opt_batchSelectEliteKey(keytable, key_index, key_sel_p);
+            key = key_sel_p;
+        }
+        loclass_opt_batchMAC(csn, cc_nr_p, key, macs + n * 4);
+    }
+}
+
+void loclass_opt_doBatchReaderMAC_keytables(uint8_t *csn, uint8_t *cc_nr_p, const uint8_t *keytables, size_t key_count, uint8_t *macs) {
+    uint8_t key_index[8] = {0};
+    loclass_hash1(csn, key_index);
+
+    for (size_t n = 0; n < key_count; n++) {
+        uint8_t key_sel_p[8] = { 0 };
+        loclass_opt_batchSelectEliteKey(keytables + n * 128, key_index, key_sel_p);
+        loclass_opt_batchMAC(csn, cc_nr_p, key_sel_p, macs + n * 4);
+    }
+}
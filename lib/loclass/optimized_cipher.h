@@ -87,4 +87,29 @@ void loclass_opt_doTagMAC_2(LoclassState_t _init, uint8_t *nr, uint8_t mac[4], c
 
 void loclass_doMAC_N(uint8_t *in_p, uint8_t in_size, uint8_t *div_key_p, uint8_t mac[4]);
 void loclass_iclass_calc_div_key(uint8_t *csn, uint8_t *key, uint8_t *div_key, bool elite);
+
+/**
+ * @brief Diversifies a batch of keys for one card and calculates reader MAC with each of them.
+ * Same result as loclass_iclass_calc_div_key followed by loclass_opt_doReaderMAC for every key,
+ * with the card dependent part of elite diversification done once.
+ * @param csn - card serial number
+ * @param cc_nr_p - card challenge and reader nonce, 12 bytes
+ * @param keys - key_count keys, 8 bytes each
+ * @param key_count - number of keys
+ * @param elite - use elite key diversification
+ * @param macs - where to store the MACs, 4 bytes per key
+ */
+void loclass_opt_doBatchReaderMAC(uint8_t *csn, uint8_t *cc_nr_p, const uint8_t *keys, size_t key_count, bool elite, uint8_t *macs);
+
+/**
+ * @brief Elite variant of loclass_opt_doBatchReaderMAC for keys with keytables calculated ahead.
+ * Keytable only depends on key, so with keytables kept for a dictionary every card costs
+ * a single DES operation per key.
+ * @param csn - card serial number
+ * @param cc_nr_p - card challenge and reader nonce, 12 bytes
+ * @param keytables - key_count keytables from loclass_hash2, 128 bytes each
+ * @param key_count - number of keys
+ * @param macs - where to store the MACs, 4 bytes per key
+ */
+void loclass_opt_doBatchReaderMAC_keytables(uint8_t *csn, uint8_t *cc_nr_p, const uint8_t *keytables, size_t key_count, uint8_t *macs);
 #endif // OPTIMIZED_CIPHER_H
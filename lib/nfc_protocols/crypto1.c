@@ -26,19 +26,59 @@ void crypto1_init(Crypto1* crypto1, uint64_t key) {
     }
 }
 
-uint32_t crypto1_filter(uint32_t in) {
-    uint32_t out = 0;
-    out = 0xf22c0 >> (in & 0xf) & 16;
-    out |= 0x6c9c0 >> (in >> 4 & 0xf) & 8;
-    out |= 0x3c8b0 >> (in >> 8 & 0xf) & 4;
-    out |= 0x1e458 >> (in >> 12 & 0xf) & 2;
+/* Filter input index bits 4, 3 from odd state byte 0 and bits 2, 1 from byte 1,
+ * same as 0xf22c0, 0x6c9c0 and 0x3c8b0, 0x1e458 nibble tables
+ */
+static const uint8_t crypto1_filter_lo[256] = {
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+};
+
+static const uint8_t crypto1_filter_hi[256] = {
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+};
+
+static inline uint32_t crypto1_filter_fast(uint32_t in) {
+    uint32_t out = crypto1_filter_lo[in & 0xff] | crypto1_filter_hi[in >> 8 & 0xff];
     out |= 0x0d938 >> (in >> 16 & 0xf) & 1;
     return FURI_BIT(0xEC57E80A, out);
 }
 
-uint8_t crypto1_bit(Crypto1* crypto1, uint8_t in, int is_encrypted) {
-    furi_assert(crypto1);
-    uint8_t out = crypto1_filter(crypto1->odd);
+uint32_t crypto1_filter(uint32_t in) {
+    return crypto1_filter_fast(in);
+}
+
+static inline uint8_t crypto1_step(Crypto1* crypto1, uint8_t in, int is_encrypted) {
+    uint8_t out = crypto1_filter_fast(crypto1->odd);
     uint32_t feed = out & (!!is_encrypted);
     feed ^= !!in;
     feed ^= LF_POLY_ODD & crypto1->odd;
@@ -49,11 +89,16 @@ uint8_t crypto1_bit(Crypto1* crypto1, uint8_t in, int is_encrypted) {
     return out;
 }
 
+uint8_t crypto1_bit(Crypto1* crypto1, uint8_t in, int is_encrypted) {
+    furi_assert(crypto1);
+    return crypto1_step(crypto1, in, is_encrypted);
+}
+
 uint8_t crypto1_byte(Crypto1* crypto1, uint8_t in, int is_encrypted) {
     furi_assert(crypto1);
     uint8_t out = 0;
     for(uint8_t i = 0; i < 8; i++) {
-        out |= crypto1_bit(crypto1, FURI_BIT(in, i), is_encrypted) << i;
+        out |= crypto1_step(crypto1, FURI_BIT(in, i), is_encrypted) << i;
     }
     return out;
 }
@@ -62,11 +107,243 @@ uint32_t crypto1_word(Crypto1* crypto1, uint32_t in, int is_encrypted) {
     furi_assert(crypto1);
     uint32_t out = 0;
     for(uint8_t i = 0; i < 32; i++) {
-        out |= crypto1_bit(crypto1, BEBIT(in, i), is_encrypted) << (24 ^ i);
+        out |= (uint32_t)crypto1_step(crypto1, BEBIT(in, i), is_encrypted) << (24 ^ i);
+    }
+    return out;
+}
+
+#define CRYPTO1_KEYSTREAM_WORDS (CRYPTO1_KEYSTREAM_BITS / 32)
+#define CRYPTO1_KEYSTREAM_MASK (CRYPTO1_KEYSTREAM_BITS - 1)
+
+void crypto1_keystream_reset(Crypto1Keystream* keystream) {
+    furi_assert(keystream);
+    keystream->head = 0;
+    keystream->count = 0;
+}
+
+/* 32 keystream bits with no input, two steps per iteration to avoid register swap */
+static void crypto1_keystream_append_word(Crypto1* crypto1, Crypto1Keystream* keystream) {
+    uint32_t odd = crypto1->odd;
+    uint32_t even = crypto1->even;
+    uint32_t out = 0;
+    for(uint8_t i = 0; i < 32; i += 2) {
+        out |= crypto1_filter_fast(odd) << i;
+        even = even << 1 | nfc_util_even_parity32((LF_POLY_ODD & odd) ^ (LF_POLY_EVEN & even));
+        out |= crypto1_filter_fast(even) << (i + 1);
+        odd = odd << 1 | nfc_util_even_parity32((LF_POLY_ODD & even) ^ (LF_POLY_EVEN & odd));
+    }
+    crypto1->odd = odd;
+    crypto1->even = even;
+
+    const uint16_t tail = (keystream->head + keystream->count) & CRYPTO1_KEYSTREAM_MASK;
+    keystream->bits[tail / 32] = out;
+    keystream->count += 32;
+}
+
+void crypto1_keystream_fill(Crypto1* crypto1, Crypto1Keystream* keystream) {
+    furi_assert(crypto1);
+    furi_assert(keystream);
+    while(keystream->count <= CRYPTO1_KEYSTREAM_BITS - 32) {
+        crypto1_keystream_append_word(crypto1, keystream);
+    }
+}
+
+/* Make sure at least bits are buffered, generating the missing ones now */
+static inline void
+    crypto1_keystream_require(Crypto1* crypto1, Crypto1Keystream* keystream, uint16_t bits) {
+    while(keystream->count < bits) {
+        crypto1_keystream_append_word(crypto1, keystream);
+    }
+}
+
+static inline uint8_t crypto1_keystream_peek_byte(Crypto1Keystream* keystream, uint16_t offset) {
+    const uint16_t pos = (keystream->head + offset) & CRYPTO1_KEYSTREAM_MASK;
+    const uint8_t shift = pos % 32;
+    uint32_t out = keystream->bits[pos / 32] >> shift;
+    if(shift > 24) {
+        out |= keystream->bits[(pos / 32 + 1) % CRYPTO1_KEYSTREAM_WORDS] << (32 - shift);
     }
     return out;
 }
 
+static inline void crypto1_keystream_consume(Crypto1Keystream* keystream, uint16_t bits) {
+    keystream->head = (keystream->head + bits) & CRYPTO1_KEYSTREAM_MASK;
+    keystream->count -= bits;
+}
+
+void crypto1_keystream_decrypt(
+    Crypto1* crypto1,
+    Crypto1Keystream* keystream,
+    const uint8_t* encrypted_data,
+    uint16_t encrypted_data_bits,
+    uint8_t* decrypted_data) {
+    furi_assert(crypto1);
+    furi_assert(keystream);
+    if(encrypted_data_bits < 8) {
+        crypto1_keystream_require(crypto1, keystream, encrypted_data_bits);
+        const uint8_t mask = (1 << encrypted_data_bits) - 1;
+        decrypted_data[0] =
+            (crypto1_keystream_peek_byte(keystream, 0) ^ encrypted_data[0]) & mask;
+        crypto1_keystream_consume(keystream, encrypted_data_bits);
+    } else {
+        for(size_t i = 0; i < encrypted_data_bits / 8; i++) {
+            crypto1_keystream_require(crypto1, keystream, 8);
+            decrypted_data[i] = crypto1_keystream_peek_byte(keystream, 0) ^ encrypted_data[i];
+            crypto1_keystream_consume(keystream, 8);
+        }
+    }
+}
+
+void crypto1_keystream_encrypt(
+    Crypto1* crypto1,
+    Crypto1Keystream* keystream,
+    const uint8_t* plain_data,
+    uint16_t plain_data_bits,
+    uint8_t* encrypted_data,
+    uint8_t* encrypted_parity) {
+    furi_assert(crypto1);
+    furi_assert(keystream);
+    if(plain_data_bits < 8) {
+        crypto1_keystream_require(crypto1, keystream, plain_data_bits);
+        const uint8_t mask = (1 << plain_data_bits) - 1;
+        encrypted_data[0] = (crypto1_keystream_peek_byte(keystream, 0) ^ plain_data[0]) & mask;
+        crypto1_keystream_consume(keystream, plain_data_bits);
+    } else {
+        memset(encrypted_parity, 0, (plain_data_bits / 8 + 7) / 8);
+        for(size_t i = 0; i < plain_data_bits / 8; i++) {
+            // Parity is encrypted with first bit of next byte keystream
+            crypto1_keystream_require(crypto1, keystream, 9);
+            const uint8_t ks = crypto1_keystream_peek_byte(keystream, 0);
+            const uint8_t ks_parity = crypto1_keystream_peek_byte(keystream, 8) & 0x01;
+            encrypted_data[i] = ks ^ plain_data[i];
+            encrypted_parity[i / 8] |= (ks_parity ^ nfc_util_odd_parity8(plain_data[i]))
+                                       << (7 - (i & 0x0007));
+            crypto1_keystream_consume(keystream, 8);
+        }
+    }
+}
+
+bool crypto1_check_reader_auth(
+    uint64_t key,
+    uint32_t cuid,
+    uint32_t nt,
+    uint32_t nr_enc,
+    uint32_t ar_enc) {
+    Crypto1 crypto1;
+    crypto1_init(&crypto1, key);
+    crypto1_word(&crypto1, cuid ^ nt, 0);
+    crypto1_word(&crypto1, nr_enc, 1);
+    return (ar_enc ^ crypto1_word(&crypto1, 0, 0)) == prng_successor(nt, 64);
+}
+
+/* Bitsliced Crypto1: bit n of every word belongs to lane (key) n.
+ * LFSR is kept as a stream of bits, b[t - 2j] is odd[j] and b[t - 1 - 2j]
+ * is even[j] at time t, so stepping is appending a single word.
+ * Filter functions are 0xf22c/0xd938 nibble tables and 0xEC57E80A
+ * combining table in gate form.
+ */
+#define CRYPTO1_BATCH_LFSR_BITS (48)
+#define CRYPTO1_BATCH_STEPS (32 * 3)
+
+static inline uint32_t crypto1_batch_fa(uint32_t x0, uint32_t x1, uint32_t x2, uint32_t x3) {
+    return ((x3 & x2) | x1) ^ ((x3 ^ x2) & (x1 | x0));
+}
+
+static inline uint32_t crypto1_batch_fb(uint32_t x0, uint32_t x1, uint32_t x2, uint32_t x3) {
+    return ((x3 | x2) ^ (x3 & x0)) ^ (x1 & ((x3 ^ x2) | x0));
+}
+
+static inline uint32_t
+    crypto1_batch_fc(uint32_t y0, uint32_t y1, uint32_t y2, uint32_t y3, uint32_t y4) {
+    return (y0 | ((y1 | y4) & (y3 ^ y4))) ^ ((y0 ^ (y1 & y3)) & ((y2 ^ y3) | (y1 & y4)));
+}
+
+#define CRYPTO1_BATCH_ODD(b, j) ((b)[-2 * (j)])
+#define CRYPTO1_BATCH_EVEN(b, j) ((b)[-1 - 2 * (j)])
+
+static inline uint32_t crypto1_batch_filter(const uint32_t* b) {
+    const uint32_t f4 = crypto1_batch_fa(
+        CRYPTO1_BATCH_ODD(b, 0),
+        CRYPTO1_BATCH_ODD(b, 1),
+        CRYPTO1_BATCH_ODD(b, 2),
+        CRYPTO1_BATCH_ODD(b, 3));
+    const uint32_t f3 = crypto1_batch_fb(
+        CRYPTO1_BATCH_ODD(b, 4),
+        CRYPTO1_BATCH_ODD(b, 5),
+        CRYPTO1_BATCH_ODD(b, 6),
+        CRYPTO1_BATCH_ODD(b, 7));
+    const uint32_t f2 = crypto1_batch_fa(
+        CRYPTO1_BATCH_ODD(b, 8),
+        CRYPTO1_BATCH_ODD(b, 9),
+        CRYPTO1_BATCH_ODD(b, 10),
+        CRYPTO1_BATCH_ODD(b, 11));
+    const uint32_t f1 = crypto1_batch_fa(
+        CRYPTO1_BATCH_ODD(b, 12),
+        CRYPTO1_BATCH_ODD(b, 13),
+        CRYPTO1_BATCH_ODD(b, 14),
+        CRYPTO1_BATCH_ODD(b, 15));
+    const uint32_t f0 = crypto1_batch_fb(
+        CRYPTO1_BATCH_ODD(b, 16),
+        CRYPTO1_BATCH_ODD(b, 17),
+        CRYPTO1_BATCH_ODD(b, 18),
+        CRYPTO1_BATCH_ODD(b, 19));
+    return crypto1_batch_fc(f0, f1, f2, f3, f4);
+}
+
+/* Taps of LF_POLY_ODD and LF_POLY_EVEN */
+static inline uint32_t crypto1_batch_feedback(const uint32_t* b) {
+    return CRYPTO1_BATCH_ODD(b, 2) ^ CRYPTO1_BATCH_ODD(b, 3) ^ CRYPTO1_BATCH_ODD(b, 4) ^
+           CRYPTO1_BATCH_ODD(b, 6) ^ CRYPTO1_BATCH_ODD(b, 9) ^ CRYPTO1_BATCH_ODD(b, 10) ^
+           CRYPTO1_BATCH_ODD(b, 11) ^ CRYPTO1_BATCH_ODD(b, 14) ^ CRYPTO1_BATCH_ODD(b, 15) ^
+           CRYPTO1_BATCH_ODD(b, 16) ^ CRYPTO1_BATCH_ODD(b, 19) ^ CRYPTO1_BATCH_ODD(b, 21) ^
+           CRYPTO1_BATCH_EVEN(b, 2) ^ CRYPTO1_BATCH_EVEN(b, 11) ^ CRYPTO1_BATCH_EVEN(b, 16) ^
+           CRYPTO1_BATCH_EVEN(b, 17) ^ CRYPTO1_BATCH_EVEN(b, 18) ^ CRYPTO1_BATCH_EVEN(b, 23);
+}
+
+uint32_t crypto1_batch_check_reader_auth(
+    const uint64_t* keys,
+    size_t count,
+    uint32_t cuid,
+    uint32_t nt,
+    uint32_t nr_enc,
+    uint32_t ar_enc) {
+    furi_assert(keys);
+    furi_assert(count <= CRYPTO1_BATCH_SIZE);
+
+    if(!count) return 0;
+    const uint32_t lanes = (count == CRYPTO1_BATCH_SIZE) ? UINT32_MAX : ((1UL << count) - 1);
+
+    uint32_t stream[CRYPTO1_BATCH_LFSR_BITS + CRYPTO1_BATCH_STEPS];
+    uint32_t* b = &stream[CRYPTO1_BATCH_LFSR_BITS - 1];
+
+    /* Same layout as crypto1_init: odd[j] is key bit 2j ^ 7, even[j] is 2j + 1 */
+    for(size_t i = 0; i < CRYPTO1_BATCH_LFSR_BITS; i++) {
+        uint32_t word = 0;
+        for(size_t lane = 0; lane < count; lane++) {
+            word |= (uint32_t)FURI_BIT(keys[lane], i ^ 7) << lane;
+        }
+        b[-(int32_t)i] = word;
+    }
+
+    const uint32_t in = cuid ^ nt;
+    for(size_t i = 0; i < 32; i++, b++) {
+        b[1] = crypto1_batch_feedback(b) ^ -(uint32_t)BEBIT(in, i);
+    }
+    for(size_t i = 0; i < 32; i++, b++) {
+        b[1] = crypto1_batch_feedback(b) ^ crypto1_batch_filter(b) ^ -(uint32_t)BEBIT(nr_enc, i);
+    }
+
+    /* Keystream must decrypt ar to suc64(nt), stop once every lane mismatched */
+    const uint32_t ks = ar_enc ^ prng_successor(nt, 64);
+    uint32_t mismatch = ~lanes;
+    for(size_t i = 0; (i < 32) && (mismatch != UINT32_MAX); i++, b++) {
+        mismatch |= crypto1_batch_filter(b) ^ -(uint32_t)BEBIT(ks, i);
+        b[1] = crypto1_batch_feedback(b);
+    }
+
+    return ~mismatch;
+}
+
 uint32_t prng_successor(uint32_t x, uint32_t n) {
     SWAPENDIAN(x);
     while(n--) x = x >> 1 | (x >> 16 ^ x >> 18 ^ x >> 19 ^ x >> 21) << 31;
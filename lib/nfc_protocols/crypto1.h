@@ -2,12 +2,26 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
+
+/** Number of keys processed by one crypto1_batch_check_reader_auth call */
+#define CRYPTO1_BATCH_SIZE (32)
+
+/** Buffered keystream size, enough for one read or write exchange */
+#define CRYPTO1_KEYSTREAM_BITS (256)
 
 typedef struct {
     uint32_t odd;
     uint32_t even;
 } Crypto1;
 
+/** Keystream generated ahead of use, bit n is bit n % 32 of word n / 32 */
+typedef struct {
+    uint32_t bits[CRYPTO1_KEYSTREAM_BITS / 32];
+    uint16_t head; /**< Position of next unused bit */
+    uint16_t count; /**< Number of buffered bits */
+} Crypto1Keystream;
+
 void crypto1_reset(Crypto1* crypto1);
 
 void crypto1_init(Crypto1* crypto1, uint64_t key);
@@ -20,4 +34,88 @@ uint32_t crypto1_word(Crypto1* crypto1, uint32_t in, int is_encrypted);
 
 uint32_t crypto1_filter(uint32_t in);
 
+/** Drop buffered keystream, call after crypto1 state is loaded again
+ *
+ * @param keystream     Crypto1Keystream instance
+ */
+void crypto1_keystream_reset(Crypto1Keystream* keystream);
+
+/** Generate keystream until buffer is full. Use it while waiting for the other side,
+ * so following encrypt and decrypt calls only xor buffered bits.
+ * Crypto1 state runs ahead of buffered keystream and can't be used directly until reset.
+ *
+ * @param crypto1       Crypto1 instance
+ * @param keystream     Crypto1Keystream instance
+ */
+void crypto1_keystream_fill(Crypto1* crypto1, Crypto1Keystream* keystream);
+
+/** Decrypt frame with buffered keystream, missing bits are generated on the fly
+ *
+ * @param crypto1               Crypto1 instance
+ * @param keystream             Crypto1Keystream instance
+ * @param encrypted_data        encrypted frame
+ * @param encrypted_data_bits   frame size in bits, whole bytes or less than 8 bits
+ * @param decrypted_data        buffer for decrypted frame
+ */
+void crypto1_keystream_decrypt(
+    Crypto1* crypto1,
+    Crypto1Keystream* keystream,
+    const uint8_t* encrypted_data,
+    uint16_t encrypted_data_bits,
+    uint8_t* decrypted_data);
+
+/** Encrypt frame and its parity with buffered keystream, missing bits are generated on the fly
+ *
+ * @param crypto1               Crypto1 instance
+ * @param keystream             Crypto1Keystream instance
+ * @param plain_data            plain frame
+ * @param plain_data_bits       frame size in bits, whole bytes or less than 8 bits
+ * @param encrypted_data        buffer for encrypted frame
+ * @param encrypted_parity      buffer for encrypted parity bits
+ */
+void crypto1_keystream_encrypt(
+    Crypto1* crypto1,
+    Crypto1Keystream* keystream,
+    const uint8_t* plain_data,
+    uint16_t plain_data_bits,
+    uint8_t* encrypted_data,
+    uint8_t* encrypted_parity);
+
+/** Check key against captured reader authentication
+ *
+ * @param key       key candidate
+ * @param cuid      card UID
+ * @param nt        plain card nonce
+ * @param nr_enc    encrypted reader nonce
+ * @param ar_enc    encrypted reader answer
+ *
+ * @return true if reader used this key
+ */
+bool crypto1_check_reader_auth(
+    uint64_t key,
+    uint32_t cuid,
+    uint32_t nt,
+    uint32_t nr_enc,
+    uint32_t ar_enc);
+
+/** Check up to CRYPTO1_BATCH_SIZE keys against captured reader authentication.
+ * Keys are run in parallel in bitsliced form, one key per bit of a word.
+ *
+ * @param keys      key candidates
+ * @param count     number of keys, no more than CRYPTO1_BATCH_SIZE
+ * @param cuid      card UID
+ * @param nt        plain card nonce
+ * @param nr_enc    encrypted reader nonce
+ * @param ar_enc    encrypted reader answer
+ *
+ * @return bitmask of matching keys, bit n for keys[n]
+ */
+uint32_t crypto1_batch_check_reader_auth(
+    const uint64_t* keys,
+    size_t count,
+    uint32_t cuid,
+    uint32_t nt,
+    uint32_t nr_enc,
+    uint32_t ar_enc);
+
 uint32_t prng_successor(uint32_t x, uint32_t n);
@@ -498,25 +498,6 @@ uint8_t mf_classic_read_card(
     return sectors_read;
 }
 
-void mf_crypto1_decrypt(
-    Crypto1* crypto,
-    uint8_t* encrypted_data,
-    uint16_t encrypted_data_bits,
-    uint8_t* decrypted_data) {
-    if(encrypted_data_bits < 8) {
-        uint8_t decrypted_byte = 0;
-        decrypted_byte |= (crypto1_bit(crypto, 0, 0) ^ FURI_BIT(encrypted_data[0], 0)) << 0;
-        decrypted_byte |= (crypto1_bit(crypto, 0, 0) ^ FURI_BIT(encrypted_data[0], 1)) << 1;
-        decrypted_byte |= (crypto1_bit(crypto, 0, 0) ^ FURI_BIT(encrypted_data[0], 2)) << 2;
-        decrypted_byte |= (crypto1_bit(crypto, 0, 0) ^ FURI_BIT(encrypted_data[0], 3)) << 3;
-        decrypted_data[0] = decrypted_byte;
-    } else {
-        for(size_t i = 0; i < encrypted_data_bits / 8; i++) {
-            decrypted_data[i] = crypto1_byte(crypto, 0, 0) ^ encrypted_data[i];
-        }
-    }
-}
-
 void mf_crypto1_encrypt(
     Crypto1* crypto,
     uint8_t* keystream,
@@ -541,20 +522,105 @@ void mf_crypto1_encrypt(
     }
 }
 
+typedef enum {
+    MfClassicEmulatorIdleNone,
+    MfClassicEmulatorIdleAuth, /**< Card nonce sent, prepare for reader answer */
+    MfClassicEmulatorIdleKeystream, /**< Authenticated, generate keystream for next frames */
+} MfClassicEmulatorIdle;
+
+struct MfClassicEmulatorCache {
+    /* Crypto1 state right after key load, by sector and MfClassicKey */
+    Crypto1 key_schedule[MF_CLASSIC_SECTORS_MAX][2];
+    Crypto1Keystream keystream;
+    MfClassicEmulatorIdle idle;
+    bool nonce_load;
+    uint32_t nonce;
+    uint32_t ar_expected;
+    uint32_t at;
+    uint32_t rx_cycles;
+};
+
+static void mf_classic_emulator_update_key_schedule(MfClassicEmulator* emulator, uint8_t sector) {
+    uint8_t sector_trailer_block = mf_classic_get_first_block_num_of_sector(sector) +
+                                   mf_classic_get_blocks_num_in_sector(sector) - 1;
+    MfClassicSectorTrailer* sector_trailer =
+        (MfClassicSectorTrailer*)emulator->data.block[sector_trailer_block].value;
+    Crypto1* key_schedule = emulator->cache->key_schedule[sector];
+    crypto1_init(&key_schedule[MfClassicKeyA], nfc_util_bytes2num(sector_trailer->key_a, 6));
+    crypto1_init(&key_schedule[MfClassicKeyB], nfc_util_bytes2num(sector_trailer->key_b, 6));
+}
+
+void mf_classic_emulator_init(MfClassicEmulator* emulator) {
+    furi_assert(emulator);
+    emulator->cache = malloc(sizeof(MfClassicEmulatorCache));
+    for(uint8_t sector = 0; sector < MF_CLASSIC_SECTORS_MAX; sector++) {
+        mf_classic_emulator_update_key_schedule(emulator, sector);
+    }
+    crypto1_keystream_reset(&emulator->cache->keystream);
+    emulator->cache->idle = MfClassicEmulatorIdleNone;
+    emulator->response_cycles_max = 0;
+}
+
+void mf_classic_emulator_deinit(MfClassicEmulator* emulator) {
+    furi_assert(emulator);
+    free(emulator->cache);
+    emulator->cache = NULL;
+}
+
+static void mf_classic_emulator_prepare_auth(MfClassicEmulator* emulator) {
+    MfClassicEmulatorCache* cache = emulator->cache;
+    if(cache->nonce_load) {
+        crypto1_word(&emulator->crypto, emulator->cuid ^ cache->nonce, 0);
+    }
+    cache->ar_expected = prng_successor(cache->nonce, 64);
+    cache->at = prng_successor(cache->ar_expected, 32);
+    cache->idle = MfClassicEmulatorIdleNone;
+}
+
+static void mf_classic_emulator_idle(void* context) {
+    MfClassicEmulator* emulator = context;
+    if(emulator->cache->idle == MfClassicEmulatorIdleAuth) {
+        mf_classic_emulator_prepare_auth(emulator);
+    } else if(emulator->cache->idle == MfClassicEmulatorIdleKeystream) {
+        crypto1_keystream_fill(&emulator->crypto, &emulator->cache->keystream);
+    }
+}
+
+static bool mf_classic_emulator_tx_rx(
+    MfClassicEmulator* emulator,
+    FuriHalNfcTxRxContext* tx_rx,
+    uint16_t timeout_ms) {
+    uint32_t response_cycles = DWT->CYCCNT - emulator->cache->rx_cycles;
+    if(response_cycles > emulator->response_cycles_max) {
+        emulator->response_cycles_max = response_cycles;
+    }
+    bool tx_rx_ok = furi_hal_nfc_tx_rx(tx_rx, timeout_ms);
+    emulator->cache->rx_cycles = DWT->CYCCNT;
+    return tx_rx_ok;
+}
+
 bool mf_classic_emulator(MfClassicEmulator* emulator, FuriHalNfcTxRxContext* tx_rx) {
     furi_assert(emulator);
+    furi_assert(emulator->cache);
     furi_assert(tx_rx);
+    MfClassicEmulatorCache* cache = emulator->cache;
     bool command_processed = false;
     bool is_encrypted = false;
-    uint8_t plain_data[MF_CLASSIC_MAX_DATA_SIZE];
+    uint8_t plain_data[MF_CLASSIC_BLOCK_SIZE + 2];
     MfClassicKey access_key = MfClassicKeyA;
 
+    // Response time is counted from received reader frame
+    cache->rx_cycles = DWT->CYCCNT;
+    cache->idle = MfClassicEmulatorIdleNone;
+    tx_rx->idle_callback = mf_classic_emulator_idle;
+    tx_rx->idle_context = emulator;
+
     // Read command
     while(!command_processed) {
         if(!is_encrypted) {
-            memcpy(plain_data, tx_rx->rx_data, tx_rx->rx_bits / 8);
+            memcpy(plain_data, tx_rx->rx_data, MIN(tx_rx->rx_bits / 8, sizeof(plain_data)));
         } else {
-            if(!furi_hal_nfc_tx_rx(tx_rx, 300)) {
+            if(!mf_classic_emulator_tx_rx(emulator, tx_rx, 300)) {
                 FURI_LOG_D(
                     TAG,
                     "Error in tx rx. Tx :%d bits, Rx: %d bits",
@@ -562,7 +628,9 @@ bool mf_classic_emulator(MfClassicEmulator* emulator, FuriHalNfcTxRxContext* tx_
                     tx_rx->rx_bits);
                 break;
             }
-            mf_crypto1_decrypt(&emulator->crypto, tx_rx->rx_data, tx_rx->rx_bits, plain_data);
+            if(tx_rx->rx_bits > sizeof(plain_data) * 8) break;
+            crypto1_keystream_decrypt(
+                &emulator->crypto, &cache->keystream, tx_rx->rx_data, tx_rx->rx_bits, plain_data);
         }
 
         if(plain_data[0] == 0x50 && plain_data[1] == 0x00) {
@@ -572,34 +640,28 @@ bool mf_classic_emulator(MfClassicEmulator* emulator, FuriHalNfcTxRxContext* tx_
             break;
         } else if(plain_data[0] == 0x60 || plain_data[0] == 0x61) {
             uint8_t block = plain_data[1];
-            uint64_t key = 0;
+            uint8_t sector = mf_classic_get_sector_by_block(block);
             uint8_t sector_trailer_block = mf_classic_get_sector_trailer(block);
-            MfClassicSectorTrailer* sector_trailer =
-                (MfClassicSectorTrailer*)emulator->data.block[sector_trailer_block].value;
-            if(plain_data[0] == 0x60) {
-                key = nfc_util_bytes2num(sector_trailer->key_a, 6);
-                access_key = MfClassicKeyA;
-            } else {
-                key = nfc_util_bytes2num(sector_trailer->key_b, 6);
-                access_key = MfClassicKeyB;
-            }
+            access_key = (plain_data[0] == 0x60) ? MfClassicKeyA : MfClassicKeyB;
 
             uint32_t nonce = prng_successor(DWT->CYCCNT, 32);
             uint8_t nt[4];
-            uint8_t nt_keystream[4];
             nfc_util_num2bytes(nonce, 4, nt);
-            nfc_util_num2bytes(nonce ^ emulator->cuid, 4, nt_keystream);
-            crypto1_init(&emulator->crypto, key);
+            // Key is loaded ahead, cuid ^ nt is shifted in while reader computes its answer
+            emulator->crypto = cache->key_schedule[sector][access_key];
+            crypto1_keystream_reset(&cache->keystream);
+            cache->nonce = nonce;
             if(!is_encrypted) {
-                crypto1_word(&emulator->crypto, emulator->cuid ^ nonce, 0);
+                cache->nonce_load = true;
                 memcpy(tx_rx->tx_data, nt, sizeof(nt));
                 tx_rx->tx_parity[0] = 0;
                 for(size_t i = 0; i < sizeof(nt); i++) {
                     tx_rx->tx_parity[0] |= nfc_util_odd_parity8(nt[i]) << (7 - i);
                 }
-                tx_rx->tx_bits = sizeof(nt) * 8;
-                tx_rx->tx_rx_type = FuriHalNfcTxRxTransparent;
             } else {
+                uint8_t nt_keystream[4];
+                nfc_util_num2bytes(nonce ^ emulator->cuid, 4, nt_keystream);
+                cache->nonce_load = false;
                 mf_crypto1_encrypt(
                     &emulator->crypto,
                     nt_keystream,
@@ -607,14 +669,18 @@ bool mf_classic_emulator(MfClassicEmulator* emulator, FuriHalNfcTxRxContext* tx_
                     sizeof(nt) * 8,
                     tx_rx->tx_data,
                     tx_rx->tx_parity);
-                tx_rx->tx_bits = sizeof(nt) * 8;
-                tx_rx->tx_rx_type = FuriHalNfcTxRxTransparent;
             }
-            if(!furi_hal_nfc_tx_rx(tx_rx, 500)) {
+            tx_rx->tx_bits = sizeof(nt) * 8;
+            tx_rx->tx_rx_type = FuriHalNfcTxRxTransparent;
+            cache->idle = MfClassicEmulatorIdleAuth;
+            if(!mf_classic_emulator_tx_rx(emulator, tx_rx, 500)) {
                 FURI_LOG_E(TAG, "Error in NT exchange");
                 command_processed = true;
                 break;
             }
+            if(cache->idle == MfClassicEmulatorIdleAuth) {
+                mf_classic_emulator_prepare_auth(emulator);
+            }
 
             if(tx_rx->rx_bits != 64) {
                 FURI_LOG_W(TAG, "Incorrect nr + ar");
@@ -635,16 +701,26 @@ bool mf_classic_emulator(MfClassicEmulator* emulator, FuriHalNfcTxRxContext* tx_
                 nr,
                 ar);
 
+            if(emulator->nonce_callback) {
+                MfClassicNonce captured = {
+                    .cuid = emulator->cuid,
+                    .nt = nonce,
+                    .nr = nr,
+                    .ar = ar,
+                    .sector = sector,
+                    .key_type = access_key,
+                };
+                emulator->nonce_callback(&captured, emulator->nonce_context);
+            }
+
             // Check if we store valid key
             if(access_key == MfClassicKeyA) {
-                if(FURI_BIT(emulator->data.key_a_mask, mf_classic_get_sector_by_block(block)) ==
-                   0) {
+                if(FURI_BIT(emulator->data.key_a_mask, sector) == 0) {
                     FURI_LOG_D(TAG, "Unsupported sector key A for block %d", sector_trailer_block);
                     break;
                 }
             } else if(access_key == MfClassicKeyB) {
-                if(FURI_BIT(emulator->data.key_b_mask, mf_classic_get_sector_by_block(block)) ==
-                   0) {
+                if(FURI_BIT(emulator->data.key_b_mask, sector) == 0) {
                     FURI_LOG_D(TAG, "Unsupported sector key B for block %d", sector_trailer_block);
                     break;
                 }
@@ -652,19 +728,18 @@ bool mf_classic_emulator(MfClassicEmulator* emulator, FuriHalNfcTxRxContext* tx_
 
             crypto1_word(&emulator->crypto, nr, 1);
             uint32_t cardRr = ar ^ crypto1_word(&emulator->crypto, 0, 0);
-            if(cardRr != prng_successor(nonce, 64)) {
-                FURI_LOG_T(TAG, "Wrong AUTH! %08X != %08X", cardRr, prng_successor(nonce, 64));
+            if(cardRr != cache->ar_expected) {
+                FURI_LOG_T(TAG, "Wrong AUTH! %08X != %08X", cardRr, cache->ar_expected);
                 // Don't send NACK, as tag don't send it
                 command_processed = true;
                 break;
             }
 
-            uint32_t ans = prng_successor(nonce, 96);
             uint8_t responce[4] = {};
-            nfc_util_num2bytes(ans, 4, responce);
-            mf_crypto1_encrypt(
+            nfc_util_num2bytes(cache->at, 4, responce);
+            crypto1_keystream_encrypt(
                 &emulator->crypto,
-                NULL,
+                &cache->keystream,
                 responce,
                 sizeof(responce) * 8,
                 tx_rx->tx_data,
@@ -672,6 +747,8 @@ bool mf_classic_emulator(MfClassicEmulator* emulator, FuriHalNfcTxRxContext* tx_
             tx_rx->tx_bits = sizeof(responce) * 8;
             tx_rx->tx_rx_type = FuriHalNfcTxRxTransparent;
 
+            // From now on only keystream is used, generate it while waiting for reader
+            cache->idle = MfClassicEmulatorIdleKeystream;
             is_encrypted = true;
         } else if(is_encrypted && plain_data[0] == 0x30) {
             uint8_t block = plain_data[1];
@@ -698,9 +775,9 @@ bool mf_classic_emulator(MfClassicEmulator* emulator, FuriHalNfcTxRxContext* tx_
             }
             nfca_append_crc16(block_data, 16);
 
-            mf_crypto1_encrypt(
+            crypto1_keystream_encrypt(
                 &emulator->crypto,
-                NULL,
+                &cache->keystream,
                 block_data,
                 sizeof(block_data) * 8,
                 tx_rx->tx_data,
@@ -714,14 +791,16 @@ bool mf_classic_emulator(MfClassicEmulator* emulator, FuriHalNfcTxRxContext* tx_
             }
             // Send ACK
             uint8_t ack = 0x0A;
-            mf_crypto1_encrypt(&emulator->crypto, NULL, &ack, 4, tx_rx->tx_data, tx_rx->tx_parity);
+            crypto1_keystream_encrypt(
+                &emulator->crypto, &cache->keystream, &ack, 4, tx_rx->tx_data, tx_rx->tx_parity);
             tx_rx->tx_rx_type = FuriHalNfcTxRxTransparent;
             tx_rx->tx_bits = 4;
 
-            if(!furi_hal_nfc_tx_rx(tx_rx, 300)) break;
+            if(!mf_classic_emulator_tx_rx(emulator, tx_rx, 300)) break;
             if(tx_rx->rx_bits != 18 * 8) break;
 
-            mf_crypto1_decrypt(&emulator->crypto, tx_rx->rx_data, tx_rx->rx_bits, plain_data);
+            crypto1_keystream_decrypt(
+                &emulator->crypto, &cache->keystream, tx_rx->rx_data, tx_rx->rx_bits, plain_data);
             uint8_t block_data[16] = {};
             memcpy(block_data, emulator->data.block[block].value, MF_CLASSIC_BLOCK_SIZE);
             if(mf_classic_is_sector_trailer(block)) {
@@ -746,10 +825,15 @@ bool mf_classic_emulator(MfClassicEmulator* emulator, FuriHalNfcTxRxContext* tx_
             if(memcmp(block_data, emulator->data.block[block].value, MF_CLASSIC_BLOCK_SIZE)) {
                 memcpy(emulator->data.block[block].value, block_data, MF_CLASSIC_BLOCK_SIZE);
                 emulator->data_changed = true;
+                if(mf_classic_is_sector_trailer(block)) {
+                    mf_classic_emulator_update_key_schedule(
+                        emulator, mf_classic_get_sector_by_block(block));
+                }
             }
             // Send ACK
             ack = 0x0A;
-            mf_crypto1_encrypt(&emulator->crypto, NULL, &ack, 4, tx_rx->tx_data, tx_rx->tx_parity);
+            crypto1_keystream_encrypt(
+                &emulator->crypto, &cache->keystream, &ack, 4, tx_rx->tx_data, tx_rx->tx_parity);
             tx_rx->tx_rx_type = FuriHalNfcTxRxTransparent;
             tx_rx->tx_bits = 4;
         } else {
@@ -762,15 +846,18 @@ bool mf_classic_emulator(MfClassicEmulator* emulator, FuriHalNfcTxRxContext* tx_
         // Send NACK
         uint8_t nack = 0x04;
         if(is_encrypted) {
-            mf_crypto1_encrypt(
-                &emulator->crypto, NULL, &nack, 4, tx_rx->tx_data, tx_rx->tx_parity);
+            crypto1_keystream_encrypt(
+                &emulator->crypto, &cache->keystream, &nack, 4, tx_rx->tx_data, tx_rx->tx_parity);
         } else {
             tx_rx->tx_data[0] = nack;
         }
         tx_rx->tx_rx_type = FuriHalNfcTxRxTransparent;
         tx_rx->tx_bits = 4;
-        furi_hal_nfc_tx_rx(tx_rx, 300);
+        mf_classic_emulator_tx_rx(emulator, tx_rx, 300);
     }
 
+    tx_rx->idle_callback = NULL;
+    tx_rx->idle_context = NULL;
+
     return true;
 }
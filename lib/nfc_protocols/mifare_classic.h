@@ -68,11 +68,30 @@ typedef struct {
     MfClassicSectorReader sector_reader[MF_CLASSIC_SECTORS_MAX];
 } MfClassicReader;
 
+/** Reader authentication captured in emulation, enough to check keys offline */
+typedef struct {
+    uint32_t cuid;
+    uint32_t nt;
+    uint32_t nr; /**< Encrypted reader nonce */
+    uint32_t ar; /**< Encrypted reader answer */
+    uint8_t sector;
+    MfClassicKey key_type;
+} MfClassicNonce;
+
+typedef void (*MfClassicNonceCallback)(const MfClassicNonce* nonce, void* context);
+
+/** Key schedule and keystream prepared ahead of reader frames */
+typedef struct MfClassicEmulatorCache MfClassicEmulatorCache;
+
 typedef struct {
     uint32_t cuid;
     Crypto1 crypto;
     MfClassicData data;
     bool data_changed;
+    MfClassicNonceCallback nonce_callback;
+    void* nonce_context;
+    MfClassicEmulatorCache* cache;
+    uint32_t response_cycles_max; /**< Worst time from reader frame to our answer, in CPU cycles */
 } MfClassicEmulator;
 
 bool mf_classic_check_card_type(uint8_t ATQA0, uint8_t ATQA1, uint8_t SAK);
@@ -111,4 +130,12 @@ uint8_t mf_classic_read_card(
     MfClassicReader* reader,
     MfClassicData* data);
 
+/** Prepare per-sector key schedule, call after emulator data is set
+ *
+ * @param emulator  MfClassicEmulator instance
+ */
+void mf_classic_emulator_init(MfClassicEmulator* emulator);
+
+void mf_classic_emulator_deinit(MfClassicEmulator* emulator);
+
 bool mf_classic_emulator(MfClassicEmulator* emulator, FuriHalNfcTxRxContext* tx_rx);
@@ -2,7 +2,17 @@
 #include <furi.h>
 #include <furi_hal_nfc.h>
 
+#define MF_DF_ARENA_ALIGN(size) (((size) + 7) & ~7)
+
 void mf_df_clear(MifareDesfireData* data) {
+    if(data->arena) {
+        free(data->arena);
+        data->arena = NULL;
+        data->free_memory = NULL;
+        data->master_key_settings = NULL;
+        data->app_head = NULL;
+        return;
+    }
     free(data->free_memory);
     if(data->master_key_settings) {
         MifareDesfireKeyVersion* key_version = data->master_key_settings->key_version_head;
@@ -40,6 +50,216 @@ void mf_df_clear(MifareDesfireData* data) {
     data->app_head = NULL;
 }
 
+uint32_t mf_df_get_file_contents_size(const MifareDesfireFile* file) {
+    uint32_t size = 0;
+    if(file->type == MifareDesfireFileTypeStandard || file->type == MifareDesfireFileTypeBackup) {
+        size = file->settings.data.size;
+    } else if(file->type == MifareDesfireFileTypeValue) {
+        size = 4;
+    } else if(
+        file->type == MifareDesfireFileTypeLinearRecord ||
+        file->type == MifareDesfireFileTypeCyclicRecord) {
+        size = file->settings.record.size * file->settings.record.cur;
+    }
+    return size;
+}
+
+/* Reserve node in arena, copy it if arena is given. Returns node offset. */
+static size_t mf_df_pack_node(uint8_t* arena, size_t* pos, const void* node, size_t size) {
+    size_t offset = *pos;
+    if(arena) memcpy(&arena[offset], node, size);
+    *pos += MF_DF_ARENA_ALIGN(size);
+    return offset;
+}
+
+#define MF_DF_PACK_LINK(arena, offset, type, field, value) \
+    if(arena) ((type*)&(arena)[offset])->field = (void*)(uintptr_t)(value)
+
+static size_t
+    mf_df_pack_key_settings(uint8_t* arena, size_t* pos, const MifareDesfireKeySettings* ks) {
+    size_t ks_offset = mf_df_pack_node(arena, pos, ks, sizeof(MifareDesfireKeySettings));
+    size_t prev_offset = 0;
+    for(MifareDesfireKeyVersion* kv = ks->key_version_head; kv; kv = kv->next) {
+        size_t offset = mf_df_pack_node(arena, pos, kv, sizeof(MifareDesfireKeyVersion));
+        MF_DF_PACK_LINK(arena, offset, MifareDesfireKeyVersion, next, 0);
+        if(prev_offset) {
+            MF_DF_PACK_LINK(arena, prev_offset, MifareDesfireKeyVersion, next, offset);
+        } else {
+            MF_DF_PACK_LINK(arena, ks_offset, MifareDesfireKeySettings, key_version_head, offset);
+        }
+        prev_offset = offset;
+    }
+    return ks_offset;
+}
+
+size_t mf_df_pack(const MifareDesfireData* data, uint8_t* arena) {
+    furi_assert(data);
+    size_t pos = 0;
+
+    /* Root node at offset 0, so zero offset always means NULL */
+    mf_df_pack_node(arena, &pos, data, sizeof(MifareDesfireData));
+    MF_DF_PACK_LINK(arena, 0, MifareDesfireData, arena, 0);
+    if(data->free_memory) {
+        size_t offset =
+            mf_df_pack_node(arena, &pos, data->free_memory, sizeof(MifareDesfireFreeMemory));
+        MF_DF_PACK_LINK(arena, 0, MifareDesfireData, free_memory, offset);
+    }
+    if(data->master_key_settings) {
+        size_t offset = mf_df_pack_key_settings(arena, &pos, data->master_key_settings);
+        MF_DF_PACK_LINK(arena, 0, MifareDesfireData, master_key_settings, offset);
+    }
+
+    size_t prev_app_offset = 0;
+    for(MifareDesfireApplication* app = data->app_head; app; app = app->next) {
+        size_t app_offset = mf_df_pack_node(arena, &pos, app, sizeof(MifareDesfireApplication));
+        MF_DF_PACK_LINK(arena, app_offset, MifareDesfireApplication, next, 0);
+        MF_DF_PACK_LINK(arena, app_offset, MifareDesfireApplication, file_head, 0);
+        if(prev_app_offset) {
+            MF_DF_PACK_LINK(arena, prev_app_offset, MifareDesfireApplication, next, app_offset);
+        } else {
+            MF_DF_PACK_LINK(arena, 0, MifareDesfireData, app_head, app_offset);
+        }
+        prev_app_offset = app_offset;
+
+        if(app->key_settings) {
+            size_t offset = mf_df_pack_key_settings(arena, &pos, app->key_settings);
+            MF_DF_PACK_LINK(arena, app_offset, MifareDesfireApplication, key_settings, offset);
+        }
+
+        size_t prev_file_offset = 0;
+        for(MifareDesfireFile* file = app->file_head; file; file = file->next) {
+            size_t file_offset = mf_df_pack_node(arena, &pos, file, sizeof(MifareDesfireFile));
+            MF_DF_PACK_LINK(arena, file_offset, MifareDesfireFile, next, 0);
+            if(prev_file_offset) {
+                MF_DF_PACK_LINK(arena, prev_file_offset, MifareDesfireFile, next, file_offset);
+            } else {
+                MF_DF_PACK_LINK(arena, app_offset, MifareDesfireApplication, file_head, file_offset);
+            }
+            prev_file_offset = file_offset;
+
+            if(file->contents) {
+                size_t offset =
+                    mf_df_pack_node(arena, &pos, file->contents, file->contents_size);
+                MF_DF_PACK_LINK(arena, file_offset, MifareDesfireFile, contents, offset);
+            }
+        }
+    }
+
+    return pos;
+}
+
+/* Turn stored offset into pointer. Nodes are packed in traversal order, so
+ * offsets must grow, which also rules out loops in corrupted data. */
+static bool mf_df_unpack_ptr(
+    uint8_t* arena,
+    size_t size,
+    size_t* next_offset,
+    void** ptr,
+    size_t node_size) {
+    uintptr_t offset = (uintptr_t)*ptr;
+    if(!offset) return true;
+    if((offset < *next_offset) || (offset != MF_DF_ARENA_ALIGN(offset))) return false;
+    if((offset > size) || (size - offset < node_size)) return false;
+    *next_offset = offset + MF_DF_ARENA_ALIGN(node_size);
+    *ptr = &arena[offset];
+    return true;
+}
+
+static bool mf_df_unpack_key_settings(
+    uint8_t* arena,
+    size_t size,
+    size_t* next_offset,
+    MifareDesfireKeySettings* ks) {
+    void** link = (void**)&ks->key_version_head;
+    while(*link) {
+        if(!mf_df_unpack_ptr(arena, size, next_offset, link, sizeof(MifareDesfireKeyVersion)))
+            return false;
+        link = (void**)&((MifareDesfireKeyVersion*)*link)->next;
+    }
+    return true;
+}
+
+bool mf_df_unpack(MifareDesfireData* data, uint8_t* arena, size_t size) {
+    furi_assert(data);
+    furi_assert(arena);
+    if(size < sizeof(MifareDesfireData)) return false;
+
+    MifareDesfireData* root = (MifareDesfireData*)arena;
+    size_t next_offset = MF_DF_ARENA_ALIGN(sizeof(MifareDesfireData));
+    bool unpacked = false;
+
+    do {
+        if(!mf_df_unpack_ptr(
+               arena,
+               size,
+               &next_offset,
+               (void**)&root->free_memory,
+               sizeof(MifareDesfireFreeMemory)))
+            break;
+        if(!mf_df_unpack_ptr(
+               arena,
+               size,
+               &next_offset,
+               (void**)&root->master_key_settings,
+               sizeof(MifareDesfireKeySettings)))
+            break;
+        if(root->master_key_settings &&
+           !mf_df_unpack_key_settings(arena, size, &next_offset, root->master_key_settings))
+            break;
+
+        bool apps_unpacked = true;
+        void** app_link = (void**)&root->app_head;
+        while(*app_link && apps_unpacked) {
+            apps_unpacked = false;
+            if(!mf_df_unpack_ptr(
+                   arena, size, &next_offset, app_link, sizeof(MifareDesfireApplication)))
+                break;
+            MifareDesfireApplication* app = *app_link;
+            if(!mf_df_unpack_ptr(
+                   arena,
+                   size,
+                   &next_offset,
+                   (void**)&app->key_settings,
+                   sizeof(MifareDesfireKeySettings)))
+                break;
+            if(app->key_settings &&
+               !mf_df_unpack_key_settings(arena, size, &next_offset, app->key_settings))
+                break;
+
+            bool files_unpacked = true;
+            void** file_link = (void**)&app->file_head;
+            while(*file_link && files_unpacked) {
+                files_unpacked = false;
+                if(!mf_df_unpack_ptr(
+                       arena, size, &next_offset, file_link, sizeof(MifareDesfireFile)))
+                    break;
+                MifareDesfireFile* file = *file_link;
+                if(!mf_df_unpack_ptr(
+                       arena,
+                       size,
+                       &next_offset,
+                       (void**)&file->contents,
+                       file->contents_size))
+                    break;
+                file_link = (void**)&file->next;
+                files_unpacked = true;
+            }
+            if(!files_unpacked) break;
+            app_link = (void**)&app->next;
+            apps_unpacked = true;
+        }
+        if(!apps_unpacked) break;
+
+        unpacked = true;
+    } while(false);
+
+    if(unpacked) {
+        *data = *root;
+        data->arena = arena;
+    }
+    return unpacked;
+}
+
 void mf_df_cat_data(MifareDesfireData* data, string_t out) {
     mf_df_cat_card_info(data, out);
     for(MifareDesfireApplication* app = data->app_head; app; app = app->next) {
@@ -206,7 +426,7 @@ void mf_df_cat_file(MifareDesfireFile* file, string_t out) {
     }
     uint8_t* data = file->contents;
     if(data) {
-        for(int rec = 0; rec < num; rec++) {
+        for(int rec = 0; (rec < num) && ((rec + 1) * size <= file->contents_size); rec++) {
             for(int ch = 0; ch < size; ch++) {
                 string_cat_printf(out, "%02x", data[rec * size + ch]);
             }
@@ -446,6 +666,7 @@ bool mf_df_parse_read_data_response(uint8_t* buf, uint16_t len, MifareDesfireFil
     len--;
     buf++;
     out->contents = malloc(len);
+    out->contents_size = len;
     memcpy(out->contents, buf, len);
     return true;
 }
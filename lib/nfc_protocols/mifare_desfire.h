@@ -3,6 +3,7 @@
 #include <m-string.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #define MF_DF_GET_VERSION (0x60)
 #define MF_DF_GET_FREE_MEMORY (0x6E)
@@ -97,6 +98,7 @@ typedef struct MifareDesfireFile {
         } record;
     } settings;
     uint8_t* contents;
+    uint32_t contents_size; /**< Allocated size, may differ from file settings */
 
     struct MifareDesfireFile* next;
 } MifareDesfireFile;
@@ -114,10 +116,39 @@ typedef struct {
     MifareDesfireFreeMemory* free_memory;
     MifareDesfireKeySettings* master_key_settings;
     MifareDesfireApplication* app_head;
+    void* arena; /**< If set, all nodes live in this single allocation */
 } MifareDesfireData;
 
 void mf_df_clear(MifareDesfireData* data);
 
+/** Get size of file contents as defined by file settings
+ *
+ * @param file  MifareDesfireFile instance
+ *
+ * @return contents size in bytes
+ */
+uint32_t mf_df_get_file_contents_size(const MifareDesfireFile* file);
+
+/** Pack data tree into contiguous buffer with pointers stored as offsets
+ *
+ * @param data  MifareDesfireData to pack
+ * @param arena buffer to pack to, NULL to only get packed size
+ *
+ * @return packed size in bytes
+ */
+size_t mf_df_pack(const MifareDesfireData* data, uint8_t* arena);
+
+/** Turn packed buffer back into data tree in place, without per node allocations.
+ * On success data takes ownership of arena, which is freed by mf_df_clear.
+ *
+ * @param data  MifareDesfireData to fill
+ * @param arena buffer produced by mf_df_pack, allocated with malloc
+ * @param size  buffer size
+ *
+ * @return true if buffer is consistent
+ */
+bool mf_df_unpack(MifareDesfireData* data, uint8_t* arena, size_t size);
+
 void mf_df_cat_data(MifareDesfireData* data, string_t out);
 void mf_df_cat_card_info(MifareDesfireData* data, string_t out);
 void mf_df_cat_version(MifareDesfireVersion* version, string_t out);
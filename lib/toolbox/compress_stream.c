@@ -0,0 +1,139 @@
+#include "compress_stream.h"
+
+#include <furi.h>
+#include <lib/heatshrink/heatshrink_decoder.h>
+
+#define COMPRESS_STREAM_INPUT_BUFFER_SIZE 512
+#define COMPRESS_STREAM_SKIP_BUFFER_SIZE 512
+#define COMPRESS_STREAM_MAX_WINDOW_LOG 13
+
+struct CompressStreamDecoder {
+    heatshrink_decoder* decoder;
+    /* Decoder input buffer followed by expansion window */
+    uint8_t* decoder_buffer;
+    size_t decoder_buffer_size;
+    /* Compressed data from source, not yet sunk into decoder */
+    uint8_t* source_buffer;
+    size_t source_buffer_fill;
+    size_t source_buffer_pos;
+    /* Scratch buffer for forward seeks */
+    uint8_t* skip_buffer;
+    size_t position;
+    CompressStreamReadCallback read_cb;
+    void* read_context;
+};
+
+bool compress_stream_header_is_valid(const CompressStreamHeader* header) {
+    furi_assert(header);
+    return (memcmp(header->magic, COMPRESS_STREAM_HEATSHRINK_MAGIC, sizeof(header->magic)) ==
+            0) &&
+           (header->version == COMPRESS_STREAM_HEATSHRINK_VERSION) &&
+           (header->window_log >= HEATSHRINK_MIN_WINDOW_BITS) &&
+           (header->window_log <= COMPRESS_STREAM_MAX_WINDOW_LOG) &&
+           (header->lookahead_log >= HEATSHRINK_MIN_LOOKAHEAD_BITS) &&
+           (header->lookahead_log < header->window_log);
+}
+
+CompressStreamDecoder* compress_stream_decoder_alloc(
+    const CompressStreamHeader* header,
+    CompressStreamReadCallback read_cb,
+    void* read_context) {
+    furi_check(compress_stream_header_is_valid(header));
+    furi_assert(read_cb);
+
+    CompressStreamDecoder* decoder = malloc(sizeof(CompressStreamDecoder));
+    decoder->decoder_buffer_size =
+        COMPRESS_STREAM_INPUT_BUFFER_SIZE + (1 << header->window_log);
+    decoder->decoder_buffer = malloc(decoder->decoder_buffer_size);
+    decoder->decoder = heatshrink_decoder_alloc(
+        decoder->decoder_buffer,
+        COMPRESS_STREAM_INPUT_BUFFER_SIZE,
+        header->window_log,
+        header->lookahead_log);
+    furi_check(decoder->decoder);
+    decoder->source_buffer = malloc(COMPRESS_STREAM_INPUT_BUFFER_SIZE);
+    decoder->skip_buffer = malloc(COMPRESS_STREAM_SKIP_BUFFER_SIZE);
+    decoder->read_cb = read_cb;
+    decoder->read_context = read_context;
+    compress_stream_decoder_rewind(decoder);
+    return decoder;
+}
+
+void compress_stream_decoder_free(CompressStreamDecoder* decoder) {
+    furi_assert(decoder);
+    heatshrink_decoder_free(decoder->decoder);
+    free(decoder->decoder_buffer);
+    free(decoder->source_buffer);
+    free(decoder->skip_buffer);
+    free(decoder);
+}
+
+bool compress_stream_decoder_read(CompressStreamDecoder* decoder, uint8_t* buffer, size_t size) {
+    furi_assert(decoder);
+    size_t decoded = 0;
+
+    while(decoded < size) {
+        size_t polled = 0;
+        HSD_poll_res poll_res =
+            heatshrink_decoder_poll(decoder->decoder, &buffer[decoded], size - decoded, &polled);
+        if(poll_res < 0) {
+            break;
+        }
+        decoded += polled;
+        if((decoded == size) || (poll_res == HSDR_POLL_MORE)) {
+            continue;
+        }
+
+        /* Decoder ran out of input */
+        if(decoder->source_buffer_pos == decoder->source_buffer_fill) {
+            int32_t bytes_read = decoder->read_cb(
+                decoder->read_context, decoder->source_buffer, COMPRESS_STREAM_INPUT_BUFFER_SIZE);
+            if(bytes_read <= 0) {
+                break;
+            }
+            decoder->source_buffer_fill = bytes_read;
+            decoder->source_buffer_pos = 0;
+        }
+
+        size_t sunk = 0;
+        heatshrink_decoder_sink(
+            decoder->decoder,
+            &decoder->source_buffer[decoder->source_buffer_pos],
+            decoder->source_buffer_fill - decoder->source_buffer_pos,
+            &sunk);
+        decoder->source_buffer_pos += sunk;
+    }
+
+    decoder->position += decoded;
+    return decoded == size;
+}
+
+bool compress_stream_decoder_seek(CompressStreamDecoder* decoder, size_t position) {
+    furi_assert(decoder);
+    if(position < decoder->position) {
+        return false;
+    }
+
+    while(decoder->position < position) {
+        size_t skip_size =
+            MIN((size_t)COMPRESS_STREAM_SKIP_BUFFER_SIZE, position - decoder->position);
+        if(!compress_stream_decoder_read(decoder, decoder->skip_buffer, skip_size)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t compress_stream_decoder_tell(CompressStreamDecoder* decoder) {
+    furi_assert(decoder);
+    return decoder->position;
+}
+
+void compress_stream_decoder_rewind(CompressStreamDecoder* decoder) {
+    furi_assert(decoder);
+    heatshrink_decoder_reset(decoder->decoder);
+    memset(decoder->decoder_buffer, 0, decoder->decoder_buffer_size);
+    decoder->source_buffer_fill = 0;
+    decoder->source_buffer_pos = 0;
+    decoder->position = 0;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define COMPRESS_STREAM_HEATSHRINK_MAGIC "HSDS"
+#define COMPRESS_STREAM_HEATSHRINK_VERSION 1
+
+#pragma pack(push, 1)
+
+/** Header of heatshrink-compressed stream, followed by compressed data.
+ * Produced by scripts/update.py
+ */
+typedef struct {
+    char magic[4];
+    uint8_t version;
+    uint8_t window_log;
+    uint8_t lookahead_log;
+    uint8_t reserved;
+} CompressStreamHeader;
+
+#pragma pack(pop)
+
+/** Source read callback
+ *
+ * @param context   read context
+ * @param buffer    buffer to fill
+ * @param size      buffer size
+ *
+ * @return number of bytes read, 0 on end of data, negative on error
+ */
+typedef int32_t (*CompressStreamReadCallback)(void* context, uint8_t* buffer, size_t size);
+
+typedef struct CompressStreamDecoder CompressStreamDecoder;
+
+/**
+ * @brief Check that header describes supported stream
+ *
+ * @param header stream header
+ * @return true if stream can be decoded
+ */
+bool compress_stream_header_is_valid(const CompressStreamHeader* header);
+
+/**
+ * @brief Allocate streaming decoder. Source must be positioned after header.
+ *
+ * @param header stream header, must be valid
+ * @param read_cb source read callback
+ * @param read_context source read callback context
+ * @return CompressStreamDecoder instance
+ */
+CompressStreamDecoder* compress_stream_decoder_alloc(
+    const CompressStreamHeader* header,
+    CompressStreamReadCallback read_cb,
+    void* read_context);
+
+void compress_stream_decoder_free(CompressStreamDecoder* decoder);
+
+/**
+ * @brief Decode exactly size bytes
+ *
+ * @param decoder CompressStreamDecoder instance
+ * @param buffer output buffer
+ * @param size number of bytes to decode
+ * @return true if all bytes were decoded
+ */
+bool compress_stream_decoder_read(CompressStreamDecoder* decoder, uint8_t* buffer, size_t size);
+
+/**
+ * @brief Skip decoded data up to position. Only forward seek is supported,
+ * use compress_stream_decoder_rewind to go back.
+ *
+ * @param decoder CompressStreamDecoder instance
+ * @param position absolute position in decoded data
+ * @return true on success
+ */
+bool compress_stream_decoder_seek(CompressStreamDecoder* decoder, size_t position);
+
+/**
+ * @brief Get position in decoded data
+ *
+ * @param decoder CompressStreamDecoder instance
+ * @return position
+ */
+size_t compress_stream_decoder_tell(CompressStreamDecoder* decoder);
+
+/**
+ * @brief Reset decoder to start of stream. Caller must also rewind
+ * source to start of compressed data.
+ *
+ * @param decoder CompressStreamDecoder instance
+ */
+void compress_stream_decoder_rewind(CompressStreamDecoder* decoder);
+
+#ifdef __cplusplus
+}
+#endif
@@ -4,6 +4,7 @@
 #include <storage/storage.h>
 #include <furi.h>
 #include <toolbox/path.h>
+#include <toolbox/compress_stream.h>
 
 #define TAG "TarArch"
 #define MAX_NAME_LEN 255
@@ -19,6 +20,12 @@ typedef struct TarArchive {
     void* unpack_cb_context;
 } TarArchive;
 
+/* Read-only stream for heatshrink-compressed archives */
+typedef struct {
+    File* file;
+    CompressStreamDecoder* decoder;
+} TarCompressedStream;
+
 /* API WRAPPER */
 static int mtar_storage_file_write(void* stream, const void* data, unsigned size) {
     uint16_t bytes_written = storage_file_write(stream, data, size);
@@ -50,6 +57,65 @@ const struct mtar_ops filesystem_ops = {
     .close = mtar_storage_file_close,
 };
 
+static int32_t tar_compressed_stream_source_read(void* context, uint8_t* buffer, size_t size) {
+    return storage_file_read(context, buffer, size);
+}
+
+static int mtar_compressed_file_read(void* stream, void* data, unsigned size) {
+    TarCompressedStream* compressed_stream = stream;
+    bool success = compress_stream_decoder_read(compressed_stream->decoder, data, size);
+    return success ? (int)size : MTAR_EREADFAIL;
+}
+
+static int mtar_compressed_file_write(void* stream, const void* data, unsigned size) {
+    UNUSED(stream);
+    UNUSED(data);
+    UNUSED(size);
+    return MTAR_EWRITEFAIL;
+}
+
+/* Archive is read mostly sequentially: forward seeks skip decoded data,
+ * backward seeks restart decoding from the beginning */
+static int mtar_compressed_file_seek(void* stream, unsigned offset) {
+    TarCompressedStream* compressed_stream = stream;
+    if(offset < compress_stream_decoder_tell(compressed_stream->decoder)) {
+        if(!storage_file_seek(compressed_stream->file, sizeof(CompressStreamHeader), true)) {
+            return MTAR_ESEEKFAIL;
+        }
+        compress_stream_decoder_rewind(compressed_stream->decoder);
+    }
+    bool success = compress_stream_decoder_seek(compressed_stream->decoder, offset);
+    return success ? MTAR_ESUCCESS : MTAR_ESEEKFAIL;
+}
+
+static int mtar_compressed_file_close(void* stream) {
+    TarCompressedStream* compressed_stream = stream;
+    if(compressed_stream) {
+        compress_stream_decoder_free(compressed_stream->decoder);
+        storage_file_close(compressed_stream->file);
+        storage_file_free(compressed_stream->file);
+        free(compressed_stream);
+    }
+    return MTAR_ESUCCESS;
+}
+
+const struct mtar_ops compressed_filesystem_ops = {
+    .read = mtar_compressed_file_read,
+    .write = mtar_compressed_file_write,
+    .seek = mtar_compressed_file_seek,
+    .close = mtar_compressed_file_close,
+};
+
+/* Checks for compressed stream header. Leaves file positioned at archive data. */
+static bool tar_archive_is_compressed(File* stream, CompressStreamHeader* header) {
+    uint16_t bytes_read = storage_file_read(stream, header, sizeof(CompressStreamHeader));
+    if((bytes_read == sizeof(CompressStreamHeader)) && compress_stream_header_is_valid(header)) {
+        return true;
+    }
+    storage_file_seek(stream, 0, true);
+    return false;
+}
+
 TarArchive* tar_archive_alloc(Storage* storage) {
     furi_check(storage);
     TarArchive* archive = malloc(sizeof(TarArchive));
@@ -84,7 +150,18 @@ bool tar_archive_open(TarArchive* archive, const char* path, TarOpenMode mode) {
         storage_file_free(stream);
         return false;
     }
-    mtar_init(&archive->tar, mtar_access, &filesystem_ops, stream);
+
+    CompressStreamHeader compress_header;
+    if((mode == TAR_OPEN_MODE_READ) && tar_archive_is_compressed(stream, &compress_header)) {
+        FURI_LOG_I(TAG, "Opening compressed archive");
+        TarCompressedStream* compressed_stream = malloc(sizeof(TarCompressedStream));
+        compressed_stream->file = stream;
+        compressed_stream->decoder = compress_stream_decoder_alloc(
+            &compress_header, tar_compressed_stream_source_read, stream);
+        mtar_init(&archive->tar, mtar_access, &compressed_filesystem_ops, compressed_stream);
+    } else {
+        mtar_init(&archive->tar, mtar_access, &filesystem_ops, stream);
+    }
 
     return true;
 }
@@ -165,12 +242,15 @@ bool tar_archive_file_finalize(TarArchive* archive) {
 typedef struct {
     TarArchive* archive;
     const char* work_dir;
+    /* Reused across entries */
+    File* out_file;
+    uint8_t* readbuf;
+    string_t fname;
 } TarArchiveDirectoryOpParams;
 
 static int archive_extract_foreach_cb(mtar_t* tar, const mtar_header_t* header, void* param) {
     TarArchiveDirectoryOpParams* op_params = param;
     TarArchive* archive = op_params->archive;
-    string_t fname;
 
     bool skip_entry = false;
     if(archive->unpack_cb) {
@@ -184,11 +264,10 @@ static int archive_extract_foreach_cb(mtar_t* tar, const mtar_header_t* header,
     }
 
     if(header->type == MTAR_TDIR) {
-        string_init(fname);
-        path_concat(op_params->work_dir, header->name, fname);
+        path_concat(op_params->work_dir, header->name, op_params->fname);
 
-        bool create_res = storage_simply_mkdir(archive->storage, string_get_cstr(fname));
-        string_clear(fname);
+        bool create_res =
+            storage_simply_mkdir(archive->storage, string_get_cstr(op_params->fname));
         return create_res ? 0 : -1;
     }
 
@@ -197,21 +276,24 @@ static int archive_extract_foreach_cb(mtar_t* tar, const mtar_header_t* header,
         return 0;
     }
 
-    string_init(fname);
-    path_concat(op_params->work_dir, header->name, fname);
+    path_concat(op_params->work_dir, header->name, op_params->fname);
     FURI_LOG_I(TAG, "Extracting %d bytes to '%s'", header->size, header->name);
-    File* out_file = storage_file_alloc(archive->storage);
-    uint8_t* readbuf = malloc(FILE_BLOCK_SIZE);
+    File* out_file = op_params->out_file;
+    uint8_t* readbuf = op_params->readbuf;
 
     bool failed = false;
     uint8_t n_tries = FILE_OPEN_NTRIES;
     do {
         while(n_tries-- > 0) {
             if(storage_file_open(
-                   out_file, string_get_cstr(fname), FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+                   out_file, string_get_cstr(op_params->fname), FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
                 break;
             }
-            FURI_LOG_W(TAG, "Failed to open '%s', reties: %d", string_get_cstr(fname), n_tries);
+            FURI_LOG_W(
+                TAG,
+                "Failed to open '%s', reties: %d",
+                string_get_cstr(op_params->fname),
+                n_tries);
             storage_file_close(out_file);
             furi_delay_ms(FILE_OPEN_RETRY_DELAY);
         }
@@ -230,9 +312,7 @@ static int archive_extract_foreach_cb(mtar_t* tar, const mtar_header_t* header,
         }
     } while(false);
 
-    storage_file_free(out_file);
-    free(readbuf);
-    string_clear(fname);
+    storage_file_close(out_file);
     return failed ? -1 : 0;
 }
 
@@ -241,11 +321,20 @@ bool tar_archive_unpack_to(TarArchive* archive, const char* destination) {
     TarArchiveDirectoryOpParams param = {
         .archive = archive,
         .work_dir = destination,
+        .out_file = storage_file_alloc(archive->storage),
+        .readbuf = malloc(FILE_BLOCK_SIZE),
     };
+    string_init(param.fname);
 
     FURI_LOG_I(TAG, "Restoring '%s'", destination);
 
-    return (mtar_foreach(&archive->tar, archive_extract_foreach_cb, &param) == MTAR_ESUCCESS);
+    bool success =
+        (mtar_foreach(&archive->tar, archive_extract_foreach_cb, &param) == MTAR_ESUCCESS);
+
+    string_clear(param.fname);
+    free(param.readbuf);
+    storage_file_free(param.out_file);
+    return success;
 };
 
 bool tar_archive_add_file(
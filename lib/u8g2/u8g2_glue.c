@@ -2,6 +2,9 @@
 
 #include <furi_hal.h>
 
+/* Shorter transfers (commands) are not worth DMA setup */
+#define U8X8_HW_SPI_DMA_THRESHOLD 16
+
 uint8_t u8g2_gpio_and_delay_stm32(u8x8_t* u8x8, uint8_t msg, uint8_t arg_int, void* arg_ptr) {
     UNUSED(u8x8);
     UNUSED(arg_ptr);
@@ -32,7 +35,13 @@ uint8_t u8x8_hw_spi_stm32(u8x8_t* u8x8, uint8_t msg, uint8_t arg_int, void* arg_
     UNUSED(u8x8);
     switch(msg) {
     case U8X8_MSG_BYTE_SEND:
-        furi_hal_spi_bus_tx(&furi_hal_spi_bus_handle_display, (uint8_t*)arg_ptr, arg_int, 10000);
+        if(arg_int >= U8X8_HW_SPI_DMA_THRESHOLD) {
+            furi_hal_spi_bus_trx_dma(
+                &furi_hal_spi_bus_handle_display, (uint8_t*)arg_ptr, NULL, arg_int, 10000);
+        } else {
+            furi_hal_spi_bus_tx(
+                &furi_hal_spi_bus_handle_display, (uint8_t*)arg_ptr, arg_int, 10000);
+        }
         break;
     case U8X8_MSG_BYTE_SET_DC:
         furi_hal_gpio_write(&gpio_display_di, arg_int);
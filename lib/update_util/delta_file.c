@@ -0,0 +1,141 @@
+#include "delta_file.h"
+
+#include <furi_hal.h>
+#include <toolbox/crc32_calc.h>
+
+#define DELTA_CRC_CHUNK_SIZE 4096
+
+bool delta_file_read_header(File* deltaf, DeltaFileHeader* header) {
+    furi_assert(header);
+
+    if(!storage_file_is_open(deltaf) || !storage_file_seek(deltaf, 0, true)) {
+        return false;
+    }
+
+    uint16_t bytes_read = storage_file_read(deltaf, header, sizeof(DeltaFileHeader));
+    if(bytes_read != sizeof(DeltaFileHeader)) {
+        return false;
+    }
+
+    if(memcmp(header->magic, DELTA_FILE_MAGIC, sizeof(header->magic))) {
+        return false;
+    }
+
+    if((header->version != DELTA_FILE_VERSION) ||
+       (header->page_size != furi_hal_flash_get_page_size()) ||
+       (header->base_address != furi_hal_flash_get_base())) {
+        return false;
+    }
+
+    return true;
+}
+
+static uint32_t delta_file_calc_flash_crc(
+    size_t address,
+    size_t size,
+    const DfuPageTaskProgressCb progress_cb,
+    void* context) {
+    uint32_t crc = 0;
+    for(size_t offset = 0; offset < size; offset += DELTA_CRC_CHUNK_SIZE) {
+        const size_t chunk_size = MIN((size_t)DELTA_CRC_CHUNK_SIZE, size - offset);
+        crc = crc32_calc_buffer(crc, (const void*)(address + offset), chunk_size);
+        if(progress_cb) {
+            progress_cb((offset + chunk_size) * 100 / size, context);
+        }
+    }
+    return crc;
+}
+
+bool delta_file_validate_base(
+    const DeltaFileHeader* header,
+    const DfuPageTaskProgressCb progress_cb,
+    void* context) {
+    furi_assert(header);
+    return delta_file_calc_flash_crc(
+               header->base_address, header->base_size, progress_cb, context) ==
+           header->base_crc;
+}
+
+bool delta_file_validate_target(
+    const DeltaFileHeader* header,
+    const DfuPageTaskProgressCb progress_cb,
+    void* context) {
+    furi_assert(header);
+    return delta_file_calc_flash_crc(
+               header->base_address, header->target_size, progress_cb, context) ==
+           header->target_crc;
+}
+
+/* Reads runs for a single record into page buffer */
+static bool delta_file_apply_runs(
+    File* deltaf,
+    const DeltaPageRecord* record,
+    uint8_t* page_buffer,
+    const size_t page_size) {
+    DeltaPageRun run = {0};
+    for(uint16_t i_run = 0; i_run < record->n_runs; ++i_run) {
+        if(storage_file_read(deltaf, &run, sizeof(DeltaPageRun)) != sizeof(DeltaPageRun)) {
+            return false;
+        }
+
+        if((run.length == 0) || ((size_t)(run.offset + run.length) > page_size)) {
+            return false;
+        }
+
+        if(storage_file_read(deltaf, &page_buffer[run.offset], run.length) != run.length) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool delta_file_process_records(
+    const DfuUpdateTask* task,
+    File* deltaf,
+    const DeltaFileHeader* header) {
+    furi_assert(task);
+    furi_assert(header);
+    task->progress_cb(0, task->context);
+
+    const size_t FLASH_PAGE_SIZE = furi_hal_flash_get_page_size();
+    uint8_t* page_buffer = malloc(FLASH_PAGE_SIZE);
+    DeltaPageRecord record = {0};
+    uint32_t i_record = 0;
+
+    for(; i_record < header->n_records; ++i_record) {
+        if(storage_file_read(deltaf, &record, sizeof(DeltaPageRecord)) !=
+           sizeof(DeltaPageRecord)) {
+            break;
+        }
+
+        const size_t page_address = header->base_address + record.page * FLASH_PAGE_SIZE;
+        if(task->address_cb && (!task->address_cb(page_address) ||
+                                !task->address_cb(page_address + FLASH_PAGE_SIZE - 1))) {
+            break;
+        }
+
+        if(record.flags & DeltaPageRecordFlagErased) {
+            memset(page_buffer, 0xFF, FLASH_PAGE_SIZE);
+        } else {
+            memcpy(page_buffer, (const void*)page_address, FLASH_PAGE_SIZE);
+        }
+
+        if(!delta_file_apply_runs(deltaf, &record, page_buffer, FLASH_PAGE_SIZE)) {
+            break;
+        }
+
+        int16_t i_page = furi_hal_flash_get_page_number(page_address);
+        if(i_page < 0) {
+            break;
+        }
+
+        if(!task->task_cb(i_page, page_buffer, FLASH_PAGE_SIZE)) {
+            break;
+        }
+
+        task->progress_cb((i_record + 1) * 100 / header->n_records, task->context);
+    }
+
+    free(page_buffer);
+    return i_record == header->n_records;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "dfu_file.h"
+
+#include <stdbool.h>
+#include <storage/storage.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Delta firmware package: page-level binary patch against a known base image.
+ * Generated by scripts/update.py. All values are little-endian.
+ *
+ * File layout:
+ *   DeltaFileHeader
+ *   DeltaPageRecord[n_records], each followed by n_runs of
+ *     DeltaPageRun + run data
+ *
+ * Records are sorted by page. Runs overwrite absolute bytes, so applying
+ * a record on top of an already patched page gives the same result.
+ */
+
+#define DELTA_FILE_MAGIC "FDLT"
+#define DELTA_FILE_VERSION 1
+
+#pragma pack(push, 1)
+
+typedef struct {
+    char magic[4];
+    uint8_t version;
+    uint8_t _reserved;
+    uint16_t page_size;
+    uint32_t base_address;
+    uint32_t base_size;
+    uint32_t base_crc;
+    uint32_t target_size;
+    uint32_t target_crc;
+    uint32_t n_records;
+} DeltaFileHeader;
+
+typedef enum {
+    /* Start from erased page instead of current flash contents */
+    DeltaPageRecordFlagErased = (1 << 0),
+} DeltaPageRecordFlag;
+
+typedef struct {
+    uint16_t page;
+    uint8_t flags;
+    uint8_t _reserved;
+    uint16_t n_runs;
+} DeltaPageRecord;
+
+typedef struct {
+    uint16_t offset;
+    uint16_t length;
+} DeltaPageRun;
+
+#pragma pack(pop)
+
+/* Reads and sanity-checks delta file header.
+ * Leaves read pointer at first page record.
+ */
+bool delta_file_read_header(File* deltaf, DeltaFileHeader* header);
+
+/* Checks that flash contents match base image described by header */
+bool delta_file_validate_base(
+    const DeltaFileHeader* header,
+    const DfuPageTaskProgressCb progress_cb,
+    void* context);
+
+/* Checks that flash contents match target image described by header */
+bool delta_file_validate_target(
+    const DeltaFileHeader* header,
+    const DfuPageTaskProgressCb progress_cb,
+    void* context);
+
+/* Applies page records. Assumes file read pointer is at first record.
+ * task_cb is called with fully patched page contents.
+ */
+bool delta_file_process_records(
+    const DfuUpdateTask* task,
+    File* deltaf,
+    const DeltaFileHeader* header);
+
+#ifdef __cplusplus
+}
+#endif
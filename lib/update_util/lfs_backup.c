@@ -1,13 +1,634 @@
 #include "lfs_backup.h"
 
+#include <furi.h>
+#include <m-dict.h>
 #include <toolbox/tar/tar_archive.h>
+#include <toolbox/dir_walk.h>
+#include <toolbox/crc32_calc.h>
 
-#define LFS_BACKUP_DEFAULT_LOCATION "/ext/" LFS_BACKUP_DEFAULT_FILENAME
+#define TAG "LfsBackup"
+
+#define LFS_BACKUP_INT_PATH "/int"
+#define LFS_BACKUP_TEMP_SUFFIX ".tmp"
+
+/* Pipeline buffer pool */
+#define LFS_BACKUP_BLOCK_SIZE 1024
+#define LFS_BACKUP_BLOCK_COUNT 4
+#define LFS_BACKUP_CHUNK_QUEUE_SIZE (LFS_BACKUP_BLOCK_COUNT * 2 + 2)
+#define LFS_BACKUP_QUEUE_TIMEOUT 100
+#define LFS_BACKUP_READER_STACK_SIZE 2048
+
+#define LFS_BACKUP_MANIFEST_MAGIC 0x4D53424C
+#define LFS_BACKUP_MANIFEST_VERSION 1
+
+typedef enum {
+    LfsBackupEntryFlagDirectory = (1 << 0),
+    /* Entry data is in increment archive, not in base */
+    LfsBackupEntryFlagIncrement = (1 << 1),
+} LfsBackupEntryFlag;
+
+#pragma pack(push, 1)
+
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t _reserved[3];
+    /* Size of base archive, to detect that it was replaced */
+    uint32_t base_size;
+    uint32_t n_records;
+} LfsBackupManifestHeader;
+
+/* Followed by name_len bytes of entry name */
+typedef struct {
+    uint8_t flags;
+    uint8_t name_len;
+    uint16_t _reserved;
+    uint32_t size;
+    uint32_t crc;
+} LfsBackupManifestRecord;
+
+#pragma pack(pop)
+
+typedef struct {
+    uint8_t flags;
+    uint32_t size;
+    uint32_t crc;
+} LfsBackupSnapshotEntry;
+
+DICT_DEF2(
+    LfsBackupSnapshot,
+    string_t,
+    STRING_OPLIST,
+    LfsBackupSnapshotEntry,
+    M_POD_OPLIST)
+
+typedef enum {
+    LfsBackupChunkTypeDirectory,
+    LfsBackupChunkTypeFileStart,
+    LfsBackupChunkTypeFileData,
+    LfsBackupChunkTypeFileEnd,
+    LfsBackupChunkTypeFileUnchanged,
+    LfsBackupChunkTypeDone,
+    LfsBackupChunkTypeError,
+} LfsBackupChunkType;
+
+typedef struct {
+    LfsBackupChunkType type;
+    /* Entry name for Directory, FileStart and FileUnchanged, data for FileData */
+    uint8_t* block;
+    uint16_t length;
+    uint32_t size;
+    uint32_t crc;
+} LfsBackupChunk;
+
+/* Reader thread walks /int and fills blocks from pool,
+ * writer (calling thread) stores them into archive and returns blocks to pool. */
+typedef struct {
+    Storage* storage;
+    uint8_t* blocks;
+    FuriMessageQueue* free_blocks;
+    FuriMessageQueue* chunks;
+    volatile bool abort;
+    /* Previous snapshot, NULL for full backup */
+    LfsBackupSnapshot_ptr previous;
+} LfsBackupPipeline;
+
+/* Manifest */
+
+static void lfs_backup_get_manifest_path(const char* archive_path, string_t manifest_path) {
+    string_printf(manifest_path, "%s%s", archive_path, LFS_BACKUP_MANIFEST_SUFFIX);
+}
+
+static void lfs_backup_get_increment_path(const char* archive_path, string_t increment_path) {
+    string_printf(increment_path, "%s%s", archive_path, LFS_BACKUP_INCREMENT_SUFFIX);
+}
+
+static bool lfs_backup_manifest_write_record(
+    File* manifest,
+    const char* name,
+    uint8_t flags,
+    uint32_t size,
+    uint32_t crc) {
+    const size_t name_len = strlen(name);
+    if(name_len > UINT8_MAX) {
+        return false;
+    }
+
+    LfsBackupManifestRecord record = {
+        .flags = flags,
+        .name_len = name_len,
+        .size = size,
+        .crc = crc,
+    };
+    return (storage_file_write(manifest, &record, sizeof(record)) == sizeof(record)) &&
+           (storage_file_write(manifest, name, name_len) == name_len);
+}
+
+static bool lfs_backup_manifest_load(
+    Storage* storage,
+    const char* manifest_path,
+    LfsBackupManifestHeader* header,
+    LfsBackupSnapshot_t snapshot) {
+    File* manifest = storage_file_alloc(storage);
+    char* name = malloc(UINT8_MAX + 1);
+    bool success = false;
+
+    do {
+        if(!storage_file_open(manifest, manifest_path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+            break;
+        }
+
+        if((storage_file_read(manifest, header, sizeof(LfsBackupManifestHeader)) !=
+            sizeof(LfsBackupManifestHeader)) ||
+           (header->magic != LFS_BACKUP_MANIFEST_MAGIC) ||
+           (header->version != LFS_BACKUP_MANIFEST_VERSION)) {
+            break;
+        }
+
+        string_t key;
+        string_init(key);
+        uint32_t i_record = 0;
+        for(; i_record < header->n_records; ++i_record) {
+            LfsBackupManifestRecord record;
+            if(storage_file_read(manifest, &record, sizeof(record)) != sizeof(record)) {
+                break;
+            }
+            if(storage_file_read(manifest, name, record.name_len) != record.name_len) {
+                break;
+            }
+            name[record.name_len] = '\0';
+            string_set_str(key, name);
+
+            LfsBackupSnapshotEntry entry = {
+                .flags = record.flags,
+                .size = record.size,
+                .crc = record.crc,
+            };
+            LfsBackupSnapshot_set_at(snapshot, key, entry);
+        }
+        string_clear(key);
+
+        success = (i_record == header->n_records);
+    } while(false);
+
+    free(name);
+    storage_file_free(manifest);
+    return success;
+}
+
+/* Pipeline: reader side */
+
+static bool lfs_backup_reader_get_block(LfsBackupPipeline* pipeline, uint8_t** block) {
+    while(!pipeline->abort) {
+        if(furi_message_queue_get(pipeline->free_blocks, block, LFS_BACKUP_QUEUE_TIMEOUT) ==
+           FuriStatusOk) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void lfs_backup_reader_put_chunk(LfsBackupPipeline* pipeline, LfsBackupChunk* chunk) {
+    furi_check(
+        furi_message_queue_put(pipeline->chunks, chunk, FuriWaitForever) == FuriStatusOk);
+}
+
+static bool lfs_backup_reader_send_name(
+    LfsBackupPipeline* pipeline,
+    LfsBackupChunkType type,
+    const char* name,
+    uint32_t size,
+    uint32_t crc) {
+    LfsBackupChunk chunk = {
+        .type = type,
+        .size = size,
+        .crc = crc,
+    };
+    if(!lfs_backup_reader_get_block(pipeline, &chunk.block)) {
+        return false;
+    }
+    strlcpy((char*)chunk.block, name, LFS_BACKUP_BLOCK_SIZE);
+    lfs_backup_reader_put_chunk(pipeline, &chunk);
+    return true;
+}
+
+static bool lfs_backup_reader_send_file_data(
+    LfsBackupPipeline* pipeline,
+    File* file,
+    uint32_t file_size) {
+    uint32_t crc = 0;
+    uint32_t offset = 0;
+    while(offset < file_size) {
+        LfsBackupChunk chunk = {
+            .type = LfsBackupChunkTypeFileData,
+        };
+        if(!lfs_backup_reader_get_block(pipeline, &chunk.block)) {
+            break;
+        }
+
+        const uint16_t bytes_to_read = MIN(LFS_BACKUP_BLOCK_SIZE, file_size - offset);
+        chunk.length = storage_file_read(file, chunk.block, bytes_to_read);
+        if(chunk.length != bytes_to_read) {
+            furi_message_queue_put(pipeline->free_blocks, &chunk.block, FuriWaitForever);
+            break;
+        }
+
+        crc = crc32_calc_buffer(crc, chunk.block, chunk.length);
+        offset += chunk.length;
+        lfs_backup_reader_put_chunk(pipeline, &chunk);
+    }
+
+    if(offset != file_size) {
+        return false;
+    }
+
+    LfsBackupChunk chunk = {
+        .type = LfsBackupChunkTypeFileEnd,
+        .size = file_size,
+        .crc = crc,
+    };
+    lfs_backup_reader_put_chunk(pipeline, &chunk);
+    return true;
+}
+
+/* Returns true if file matches previous snapshot and is stored in base archive */
+static bool lfs_backup_reader_is_unchanged(
+    LfsBackupPipeline* pipeline,
+    File* file,
+    const char* name,
+    uint32_t file_size,
+    uint32_t* crc) {
+    string_t key;
+    string_init_set_str(key, name);
+    LfsBackupSnapshotEntry* entry = LfsBackupSnapshot_get(pipeline->previous, key);
+    string_clear(key);
+
+    if(!entry || (entry->flags & LfsBackupEntryFlagIncrement) || (entry->size != file_size)) {
+        return false;
+    }
+
+    *crc = crc32_calc_file(file, NULL, NULL);
+    storage_file_seek(file, 0, true);
+    return *crc == entry->crc;
+}
+
+static bool lfs_backup_reader_send_file(
+    LfsBackupPipeline* pipeline,
+    File* file,
+    const char* path,
+    const char* name,
+    uint32_t file_size) {
+    if(!storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        storage_file_close(file);
+        return false;
+    }
+
+    bool success = false;
+    uint32_t crc = 0;
+    if(pipeline->previous &&
+       lfs_backup_reader_is_unchanged(pipeline, file, name, file_size, &crc)) {
+        success = lfs_backup_reader_send_name(
+            pipeline, LfsBackupChunkTypeFileUnchanged, name, file_size, crc);
+    } else {
+        success =
+            lfs_backup_reader_send_name(
+                pipeline, LfsBackupChunkTypeFileStart, name, file_size, 0) &&
+            lfs_backup_reader_send_file_data(pipeline, file, file_size);
+    }
+
+    storage_file_close(file);
+    return success;
+}
+
+static int32_t lfs_backup_reader_thread(void* context) {
+    LfsBackupPipeline* pipeline = context;
+    DirWalk* dir_walk = dir_walk_alloc(pipeline->storage);
+    File* file = storage_file_alloc(pipeline->storage);
+    string_t path;
+    string_init(path);
+    FileInfo file_info;
+
+    bool success = dir_walk_open(dir_walk, LFS_BACKUP_INT_PATH);
+    while(success && !pipeline->abort) {
+        DirWalkResult walk_result = dir_walk_read(dir_walk, path, &file_info);
+        if(walk_result == DirWalkLast) {
+            break;
+        } else if(walk_result == DirWalkError) {
+            success = false;
+            break;
+        }
+
+        const char* name = string_get_cstr(path) + strlen(LFS_BACKUP_INT_PATH "/");
+        if(file_info.flags & FSF_DIRECTORY) {
+            success = lfs_backup_reader_send_name(
+                pipeline, LfsBackupChunkTypeDirectory, name, 0, 0);
+        } else {
+            success = lfs_backup_reader_send_file(
+                pipeline, file, string_get_cstr(path), name, file_info.size);
+        }
+    }
+
+    if(!success) {
+        FURI_LOG_E(TAG, "Failed to read '%s'", string_get_cstr(path));
+    }
+
+    LfsBackupChunk chunk = {
+        .type = (success && !pipeline->abort) ? LfsBackupChunkTypeDone :
+                                                LfsBackupChunkTypeError,
+    };
+    lfs_backup_reader_put_chunk(pipeline, &chunk);
+
+    string_clear(path);
+    storage_file_free(file);
+    dir_walk_free(dir_walk);
+    return 0;
+}
+
+/* Pipeline: writer side */
+
+static bool lfs_backup_writer_process_chunk(
+    const LfsBackupChunk* chunk,
+    TarArchive* archive,
+    File* manifest,
+    uint8_t written_entry_flags,
+    uint32_t* n_records,
+    string_t file_name) {
+    const char* name = (const char*)chunk->block;
+    bool success = true;
+
+    switch(chunk->type) {
+    case LfsBackupChunkTypeDirectory:
+        success = tar_archive_dir_add_element(archive, name) &&
+                  lfs_backup_manifest_write_record(
+                      manifest, name, written_entry_flags | LfsBackupEntryFlagDirectory, 0, 0);
+        ++*n_records;
+        break;
+    case LfsBackupChunkTypeFileStart:
+        string_set_str(file_name, name);
+        success = tar_archive_file_add_header(archive, name, chunk->size);
+        break;
+    case LfsBackupChunkTypeFileData:
+        success = tar_archive_file_add_data_block(archive, chunk->block, chunk->length);
+        break;
+    case LfsBackupChunkTypeFileEnd:
+        success = tar_archive_file_finalize(archive) &&
+                  lfs_backup_manifest_write_record(
+                      manifest,
+                      string_get_cstr(file_name),
+                      written_entry_flags,
+                      chunk->size,
+                      chunk->crc);
+        ++*n_records;
+        break;
+    case LfsBackupChunkTypeFileUnchanged:
+        success = lfs_backup_manifest_write_record(manifest, name, 0, chunk->size, chunk->crc);
+        ++*n_records;
+        break;
+    default:
+        break;
+    }
+
+    return success;
+}
+
+/* Drains pipeline until reader finishes, even after a write error */
+static bool lfs_backup_writer_run(
+    LfsBackupPipeline* pipeline,
+    TarArchive* archive,
+    File* manifest,
+    uint8_t written_entry_flags,
+    uint32_t* n_records) {
+    string_t file_name;
+    string_init(file_name);
+    bool success = true;
+    bool finished = false;
+
+    while(!finished) {
+        LfsBackupChunk chunk;
+        furi_check(
+            furi_message_queue_get(pipeline->chunks, &chunk, FuriWaitForever) == FuriStatusOk);
+
+        if(chunk.type == LfsBackupChunkTypeDone) {
+            finished = true;
+        } else if(chunk.type == LfsBackupChunkTypeError) {
+            success = false;
+            finished = true;
+        } else if(success) {
+            success = lfs_backup_writer_process_chunk(
+                &chunk, archive, manifest, written_entry_flags, n_records, file_name);
+            if(!success) {
+                FURI_LOG_E(TAG, "Failed to write backup");
+                pipeline->abort = true;
+            }
+        }
+
+        if(chunk.block) {
+            furi_message_queue_put(pipeline->free_blocks, &chunk.block, FuriWaitForever);
+        }
+    }
+
+    string_clear(file_name);
+    return success;
+}
+
+static bool lfs_backup_pipeline_run(
+    Storage* storage,
+    LfsBackupSnapshot_ptr previous,
+    TarArchive* archive,
+    File* manifest,
+    uint32_t* n_records) {
+    LfsBackupPipeline pipeline = {
+        .storage = storage,
+        .blocks = malloc(LFS_BACKUP_BLOCK_SIZE * LFS_BACKUP_BLOCK_COUNT),
+        .free_blocks = furi_message_queue_alloc(LFS_BACKUP_BLOCK_COUNT, sizeof(uint8_t*)),
+        .chunks = furi_message_queue_alloc(LFS_BACKUP_CHUNK_QUEUE_SIZE, sizeof(LfsBackupChunk)),
+        .abort = false,
+        .previous = previous,
+    };
+
+    for(size_t i_block = 0; i_block < LFS_BACKUP_BLOCK_COUNT; ++i_block) {
+        uint8_t* block = &pipeline.blocks[i_block * LFS_BACKUP_BLOCK_SIZE];
+        furi_message_queue_put(pipeline.free_blocks, &block, 0);
+    }
+
+    FuriThread* reader = furi_thread_alloc();
+    furi_thread_set_name(reader, "LfsBackupReader");
+    furi_thread_set_stack_size(reader, LFS_BACKUP_READER_STACK_SIZE);
+    furi_thread_set_context(reader, &pipeline);
+    furi_thread_set_callback(reader, lfs_backup_reader_thread);
+    furi_thread_start(reader);
+
+    const uint8_t written_entry_flags = previous ? LfsBackupEntryFlagIncrement : 0;
+    bool success =
+        lfs_backup_writer_run(&pipeline, archive, manifest, written_entry_flags, n_records);
+
+    furi_thread_join(reader);
+    furi_thread_free(reader);
+
+    furi_message_queue_free(pipeline.chunks);
+    furi_message_queue_free(pipeline.free_blocks);
+    free(pipeline.blocks);
+    return success;
+}
+
+/* Writes archive and manifest. In incremental mode, archive only
+ * gets entries that changed since previous snapshot. */
+static bool lfs_backup_write_snapshot(
+    Storage* storage,
+    const char* archive_path,
+    const char* manifest_path,
+    LfsBackupSnapshot_ptr previous,
+    uint32_t base_size) {
+    TarArchive* archive = tar_archive_alloc(storage);
+    File* manifest = storage_file_alloc(storage);
+    bool success = false;
+
+    do {
+        if(!tar_archive_open(archive, archive_path, TAR_OPEN_MODE_WRITE) ||
+           !storage_file_open(manifest, manifest_path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+            break;
+        }
+
+        LfsBackupManifestHeader header = {
+            .magic = LFS_BACKUP_MANIFEST_MAGIC,
+            .version = LFS_BACKUP_MANIFEST_VERSION,
+            .base_size = base_size,
+            .n_records = 0,
+        };
+        /* Placeholder, updated when number of records is known */
+        if(storage_file_write(manifest, &header, sizeof(header)) != sizeof(header)) {
+            break;
+        }
+
+        if(!lfs_backup_pipeline_run(storage, previous, archive, manifest, &header.n_records) ||
+           !tar_archive_finalize(archive)) {
+            break;
+        }
+
+        if(!previous) {
+            /* Full backup: archive we just wrote is the base */
+            FileInfo file_info;
+            tar_archive_free(archive);
+            archive = NULL;
+            if(storage_common_stat(storage, archive_path, &file_info) != FSE_OK) {
+                break;
+            }
+            header.base_size = file_info.size;
+        }
+
+        success = storage_file_seek(manifest, 0, true) &&
+                  (storage_file_write(manifest, &header, sizeof(header)) == sizeof(header));
+    } while(false);
+
+    if(archive) {
+        tar_archive_free(archive);
+    }
+    storage_file_free(manifest);
+    return success;
+}
+
+static bool lfs_backup_replace_file(Storage* storage, const char* temp_path, const char* path) {
+    storage_common_remove(storage, path);
+    return storage_common_rename(storage, temp_path, path) == FSE_OK;
+}
+
+static bool lfs_backup_create_full(Storage* storage, const char* destination) {
+    string_t manifest_path, increment_path;
+    string_init(manifest_path);
+    string_init(increment_path);
+    lfs_backup_get_manifest_path(destination, manifest_path);
+    lfs_backup_get_increment_path(destination, increment_path);
+
+    storage_common_remove(storage, string_get_cstr(increment_path));
+    bool success = lfs_backup_write_snapshot(
+        storage, destination, string_get_cstr(manifest_path), NULL, 0);
+    if(!success) {
+        storage_common_remove(storage, string_get_cstr(manifest_path));
+    }
+
+    string_clear(manifest_path);
+    string_clear(increment_path);
+    return success;
+}
+
+static bool lfs_backup_create_increment(
+    Storage* storage,
+    const char* destination,
+    LfsBackupSnapshot_ptr previous,
+    uint32_t base_size) {
+    string_t manifest_path, increment_path, temp_manifest_path, temp_increment_path;
+    string_init(manifest_path);
+    string_init(increment_path);
+    lfs_backup_get_manifest_path(destination, manifest_path);
+    lfs_backup_get_increment_path(destination, increment_path);
+    string_init_printf(
+        temp_manifest_path, "%s%s", string_get_cstr(manifest_path), LFS_BACKUP_TEMP_SUFFIX);
+    string_init_printf(
+        temp_increment_path, "%s%s", string_get_cstr(increment_path), LFS_BACKUP_TEMP_SUFFIX);
+
+    /* Previous snapshot stays valid until new one is complete */
+    bool success = lfs_backup_write_snapshot(
+                       storage,
+                       string_get_cstr(temp_increment_path),
+                       string_get_cstr(temp_manifest_path),
+                       previous,
+                       base_size) &&
+                   lfs_backup_replace_file(
+                       storage,
+                       string_get_cstr(temp_increment_path),
+                       string_get_cstr(increment_path)) &&
+                   lfs_backup_replace_file(
+                       storage,
+                       string_get_cstr(temp_manifest_path),
+                       string_get_cstr(manifest_path));
+
+    storage_common_remove(storage, string_get_cstr(temp_increment_path));
+    storage_common_remove(storage, string_get_cstr(temp_manifest_path));
+
+    string_clear(manifest_path);
+    string_clear(increment_path);
+    string_clear(temp_manifest_path);
+    string_clear(temp_increment_path);
+    return success;
+}
 
 bool lfs_backup_create(Storage* storage, const char* destination) {
     const char* final_destination =
         destination && strlen(destination) ? destination : LFS_BACKUP_DEFAULT_LOCATION;
-    return storage_int_backup(storage, final_destination) == FSE_OK;
+    return lfs_backup_create_full(storage, final_destination);
+}
+
+bool lfs_backup_create_incremental(Storage* storage, const char* destination) {
+    const char* final_destination =
+        destination && strlen(destination) ? destination : LFS_BACKUP_DEFAULT_LOCATION;
+
+    string_t manifest_path;
+    string_init(manifest_path);
+    lfs_backup_get_manifest_path(final_destination, manifest_path);
+
+    LfsBackupSnapshot_t previous;
+    LfsBackupSnapshot_init(previous);
+    LfsBackupManifestHeader header;
+    FileInfo base_info;
+
+    bool has_previous =
+        lfs_backup_manifest_load(storage, string_get_cstr(manifest_path), &header, previous) &&
+        (storage_common_stat(storage, final_destination, &base_info) == FSE_OK) &&
+        (base_info.size == header.base_size);
+
+    bool success = false;
+    if(has_previous) {
+        FURI_LOG_I(TAG, "Incremental backup, %lu entries in snapshot", header.n_records);
+        success =
+            lfs_backup_create_increment(storage, final_destination, previous, header.base_size);
+    } else {
+        FURI_LOG_I(TAG, "No valid snapshot, doing full backup");
+        success = lfs_backup_create_full(storage, final_destination);
+    }
+
+    LfsBackupSnapshot_clear(previous);
+    string_clear(manifest_path);
+    return success;
 }
 
 bool lfs_backup_exists(Storage* storage, const char* source) {
@@ -16,7 +637,68 @@ bool lfs_backup_exists(Storage* storage, const char* source) {
     return storage_common_stat(storage, final_source, &fi) == FSE_OK;
 }
 
+/* Only extracts base archive entries that are still current */
+static bool lfs_backup_base_entry_filter_cb(const char* name, bool is_directory, void* context) {
+    LfsBackupSnapshot_ptr snapshot = context;
+    string_t key;
+    string_init_set_str(key, name);
+    /* Directory entries may come with trailing separator */
+    if(is_directory && string_end_with_str_p(key, "/")) {
+        string_left(key, string_size(key) - 1);
+    }
+    LfsBackupSnapshotEntry* entry = LfsBackupSnapshot_get(snapshot, key);
+    string_clear(key);
+
+    if(!entry) {
+        return false;
+    }
+    return is_directory || !(entry->flags & LfsBackupEntryFlagIncrement);
+}
+
+static bool lfs_backup_unpack_archive(
+    Storage* storage,
+    const char* source,
+    tar_unpack_file_cb filter_cb,
+    void* filter_context) {
+    TarArchive* archive = tar_archive_alloc(storage);
+    tar_archive_set_file_callback(archive, filter_cb, filter_context);
+    bool success = tar_archive_open(archive, source, TAR_OPEN_MODE_READ) &&
+                   tar_archive_unpack_to(archive, LFS_BACKUP_INT_PATH);
+    tar_archive_free(archive);
+    return success;
+}
+
 bool lfs_backup_unpack(Storage* storage, const char* source) {
     const char* final_source = source && strlen(source) ? source : LFS_BACKUP_DEFAULT_LOCATION;
-    return storage_int_restore(storage, final_source) == FSE_OK;
+
+    string_t manifest_path, increment_path;
+    string_init(manifest_path);
+    string_init(increment_path);
+    lfs_backup_get_manifest_path(final_source, manifest_path);
+    lfs_backup_get_increment_path(final_source, increment_path);
+
+    LfsBackupSnapshot_t snapshot;
+    LfsBackupSnapshot_init(snapshot);
+    LfsBackupManifestHeader header;
+    FileInfo base_info;
+
+    bool success = false;
+    /* Snapshot only applies to base archive it was made against */
+    if((storage_common_stat(storage, string_get_cstr(increment_path), NULL) == FSE_OK) &&
+       lfs_backup_manifest_load(storage, string_get_cstr(manifest_path), &header, snapshot) &&
+       (storage_common_stat(storage, final_source, &base_info) == FSE_OK) &&
+       (base_info.size == header.base_size)) {
+        FURI_LOG_I(TAG, "Restoring base and increment");
+        success = lfs_backup_unpack_archive(
+                      storage, final_source, lfs_backup_base_entry_filter_cb, snapshot) &&
+                  lfs_backup_unpack_archive(
+                      storage, string_get_cstr(increment_path), NULL, NULL);
+    } else {
+        success = lfs_backup_unpack_archive(storage, final_source, NULL, NULL);
+    }
+
+    LfsBackupSnapshot_clear(snapshot);
+    string_clear(manifest_path);
+    string_clear(increment_path);
+    return success;
 }
@@ -4,12 +4,22 @@
 #include <storage/storage.h>
 
 #define LFS_BACKUP_DEFAULT_FILENAME "backup.tar"
+/* Fixed location, so snapshot survives between update packages */
+#define LFS_BACKUP_DEFAULT_LOCATION "/ext/" LFS_BACKUP_DEFAULT_FILENAME
+/* Snapshot manifest and incremental archive are stored next to backup archive */
+#define LFS_BACKUP_MANIFEST_SUFFIX ".idx"
+#define LFS_BACKUP_INCREMENT_SUFFIX ".inc"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 bool lfs_backup_create(Storage* storage, const char* destination);
+
+/* Only stores files changed since last snapshot at destination, by size and CRC32.
+ * Falls back to full backup if there's no valid snapshot.
+ */
+bool lfs_backup_create_incremental(Storage* storage, const char* destination);
 bool lfs_backup_exists(Storage* storage, const char* source);
 bool lfs_backup_unpack(Storage* storage, const char* source);
 
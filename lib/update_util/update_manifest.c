@@ -9,6 +9,9 @@
 #define MANIFEST_KEY_LOADER_FILE "Loader"
 #define MANIFEST_KEY_LOADER_CRC "Loader CRC"
 #define MANIFEST_KEY_DFU_FILE "Firmware"
+#define MANIFEST_KEY_DELTA_FILE "Firmware delta"
+#define MANIFEST_KEY_DELTA_CRC "Firmware delta CRC"
+#define MANIFEST_KEY_DELTA_BASE_CRC "Firmware delta base CRC"
 #define MANIFEST_KEY_RADIO_FILE "Radio"
 #define MANIFEST_KEY_RADIO_ADDRESS "Radio address"
 #define MANIFEST_KEY_RADIO_VERSION "Radio version"
@@ -23,10 +26,13 @@ UpdateManifest* update_manifest_alloc() {
     UpdateManifest* update_manifest = malloc(sizeof(UpdateManifest));
     string_init(update_manifest->version);
     string_init(update_manifest->firmware_dfu_image);
+    string_init(update_manifest->firmware_delta_image);
     string_init(update_manifest->radio_image);
     string_init(update_manifest->staged_loader_file);
     string_init(update_manifest->resource_bundle);
     string_init(update_manifest->splash_file);
+    update_manifest->firmware_delta_crc = 0;
+    update_manifest->firmware_delta_base_crc = 0;
     update_manifest->target = 0;
     update_manifest->manifest_version = 0;
     memset(update_manifest->ob_reference.bytes, 0, FURI_HAL_FLASH_OB_RAW_SIZE_BYTES);
@@ -40,6 +46,7 @@ void update_manifest_free(UpdateManifest* update_manifest) {
     furi_assert(update_manifest);
     string_clear(update_manifest->version);
     string_clear(update_manifest->firmware_dfu_image);
+    string_clear(update_manifest->firmware_delta_image);
     string_clear(update_manifest->radio_image);
     string_clear(update_manifest->staged_loader_file);
     string_clear(update_manifest->resource_bundle);
@@ -113,8 +120,24 @@ static bool
         flipper_format_read_string(
             flipper_file, MANIFEST_KEY_SPLASH_FILE, update_manifest->splash_file);
 
+        /* Keys below were added later and are absent in older manifests.
+         * Delta is applied only if flash contents match base CRC, with DFU as fallback */
+        flipper_format_read_string(
+            flipper_file, MANIFEST_KEY_DELTA_FILE, update_manifest->firmware_delta_image);
+        flipper_format_read_hex(
+            flipper_file,
+            MANIFEST_KEY_DELTA_CRC,
+            (uint8_t*)&update_manifest->firmware_delta_crc,
+            sizeof(uint32_t));
+        flipper_format_read_hex(
+            flipper_file,
+            MANIFEST_KEY_DELTA_BASE_CRC,
+            (uint8_t*)&update_manifest->firmware_delta_base_crc,
+            sizeof(uint32_t));
+
         update_manifest->valid =
             (!string_empty_p(update_manifest->firmware_dfu_image) ||
+             !string_empty_p(update_manifest->firmware_delta_image) ||
              !string_empty_p(update_manifest->radio_image) ||
              !string_empty_p(update_manifest->resource_bundle));
     }
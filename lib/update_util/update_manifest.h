@@ -34,6 +34,9 @@ typedef struct {
     string_t staged_loader_file;
     uint32_t staged_loader_crc;
     string_t firmware_dfu_image;
+    string_t firmware_delta_image;
+    uint32_t firmware_delta_crc;
+    uint32_t firmware_delta_base_crc;
     string_t radio_image;
     uint32_t radio_address;
     UpdateManifestRadioVersion radio_version;
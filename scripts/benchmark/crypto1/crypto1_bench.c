@@ -0,0 +1,87 @@
+/* Host benchmark of scalar and bitsliced Crypto1 reader authentication check
+ *
+ * Build and run from repository root:
+ *   cc -O2 -Iscripts/benchmark/crypto1 -Ilib/nfc_protocols \
+ *       scripts/benchmark/crypto1/crypto1_bench.c \
+ *       lib/nfc_protocols/crypto1.c lib/nfc_protocols/nfc_util.c \
+ *       -o crypto1_bench && ./crypto1_bench
+ */
+
+#include <crypto1.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define CRYPTO1_BENCH_KEYS (1UL << 16)
+#define CRYPTO1_BENCH_ROUNDS (8)
+
+static uint64_t crypto1_bench_rand(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static double crypto1_bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(void) {
+    uint64_t seed = 0x0123456789ABCDEFULL;
+    uint64_t* keys = malloc(CRYPTO1_BENCH_KEYS * sizeof(uint64_t));
+    for(size_t i = 0; i < CRYPTO1_BENCH_KEYS; i++) {
+        keys[i] = crypto1_bench_rand(&seed) & 0xFFFFFFFFFFFFULL;
+    }
+
+    /* Reader side of authentication with key from the middle of dictionary */
+    const size_t key_index = CRYPTO1_BENCH_KEYS / 2 + 7;
+    const uint32_t cuid = crypto1_bench_rand(&seed);
+    const uint32_t nt = crypto1_bench_rand(&seed);
+    const uint32_t nr = crypto1_bench_rand(&seed);
+    Crypto1 crypto1;
+    crypto1_init(&crypto1, keys[key_index]);
+    crypto1_word(&crypto1, cuid ^ nt, 0);
+    const uint32_t nr_enc = nr ^ crypto1_word(&crypto1, nr, 0);
+    const uint32_t ar_enc = prng_successor(nt, 64) ^ crypto1_word(&crypto1, 0, 0);
+
+    size_t scalar_found = 0;
+    double start = crypto1_bench_now();
+    for(size_t round = 0; round < CRYPTO1_BENCH_ROUNDS; round++) {
+        for(size_t i = 0; i < CRYPTO1_BENCH_KEYS; i++) {
+            if(crypto1_check_reader_auth(keys[i], cuid, nt, nr_enc, ar_enc)) {
+                scalar_found += (i == key_index);
+            }
+        }
+    }
+    const double scalar_time = crypto1_bench_now() - start;
+
+    size_t batch_found = 0;
+    start = crypto1_bench_now();
+    for(size_t round = 0; round < CRYPTO1_BENCH_ROUNDS; round++) {
+        for(size_t i = 0; i < CRYPTO1_BENCH_KEYS; i += CRYPTO1_BATCH_SIZE) {
+            uint32_t found =
+                crypto1_batch_check_reader_auth(&keys[i], CRYPTO1_BATCH_SIZE, cuid, nt, nr_enc, ar_enc);
+            while(found) {
+                size_t lane = __builtin_ctz(found);
+                batch_found += (i + lane == key_index);
+                found &= found - 1;
+            }
+        }
+    }
+    const double batch_time = crypto1_bench_now() - start;
+
+    const double total = (double)CRYPTO1_BENCH_KEYS * CRYPTO1_BENCH_ROUNDS;
+    printf("scalar:     %10.0f keys/s\r\n", total / scalar_time);
+    printf("bitsliced:  %10.0f keys/s (x%.1f)\r\n", total / batch_time, scalar_time / batch_time);
+
+    free(keys);
+
+    if((scalar_found != CRYPTO1_BENCH_ROUNDS) || (batch_found != CRYPTO1_BENCH_ROUNDS)) {
+        printf("key mismatch: scalar %zu, bitsliced %zu\r\n", scalar_found, batch_found);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+/* Minimal furi shim to build lib/nfc_protocols on host */
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#define FURI_BIT(x, n) (((x) >> (n)) & 1)
+
+#define FURI_SWAP(x, y)     \
+    do {                    \
+        typeof(x) SWAP = x; \
+        x = y;              \
+        y = SWAP;           \
+    } while(0)
+
+#define furi_assert(x) assert(x)
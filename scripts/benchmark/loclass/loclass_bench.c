@@ -0,0 +1,110 @@
+/* Host benchmark of per key and batched iCLASS key diversification and reader MAC
+ *
+ * Build and run from repository root, needs mbedtls installed on host:
+ *   cc -O2 -Ilib/loclass \
+ *       scripts/benchmark/loclass/loclass_bench.c \
+ *       lib/loclass/optimized_cipher.c lib/loclass/optimized_cipherutils.c \
+ *       lib/loclass/optimized_elite.c lib/loclass/optimized_ikeys.c \
+ *       -lmbedcrypto -o loclass_bench && ./loclass_bench
+ */
+
+#include <optimized_cipher.h>
+#include <optimized_elite.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define LOCLASS_BENCH_KEYS (256)
+#define LOCLASS_BENCH_ROUNDS (64)
+
+static uint64_t loclass_bench_rand(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static double loclass_bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(void) {
+    uint64_t seed = 0x0123456789ABCDEFULL;
+    uint8_t* keys = malloc(LOCLASS_BENCH_KEYS * 8);
+    for(size_t i = 0; i < LOCLASS_BENCH_KEYS * 8; i++) {
+        keys[i] = loclass_bench_rand(&seed);
+    }
+    uint8_t* keytables = malloc(LOCLASS_BENCH_KEYS * 128);
+    for(size_t i = 0; i < LOCLASS_BENCH_KEYS; i++) {
+        loclass_hash2(&keys[i * 8], &keytables[i * 128]);
+    }
+
+    uint8_t csn[8];
+    uint8_t ccnr[12] = {0};
+    for(size_t i = 0; i < 8; i++) {
+        csn[i] = loclass_bench_rand(&seed);
+        ccnr[i] = loclass_bench_rand(&seed);
+    }
+
+    uint8_t* single_macs = malloc(LOCLASS_BENCH_KEYS * 4 * 2);
+    uint8_t* batch_macs = malloc(LOCLASS_BENCH_KEYS * 4 * 2);
+    uint8_t* keytable_macs = malloc(LOCLASS_BENCH_KEYS * 4);
+
+    /* Every key diversified and MACed on its own, standard and elite */
+    double start = loclass_bench_now();
+    for(size_t round = 0; round < LOCLASS_BENCH_ROUNDS; round++) {
+        for(size_t elite = 0; elite < 2; elite++) {
+            for(size_t i = 0; i < LOCLASS_BENCH_KEYS; i++) {
+                uint8_t div_key[8];
+                loclass_iclass_calc_div_key(csn, &keys[i * 8], div_key, elite);
+                loclass_opt_doReaderMAC(
+                    ccnr, div_key, &single_macs[(elite * LOCLASS_BENCH_KEYS + i) * 4]);
+            }
+        }
+    }
+    const double single_time = loclass_bench_now() - start;
+
+    start = loclass_bench_now();
+    for(size_t round = 0; round < LOCLASS_BENCH_ROUNDS; round++) {
+        loclass_opt_doBatchReaderMAC(csn, ccnr, keys, LOCLASS_BENCH_KEYS, false, batch_macs);
+        loclass_opt_doBatchReaderMAC(
+            csn, ccnr, keys, LOCLASS_BENCH_KEYS, true, &batch_macs[LOCLASS_BENCH_KEYS * 4]);
+    }
+    const double batch_time = loclass_bench_now() - start;
+
+    /* Elite keytables are calculated once per dictionary, not per card */
+    start = loclass_bench_now();
+    for(size_t round = 0; round < LOCLASS_BENCH_ROUNDS; round++) {
+        loclass_opt_doBatchReaderMAC(csn, ccnr, keys, LOCLASS_BENCH_KEYS, false, batch_macs);
+        loclass_opt_doBatchReaderMAC_keytables(
+            csn, ccnr, keytables, LOCLASS_BENCH_KEYS, keytable_macs);
+    }
+    const double keytable_time = loclass_bench_now() - start;
+
+    const double total = (double)LOCLASS_BENCH_KEYS * 2 * LOCLASS_BENCH_ROUNDS;
+    printf("single:     %10.0f MACs/s\r\n", total / single_time);
+    printf("batch:      %10.0f MACs/s (x%.1f)\r\n", total / batch_time, single_time / batch_time);
+    printf(
+        "keytables:  %10.0f MACs/s (x%.1f)\r\n",
+        total / keytable_time,
+        single_time / keytable_time);
+
+    const uint8_t* elite_macs = &single_macs[LOCLASS_BENCH_KEYS * 4];
+    int mismatch = memcmp(single_macs, batch_macs, LOCLASS_BENCH_KEYS * 4 * 2) ||
+                   memcmp(elite_macs, keytable_macs, LOCLASS_BENCH_KEYS * 4);
+
+    free(keytable_macs);
+    free(batch_macs);
+    free(single_macs);
+    free(keytables);
+    free(keys);
+
+    if(mismatch) {
+        printf("MAC mismatch\r\n");
+        return 1;
+    }
+    return 0;
+}
@@ -10,6 +10,7 @@ import shutil
 import zlib
 import tarfile
 import math
+import struct
 
 from slideshow import Main as SlideshowMain
 
@@ -22,6 +23,13 @@ class Main(App):
     RESOURCE_TAR_MODE = "w:"
     RESOURCE_TAR_FORMAT = tarfile.USTAR_FORMAT
     RESOURCE_FILE_NAME = "resources.tar"
+    RESOURCE_COMPRESSED_FILE_NAME = "resources.ths"
+
+    # Heatshrink stream, see lib/toolbox/compress_stream.h
+    HEATSHRINK_STREAM_MAGIC = b"HSDS"
+    HEATSHRINK_STREAM_VERSION = 1
+    HEATSHRINK_WINDOW_SZ2 = 12
+    HEATSHRINK_LOOKAHEAD_SZ2 = 6
 
     WHITELISTED_STACK_TYPES = set(
         map(
@@ -31,8 +39,17 @@ class Main(App):
     )
 
     FLASH_BASE = 0x8000000
+    FLASH_PAGE_SIZE = 4 * 1024
     MIN_LFS_PAGES = 6
 
+    # Delta firmware package, see lib/update_util/delta_file.h
+    DELTA_FILE_NAME = "firmware.delta"
+    DELTA_FILE_MAGIC = b"FDLT"
+    DELTA_FILE_VERSION = 1
+    DELTA_RECORD_FLAG_ERASED = 1 << 0
+    # Unchanged gaps shorter than this are merged into surrounding run
+    DELTA_RUN_MERGE_GAP = 8
+
     # Post-update slideshow
     SPLASH_BIN_NAME = "splash.bin"
 
@@ -51,6 +68,13 @@ class Main(App):
             "--dfu", dest="dfu", default="", required=False
         )
         self.parser_generate.add_argument("-r", dest="resources", required=False)
+        self.parser_generate.add_argument(
+            "--uncompressed-resources",
+            dest="uncompressed_resources",
+            action="store_true",
+            help="Don't compress resources archive",
+            required=False,
+        )
         self.parser_generate.add_argument("--stage", dest="stage", required=True)
         self.parser_generate.add_argument(
             "--radio", dest="radiobin", default="", required=False
@@ -67,6 +91,13 @@ class Main(App):
             "--radiotype", dest="radiotype", required=False
         )
 
+        self.parser_generate.add_argument(
+            "--delta-base",
+            dest="delta_base",
+            help="Base firmware .dfu or .bin to generate delta package against",
+            required=False,
+        )
+
         self.parser_generate.add_argument("--obdata", dest="obdata", required=False)
         self.parser_generate.add_argument("--splash", dest="splash", required=False)
         self.parser_generate.add_argument(
@@ -118,10 +149,20 @@ class Main(App):
             shutil.copyfile(
                 self.args.radiobin, join(self.args.directory, radiobin_basename)
             )
+        delta_basename = ""
+        delta_base_crc = 0
+        if self.args.delta_base:
+            if not self.args.dfu:
+                raise ValueError("--delta-base requires --dfu")
+            delta_basename = self.DELTA_FILE_NAME
+            delta_base_crc = self.package_delta(
+                self.args.delta_base,
+                self.args.dfu,
+                join(self.args.directory, delta_basename),
+            )
         if self.args.resources:
-            resources_basename = self.RESOURCE_FILE_NAME
-            self.package_resources(
-                self.args.resources, join(self.args.directory, resources_basename)
+            resources_basename = self.package_resources(
+                self.args.resources, self.args.directory
             )
 
         if not self.layout_check(dfu_size, radio_addr):
@@ -172,6 +213,15 @@ class Main(App):
         file.writeKey("OB mask", self.bytes2ffhex(obvalues.compare_mask))
         file.writeKey("OB write mask", self.bytes2ffhex(obvalues.write_mask))
         file.writeKey("Splashscreen", self.SPLASH_BIN_NAME if self.args.splash else "")
+        file.writeKey("Firmware delta", delta_basename)
+        if delta_basename:
+            file.writeKey(
+                "Firmware delta CRC",
+                self.int2ffhex(self.crc(join(self.args.directory, delta_basename))),
+            )
+        else:
+            file.writeKey("Firmware delta CRC", self.int2ffhex(0))
+        file.writeKey("Firmware delta base CRC", self.int2ffhex(delta_base_crc))
         file.save(join(self.args.directory, self.UPDATE_MANIFEST_NAME))
 
         return 0
@@ -199,12 +249,136 @@ class Main(App):
             "Please confirm that you REALLY want to do that with --I-understand-what-I-am-doing=yes"
         )
 
-    def package_resources(self, srcdir: str, dst_name: str):
+    def package_resources(self, srcdir: str, dst_dir: str):
+        tar_name = join(dst_dir, self.RESOURCE_FILE_NAME)
         with tarfile.open(
-            dst_name, self.RESOURCE_TAR_MODE, format=self.RESOURCE_TAR_FORMAT
+            tar_name, self.RESOURCE_TAR_MODE, format=self.RESOURCE_TAR_FORMAT
         ) as tarball:
             tarball.add(srcdir, arcname="")
 
+        if self.args.uncompressed_resources:
+            return self.RESOURCE_FILE_NAME
+
+        try:
+            import heatshrink2
+        except ImportError as e:
+            self.logger.warn("heatshrink2 module is missing, resources not compressed")
+            return self.RESOURCE_FILE_NAME
+
+        with open(tar_name, "rb") as file:
+            tar_data = file.read()
+        compressed_data = heatshrink2.compress(
+            tar_data,
+            window_sz2=self.HEATSHRINK_WINDOW_SZ2,
+            lookahead_sz2=self.HEATSHRINK_LOOKAHEAD_SZ2,
+        )
+        with open(join(dst_dir, self.RESOURCE_COMPRESSED_FILE_NAME), "wb") as file:
+            file.write(
+                struct.pack(
+                    "<4sBBBB",
+                    self.HEATSHRINK_STREAM_MAGIC,
+                    self.HEATSHRINK_STREAM_VERSION,
+                    self.HEATSHRINK_WINDOW_SZ2,
+                    self.HEATSHRINK_LOOKAHEAD_SZ2,
+                    0,
+                )
+            )
+            file.write(compressed_data)
+        os.remove(tar_name)
+        self.logger.info(
+            f"Resources compressed: {len(tar_data)} -> {len(compressed_data)} bytes"
+        )
+        return self.RESOURCE_COMPRESSED_FILE_NAME
+
+    def load_firmware_image(self, filename: str):
+        with open(filename, "rb") as file:
+            data = file.read()
+        if not filename.endswith(".dfu"):
+            return data
+        # Single target, single element DFU, as produced by bin2dfu.py
+        prefix_size = struct.calcsize("<5sBIB")
+        target_prefix_size = struct.calcsize("<6sBI255sII")
+        element_address, element_size = struct.unpack_from(
+            "<II", data, prefix_size + target_prefix_size
+        )
+        if element_address != self.FLASH_BASE:
+            raise ValueError(f"Unexpected DFU element address 0x{element_address:08X}")
+        element_offset = prefix_size + target_prefix_size + struct.calcsize("<II")
+        return data[element_offset : element_offset + element_size]
+
+    def diff_page(self, base_page: bytes, target_page: bytes):
+        runs = []
+        run_start = None
+        last_changed = None
+        for offset in range(len(target_page)):
+            if base_page[offset] == target_page[offset]:
+                continue
+            if run_start is None:
+                run_start = offset
+            elif offset - last_changed > self.DELTA_RUN_MERGE_GAP:
+                runs.append((run_start, last_changed + 1))
+                run_start = offset
+            last_changed = offset
+        if run_start is not None:
+            runs.append((run_start, last_changed + 1))
+        return runs
+
+    def package_delta(self, base_filename: str, target_filename: str, dst_name: str):
+        base = self.load_firmware_image(base_filename)
+        target = self.load_firmware_image(target_filename)
+
+        page_size = self.FLASH_PAGE_SIZE
+        # Flash beyond image end is erased within the last page
+        base_padded_size = math.ceil(len(base) / page_size) * page_size
+        base_padded = base.ljust(base_padded_size, b"\xFF")
+        target_pages = math.ceil(len(target) / page_size)
+        target_padded = target.ljust(target_pages * page_size, b"\xFF")
+
+        records = []
+        for page in range(target_pages):
+            page_slice = slice(page * page_size, (page + 1) * page_size)
+            target_page = target_padded[page_slice]
+            if page_slice.stop > base_padded_size:
+                # Contents are unknown, write whole page
+                base_page = b"\xFF" * page_size
+                flags = self.DELTA_RECORD_FLAG_ERASED
+            else:
+                base_page = base_padded[page_slice]
+                flags = 0
+            runs = self.diff_page(base_page, target_page)
+            if not runs and not flags:
+                continue
+            record = struct.pack("<HBBH", page, flags, 0, len(runs))
+            for start, end in runs:
+                record += struct.pack("<HH", start, end - start)
+                record += target_page[start:end]
+            records.append(record)
+
+        base_crc = zlib.crc32(base) & 0xFFFFFFFF
+        header = struct.pack(
+            "<4sBBHIIIIII",
+            self.DELTA_FILE_MAGIC,
+            self.DELTA_FILE_VERSION,
+            0,
+            page_size,
+            self.FLASH_BASE,
+            len(base),
+            base_crc,
+            len(target),
+            zlib.crc32(target) & 0xFFFFFFFF,
+            len(records),
+        )
+        with open(dst_name, "wb") as file:
+            file.write(header)
+            for record in records:
+                file.write(record)
+
+        self.logger.info(
+            f"Delta: {len(records)} of {target_pages} pages changed, "
+            f"{os.stat(dst_name).st_size} bytes"
+        )
+        return base_crc
+
     @staticmethod
     def copro_version_as_int(coprometa, stacktype):
         major = coprometa.img_sig.version_major